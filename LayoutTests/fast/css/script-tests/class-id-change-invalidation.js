@@ -0,0 +1,122 @@
+description(
+"Tests that changing an element's class or id restyles the element, its descendants and its siblings when rules depend on them, including classes and ids that only some rules use."
+);
+
+var style = document.createElement("style");
+style.textContent =
+    ".ancestor .child { color: rgb(0, 128, 0); }\n" +
+    ".parent > .child { font-weight: bold; }\n" +
+    ".self { color: rgb(0, 0, 255); }\n" +
+    ".self-box { border-left: 3px solid; }\n" +
+    ".both { color: rgb(0, 128, 0); }\n" +
+    ".both .child { font-style: italic; }\n" +
+    ".adjacent + .sibling { color: rgb(0, 128, 0); }\n" +
+    ".general ~ .sibling { font-weight: bold; }\n" +
+    "#ancestor-id .child { color: rgb(0, 128, 0); }\n" +
+    "#self-id { color: rgb(0, 0, 255); }\n" +
+    "#adjacent-id + .sibling { font-style: italic; }\n";
+document.getElementsByTagName("head")[0].appendChild(style);
+
+var root = document.createElement("div");
+root.innerHTML =
+    "<div id='container'>" +
+        "<div id='target' class='unused'><div class='child' id='child'><span id='grandchild'>text</span></div></div>" +
+        "<div class='sibling' id='sibling1'></div>" +
+        "<div class='sibling' id='sibling2'></div>" +
+    "</div>";
+document.body.appendChild(root);
+
+var target = document.getElementById("target");
+var child = document.getElementById("child");
+var grandchild = document.getElementById("grandchild");
+var sibling1 = document.getElementById("sibling1");
+var sibling2 = document.getElementById("sibling2");
+
+function computed(element, property)
+{
+    return getComputedStyle(element, null).getPropertyValue(property);
+}
+
+var black = "rgb(0, 0, 0)";
+var green = "rgb(0, 128, 0)";
+var blue = "rgb(0, 0, 255)";
+
+debug("Classes used left of a combinator restyle descendants.");
+shouldBeEqualToString("computed(child, 'color')", black);
+target.className = "unused ancestor";
+shouldBeEqualToString("computed(child, 'color')", green);
+shouldBeEqualToString("computed(grandchild, 'color')", green);
+target.className = "unused";
+shouldBeEqualToString("computed(child, 'color')", black);
+shouldBeEqualToString("computed(grandchild, 'color')", black);
+target.className = "parent";
+shouldBeEqualToString("computed(child, 'font-weight')", "bold");
+target.removeAttribute("class");
+shouldBeEqualToString("computed(child, 'font-weight')", "normal");
+
+debug("");
+debug("Classes used only in the rightmost selector restyle the element, and descendants inherit from it.");
+target.className = "self";
+shouldBeEqualToString("computed(target, 'color')", blue);
+shouldBeEqualToString("computed(child, 'color')", blue);
+shouldBeEqualToString("computed(grandchild, 'color')", blue);
+target.className = "self self-box";
+shouldBeEqualToString("computed(target, 'border-left-width')", "3px");
+shouldBeEqualToString("computed(child, 'border-left-width')", "0px");
+target.className = "self-box";
+shouldBeEqualToString("computed(target, 'color')", black);
+shouldBeEqualToString("computed(grandchild, 'color')", black);
+target.className = "";
+shouldBeEqualToString("computed(target, 'border-left-width')", "0px");
+
+debug("");
+debug("A class used both ways restyles the element and its descendants.");
+target.className = "both";
+shouldBeEqualToString("computed(target, 'color')", green);
+shouldBeEqualToString("computed(child, 'font-style')", "italic");
+target.className = "unused";
+shouldBeEqualToString("computed(child, 'font-style')", "normal");
+shouldBeEqualToString("computed(child, 'color')", black);
+
+debug("");
+debug("Classes used left of sibling combinators restyle the following siblings.");
+target.className = "adjacent";
+shouldBeEqualToString("computed(sibling1, 'color')", green);
+shouldBeEqualToString("computed(sibling2, 'color')", black);
+target.className = "general";
+shouldBeEqualToString("computed(sibling1, 'color')", black);
+shouldBeEqualToString("computed(sibling1, 'font-weight')", "bold");
+shouldBeEqualToString("computed(sibling2, 'font-weight')", "bold");
+target.className = "";
+shouldBeEqualToString("computed(sibling2, 'font-weight')", "normal");
+
+debug("");
+debug("Classes that no rule uses change nothing.");
+target.className = "unused other";
+shouldBeEqualToString("computed(target, 'color')", black);
+shouldBeEqualToString("computed(child, 'color')", black);
+target.className = "unused other ancestor";
+shouldBeEqualToString("computed(child, 'color')", green);
+target.className = "other ancestor";
+shouldBeEqualToString("computed(child, 'color')", green);
+target.className = "other";
+shouldBeEqualToString("computed(child, 'color')", black);
+
+debug("");
+debug("Ids restyle like classes.");
+target.id = "ancestor-id";
+shouldBeEqualToString("computed(child, 'color')", green);
+target.id = "self-id";
+shouldBeEqualToString("computed(child, 'color')", blue);
+target.id = "adjacent-id";
+shouldBeEqualToString("computed(child, 'color')", black);
+shouldBeEqualToString("computed(sibling1, 'font-style')", "italic");
+target.removeAttribute("id");
+shouldBeEqualToString("computed(sibling1, 'font-style')", "normal");
+target.setAttribute("id", "self-id");
+shouldBeEqualToString("computed(target, 'color')", blue);
+target.id = "unused-id";
+shouldBeEqualToString("computed(target, 'color')", black);
+
+document.body.removeChild(root);
+var successfullyParsed = true;
@@ -0,0 +1,114 @@
+description(
+"Tests how the CSS tokenizer reads escapes, url() values, an+b expressions, unicode ranges and style sheets that end in the middle of a construct."
+);
+
+var root = document.createElement("div");
+root.innerHTML =
+    "<div id='123'></div>" +
+    "<div id='A'></div>" +
+    "<div id='e-x'></div>" +
+    "<div class='a:b' id='colon'></div>" +
+    "<div id='keyword'></div>" +
+    "<div id='quote' title='a\"b'></div>" +
+    "<div id='newline' title='cd'></div>" +
+    "<div id='u1'></div><div id='u2'></div><div id='u3'></div><div id='u4'></div><div id='u5'></div>" +
+    "<div id='n1'><p></p><p></p><p></p><p></p><p></p></div>" +
+    "<div id='n2'><p></p><p></p><p></p><p></p><p></p></div>" +
+    "<div id='n3'><p></p><p></p><p></p><p></p><p></p></div>" +
+    "<div id='n4'><p></p><p></p><p></p><p></p><p></p></div>" +
+    "<div id='n5'><p></p><p></p><p></p><p></p><p></p></div>" +
+    "<div id='eof1'></div><div id='eof2'></div><div id='eof3'></div><div id='eof4'></div>";
+document.body.appendChild(root);
+
+function addSheet(text)
+{
+    var style = document.createElement("style");
+    style.textContent = text;
+    document.getElementsByTagName("head")[0].appendChild(style);
+    return style.sheet;
+}
+
+function computed(id, property)
+{
+    return getComputedStyle(document.getElementById(id), null).getPropertyValue(property);
+}
+
+function greenChildren(id)
+{
+    var result = [];
+    var children = document.getElementById(id).childNodes;
+    for (var i = 0; i < children.length; ++i) {
+        if (getComputedStyle(children[i], null).color == "rgb(0, 128, 0)")
+            result.push(i + 1);
+    }
+    return result.join(" ");
+}
+
+debug("Escapes in selectors and values.");
+addSheet(
+    "#\\31 23 { color: green }\n" +
+    "#\\000041 { color: green }\n" +
+    "#e\\-x { color: green }\n" +
+    ".a\\:b { color: green }\n" +
+    "#keyword { color: gr\\65 en }\n" +
+    "[title=\"a\\\"b\"] { color: green }\n" +
+    "[title=\"c\\\nd\"] { color: green }\n");
+shouldBeEqualToString("computed('123', 'color')", "rgb(0, 128, 0)");
+shouldBeEqualToString("computed('A', 'color')", "rgb(0, 128, 0)");
+shouldBeEqualToString("computed('e-x', 'color')", "rgb(0, 128, 0)");
+shouldBeEqualToString("computed('colon', 'color')", "rgb(0, 128, 0)");
+shouldBeEqualToString("computed('keyword', 'color')", "rgb(0, 128, 0)");
+shouldBeEqualToString("computed('quote', 'color')", "rgb(0, 128, 0)");
+shouldBeEqualToString("computed('newline', 'color')", "rgb(0, 128, 0)");
+
+debug("");
+debug("url() with white space, quotes, escapes and upper case.");
+addSheet(
+    "#u1 { background-image: url(  tok-a.png  ) }\n" +
+    "#u2 { background-image: url( \"tok-b.png\" ) }\n" +
+    "#u3 { background-image: url(tok\\2d c.png) }\n" +
+    "#u4 { background-image: url(tok d.png) }\n" +
+    "#u5 { background-image: URL(tok-e.png) }\n");
+shouldBeTrue("/\\/tok-a\\.png\\)$/.test(computed('u1', 'background-image'))");
+shouldBeTrue("/\\/tok-b\\.png\\)$/.test(computed('u2', 'background-image'))");
+shouldBeTrue("/\\/tok-c\\.png\\)$/.test(computed('u3', 'background-image'))");
+shouldBeEqualToString("computed('u4', 'background-image')", "none");
+shouldBeTrue("/\\/tok-e\\.png\\)$/.test(computed('u5', 'background-image'))");
+
+debug("");
+debug("an+b expressions in :nth-child().");
+addSheet(
+    "#n1 > :nth-child(2n+1) { color: green }\n" +
+    "#n2 > :nth-child(-n+2) { color: green }\n" +
+    "#n3 > :nth-child( 3n + 2 ) { color: green }\n" +
+    "#n4 > :nth-child(+3) { color: green }\n" +
+    "#n5 > :nth-child(-2n+3) { color: green }\n");
+shouldBeEqualToString("greenChildren('n1')", "1 3 5");
+shouldBeEqualToString("greenChildren('n2')", "1 2");
+shouldBeEqualToString("greenChildren('n3')", "2 5");
+shouldBeEqualToString("greenChildren('n4')", "3");
+shouldBeEqualToString("greenChildren('n5')", "1 3");
+
+debug("");
+debug("unicode-range in @font-face.");
+var range1 = addSheet("@font-face { font-family: tok1; unicode-range: U+0-7F, u+4??; }").cssRules[0].style;
+var range2 = addSheet("@font-face { font-family: tok2; unicode-range: U+1F600; }").cssRules[0].style;
+var range3 = addSheet("@font-face { font-family: tok3; unicode-range: U+; }").cssRules[0].style;
+shouldBe("range1.length", "2");
+shouldBe("range2.length", "2");
+shouldBe("range3.length", "1");
+
+debug("");
+debug("Style sheets ending inside a block, a string, a comment and an escape.");
+addSheet("#eof1 { color: green");
+addSheet("#eof2 { color: green; font-family: \"abc");
+addSheet("#eof3 { color: green }\n/* unterminated");
+addSheet("#eof4 { color: green }\n#x\\");
+shouldBeEqualToString("computed('eof1', 'color')", "rgb(0, 128, 0)");
+shouldBeEqualToString("computed('eof2', 'color')", "rgb(0, 128, 0)");
+shouldBeEqualToString("computed('eof3', 'color')", "rgb(0, 128, 0)");
+shouldBeEqualToString("computed('eof4', 'color')", "rgb(0, 128, 0)");
+
+document.body.removeChild(root);
+
+var successfullyParsed = true;
@@ -0,0 +1,85 @@
+description(
+"Tests setting single keywords, inherit and initial through element.style, and that invalid keywords leave the old value in place."
+);
+
+var parent = document.createElement("div");
+parent.style.position = "relative";
+parent.style.marginLeft = "7px";
+var element = document.createElement("div");
+var plain = document.createElement("div");
+var shorthand = document.createElement("div");
+parent.appendChild(element);
+parent.appendChild(plain);
+parent.appendChild(shorthand);
+document.body.appendChild(parent);
+
+function computed(node, property)
+{
+    return getComputedStyle(node, null).getPropertyValue(property);
+}
+
+debug("Keywords valid for the property.");
+element.style.display = "inline-block";
+shouldBeEqualToString("element.style.display", "inline-block");
+shouldBeEqualToString("computed(element, 'display')", "inline-block");
+element.style.display = "TABLE-CELL";
+shouldBeEqualToString("element.style.display", "table-cell");
+element.style.visibility = "hidden";
+shouldBeEqualToString("element.style.visibility", "hidden");
+element.style.cssFloat = "left";
+shouldBeEqualToString("element.style.cssFloat", "left");
+element.style.textAlign = "-webkit-center";
+shouldBeEqualToString("element.style.textAlign", "-webkit-center");
+element.style.whiteSpace = "pre-wrap";
+shouldBeEqualToString("element.style.whiteSpace", "pre-wrap");
+element.style.overflowX = "scroll";
+shouldBeEqualToString("element.style.overflowX", "scroll");
+element.style.fontSize = "larger";
+shouldBeEqualToString("element.style.fontSize", "larger");
+element.style.verticalAlign = "middle";
+shouldBeEqualToString("element.style.verticalAlign", "middle");
+element.style.listStyleType = "lower-roman";
+shouldBeEqualToString("element.style.listStyleType", "lower-roman");
+element.style.width = "auto";
+shouldBeEqualToString("element.style.width", "auto");
+element.style.zIndex = "auto";
+shouldBeEqualToString("element.style.zIndex", "auto");
+
+debug("");
+debug("Keywords for properties that are still parsed by the grammar.");
+element.style.cursor = "pointer";
+shouldBeEqualToString("element.style.cursor", "pointer");
+
+debug("");
+debug("inherit and initial.");
+element.style.position = "inherit";
+shouldBeEqualToString("element.style.position", "inherit");
+shouldBeEqualToString("computed(element, 'position')", "relative");
+plain.style.display = "initial";
+shouldBeEqualToString("plain.style.display", "initial");
+shouldBeEqualToString("computed(plain, 'display')", "inline");
+element.style.zIndex = "INHERIT";
+shouldBeEqualToString("element.style.zIndex", "inherit");
+shorthand.style.margin = "inherit";
+shouldBeEqualToString("computed(shorthand, 'margin-left')", "7px");
+
+debug("");
+debug("Invalid keywords keep the previous value.");
+element.style.display = "block";
+element.style.display = "bogus";
+shouldBeEqualToString("element.style.display", "block");
+element.style.position = "absolute";
+element.style.position = "block";
+shouldBeEqualToString("element.style.position", "absolute");
+element.style.visibility = "inherit inherit";
+shouldBeEqualToString("element.style.visibility", "hidden");
+element.style.fontSize = "bigger";
+shouldBeEqualToString("element.style.fontSize", "larger");
+element.style.cssFloat = "initial initial";
+shouldBeEqualToString("element.style.cssFloat", "left");
+element.style.display = "";
+shouldBeEqualToString("element.style.display", "");
+
+document.body.removeChild(parent);
+
+var successfullyParsed = true;
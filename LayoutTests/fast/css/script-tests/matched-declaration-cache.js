@@ -0,0 +1,83 @@
+description(
+"Tests that sibling elements matching the same declarations still get their own style when they differ in inline style, link state, or the zoom of their ancestors."
+);
+
+var style = document.createElement("style");
+style.textContent =
+    ".item { color: rgb(0, 128, 0); width: 10px; font-size: 12px; }\n" +
+    ".shrink { display: inline-block; }\n" +
+    ".zoomed { zoom: 2; }\n";
+document.getElementsByTagName("head")[0].appendChild(style);
+
+var root = document.createElement("div");
+root.innerHTML =
+    "<div id='inline'>" +
+        "<div class='item' id='i1'></div>" +
+        "<div class='item' id='i2' style='color: rgb(0, 0, 255)'></div>" +
+        "<div class='item' id='i3'></div>" +
+        "<div class='item' id='i4'></div>" +
+    "</div>" +
+    "<div id='links'>" +
+        "<a class='item' id='l1'><span id='s1'>x</span></a>" +
+        "<a class='item' id='l2' href='#'><span id='s2'>x</span></a>" +
+        "<a class='item' id='l3'><span id='s3'>x</span></a>" +
+    "</div>" +
+    "<div class='shrink' id='z1'><div class='zoomed' id='zoom1'><div class='item'></div></div></div>" +
+    "<div class='shrink' id='z2'><div id='zoom2'><div class='item'></div></div></div>" +
+    "<div class='shrink' id='z3'><div id='zoom3'><div class='item'></div></div></div>";
+document.body.appendChild(root);
+
+function computed(id, property)
+{
+    return getComputedStyle(document.getElementById(id), null).getPropertyValue(property);
+}
+
+function width(id)
+{
+    return document.getElementById(id).offsetWidth;
+}
+
+debug("Inline style only affects its own element.");
+shouldBeEqualToString("computed('i1', 'color')", "rgb(0, 128, 0)");
+shouldBeEqualToString("computed('i2', 'color')", "rgb(0, 0, 255)");
+shouldBeEqualToString("computed('i3', 'color')", "rgb(0, 128, 0)");
+shouldBeEqualToString("computed('i2', 'font-size')", "12px");
+document.getElementById("i3").style.color = "rgb(255, 0, 0)";
+shouldBeEqualToString("computed('i3', 'color')", "rgb(255, 0, 0)");
+shouldBeEqualToString("computed('i4', 'color')", "rgb(0, 128, 0)");
+document.getElementById("i3").style.color = "rgb(0, 0, 255)";
+shouldBeEqualToString("computed('i3', 'color')", "rgb(0, 0, 255)");
+document.getElementById("i3").removeAttribute("style");
+shouldBeEqualToString("computed('i3', 'color')", "rgb(0, 128, 0)");
+document.getElementById("i1").style.width = "20px";
+shouldBe("width('i1')", "20");
+shouldBe("width('i4')", "10");
+
+debug("");
+debug("Links and the elements inside them do not share with other elements.");
+shouldBeEqualToString("computed('l1', 'color')", "rgb(0, 128, 0)");
+shouldBeEqualToString("computed('s1', 'color')", "rgb(0, 128, 0)");
+shouldBeEqualToString("computed('l3', 'color')", "rgb(0, 128, 0)");
+shouldBeEqualToString("computed('s3', 'color')", "rgb(0, 128, 0)");
+shouldBeEqualToString("computed('l1', 'text-decoration')", "none");
+shouldBeEqualToString("computed('l2', 'text-decoration')", "underline");
+shouldBeEqualToString("computed('l3', 'text-decoration')", "none");
+document.getElementById("l1").setAttribute("href", "#");
+shouldBeEqualToString("computed('l1', 'text-decoration')", "underline");
+shouldBeEqualToString("computed('l3', 'text-decoration')", "none");
+document.getElementById("l1").removeAttribute("href");
+shouldBeEqualToString("computed('l1', 'text-decoration')", "none");
+
+debug("");
+debug("Elements below a zoomed ancestor are sized with its zoom, and others are not.");
+shouldBe("width('z1')", "20");
+shouldBe("width('z2')", "10");
+document.getElementById("zoom3").className = "zoomed";
+shouldBe("width('z3')", "20");
+shouldBe("width('z2')", "10");
+document.getElementById("zoom1").className = "";
+shouldBe("width('z1')", "10");
+shouldBe("width('z3')", "20");
+
+document.body.removeChild(root);
+var successfullyParsed = true;
@@ -0,0 +1,86 @@
+description(
+"Tests that JSON.stringify and JSON.parse round-trip strings with escapes and surrogates, numbers, repeated key sets, and values passed through a reviver."
+);
+
+function roundTrip(value)
+{
+    return JSON.parse(JSON.stringify(value));
+}
+
+// Escapes.
+shouldBe("JSON.stringify('\"\\\\/\\b\\f\\n\\r\\t')", "'\"\\\\\"\\\\\\\\/\\\\b\\\\f\\\\n\\\\r\\\\t\"'");
+shouldBe("JSON.stringify('\\u0000\\u0001\\u001f\\u007f')", "'\"\\\\u0000\\\\u0001\\\\u001f\\u007f\"'");
+shouldBe("JSON.stringify('a\\u2028b\\u2029c')", "'\"a\\u2028b\\u2029c\"'");
+shouldBe("JSON.parse('\"\\\\u0041\\\\u00e9\\\\u4E2D\\\\/\\\\\\\\\"')", "'A\\u00e9\\u4e2d/\\\\'");
+shouldBe("JSON.parse('\"\\\\b\\\\f\\\\n\\\\r\\\\t\\\\\"\"')", "'\\b\\f\\n\\r\\t\"'");
+shouldBe("roundTrip('plain ascii text')", "'plain ascii text'");
+var allChars = "";
+for (var i = 0; i < 256; ++i)
+    allChars += String.fromCharCode(i);
+shouldBe("roundTrip(allChars)", "allChars");
+shouldBe("roundTrip({ 'key\\nwith\\tescapes\"': 'v' })['key\\nwith\\tescapes\"']", "'v'");
+shouldThrow("JSON.parse('\"\\\\x41\"')");
+shouldThrow("JSON.parse('\"\\\\u00G1\"')");
+shouldThrow("JSON.parse('\"a\\nb\"')");
+shouldThrow("JSON.parse('\"unterminated')");
+
+// Surrogates, paired and lone, survive unchanged.
+shouldBe("roundTrip('\\ud834\\udd1e')", "'\\ud834\\udd1e'");
+shouldBe("roundTrip('\\ud834\\udd1e').length", "2");
+shouldBe("roundTrip('x\\ud800')", "'x\\ud800'");
+shouldBe("roundTrip('\\udc00x')", "'\\udc00x'");
+shouldBe("JSON.parse('\"\\\\uD834\\\\uDD1E\"')", "'\\ud834\\udd1e'");
+shouldBe("JSON.parse('\"\\\\uDC00\\\\uD800\"')", "'\\udc00\\ud800'");
+shouldBe("roundTrip({ '\\ud834\\udd1e': 1 })['\\ud834\\udd1e']", "1");
+
+// Numbers.
+shouldBe("JSON.stringify([0, -0, 1, -1, 123456789, 2147483647, -2147483648, 2147483648, 1.5, 1e21, 1e-7, NaN, Infinity])", "'[0,0,1,-1,123456789,2147483647,-2147483648,2147483648,1.5,1e+21,1e-7,null,null]'");
+shouldBe("JSON.parse('[0, -0, 123456789, 1234567890, 99999999999, -12, 1.5e3, 0.1, 1E2]')", "[0, -0, 123456789, 1234567890, 99999999999, -12, 1500, 0.1, 100]");
+shouldBe("1 / JSON.parse('-0')", "-Infinity");
+shouldBe("JSON.parse('999999999')", "999999999");
+shouldBe("JSON.parse('-999999999')", "-999999999");
+shouldThrow("JSON.parse('01')");
+shouldThrow("JSON.parse('1.')");
+shouldThrow("JSON.parse('+1')");
+
+// Objects with repeated key sets, and a key set that changes partway through.
+var records = [];
+for (var i = 0; i < 20; ++i)
+    records.push({ id: i, name: "n" + i, a: i % 2 ? null : true, b: [i] });
+records[10] = { id: 10, name: "n10", b: [10], a: false };
+records[15] = { id: 15 };
+var recordsText = JSON.stringify(records);
+var parsedRecords = JSON.parse(recordsText);
+shouldBe("JSON.stringify(parsedRecords)", "recordsText");
+shouldBe("Object.keys(parsedRecords[10]).join()", "'id,name,b,a'");
+shouldBe("Object.keys(parsedRecords[15]).join()", "'id'");
+shouldBe("Object.keys(parsedRecords[16]).join()", "'id,name,a,b'");
+shouldBe("parsedRecords[19].b[0]", "19");
+shouldBe("JSON.stringify(JSON.parse('{\"a\":1,\"a\":2}'))", "'{\"a\":2}'");
+shouldBe("JSON.stringify(JSON.parse('[{\"a\":1,\"b\":2},{\"b\":3,\"a\":4},{\"a\":5}]'))", "'[{\"a\":1,\"b\":2},{\"b\":3,\"a\":4},{\"a\":5}]'");
+shouldBe("JSON.stringify(JSON.parse('{\"\":1,\"a\":{\"\":2}}'))", "'{\"\":1,\"a\":{\"\":2}}'");
+
+// Properties added between objects with the same Structure, and deleted properties.
+var o1 = { x: 1, y: 2 };
+var o2 = { x: 3, y: 4 };
+o2.z = 5;
+var o3 = { x: 6, y: 7 };
+delete o3.x;
+shouldBe("JSON.stringify([o1, o2, o3, o1])", "'[{\"x\":1,\"y\":2},{\"x\":3,\"y\":4,\"z\":5},{\"y\":7},{\"x\":1,\"y\":2}]'");
+shouldBe("JSON.stringify([{ a: undefined, b: function() {} }, { a: 1 }])", "'[{},{\"a\":1}]'");
+
+// Revivers.
+shouldBe("JSON.parse('{\"a\":1,\"b\":[1,2,{\"c\":3}]}', function(k, v) { return typeof v == 'number' ? v * 10 : v; }).b[2].c", "30");
+shouldBe("JSON.stringify(JSON.parse('{\"a\":1,\"b\":2}', function(k, v) { return k == 'a' ? undefined : v; }))", "'{\"b\":2}'");
+var order = [];
+JSON.parse('{"a":{"b":1,"c":[2,3]},"d":4}', function(k, v) { order.push(k); return v; });
+shouldBe("order.join()", "'b,0,1,c,a,d,'");
+shouldBe("JSON.parse('\"\\\\ud834\\\\udd1e\"', function(k, v) { return v.length; })", "2");
+shouldBe("JSON.parse('[1,2]', function(k, v) { return k === '' ? this[''] : v; })", "[1, 2]");
+
+// Replacers and indentation.
+shouldBe("JSON.stringify({ a: 1, b: 2, c: 3 }, ['c', 'a'])", "'{\"c\":3,\"a\":1}'");
+shouldBe("JSON.stringify({ a: [1, { b: 'x' }] }, null, 2)", "'{\\n  \"a\": [\\n    1,\\n    {\\n      \"b\": \"x\"\\n    }\\n  ]\\n}'");
+shouldBe("JSON.stringify({ a: 'x\\ny' }, function(k, v) { return typeof v == 'string' ? v.toUpperCase() : v; })", "'{\"a\":\"X\\\\nY\"}'");
+
+var successfullyParsed = true;
@@ -0,0 +1,122 @@
+description(
+"Tests arrays whose values change from int32 to double to other values, including holes, sorting, mapping and garbage collection."
+);
+
+function gcIfPossible()
+{
+    if (this.GCController)
+        GCController.collect();
+    else if (this.gc)
+        gc();
+    else {
+        for (var i = 0; i < 10000; ++i)
+            new Array(10);
+    }
+}
+
+function fill(a, n, f)
+{
+    for (var i = 0; i < n; ++i)
+        a[i] = f(i);
+    return a;
+}
+
+// int32 to double to object, by indexed store and by push.
+var a = fill([], 10, function(i) { return i; });
+a[3] = 1.5;
+shouldBe("a[3]", "1.5");
+shouldBe("a[4]", "4");
+a[5] = "five";
+shouldBe("a[5]", "'five'");
+a[6] = { value: 6 };
+gcIfPossible();
+shouldBe("a[6].value", "6");
+shouldBe("a.join()", "'0,1,2,1.5,4,five,[object Object],7,8,9'");
+
+var b = [1, 2, 3];
+b.push(0.5);
+b.push(-0);
+b.push(NaN);
+shouldBe("b.length", "6");
+shouldBe("1 / b[4]", "-Infinity");
+shouldBeTrue("isNaN(b[5])");
+b.push("s", null, undefined, true);
+shouldBe("b.slice(6).join('|')", "'s|||true'");
+shouldBe("typeof b[8]", "'undefined'");
+shouldBeTrue("8 in b");
+
+// Objects stored into a numeric array must stay alive across a collection.
+var c = fill(new Array(100), 100, function(i) { return i * 0.5; });
+for (var i = 0; i < 100; i += 10)
+    c[i] = { index: i, name: "object " + i };
+gcIfPossible();
+fill([], 1000, function(i) { return { garbage: i }; });
+gcIfPossible();
+var ok = true;
+for (var i = 0; i < 100; ++i) {
+    if (i % 10) {
+        if (c[i] !== i * 0.5)
+            ok = false;
+    } else if (c[i].index !== i || c[i].name !== "object " + i)
+        ok = false;
+}
+shouldBeTrue("ok");
+
+// A numeric array that later receives a string made by concatenation.
+var d = fill([], 50, function(i) { return i; });
+d[49] = "str" + Math.random();
+gcIfPossible();
+shouldBe("d[49].substring(0, 3)", "'str'");
+
+// Holes read as undefined and are skipped by sort and map.
+var e = [3, , 1, , 2];
+shouldBe("e.length", "5");
+shouldBeFalse("1 in e");
+shouldBe("e[1]", "undefined");
+e[10] = 0.25;
+shouldBe("e.length", "11");
+shouldBeFalse("7 in e");
+gcIfPossible();
+e.sort(function(x, y) { return x - y; });
+shouldBe("e.slice(0, 4)", "[0.25, 1, 2, 3]");
+shouldBeFalse("4 in e");
+shouldBe("e.length", "11");
+
+var f = new Array(5);
+f[2] = 7;
+f[4] = { x: 1 };
+gcIfPossible();
+shouldBe("f[4].x", "1");
+shouldBeFalse("0 in f");
+shouldBe("[1, , 3].map(function(x) { return x * 2; }).length", "3");
+shouldBeFalse("1 in [1, , 3].map(function(x) { return x * 2; })");
+
+// Sorting arrays of each type.
+shouldBe("[3, 1, 2, -5, 10].sort(function(x, y) { return x - y; })", "[-5, 1, 2, 3, 10]");
+shouldBe("[3, 1, 2, -5, 10].sort()", "[-5, 1, 10, 2, 3]");
+shouldBe("[2147483647, -2147483648, 0].sort(function(x, y) { return x - y; })", "[-2147483648, 0, 2147483647]");
+shouldBe("[0.5, -1.5, 2, 1].sort(function(x, y) { return x - y; })", "[-1.5, 0.5, 1, 2]");
+shouldBe("[3, 1, '2', 0.5].sort(function(x, y) { return x - y; })", "[0.5, 1, '2', 3]");
+shouldBe("[3, 1, 2].concat([0.5]).sort(function(x, y) { return x - y; })", "[0.5, 1, 2, 3]");
+
+// map results start out as numbers but may hold anything.
+shouldBe("[1, 2, 3].map(function(x) { return x / 2; })", "[0.5, 1, 1.5]");
+shouldBe("[1, 2, 3].map(function(x) { return x == 2 ? 'two' : x; })", "[1, 'two', 3]");
+var mapped = [1, 2, 3].map(function(x) { return { v: x }; });
+gcIfPossible();
+shouldBe("mapped[2].v", "3");
+
+// Stores in a hot loop, where the JIT's put_by_val fast path is used.
+var g = [];
+for (var i = 0; i < 1000; ++i)
+    g[i] = i;
+for (var i = 0; i < 1000; ++i)
+    g[i] = i < 500 ? i : i + 0.5;
+for (var i = 900; i < 1000; ++i)
+    g[i] = { n: i };
+gcIfPossible();
+shouldBe("g[499]", "499");
+shouldBe("g[500]", "500.5");
+shouldBe("g[999].n", "999");
+
+var successfullyParsed = true;
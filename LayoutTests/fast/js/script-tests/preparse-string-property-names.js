@@ -0,0 +1,30 @@
+description(
+"Tests that object literals keyed by string literals are parsed correctly inside lazily parsed function bodies."
+);
+
+function stringKeyedGetter() { return { "a": 1, get b() { return 2; } }; }
+function stringKeyedSetter() { var o = { "a": 1, set b(v) { this.a = v; } }; o.b = 7; return o.a; }
+function getterAndSetterPair() { var o = { "_v": 0, get v() { return this._v; }, set v(x) { this._v = x * 2; } }; o.v = 4; return o.v; }
+function duplicateSloppyKeys() { return { "a": 1, "a": 2 }.a; }
+function nestedFunction() { return function() { return { "key with spaces": 5, "x y": 6 }; }; }
+
+shouldBe("stringKeyedGetter().a", "1");
+shouldBe("stringKeyedGetter().b", "2");
+shouldBe("stringKeyedSetter()", "7");
+shouldBe("getterAndSetterPair()", "8");
+shouldBe("duplicateSloppyKeys()", "2");
+shouldBe("nestedFunction()()['key with spaces']", "5");
+shouldBe("nestedFunction()()['x y']", "6");
+
+shouldThrow("eval('function f() { return { get a() { return 1; }, \"a\": 2 }; }')");
+shouldThrow("eval('function f() { return { \"a\": 2, get a() { return 1; } }; }')");
+shouldThrow("eval('function f() { return { set b(v) { }, \"b\": 2 }; }')");
+shouldThrow("eval('function f() { \"use strict\"; return { \"a\": 1, \"a\": 2 }; }')");
+shouldThrow("eval('function f() { \"use strict\"; return { \"a\": 1, a: 2 }; }')");
+shouldBeUndefined("eval('function f() { return { \"a\": 1, get b() { return 1; }, set b(v) { } }; }')");
+
+// Accessors are only named by identifiers.
+shouldThrow("eval('function f() { return { get \"a\"() { return 1; } }; }')");
+shouldThrow("eval('function f() { return { set 1(v) { } }; }')");
+
+var successfullyParsed = true;
@@ -0,0 +1,74 @@
+description(
+"Tests global String.prototype.replace and String.prototype.split with empty matches, captures, literal patterns, lastIndex and the RegExp statics."
+);
+
+// Empty matches advance by one character.
+shouldBe("'abc'.replace(/x*/g, '-')", "'-a-b-c-'");
+shouldBe("''.replace(/x*/g, '-')", "'-'");
+shouldBe("'abc'.replace(/(?:)/g, '$&|')", "'|a|b|c|'");
+shouldBe("'aaa'.replace(/a*?/g, '-')", "'-a-a-a-'");
+shouldBe("'aaa'.replace(/a*/g, '-')", "'--'");
+shouldBe("'abc'.split(/x*/)", "['a', 'b', 'c']");
+shouldBe("'abc'.split(/(?:)/)", "['a', 'b', 'c']");
+shouldBe("''.split(/x*/)", "[]");
+shouldBe("''.split(/y/)", "['']");
+shouldBe("'ab'.split(/a*?/)", "['a', 'b']");
+shouldBe("'ab'.split(/a*/)", "['', 'b']");
+
+// Captures, including ones that do not participate in a match.
+shouldBe("'A<B>bold</B>and<CODE>coded</CODE>'.split(/<(\\/)?([^<>]+)>/)", "['A', undefined, 'B', 'bold', '/', 'B', 'and', undefined, 'CODE', 'coded', '/', 'CODE', '']");
+shouldBe("'a1b2c3'.split(/(\\d)/)", "['a', '1', 'b', '2', 'c', '3', '']");
+shouldBe("'a1b22c'.split(/(\\d)(\\d)?/).join('|')", "'a|1||b|2|2|c'");
+shouldBe("'a1b22c'.replace(/(\\d)(\\d)?/g, '[$1$2]')", "'a[1]b[22]c'");
+shouldBe("'x-y_z'.replace(/(-)|(_)/g, '<$1|$2>')", "'x<-|>y<|_>z'");
+shouldBe("'x-y_z'.split(/(-)|(_)/)", "['x', '-', undefined, 'y', undefined, '_', 'z']");
+shouldBe("'aaa'.replace(/(a)|b/g, '$1$1')", "'aaaaaa'");
+shouldBe("'abcabc'.replace(/(b)/g, '$$$1$`')", "'a$baca$babcac'");
+shouldBe("'abc'.replace(/b/g, \"$'\")", "'acc'");
+
+// Limits on split.
+shouldBe("'a,b,c,d'.split(/,/, 2)", "['a', 'b']");
+shouldBe("'a,b,c,d'.split(/,/, 0)", "[]");
+shouldBe("'a,b,c,d'.split(/,/, -1)", "['a', 'b', 'c', 'd']");
+shouldBe("'a,b,c,d'.split(/,/, undefined)", "['a', 'b', 'c', 'd']");
+
+// Literal patterns.
+shouldBe("'a.b.c'.replace(/\\./g, '/')", "'a/b/c'");
+shouldBe("'aXbXXc'.split(/X/)", "['a', 'b', '', 'c']");
+shouldBe("'abababa'.replace(/aba/g, 'x')", "'xbx'");
+shouldBe("'aaaa'.replace(/a{2}/g, 'b')", "'bb'");
+shouldBe("'a\\nb\\nc'.split(/\\n/)", "['a', 'b', 'c']");
+shouldBe("'AbAB'.replace(/ab/gi, '-')", "'--'");
+shouldBe("'foo bar foo'.replace(/foo|bar/g, 'x')", "'x x x'");
+shouldBe("'abcabc'.split(/abc/)", "['', '', '']");
+
+// Matching starts at the beginning whatever lastIndex is, and the statics reflect the last match.
+var re = /(\d)(\w)/g;
+re.lastIndex = 3;
+shouldBe("'1a 2b 3c'.replace(re, '$2$1')", "'a1 b2 c3'");
+shouldBe("RegExp.lastMatch", "'3c'");
+shouldBe("RegExp.$1", "'3'");
+shouldBe("RegExp.$2", "'c'");
+shouldBe("RegExp.leftContext", "'1a 2b '");
+shouldBe("RegExp.rightContext", "''");
+
+// A replacement callback sees the statics for each match in turn.
+var seen = [];
+'1a 2b'.replace(/(\d)(\w)/g, function(m, a, b, offset) { seen.push(RegExp.lastMatch + ':' + RegExp.$2 + ':' + offset); return m; });
+shouldBe("seen.join(' ')", "'1a:a:0 2b:b:3'");
+shouldBe("'abc'.replace(/(?:)/g, function(m, offset) { return '' + offset; })", "'0a1b2c3'");
+
+// Non-global patterns replace only the first match.
+shouldBe("'aaa'.replace(/a/, 'b')", "'baa'");
+shouldBe("'aaa'.replace(/x*/, '-')", "'-aaa'");
+
+// Literal patterns expanded by a quantifier, including ones too long to expand.
+shouldBe("'xaaaay'.replace(/a{3}/g, '-')", "'x-ay'");
+shouldBe("'a,,b,,c'.split(/,{2}/)", "['a', 'b', 'c']");
+var longRun = new Array(302).join('b');
+shouldBe("('a' + longRun + 'c').replace(/b{300}/g, '-')", "'a-bc'");
+shouldBe("('a' + longRun).search(/ab{300}/)", "0");
+shouldBe("'abc'.search(/b{4000000000}/)", "-1");
+shouldBe("'abc'.replace(/c{4000000000}/g, '-')", "'abc'");
+
+var successfullyParsed = true;
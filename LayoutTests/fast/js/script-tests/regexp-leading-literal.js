@@ -0,0 +1,66 @@
+description(
+"Tests regular expressions that begin with literal characters, including case-insensitive, multiline and anchored patterns, and patterns run by the interpreter."
+);
+
+var text = "";
+for (var i = 0; i < 200; ++i)
+    text += "neelde nedle needl ";
+var tail = text + "needle42 NEEDLE7 x";
+
+// Short and long leading literals.
+shouldBe("tail.search(/n\\d/)", "-1");
+shouldBe("tail.search(/ne/)", "0");
+shouldBe("tail.search(/needle\\d+/)", "text.length");
+shouldBe("tail.match(/needle\\d+/)[0]", "'needle42'");
+shouldBe("tail.match(/needle(\\d)\\1?/)[0]", "'needle4'");
+shouldBe("tail.search(/needle4(\\d)(?=\\s)/)", "text.length");
+shouldBe("tail.search(/needle(\\d)\\1/)", "-1");
+shouldBe("tail.search(/nedle nee(d)l\\1/)", "-1");
+shouldBe("tail.search(/nedle needl needle(4)/)", "text.length - 12");
+shouldBe("tail.search(/needle42 NEEDLE/)", "text.length");
+shouldBe("tail.search(/needle43/)", "-1");
+shouldBe("tail.search(/needle42$/)", "-1");
+shouldBe("tail.search(/x$/)", "tail.length - 1");
+
+// Case-insensitive patterns match literals in either case.
+shouldBe("tail.search(/NEEDLE\\d/i)", "text.length");
+shouldBe("tail.search(/NEEDLE7/i)", "text.length + 9");
+shouldBe("tail.search(/neEdle7/i)", "text.length + 9");
+shouldBe("tail.search(/NeEdLe(\\d)/i)", "text.length");
+shouldBe("'xxAbCd'.search(/abcd/i)", "2");
+shouldBe("'xx\\u00c0b'.search(/\\u00e0b/i)", "2");
+
+// Multiline anchors.
+shouldBe("'foo\\nbar\\nbaz'.search(/^bar/m)", "4");
+shouldBe("'foo\\nbar\\nbaz'.search(/^bar/)", "-1");
+shouldBe("'foo\\nbar\\nbaz'.search(/ba.$/m)", "4");
+shouldBe("'foo\\nbar\\nbaz'.match(/^ba./gm)", "['bar', 'baz']");
+shouldBe("'ab\\nab'.search(/b$/m)", "1");
+shouldBe("'xab\\nab'.search(/^ab/m)", "4");
+
+// Characters that share their low byte with the literal must not be confused with it.
+shouldBe("'\\u0161\\u0162\\u0163abc'.search(/abc/)", "3");
+shouldBe("'\\u0161bcde abcde'.search(/abcde/)", "6");
+shouldBe("'\\u0161bcd(e) abcde'.search(/abcd(e)/)", "8");
+shouldBe("'abcd\\u0165 abcde'.search(/abcd(e)\\1?/)", "6");
+shouldBe("'xyz'.search(/\\u0178yz/)", "-1");
+
+// Literals at the very end of the subject, and subjects shorter than the literal.
+shouldBe("'abcdefgh'.search(/fgh/)", "5");
+shouldBe("'abcdefgh'.search(/efgh(i)?/)", "4");
+shouldBe("'abcdefgh'.search(/fghi/)", "-1");
+shouldBe("'ab'.search(/abcdef(g)/)", "-1");
+shouldBe("''.search(/a/)", "-1");
+
+// Global matching continues from the end of each match.
+shouldBe("'aXbXcX'.match(/[a-c]X/g)", "['aX', 'bX', 'cX']");
+shouldBe("'abab abab'.replace(/abab(\\s)?/g, '<$1>')", "'< ><>'");
+shouldBe("'ab1 ab2 ab3'.match(/ab\\d/g)", "['ab1', 'ab2', 'ab3']");
+
+// Alternations and optional leading characters start matches anywhere.
+shouldBe("'xxbc'.search(/abc|bc/)", "2");
+shouldBe("'xxbc'.search(/a?bc/)", "2");
+shouldBe("'xxbc'.search(/a*bc/)", "2");
+shouldBe("'xxabc'.search(/(a)bc/)", "2");
+
+var successfullyParsed = true;
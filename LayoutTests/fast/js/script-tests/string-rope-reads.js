@@ -0,0 +1,90 @@
+description(
+"Tests that charAt, charCodeAt, indexOf, slice and indexed reads give the same results on strings built by concatenation as on flat strings."
+);
+
+function makeRope(parts)
+{
+    var s = "";
+    for (var i = 0; i < parts.length; ++i)
+        s += parts[i];
+    return s;
+}
+
+function makePrefixRope(count)
+{
+    var s = "end";
+    for (var i = 0; i < count; ++i)
+        s = String.fromCharCode(97 + i % 26) + s;
+    return s;
+}
+
+var parts = ["abc", "def", "", "ghij", "k", "lmnop", "\u1234\u5678", "qrstuvwxyz"];
+var flat = parts.join("");
+
+var rope = makeRope(parts);
+shouldBe("rope.length", "flat.length");
+shouldBe("rope.charAt(0)", "'a'");
+shouldBe("rope.charAt(3)", "'d'");
+shouldBe("rope.charAt(6)", "'g'");
+shouldBe("rope.charAt(10)", "'k'");
+shouldBe("rope.charAt(flat.length - 1)", "'z'");
+shouldBe("rope.charAt(flat.length)", "''");
+shouldBe("rope.charAt(-1)", "''");
+shouldBe("rope.charCodeAt(16)", "0x1234");
+shouldBe("rope.charCodeAt(17)", "0x5678");
+shouldBeTrue("isNaN(rope.charCodeAt(flat.length))");
+shouldBeTrue("isNaN(rope.charCodeAt(-1))");
+shouldBe("rope[11]", "'l'");
+shouldBe("rope[flat.length]", "undefined");
+
+rope = makeRope(parts);
+shouldBe("rope.indexOf('a')", "0");
+shouldBe("rope.indexOf('cde')", "2");
+shouldBe("rope.indexOf('fgh')", "5");
+shouldBe("rope.indexOf('jklm')", "9");
+shouldBe("rope.indexOf('p\\u1234\\u5678q')", "15");
+shouldBe("rope.indexOf('xyz')", "flat.length - 3");
+shouldBe("rope.indexOf('')", "0");
+shouldBe("rope.indexOf('', 5)", "5");
+shouldBe("rope.indexOf('', 1000)", "flat.length");
+shouldBe("rope.indexOf('zz')", "-1");
+shouldBe("rope.indexOf('abd')", "-1");
+shouldBe("rope.indexOf('d', 4)", "-1");
+shouldBe("rope.indexOf('k', 10)", "10");
+shouldBe("rope.indexOf('k', 11)", "-1");
+shouldBe("rope.indexOf(flat)", "0");
+shouldBe("rope.indexOf(flat + 'x')", "-1");
+
+rope = makeRope(parts);
+shouldBe("rope.slice(0, 3)", "'abc'");
+shouldBe("rope.slice(2, 11)", "'cdefghijk'");
+shouldBe("rope.slice(-3)", "'xyz'");
+shouldBe("rope.slice(5, 5)", "''");
+shouldBe("rope.slice(7, 3)", "''");
+shouldBe("rope.slice(0)", "flat");
+shouldBe("rope.substring(4, 9)", "'efghi'");
+shouldBe("rope.substr(10, 2)", "'kl'");
+
+// Deep ropes and ropes with many fibers fall back to flattening; the results must not change.
+var deep = makePrefixRope(200);
+var deepFlat = deep.split("").join("");
+shouldBe("deep.charAt(0)", "deepFlat.charAt(0)");
+shouldBe("deep.charCodeAt(199)", "deepFlat.charCodeAt(199)");
+shouldBe("deep.charAt(200)", "'e'");
+shouldBe("deep.charAt(150)", "deepFlat.charAt(150)");
+deep = makePrefixRope(200);
+shouldBe("deep.indexOf('zab')", "deepFlat.indexOf('zab')");
+shouldBe("deep.indexOf('end')", "200");
+shouldBe("deep.indexOf('abcdefghijklmnopqrstuvwxyzabcdefghijk')", "deepFlat.indexOf('abcdefghijklmnopqrstuvwxyzabcdefghijk')");
+shouldBe("deep.slice(190)", "deepFlat.slice(190)");
+
+var many = "";
+for (var i = 0; i < 100; ++i)
+    many = many + i + ",";
+var manyFlat = many.split("").join("");
+shouldBe("many.indexOf('99,')", "manyFlat.indexOf('99,')");
+shouldBe("many.indexOf('9,10')", "manyFlat.indexOf('9,10')");
+shouldBe("many.charAt(many.length - 2)", "'9'");
+shouldBe("many.lastIndexOf('5')", "manyFlat.lastIndexOf('5')");
+
+var successfullyParsed = true;
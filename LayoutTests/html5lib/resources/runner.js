@@ -0,0 +1,119 @@
+// Runs html5lib tree construction tests: each test is a #data section, an
+// #errors section, which is not checked, and the expected #document tree.
+// Every test is written into an iframe with document.write() several times:
+// all at once, one character per call, and seven characters per call. Each
+// call ends a segment of the parser's input, so the later runs split text,
+// attribute values, character references and CR LF pairs at every position.
+
+if (window.layoutTestController)
+    layoutTestController.dumpAsText();
+
+function log(message)
+{
+    document.getElementById("console").appendChild(document.createTextNode(message + "\n"));
+}
+
+function parseTests(text)
+{
+    var tests = [];
+    var lines = text.split("\n");
+    var test = null;
+    var section = null;
+    for (var i = 0; i < lines.length; ++i) {
+        var line = lines[i];
+        if (line == "#data") {
+            test = { data: [], document: [] };
+            tests.push(test);
+            section = test.data;
+        } else if (line == "#errors")
+            section = null;
+        else if (line == "#document")
+            section = test.document;
+        else if (section)
+            section.push(line);
+    }
+    for (var i = 0; i < tests.length; ++i) {
+        tests[i].data = tests[i].data.join("\n");
+        // Drop the blank line that separates tests.
+        while (tests[i].document.length && !tests[i].document[tests[i].document.length - 1])
+            tests[i].document.pop();
+        tests[i].document = tests[i].document.join("\n");
+    }
+    return tests;
+}
+
+function indent(depth)
+{
+    return "| " + new Array(depth + 1).join("  ");
+}
+
+function serialize(node, depth, lines)
+{
+    for (var child = node.firstChild; child; child = child.nextSibling) {
+        switch (child.nodeType) {
+        case Node.ELEMENT_NODE:
+            lines.push(indent(depth) + "<" + child.localName + ">");
+            var attributes = [];
+            for (var i = 0; i < child.attributes.length; ++i)
+                attributes.push(child.attributes[i].name + "=\"" + child.attributes[i].value + "\"");
+            attributes.sort();
+            for (var i = 0; i < attributes.length; ++i)
+                lines.push(indent(depth + 1) + attributes[i]);
+            serialize(child, depth + 1, lines);
+            break;
+        case Node.TEXT_NODE:
+            lines.push(indent(depth) + "\"" + child.data + "\"");
+            break;
+        case Node.COMMENT_NODE:
+            lines.push(indent(depth) + "<!-- " + child.data + " -->");
+            break;
+        case Node.DOCUMENT_TYPE_NODE:
+            lines.push(indent(depth) + "<!DOCTYPE " + child.name + ">");
+            break;
+        }
+    }
+    return lines;
+}
+
+function parseInFrame(frame, data, charactersPerWrite)
+{
+    var doc = frame.contentDocument;
+    doc.open();
+    if (!charactersPerWrite)
+        doc.write(data);
+    else {
+        for (var i = 0; i < data.length; i += charactersPerWrite)
+            doc.write(data.substr(i, charactersPerWrite));
+    }
+    doc.close();
+    return serialize(doc, 0, []).join("\n");
+}
+
+function escapeForLog(string)
+{
+    return string.replace(/\r/g, "\\r").replace(/\0/g, "\\0");
+}
+
+function runTests(url)
+{
+    var request = new XMLHttpRequest();
+    request.open("GET", url, false);
+    request.overrideMimeType("text/plain; charset=utf-8");
+    request.send();
+    var tests = parseTests(request.responseText);
+
+    var frame = document.getElementById("frame");
+    var runs = [["in one write", 0], ["one character per write", 1], ["seven characters per write", 7]];
+    for (var i = 0; i < tests.length; ++i) {
+        var failed = false;
+        for (var j = 0; j < runs.length; ++j) {
+            var actual = parseInFrame(frame, tests[i].data, runs[j][1]);
+            if (actual == tests[i].document)
+                continue;
+            failed = true;
+            log("FAIL test " + (i + 1) + " " + runs[j][0] + ":\n" + escapeForLog(tests[i].data) + "\nExpected:\n" + tests[i].document + "\nActual:\n" + actual);
+        }
+        if (!failed)
+            log("PASS test " + (i + 1));
+    }
+}
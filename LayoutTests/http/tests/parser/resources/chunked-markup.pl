@@ -0,0 +1,36 @@
+#!/usr/bin/perl -w
+
+use strict;
+use Time::HiRes qw(sleep);
+
+# Each piece ends in the middle of a token, so that the network input
+# arrives with the tokenizer in as many different states as possible.
+my @pieces = (
+    "<!DOCTYPE html>\n<html>\n<body>\n<p id=\"spl",
+    "it\" title=\"a&am",
+    "p;b\">te",
+    "xt</p>\r",
+    "\n<textarea id=\"area\">\r",
+    "\nline one\r",
+    "\nline two</text",
+    "area>\n<!-",
+    "- comment -",
+    "->\n<scr",
+    "ipt>var scriptText = \"<\" + \"/p>\";</scr",
+    "ipt>\n<p id=\"after\">&lt",
+    ";done&gt;</p>\n</body>\n</html>\n",
+);
+
+# flush the buffers after each print
+select (STDOUT);
+$| = 1;
+
+print "Content-Type: text/html\n";
+print "Cache-Control: no-store, no-cache, must-revalidate\n";
+print "Pragma: no-cache\n";
+print "\n";
+
+foreach my $piece (@pieces) {
+    print $piece;
+    sleep 0.05;
+}
@@ -0,0 +1,42 @@
+// Loads a document into an iframe with the threaded HTML parser turned on, on the ports
+// whose DumpRenderTree supports the preference, and lets the test check what was built.
+
+if (window.layoutTestController) {
+    layoutTestController.dumpAsText();
+    layoutTestController.waitUntilDone();
+    layoutTestController.overridePreference("WebKitThreadedHTMLParserEnabled", "1");
+}
+
+function log(message)
+{
+    document.getElementById("console").appendChild(document.createTextNode(message + "\n"));
+}
+
+function shouldBe(description, actual, expected)
+{
+    if (actual === expected)
+        log("PASS " + description + " is " + JSON.stringify(expected));
+    else
+        log("FAIL " + description + " should be " + JSON.stringify(expected) + ". Was " + JSON.stringify(actual) + ".");
+}
+
+function elementList(doc)
+{
+    var result = [];
+    var elements = doc.body.getElementsByTagName("*");
+    for (var i = 0; i < elements.length; ++i)
+        result.push(elements[i].tagName.toLowerCase() + (elements[i].id ? "#" + elements[i].id : ""));
+    return result.join(" ");
+}
+
+function loadFrame(url, check)
+{
+    var frame = document.createElement("iframe");
+    frame.onload = function() {
+        check(frame.contentDocument);
+        if (window.layoutTestController)
+            layoutTestController.notifyDone();
+    };
+    frame.src = url;
+    document.body.appendChild(frame);
+}
@@ -0,0 +1,12 @@
+var pieces = [];
+for (var i = 0; i < 2000; ++i)
+    pieces.push("item" + i);
+var s = pieces.join(",");
+
+var count = 0;
+for (var j = 0; j < 100; ++j) {
+    count += s.split(/,/).length;
+    count += s.replace(/,/g, ";").length;
+    count += s.replace(/(\d+)/g, "<$1>").length;
+    count += s.split(/\s*,\s*/).length;
+}
@@ -0,0 +1,11 @@
+var pieces = [];
+for (var i = 0; i < 2000; ++i)
+    pieces.push("abcdefghij" + i);
+var s = pieces.join("");
+
+var sum = 0;
+for (var j = 0; j < 50000; ++j) {
+    var t = s + j;
+    for (var i = 0; i < 20; ++i)
+        sum += t.charCodeAt(i) + t.charAt(t.length - 1 - i).length;
+}
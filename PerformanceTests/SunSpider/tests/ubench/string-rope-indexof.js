@@ -0,0 +1,11 @@
+var pieces = [];
+for (var i = 0; i < 2000; ++i)
+    pieces.push("abcdefghij" + i);
+var s = pieces.join("");
+
+var found = 0;
+for (var j = 0; j < 20000; ++j) {
+    var t = "<" + j + ">" + s;
+    if (t.indexOf(">abc") != -1)
+        ++found;
+}
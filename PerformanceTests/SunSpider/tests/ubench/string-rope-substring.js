@@ -0,0 +1,10 @@
+var pieces = [];
+for (var i = 0; i < 2000; ++i)
+    pieces.push("abcdefghij" + i);
+var s = pieces.join("");
+
+var length = 0;
+for (var j = 0; j < 100000; ++j) {
+    var t = "prefix" + j + s;
+    length += t.substring(0, 6).length + t.slice(2, 5).length;
+}
@@ -93,6 +93,7 @@ SOURCES += \
     dfg/DFGNonSpeculativeJIT.cpp \
     dfg/DFGOperations.cpp \
     dfg/DFGSpeculativeJIT.cpp \
+    dfg/DFGWorklist.cpp \
     interpreter/CallFrame.cpp \
     interpreter/Interpreter.cpp \
     interpreter/RegisterFile.cpp \
@@ -119,6 +120,7 @@ SOURCES += \
     profiler/ProfileGenerator.cpp \
     profiler/ProfileNode.cpp \
     profiler/Profiler.cpp \
+    profiler/SamplingProfiler.cpp \
     runtime/ArgList.cpp \
     runtime/Arguments.cpp \
     runtime/ArrayConstructor.cpp \
@@ -45,7 +45,7 @@ class RepatchBuffer {
 public:
     RepatchBuffer(CodeBlock* codeBlock)
     {
-        JITCode& code = codeBlock->getJITCode();
+        JITCode& code = codeBlock->getBaselineJITCode();
         m_start = code.start();
         m_size = code.size();
 
@@ -31,6 +31,7 @@
 #include "CodeBlock.h"
 
 #include "BytecodeGenerator.h"
+#include "DFGWorklist.h"
 #include "Debugger.h"
 #include "Interpreter.h"
 #include "JIT.h"
@@ -38,6 +39,8 @@
 #include "JSFunction.h"
 #include "JSStaticScopeObject.h"
 #include "JSValue.h"
+#include "RepatchBuffer.h"
+#include "SamplingProfiler.h"
 #include "UStringConcatenate.h"
 #include <stdio.h>
 #include <wtf/StringExtras.h>
@@ -241,10 +244,10 @@ static void printStructureStubInfo(const StructureStubInfo& stubInfo, unsigned i
         printf("  [%4d] %s: %s, %s\n", instructionOffset, "get_by_id_chain", pointerToSourceString(stubInfo.u.getByIdChain.baseObjectStructure).utf8().data(), pointerToSourceString(stubInfo.u.getByIdChain.chain).utf8().data());
         return;
     case access_get_by_id_self_list:
-        printf("  [%4d] %s: %s (%d)\n", instructionOffset, "op_get_by_id_self_list", pointerToSourceString(stubInfo.u.getByIdSelfList.structureList).utf8().data(), stubInfo.u.getByIdSelfList.listSize);
+        printf("  [%4d] %s: %s (%d)%s\n", instructionOffset, "op_get_by_id_self_list", pointerToSourceString(stubInfo.u.getByIdSelfList.structureList).utf8().data(), stubInfo.u.getByIdSelfList.listSize, stubInfo.isMegamorphic() ? " megamorphic" : "");
         return;
     case access_get_by_id_proto_list:
-        printf("  [%4d] %s: %s (%d)\n", instructionOffset, "op_get_by_id_proto_list", pointerToSourceString(stubInfo.u.getByIdProtoList.structureList).utf8().data(), stubInfo.u.getByIdProtoList.listSize);
+        printf("  [%4d] %s: %s (%d)%s\n", instructionOffset, "op_get_by_id_proto_list", pointerToSourceString(stubInfo.u.getByIdProtoList.structureList).utf8().data(), stubInfo.u.getByIdProtoList.listSize, stubInfo.isMegamorphic() ? " megamorphic" : "");
         return;
     case access_put_by_id_transition:
         printf("  [%4d] %s: %s, %s, %s\n", instructionOffset, "put_by_id_transition", pointerToSourceString(stubInfo.u.putByIdTransition.previousStructure).utf8().data(), pointerToSourceString(stubInfo.u.putByIdTransition.structure).utf8().data(), pointerToSourceString(stubInfo.u.putByIdTransition.chain).utf8().data());
@@ -1379,6 +1382,13 @@ CodeBlock::CodeBlock(ScriptExecutable* ownerExecutable, CodeType codeType, JSGlo
     , m_codeType(codeType)
     , m_source(sourceProvider)
     , m_sourceOffset(sourceOffset)
+#if ENABLE(JIT)
+    , m_wasExecuted(0)
+#endif
+#if ENABLE(DFG_JIT)
+    , m_executeCounter(executeCounterThresholdForOptimization)
+    , m_speculationFailures(0)
+#endif
     , m_symbolTable(symTab)
 {
     ASSERT(m_source);
@@ -1386,13 +1396,37 @@ CodeBlock::CodeBlock(ScriptExecutable* ownerExecutable, CodeType codeType, JSGlo
 #if DUMP_CODE_BLOCK_STATISTICS
     liveCodeBlockSet.add(this);
 #endif
+
+#if ENABLE(SAMPLING_PROFILER)
+    if (SamplingProfiler* profiler = globalObject->globalData().samplingProfiler.get())
+        profiler->didCreateCodeBlock(this);
+#endif
 }
 
 CodeBlock::~CodeBlock()
 {
+#if ENABLE(SAMPLING_PROFILER)
+    if (SamplingProfiler* profiler = m_heap->globalData()->samplingProfiler.get())
+        profiler->willDestroyCodeBlock(this);
+#endif
+#if ENABLE(DFG_JIT)
+    if (DFG::Worklist* worklist = m_heap->globalData()->dfgWorklist.get())
+        worklist->cancel(this);
+#endif
+
 #if ENABLE(JIT)
     for (size_t size = m_structureStubInfos.size(), i = 0; i < size; ++i)
         m_structureStubInfos[i].deref();
+
+    // Calls linked to this code block would otherwise be left jumping into freed code.
+    unlinkIncomingCalls();
+
+    // Calls from this code block must be removed from their callees' incoming lists.
+    for (size_t size = m_callLinkInfos.size(), i = 0; i < size; ++i) {
+        CallLinkInfo& info = m_callLinkInfos[i];
+        if (info.calleeCodeBlock)
+            info.calleeCodeBlock->removeIncomingCall(&info);
+    }
 #endif // ENABLE(JIT)
 
 #if DUMP_CODE_BLOCK_STATISTICS
@@ -1400,6 +1434,85 @@ CodeBlock::~CodeBlock()
 #endif
 }
 
+#if ENABLE(JIT)
+void CallLinkInfo::unlink(JSGlobalData& globalData)
+{
+    ASSERT(isLinked());
+    ASSERT(ownerCodeBlock);
+
+    // The call site lives in the caller's code, so that is the code that must be made writable.
+    RepatchBuffer repatchBuffer(ownerCodeBlock);
+
+    // Make the callee check in the hot path fail, and send the slow path back through
+    // the linking trampoline.
+    repatchBuffer.repatch(hotPathBegin, 0);
+    repatchBuffer.relink(callReturnLocation, isCall ? globalData.jitStubs->ctiVirtualCallLink() : globalData.jitStubs->ctiVirtualConstructLink());
+    hasSeenShouldRepatch = false;
+    callee.clear();
+
+    if (calleeCodeBlock)
+        calleeCodeBlock->removeIncomingCall(this);
+}
+
+void CodeBlock::unlinkIncomingCalls()
+{
+    while (CallLinkInfo* incoming = m_incomingCalls.head())
+        incoming->unlink(*m_globalData);
+}
+#endif
+
+#if ENABLE(DFG_JIT)
+CodeLocationLabel CodeBlock::optimizedEntryForBytecodeOffset(unsigned bytecodeOffset)
+{
+    // Optimized code may only be entered at the head of a basic block.
+    size_t low = 0;
+    size_t high = m_optimizedEntryMap.size();
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        if (m_optimizedEntryMap[middle].bytecodeOffset < bytecodeOffset)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    if (low == m_optimizedEntryMap.size() || m_optimizedEntryMap[low].bytecodeOffset != bytecodeOffset)
+        return CodeLocationLabel();
+    return m_optimizedEntryMap[low].machineCode;
+}
+#endif
+
+#if ENABLE(SAMPLING_PROFILER)
+void CodeBlock::addMachineCodeMap(const Vector<MachineCodeToBytecodeOffset>& map)
+{
+    if (map.isEmpty())
+        return;
+
+    // Each run covers its own range of machine code, so keeping the runs in address
+    // order keeps the whole map sorted.
+    size_t position = 0;
+    while (position < m_machineCodeMap.size() && m_machineCodeMap[position].machineCode < map[0].machineCode)
+        ++position;
+    m_machineCodeMap.insert(position, map.data(), map.size());
+}
+
+bool CodeBlock::bytecodeOffsetForMachineCode(void* machineCode, unsigned& bytecodeOffset)
+{
+    // Find the last entry at or before machineCode.
+    size_t low = 0;
+    size_t high = m_machineCodeMap.size();
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        if (m_machineCodeMap[middle].machineCode <= machineCode)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    if (!low || m_machineCodeMap[low - 1].bytecodeOffset == MachineCodeToBytecodeOffset::noBytecodeOffset)
+        return false;
+    bytecodeOffset = m_machineCodeMap[low - 1].bytecodeOffset;
+    return true;
+}
+#endif
+
 void CodeBlock::markStructures(MarkStack& markStack, Instruction* vPC) const
 {
     Interpreter* interpreter = m_globalData->interpreter;
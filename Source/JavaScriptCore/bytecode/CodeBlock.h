@@ -38,6 +38,7 @@
 #include "Nodes.h"
 #include "RegExp.h"
 #include "UString.h"
+#include <wtf/DoublyLinkedList.h>
 #include <wtf/FastAllocBase.h>
 #include <wtf/PassOwnPtr.h>
 #include <wtf/RefPtr.h>
@@ -59,7 +60,9 @@ namespace JSC {
         hasSeenShouldRepatch
     };
 
+    class CodeBlock;
     class ExecState;
+    class RepatchBuffer;
 
     enum CodeType { GlobalCode, EvalCode, FunctionCode };
 
@@ -97,6 +100,11 @@ namespace JSC {
     struct CallLinkInfo {
         CallLinkInfo()
             : hasSeenShouldRepatch(false)
+            , isCall(false)
+            , ownerCodeBlock(0)
+            , calleeCodeBlock(0)
+            , m_prev(0)
+            , m_next(0)
         {
         }
 
@@ -105,10 +113,20 @@ namespace JSC {
         CodeLocationNearCall hotPathOther;
         WriteBarrier<JSFunction> callee;
         bool hasSeenShouldRepatch;
+        bool isCall;
+        // The code block whose JIT code contains this call site.
+        CodeBlock* ownerCodeBlock;
+        // The code block this call is linked to, if it was linked to JS code. The link
+        // is recorded in that code block's list of incoming calls.
+        CodeBlock* calleeCodeBlock;
         
         void setUnlinked() { callee.clear(); }
         bool isLinked() { return callee; }
 
+        // Restores the call site to its unlinked state, so the next call through it
+        // relinks to whatever code the callee has at that point.
+        void unlink(JSGlobalData&);
+
         bool seenOnce()
         {
             return hasSeenShouldRepatch;
@@ -118,6 +136,15 @@ namespace JSC {
         {
             hasSeenShouldRepatch = true;
         }
+
+        CallLinkInfo* prev() const { return m_prev; }
+        CallLinkInfo* next() const { return m_next; }
+        void setPrev(CallLinkInfo* prev) { m_prev = prev; }
+        void setNext(CallLinkInfo* next) { m_next = next; }
+
+    private:
+        CallLinkInfo* m_prev;
+        CallLinkInfo* m_next;
     };
 
     struct MethodCallLinkInfo {
@@ -197,6 +224,50 @@ namespace JSC {
     {
         return pc->callReturnOffset;
     }
+
+#if ENABLE(SAMPLING_PROFILER)
+    // This structure is used to map from the start of the machine code generated
+    // for a bytecode operation back to its bytecode index, so that the sampling
+    // profiler can attribute a sampled PC. An entry with noBytecodeOffset marks
+    // the end of a run of mapped code.
+    struct MachineCodeToBytecodeOffset {
+        static const unsigned noBytecodeOffset = UINT_MAX;
+
+        MachineCodeToBytecodeOffset(void* machineCode, unsigned bytecodeOffset)
+            : machineCode(machineCode)
+            , bytecodeOffset(bytecodeOffset)
+        {
+        }
+
+        void* machineCode;
+        unsigned bytecodeOffset;
+    };
+#endif
+
+#if ENABLE(DFG_JIT)
+    // This structure is used to map from a bytecode index to the machine code
+    // that executes it. Code optimized by the DFG JIT uses this to exit back in
+    // to the baseline JIT's code when a speculation fails, and the baseline JIT
+    // uses it to enter optimized code at the head of a hot loop.
+    struct BytecodeOffsetToMachineCode {
+        BytecodeOffsetToMachineCode(unsigned bytecodeOffset, int cachedResultRegister)
+            : bytecodeOffset(bytecodeOffset)
+            , cachedResultRegister(cachedResultRegister)
+        {
+        }
+
+        unsigned bytecodeOffset;
+        // The virtual register the baseline JIT expects to find cached in
+        // regT0 at this point, or std::numeric_limits<int>::max() if none.
+        int cachedResultRegister;
+        CodeLocationLabel machineCode;
+    };
+
+    inline unsigned getBytecodeOffsetForMachineCode(BytecodeOffsetToMachineCode* entry)
+    {
+        return entry->bytecodeOffset;
+    }
+#endif
 #endif
 
     class CodeBlock {
@@ -264,10 +335,18 @@ namespace JSC {
         {
             if (!m_rareData)
                 return 1;
-            Vector<CallReturnOffsetToBytecodeOffset>& callIndices = m_rareData->m_callReturnIndexVector;
-            if (!callIndices.size())
+            Vector<CallReturnOffsetToBytecodeOffset>* callIndices = &m_rareData->m_callReturnIndexVector;
+            JITCode* jitCode = &getJITCode();
+#if ENABLE(DFG_JIT)
+            // Once optimized, frames may still be executing the baseline JIT's code.
+            if (isInAlternativeJITCode(returnAddress)) {
+                callIndices = &m_alternativeCallReturnIndexVector;
+                jitCode = &m_alternativeJITCode;
+            }
+#endif
+            if (!callIndices->size())
                 return 1;
-            return binarySearch<CallReturnOffsetToBytecodeOffset, unsigned, getCallReturnOffset>(callIndices.begin(), callIndices.size(), getJITCode().offsetOf(returnAddress.value()))->bytecodeOffset;
+            return binarySearch<CallReturnOffsetToBytecodeOffset, unsigned, getCallReturnOffset>(callIndices->begin(), callIndices->size(), jitCode->offsetOf(returnAddress.value()))->bytecodeOffset;
         }
 #endif
 #if ENABLE(INTERPRETER)
@@ -291,6 +370,82 @@ namespace JSC {
 #if ENABLE(JIT)
         JITCode& getJITCode() { return m_isConstructor ? ownerExecutable()->generatedJITCodeForConstruct() : ownerExecutable()->generatedJITCodeForCall(); }
         ExecutablePool* executablePool() { return getJITCode().getExecutablePool(); }
+
+        // Function code sets this flag in its prologue, so clearing it and checking it again
+        // later tells whether the code ran in between.
+        uint32_t* addressOfWasExecuted() { return &m_wasExecuted; }
+        bool checkAndClearWasExecuted()
+        {
+            bool wasExecuted = m_wasExecuted;
+            m_wasExecuted = 0;
+            return wasExecuted;
+        }
+#endif
+
+#if ENABLE(DFG_JIT)
+        // Function code compiled by the baseline JIT counts down m_executeCounter on entry
+        // and at the head of every loop, and asks to be optimized by the DFG JIT when it
+        // reaches zero.
+        static const int32_t executeCounterThresholdForOptimization = 1000;
+        // Optimized code counts its failed speculations, once there are this many it
+        // stops running and all calls are diverted back to the baseline JIT's code.
+        static const uint32_t speculationFailureThresholdForBaseline = 100;
+
+        int32_t* addressOfExecuteCounter() { return &m_executeCounter; }
+        void optimizeAfterWarmUp() { m_executeCounter = executeCounterThresholdForOptimization; }
+        void dontOptimizeAnytimeSoon() { m_executeCounter = std::numeric_limits<int32_t>::max(); }
+        // Makes the next count down ask to be optimized, once the DFG JIT has generated code
+        // for this CodeBlock on another thread.
+        void optimizeSoon() { m_executeCounter = 1; }
+
+        uint32_t* addressOfSpeculationFailures() { return &m_speculationFailures; }
+        bool hasTooManySpeculationFailures() const { return m_speculationFailures >= speculationFailureThresholdForBaseline; }
+
+        // When the DFG JIT replaces the executable's code, the baseline JIT's code is kept
+        // here so that optimized code can exit in to it.
+        bool hasOptimizedJITCode() const { return !!m_alternativeJITCode; }
+        void setAlternativeJITCode(const JITCode& jitCode, MacroAssemblerCodePtr jitCodeWithArityCheck)
+        {
+            m_alternativeJITCode = jitCode;
+            m_alternativeJITCodeWithArityCheck = jitCodeWithArityCheck;
+            if (m_rareData)
+                m_alternativeCallReturnIndexVector.swap(m_rareData->m_callReturnIndexVector);
+        }
+        JITCode& getBaselineJITCode() { return hasOptimizedJITCode() ? m_alternativeJITCode : getJITCode(); }
+        MacroAssemblerCodePtr baselineJITCodeWithArityCheck()
+        {
+            ASSERT(hasOptimizedJITCode());
+            return m_alternativeJITCodeWithArityCheck;
+        }
+        bool isInAlternativeJITCode(ReturnAddressPtr returnAddress)
+        {
+            if (!hasOptimizedJITCode())
+                return false;
+            char* start = static_cast<char*>(m_alternativeJITCode.start());
+            char* address = static_cast<char*>(returnAddress.value());
+            return address > start && address <= start + m_alternativeJITCode.size();
+        }
+
+        // Exit locations in the baseline JIT's code, present while the code may yet be optimized.
+        bool canBeOptimized() const { return !m_baselineCodeMap.isEmpty(); }
+        Vector<BytecodeOffsetToMachineCode>& baselineCodeMap() { return m_baselineCodeMap; }
+        BytecodeOffsetToMachineCode& baselineCodeForBytecodeOffset(unsigned bytecodeOffset)
+        {
+            return *binarySearch<BytecodeOffsetToMachineCode, unsigned, getBytecodeOffsetForMachineCode>(m_baselineCodeMap.begin(), m_baselineCodeMap.size(), bytecodeOffset);
+        }
+
+        // Entry locations in the DFG JIT's code, at the head of each basic block.
+        Vector<BytecodeOffsetToMachineCode>& optimizedEntryMap() { return m_optimizedEntryMap; }
+        CodeLocationLabel optimizedEntryForBytecodeOffset(unsigned bytecodeOffset);
+#elif ENABLE(JIT)
+        bool canBeOptimized() const { return false; }
+        JITCode& getBaselineJITCode() { return getJITCode(); }
+#endif
+
+#if ENABLE(SAMPLING_PROFILER)
+        // Only code compiled while a SamplingProfiler is running is mapped.
+        void addMachineCodeMap(const Vector<MachineCodeToBytecodeOffset>&);
+        bool bytecodeOffsetForMachineCode(void* machineCode, unsigned& bytecodeOffset);
 #endif
 
         ScriptExecutable* ownerExecutable() const { return m_ownerExecutable.get(); }
@@ -348,6 +503,11 @@ namespace JSC {
         size_t numberOfStructureStubInfos() const { return m_structureStubInfos.size(); }
         void addStructureStubInfo(const StructureStubInfo& stubInfo) { m_structureStubInfos.append(stubInfo); }
         StructureStubInfo& structureStubInfo(int index) { return m_structureStubInfos[index]; }
+        void addGetByIdCacheStatistics(GetByIdCacheStatistics& statistics) const
+        {
+            for (size_t i = 0; i < m_structureStubInfos.size(); ++i)
+                statistics.add(m_structureStubInfos[i]);
+        }
 
         void addGlobalResolveInfo(unsigned globalResolveInstruction) { m_globalResolveInfos.append(GlobalResolveInfo(globalResolveInstruction)); }
         GlobalResolveInfo& globalResolveInfo(int index) { return m_globalResolveInfos[index]; }
@@ -357,6 +517,21 @@ namespace JSC {
         void addCallLinkInfo() { m_callLinkInfos.append(CallLinkInfo()); }
         CallLinkInfo& callLinkInfo(int index) { return m_callLinkInfos[index]; }
 
+        // Calls from JIT code elsewhere that have been linked directly to this code block's
+        // code. They must be unlinked before that code goes away or is replaced.
+        void linkIncomingCall(CallLinkInfo* incoming)
+        {
+            incoming->calleeCodeBlock = this;
+            m_incomingCalls.append(incoming);
+        }
+        void removeIncomingCall(CallLinkInfo* incoming)
+        {
+            ASSERT(incoming->calleeCodeBlock == this);
+            m_incomingCalls.remove(incoming);
+            incoming->calleeCodeBlock = 0;
+        }
+        void unlinkIncomingCalls();
+
         void addMethodCallLinkInfos(unsigned n) { m_methodCallLinkInfos.grow(n); }
         MethodCallLinkInfo& methodCallLinkInfo(int index) { return m_methodCallLinkInfos[index]; }
 #endif
@@ -511,6 +686,22 @@ namespace JSC {
         RefPtr<SourceProvider> m_source;
         unsigned m_sourceOffset;
 
+#if ENABLE(JIT)
+        uint32_t m_wasExecuted;
+#endif
+#if ENABLE(DFG_JIT)
+        int32_t m_executeCounter;
+        uint32_t m_speculationFailures;
+        JITCode m_alternativeJITCode;
+        MacroAssemblerCodePtr m_alternativeJITCodeWithArityCheck;
+        Vector<CallReturnOffsetToBytecodeOffset> m_alternativeCallReturnIndexVector;
+        Vector<BytecodeOffsetToMachineCode> m_baselineCodeMap;
+        Vector<BytecodeOffsetToMachineCode> m_optimizedEntryMap;
+#endif
+#if ENABLE(SAMPLING_PROFILER)
+        Vector<MachineCodeToBytecodeOffset> m_machineCodeMap;
+#endif
+
 #if ENABLE(INTERPRETER)
         Vector<unsigned> m_propertyAccessInstructions;
         Vector<unsigned> m_globalResolveInstructions;
@@ -520,6 +711,7 @@ namespace JSC {
         Vector<GlobalResolveInfo> m_globalResolveInfos;
         Vector<CallLinkInfo> m_callLinkInfos;
         Vector<MethodCallLinkInfo> m_methodCallLinkInfos;
+        DoublyLinkedList<CallLinkInfo> m_incomingCalls;
 #endif
 
         Vector<unsigned> m_jumpTargets;
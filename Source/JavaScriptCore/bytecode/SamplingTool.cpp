@@ -31,6 +31,7 @@
 
 #include "CodeBlock.h"
 #include "Interpreter.h"
+#include "JITStubs.h"
 #include "Opcode.h"
 
 #if !OS(WINDOWS)
@@ -312,6 +313,11 @@ void SamplingTool::dump(ExecState* exec)
     printf("\t--------------\n");
     printf("\tcti count:\tsamples inside a CTI function called by this opcode\n");
     printf("\tcti %% of self:\tcti count / sample count\n");
+
+#if ENABLE(JIT)
+    MegamorphicGetByIdCache& megamorphicCache = exec->globalData().jitStubs->megamorphicGetByIdCache();
+    printf("\n\tMegamorphic get_by_id cache:\t%u hits, %u misses\n", megamorphicCache.hits(), megamorphicCache.misses());
+#endif
     
 #if ENABLE(CODEBLOCK_SAMPLING)
 
@@ -342,6 +348,12 @@ void SamplingTool::dump(ExecState* exec)
                 HashMap<unsigned,unsigned> lineCounts;
                 codeBlock->dump(exec);
 
+#if ENABLE(JIT)
+                GetByIdCacheStatistics getByIdStatistics;
+                codeBlock->addGetByIdCacheStatistics(getByIdStatistics);
+                printf("    get_by_id sites: %u uncached, %u monomorphic, %u polymorphic, %u megamorphic\n\n", getByIdStatistics.uncached, getByIdStatistics.monomorphic, getByIdStatistics.polymorphic, getByIdStatistics.megamorphic);
+#endif
+
                 printf("    Opcode and line number samples [*]\n\n");
                 for (unsigned op = 0; op < record->m_size; ++op) {
                     int count = record->m_samples[op];
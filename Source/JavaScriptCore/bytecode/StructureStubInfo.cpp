@@ -107,6 +107,35 @@ void StructureStubInfo::markAggregate(MarkStack& markStack)
         ASSERT_NOT_REACHED();
     }
 }
+
+void GetByIdCacheStatistics::add(const StructureStubInfo& stubInfo)
+{
+    switch (stubInfo.accessType) {
+    case access_get_by_id:
+        ++uncached;
+        return;
+    case access_get_by_id_self:
+    case access_get_by_id_proto:
+    case access_get_by_id_chain:
+    case access_get_array_length:
+    case access_get_string_length:
+        ++monomorphic;
+        return;
+    case access_get_by_id_self_list:
+    case access_get_by_id_proto_list:
+        if (stubInfo.isMegamorphic())
+            ++megamorphic;
+        else
+            ++polymorphic;
+        return;
+    case access_get_by_id_generic:
+        ++megamorphic;
+        return;
+    default:
+        // Not a get_by_id site.
+        return;
+    }
+}
 #endif
 
 } // namespace JSC
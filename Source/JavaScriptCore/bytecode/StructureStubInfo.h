@@ -55,6 +55,7 @@ namespace JSC {
         StructureStubInfo(AccessType accessType)
             : accessType(accessType)
             , seen(false)
+            , megamorphic(false)
         {
         }
 
@@ -128,8 +129,21 @@ namespace JSC {
             seen = true;
         }
 
-        int accessType : 31;
+        // Set once a get_by_id site has filled its polymorphic list and been sent to the
+        // shared megamorphic cache.
+        bool isMegamorphic() const
+        {
+            return megamorphic;
+        }
+
+        void setMegamorphic()
+        {
+            megamorphic = true;
+        }
+
+        int accessType : 30;
         int seen : 1;
+        int megamorphic : 1;
 
         union {
             struct {
@@ -166,6 +180,23 @@ namespace JSC {
         CodeLocationLabel hotPathBegin;
     };
 
+    struct GetByIdCacheStatistics {
+        GetByIdCacheStatistics()
+            : uncached(0)
+            , monomorphic(0)
+            , polymorphic(0)
+            , megamorphic(0)
+        {
+        }
+
+        void add(const StructureStubInfo&);
+
+        unsigned uncached;
+        unsigned monomorphic;
+        unsigned polymorphic;
+        unsigned megamorphic;
+    };
+
 } // namespace JSC
 
 #endif
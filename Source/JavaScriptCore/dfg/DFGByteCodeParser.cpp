@@ -34,13 +34,6 @@
 
 namespace JSC { namespace DFG {
 
-#if ENABLE(DFG_JIT_RESTRICTIONS)
-// FIXME: Temporarily disable arithmetic, until we fix associated performance regressions.
-#define ARITHMETIC_OP() m_parseFailed = true
-#else
-#define ARITHMETIC_OP() ((void)0)
-#endif
-
 // === ByteCodeParser ===
 //
 // This class is used to compile the dataflow graph from a CodeBlock.
@@ -59,6 +52,7 @@ public:
         , m_arguments(codeBlock->m_numParameters)
         , m_variables(codeBlock->m_numVars)
         , m_temporaries(codeBlock->m_numCalleeRegisters - codeBlock->m_numVars)
+        , m_temporaryLiveRanges(m_temporaries.size())
     {
         for (unsigned i = 0; i < m_temporaries.size(); ++i)
             m_temporaries[i] = NoNode;
@@ -133,18 +127,19 @@ private:
     }
     void setVariable(unsigned operand, NodeIndex value)
     {
-        NodeIndex priorSet = m_variables[operand].set;
+        // Every store is kept, even if a later one in the block overwrites it, so that
+        // locals in the register file are up to date wherever optimized code exits.
         m_variables[operand].set = addToGraph(SetLocal, OpInfo(operand), value);
-        if (priorSet != NoNode)
-            m_graph.deref(priorSet);
     }
 
     // Used in implementing get/set, above, where the operand is a temporary.
     NodeIndex getTemporary(unsigned operand)
     {
         NodeIndex index = m_temporaries[operand];
-        if (index != NoNode)
+        if (index != NoNode) {
+            m_graph.m_temporaryLiveRanges[m_temporaryLiveRanges[operand]].lastUse = m_currentIndex;
             return index;
+        }
         
         // Detect a read of an temporary that is not a yet defined within this block (e.g. use of ?:).
         m_parseFailed = true;
@@ -153,6 +148,8 @@ private:
     void setTemporary(unsigned operand, NodeIndex value)
     {
         m_temporaries[operand] = value;
+        m_temporaryLiveRanges[operand] = m_graph.m_temporaryLiveRanges.size();
+        m_graph.m_temporaryLiveRanges.append(TemporaryLiveRange(operand + m_variables.size(), value, m_currentIndex));
     }
 
     // Used in implementing get/set, above, where the operand is an argument.
@@ -178,10 +175,7 @@ private:
         unsigned argument = operand + m_codeBlock->m_numParameters + RegisterFile::CallFrameHeaderSize;
         ASSERT(argument < m_arguments.size());
 
-        NodeIndex priorSet = m_arguments[argument].set;
         m_arguments[argument].set = addToGraph(SetLocal, OpInfo(operand), value);
-        if (priorSet != NoNode)
-            m_graph.deref(priorSet);
     }
 
     // Get an operand, and perform a ToInt32/ToNumber conversion on it.
@@ -511,6 +505,11 @@ private:
     Vector <VariableRecord, 32> m_arguments;
     Vector <VariableRecord, 32> m_variables;
     Vector <NodeIndex, 32> m_temporaries;
+    // For every temporary, the index in the Graph's m_temporaryLiveRanges of its current value.
+    Vector <unsigned, 32> m_temporaryLiveRanges;
+
+    // The bytecode offsets of the heads of loops, targets of the op_loop* family of jumps.
+    Vector<unsigned, 16> m_loopHeaders;
 
     // These maps are used to unique ToNumber and ToInt32 operations.
     typedef HashMap<NodeIndex, NodeIndex> UnaryOpMap;
@@ -682,7 +681,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         // === Arithmetic operations ===
 
         case op_add: {
-            ARITHMETIC_OP();
             NodeIndex op1 = get(currentInstruction[2].u.operand);
             NodeIndex op2 = get(currentInstruction[3].u.operand);
             // If both operands can statically be determined to the numbers, then this is an arithmetic add.
@@ -695,7 +693,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_sub: {
-            ARITHMETIC_OP();
             NodeIndex op1 = getToNumber(currentInstruction[2].u.operand);
             NodeIndex op2 = getToNumber(currentInstruction[3].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(ArithSub, op1, op2));
@@ -703,7 +700,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_mul: {
-            ARITHMETIC_OP();
             NodeIndex op1 = getToNumber(currentInstruction[2].u.operand);
             NodeIndex op2 = getToNumber(currentInstruction[3].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(ArithMul, op1, op2));
@@ -711,7 +707,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_mod: {
-            ARITHMETIC_OP();
             NodeIndex op1 = getToNumber(currentInstruction[2].u.operand);
             NodeIndex op2 = getToNumber(currentInstruction[3].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(ArithMod, op1, op2));
@@ -719,7 +714,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_div: {
-            ARITHMETIC_OP();
             NodeIndex op1 = getToNumber(currentInstruction[2].u.operand);
             NodeIndex op2 = getToNumber(currentInstruction[3].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(ArithDiv, op1, op2));
@@ -735,14 +729,12 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_not: {
-            ARITHMETIC_OP();
             NodeIndex value = get(currentInstruction[2].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(LogicalNot, value));
             NEXT_OPCODE(op_not);
         }
 
         case op_less: {
-            ARITHMETIC_OP();
             NodeIndex op1 = get(currentInstruction[2].u.operand);
             NodeIndex op2 = get(currentInstruction[3].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(CompareLess, op1, op2));
@@ -750,7 +742,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_lesseq: {
-            ARITHMETIC_OP();
             NodeIndex op1 = get(currentInstruction[2].u.operand);
             NodeIndex op2 = get(currentInstruction[3].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(CompareLessEq, op1, op2));
@@ -758,7 +749,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_eq: {
-            ARITHMETIC_OP();
             NodeIndex op1 = get(currentInstruction[2].u.operand);
             NodeIndex op2 = get(currentInstruction[3].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(CompareEq, op1, op2));
@@ -766,14 +756,12 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_eq_null: {
-            ARITHMETIC_OP();
             NodeIndex value = get(currentInstruction[2].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(CompareEq, value, constantNull()));
             NEXT_OPCODE(op_eq_null);
         }
 
         case op_stricteq: {
-            ARITHMETIC_OP();
             NodeIndex op1 = get(currentInstruction[2].u.operand);
             NodeIndex op2 = get(currentInstruction[3].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(CompareStrictEq, op1, op2));
@@ -781,7 +769,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_neq: {
-            ARITHMETIC_OP();
             NodeIndex op1 = get(currentInstruction[2].u.operand);
             NodeIndex op2 = get(currentInstruction[3].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(LogicalNot, addToGraph(CompareEq, op1, op2)));
@@ -789,14 +776,12 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_neq_null: {
-            ARITHMETIC_OP();
             NodeIndex value = get(currentInstruction[2].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(LogicalNot, addToGraph(CompareEq, value, constantNull())));
             NEXT_OPCODE(op_neq_null);
         }
 
         case op_nstricteq: {
-            ARITHMETIC_OP();
             NodeIndex op1 = get(currentInstruction[2].u.operand);
             NodeIndex op2 = get(currentInstruction[3].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(LogicalNot, addToGraph(CompareStrictEq, op1, op2)));
@@ -878,6 +863,7 @@ bool ByteCodeParser::parseBlock(unsigned limit)
 
         case op_loop: {
             unsigned relativeOffset = currentInstruction[1].u.operand;
+            m_loopHeaders.append(m_currentIndex + relativeOffset);
             addToGraph(Jump, OpInfo(m_currentIndex + relativeOffset));
             LAST_OPCODE(op_loop);
         }
@@ -898,6 +884,7 @@ bool ByteCodeParser::parseBlock(unsigned limit)
 
         case op_loop_if_true: {
             unsigned relativeOffset = currentInstruction[2].u.operand;
+            m_loopHeaders.append(m_currentIndex + relativeOffset);
             NodeIndex condition = get(currentInstruction[1].u.operand);
             addToGraph(Branch, OpInfo(m_currentIndex + relativeOffset), OpInfo(m_currentIndex + OPCODE_LENGTH(op_loop_if_true)), condition);
             LAST_OPCODE(op_loop_if_true);
@@ -905,6 +892,7 @@ bool ByteCodeParser::parseBlock(unsigned limit)
 
         case op_loop_if_false: {
             unsigned relativeOffset = currentInstruction[2].u.operand;
+            m_loopHeaders.append(m_currentIndex + relativeOffset);
             NodeIndex condition = get(currentInstruction[1].u.operand);
             addToGraph(Branch, OpInfo(m_currentIndex + OPCODE_LENGTH(op_loop_if_false)), OpInfo(m_currentIndex + relativeOffset), condition);
             LAST_OPCODE(op_loop_if_false);
@@ -964,6 +952,7 @@ bool ByteCodeParser::parseBlock(unsigned limit)
 
         case op_loop_if_less: {
             unsigned relativeOffset = currentInstruction[3].u.operand;
+            m_loopHeaders.append(m_currentIndex + relativeOffset);
             NodeIndex op1 = get(currentInstruction[1].u.operand);
             NodeIndex op2 = get(currentInstruction[2].u.operand);
             NodeIndex condition = addToGraph(CompareLess, op1, op2);
@@ -973,6 +962,7 @@ bool ByteCodeParser::parseBlock(unsigned limit)
 
         case op_loop_if_lesseq: {
             unsigned relativeOffset = currentInstruction[3].u.operand;
+            m_loopHeaders.append(m_currentIndex + relativeOffset);
             NodeIndex op1 = get(currentInstruction[1].u.operand);
             NodeIndex op2 = get(currentInstruction[2].u.operand);
             NodeIndex condition = addToGraph(CompareLessEq, op1, op2);
@@ -982,15 +972,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
 
         case op_ret: {
             addToGraph(Return, get(currentInstruction[1].u.operand));
-
-            // FIXME: throw away terminal definitions of variables;
-            // should not be necessary once we have proper DCE!
-            for (unsigned i = 0; i < m_variables.size(); ++i) {
-                NodeIndex priorSet = m_variables[i].set;
-                if (priorSet != NoNode)
-                    m_graph.deref(priorSet);
-            }
-
             LAST_OPCODE(op_ret);
         }
 
@@ -1015,6 +996,7 @@ bool ByteCodeParser::parse()
         do {
             unsigned bytecodeBegin = m_currentIndex;
             NodeIndex begin = m_graph.size();
+            unsigned temporaryLiveRangesBegin = m_graph.m_temporaryLiveRanges.size();
 
             if (!parseBlock(limit))
                 return false;
@@ -1023,12 +1005,17 @@ bool ByteCodeParser::parse()
 
             NodeIndex end = m_graph.size();
             m_graph.m_blocks.append(BasicBlock(bytecodeBegin, begin, end));
+            m_graph.m_blocks.last().temporaryLiveRangesBegin = temporaryLiveRangesBegin;
+            m_graph.m_blocks.last().temporaryLiveRangesEnd = m_graph.m_temporaryLiveRanges.size();
         } while (m_currentIndex < limit);
     }
 
     // Should have reached the end of the instructions.
     ASSERT(m_currentIndex == m_codeBlock->instructions().size());
 
+    for (unsigned i = 0; i < m_loopHeaders.size(); ++i)
+        m_graph.m_blocks[m_graph.blockIndexForBytecodeOffset(m_loopHeaders[i])].isLoopHeader = true;
+
     // Assign VirtualRegisters.
     ScoreBoard scoreBoard(m_graph, m_variables.size());
     Node* nodes = m_graph.begin();
@@ -1065,6 +1052,73 @@ bool ByteCodeParser::parse()
     return true;
 }
 
+bool canCompileOpcodes(JSGlobalData* globalData, CodeBlock* codeBlock)
+{
+    Interpreter* interpreter = globalData->interpreter;
+    Instruction* instructionsBegin = codeBlock->instructions().begin();
+    unsigned instructionCount = codeBlock->instructions().size();
+
+    for (unsigned bytecodeOffset = 0; bytecodeOffset < instructionCount; ) {
+        OpcodeID opcodeID = interpreter->getOpcodeID(instructionsBegin[bytecodeOffset].u.opcode);
+        switch (opcodeID) {
+        // These must match the opcodes handled by ByteCodeParser::parseBlock().
+        case op_enter:
+        case op_convert_this:
+        case op_bitand:
+        case op_bitor:
+        case op_bitxor:
+        case op_rshift:
+        case op_lshift:
+        case op_urshift:
+        case op_pre_inc:
+        case op_post_inc:
+        case op_pre_dec:
+        case op_post_dec:
+        case op_add:
+        case op_sub:
+        case op_mul:
+        case op_mod:
+        case op_div:
+        case op_mov:
+        case op_not:
+        case op_less:
+        case op_lesseq:
+        case op_eq:
+        case op_eq_null:
+        case op_stricteq:
+        case op_neq:
+        case op_neq_null:
+        case op_nstricteq:
+        case op_get_by_val:
+        case op_put_by_val:
+        case op_get_by_id:
+        case op_put_by_id:
+        case op_get_global_var:
+        case op_put_global_var:
+        case op_jmp:
+        case op_loop:
+        case op_jtrue:
+        case op_jfalse:
+        case op_loop_if_true:
+        case op_loop_if_false:
+        case op_jeq_null:
+        case op_jneq_null:
+        case op_jnless:
+        case op_jnlesseq:
+        case op_jless:
+        case op_jlesseq:
+        case op_loop_if_less:
+        case op_loop_if_lesseq:
+        case op_ret:
+            break;
+        default:
+            return false;
+        }
+        bytecodeOffset += opcodeLengths[opcodeID];
+    }
+    return true;
+}
+
 bool parse(Graph& graph, JSGlobalData* globalData, CodeBlock* codeBlock)
 {
 #if DFG_DEBUG_LOCAL_DISBALE
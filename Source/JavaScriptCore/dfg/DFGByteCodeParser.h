@@ -41,6 +41,10 @@ namespace DFG {
 // starting at the provided bytecode index.
 bool parse(Graph&, JSGlobalData*, CodeBlock*);
 
+// Check that every opcode in the CodeBlock is one the parser can handle.
+// This is a quick test, parsing may still fail.
+bool canCompileOpcodes(JSGlobalData*, CodeBlock*);
+
 } } // namespace JSC::DFG
 
 #endif
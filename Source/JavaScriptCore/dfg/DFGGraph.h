@@ -45,6 +45,9 @@ struct BasicBlock {
         : bytecodeBegin(bytecodeBegin)
         , begin(begin)
         , end(end)
+        , temporaryLiveRangesBegin(0)
+        , temporaryLiveRangesEnd(0)
+        , isLoopHeader(false)
     {
     }
 
@@ -56,6 +59,38 @@ struct BasicBlock {
     unsigned bytecodeBegin;
     NodeIndex begin;
     NodeIndex end;
+    // The range of the Graph's m_temporaryLiveRanges defined within this block.
+    unsigned temporaryLiveRangesBegin;
+    unsigned temporaryLiveRangesEnd;
+    // Set if this block is the target of a loop's backwards jump.
+    bool isLoopHeader;
+};
+
+// === TemporaryLiveRange ===
+//
+// Records the node holding the value of a bytecode temporary register, and the
+// bytecode over which that value is live - from the instruction that defines it,
+// up to and including the last instruction to read it. Used to reconstruct the
+// baseline JIT's view of the register file when exiting from optimized code.
+struct TemporaryLiveRange {
+    TemporaryLiveRange(int operand, NodeIndex nodeIndex, unsigned definition)
+        : operand(operand)
+        , nodeIndex(nodeIndex)
+        , definition(definition)
+        , lastUse(definition)
+    {
+    }
+
+    // Is the value required by the baseline JIT, if it starts executing at bytecodeIndex?
+    bool isLiveAt(unsigned bytecodeIndex) const
+    {
+        return definition < bytecodeIndex && bytecodeIndex <= lastUse;
+    }
+
+    int operand;
+    NodeIndex nodeIndex;
+    unsigned definition;
+    unsigned lastUse;
 };
 
 // 
@@ -90,6 +125,7 @@ public:
 #endif
 
     Vector<BasicBlock> m_blocks;
+    Vector<TemporaryLiveRange> m_temporaryLiveRanges;
 
     BlockIndex blockIndexForBytecodeOffset(unsigned bytecodeBegin)
     {
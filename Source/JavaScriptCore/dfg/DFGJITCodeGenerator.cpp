@@ -201,6 +201,13 @@ FPRReg JITCodeGenerator::fillDouble(NodeIndex nodeIndex)
 
         m_jit.convertInt32ToDouble(reg, fpReg);
 
+        // The speculative path relies on integer values remaining available
+        // in integer format, so return the converted value in a temporary.
+        if (m_isSpeculative) {
+            m_gprs.unlock(gpr);
+            return fpr;
+        }
+
         m_gprs.release(gpr);
         m_gprs.unlock(gpr);
         m_fprs.retain(fpr, virtualRegister, SpillOrderDouble);
@@ -334,6 +341,18 @@ void JITCodeGenerator::useChildren(Node& node)
     use(child3);
 }
 
+void JITCodeGenerator::emitTimeoutCheck(BasicBlock& block)
+{
+    ASSERT(isFlushed());
+
+    // This matches the old JIT, timeoutCheckRegister counts down to the next check.
+    MacroAssembler::Jump skipCheck = m_jit.branchSub32(MacroAssembler::NonZero, MacroAssembler::TrustedImm32(1), JITCompiler::timeoutCheckRegister);
+    m_jit.move(JITCompiler::callFrameRegister, JITCompiler::argumentRegister0);
+    m_jit.appendCallWithExceptionCheck(operationTimeoutCheck, block.bytecodeBegin);
+    m_jit.move(JITCompiler::returnValueRegister, JITCompiler::timeoutCheckRegister);
+    skipCheck.link(&m_jit);
+}
+
 #ifndef NDEBUG
 static const char* dataFormatString(DataFormat format)
 {
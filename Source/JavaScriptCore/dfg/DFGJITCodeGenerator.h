@@ -145,6 +145,12 @@ public:
         return info.registerFormat() == DataFormatDouble;
     }
 
+    // The code generated for each basic block, used to enter from the baseline JIT.
+    MacroAssembler::Label blockHead(BlockIndex block)
+    {
+        return m_blockHeads[block];
+    }
+
 protected:
     JITCodeGenerator(JITCompiler& jit, bool isSpeculative)
         : m_jit(jit)
@@ -671,6 +677,9 @@ protected:
         m_jit.appendCallWithExceptionCheck(function, m_jit.graph()[m_compileIndex].exceptionInfo);
     }
 
+    // Called at the head of each loop, where no values are held in machine registers.
+    void emitTimeoutCheck(BasicBlock&);
+
     void addBranch(const MacroAssembler::Jump& jump, BlockIndex destination)
     {
         m_branches.append(BranchRecord(jump, destination));
@@ -103,10 +103,8 @@ void JITCompiler::fillToJS(NodeIndex nodeIndex, GPRReg gpr)
     loadPtr(addressFor(node.virtualRegister), gprToRegisterID(gpr));
 }
 
-void JITCompiler::jumpFromSpeculativeToNonSpeculative(const SpeculationCheck& check, const EntryLocation& entry, SpeculationRecovery* recovery)
+void JITCompiler::linkSpeculationCheck(const SpeculationCheck& check, SpeculationRecovery* recovery)
 {
-    ASSERT(check.m_nodeIndex == entry.m_nodeIndex);
-
     // Link the jump from the Speculative path to here.
     check.m_check.link(this);
 
@@ -154,6 +152,14 @@ void JITCompiler::jumpFromSpeculativeToNonSpeculative(const SpeculationCheck& ch
         subPtr(tagTypeNumberRegister, regT0);
         storePtr(regT0, addressFor(virtualRegister));
     }
+}
+
+void JITCompiler::jumpFromSpeculativeToNonSpeculative(const SpeculationCheck& check, const EntryLocation& entry, SpeculationRecovery* recovery)
+{
+    ASSERT(check.m_nodeIndex == entry.m_nodeIndex);
+
+    // Link the check, performing any recovery, and spill all values held in registers.
+    linkSpeculationCheck(check, recovery);
 
     // Fill all FPRs in use by the non-speculative path.
     for (FPRReg fpr = fpr0; fpr < numberOfFPRs; next(fpr)) {
@@ -184,6 +190,65 @@ void JITCompiler::jumpFromSpeculativeToNonSpeculative(const SpeculationCheck& ch
     jump(entry.m_entry);
 }
 
+void JITCompiler::exitSpeculativeToBaseline(const OSRExit& exit, SpeculationRecovery* recovery)
+{
+    // Link the check, performing any recovery, and spill all values held in registers.
+    linkSpeculationCheck(exit.m_check, recovery);
+
+    // Store the values of live temporaries to the registers the baseline JIT's code
+    // expects to find them in. The temporaries share the RegisterFile with the DFG JIT's
+    // VirtualRegisters, so if storing a value may overwrite another not yet loaded, pass
+    // all values through the machine stack.
+    size_t operandCount = exit.m_operands.size();
+    bool mayOverwrite = false;
+    for (size_t i = 0; i < operandCount && !mayOverwrite; ++i) {
+        for (size_t j = 0; j < operandCount; ++j) {
+            Node& node = graph()[exit.m_operands[j].nodeIndex];
+            if (i != j && !node.isConstant() && node.virtualRegister == exit.m_operands[i].operand) {
+                mayOverwrite = true;
+                break;
+            }
+        }
+    }
+
+    if (mayOverwrite) {
+        for (size_t i = 0; i < operandCount; ++i) {
+            fillToJS(exit.m_operands[i].nodeIndex, gpr0);
+            push(regT0);
+        }
+        for (size_t i = operandCount; i--;) {
+            pop(regT0);
+            storePtr(regT0, addressFor(static_cast<VirtualRegister>(exit.m_operands[i].operand)));
+        }
+    } else {
+        for (size_t i = 0; i < operandCount; ++i) {
+            Node& node = graph()[exit.m_operands[i].nodeIndex];
+            if (!node.isConstant() && node.virtualRegister == exit.m_operands[i].operand)
+                continue;
+            fillToJS(exit.m_operands[i].nodeIndex, gpr0);
+            storePtr(regT0, addressFor(static_cast<VirtualRegister>(exit.m_operands[i].operand)));
+        }
+    }
+
+    // The baseline JIT's code may expect the result of the previous instruction to be cached in regT0.
+    BytecodeOffsetToMachineCode& baselineCode = m_codeBlock->baselineCodeForBytecodeOffset(exit.m_bytecodeIndex);
+    if (baselineCode.cachedResultRegister != std::numeric_limits<int>::max())
+        loadPtr(addressFor(static_cast<VirtualRegister>(baselineCode.cachedResultRegister)), regT0);
+
+    // Count the failure; once there are too many, calls will no longer enter the optimized code.
+    add32(TrustedImm32(1), AbsoluteAddress(m_codeBlock->addressOfSpeculationFailures()));
+
+    move(TrustedImmPtr(baselineCode.machineCode.executableAddress()), regT1);
+    jump(regT1);
+}
+
+void JITCompiler::linkOSRExits(SpeculativeJIT& speculative)
+{
+    OSRExitVector::Iterator exitsEnd = speculative.osrExits().end();
+    for (OSRExitVector::Iterator exitsIter = speculative.osrExits().begin(); exitsIter != exitsEnd; ++exitsIter)
+        exitSpeculativeToBaseline(*exitsIter, speculative.speculationRecovery(exitsIter->m_check.m_recoveryIndex));
+}
+
 void JITCompiler::linkSpeculationChecks(SpeculativeJIT& speculative, NonSpeculativeJIT& nonSpeculative)
 {
     // Iterators to walk over the set of bail outs & corresponding entry points.
@@ -217,7 +282,15 @@ void JITCompiler::linkSpeculationChecks(SpeculativeJIT& speculative, NonSpeculat
     ASSERT(!(entriesIter != entriesEnd));
 }
 
-void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWithArityCheck)
+bool JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWithArityCheck)
+{
+    if (!generateFunction())
+        return false;
+    linkFunction(entry, entryWithArityCheck);
+    return true;
+}
+
+bool JITCompiler::generateFunction()
 {
     // === Stage 1 - Function header code generation ===
     //
@@ -225,6 +298,11 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
     // pop the return address (since we do not allow any recursion on the machine
     // stack), and perform a fast register file check.
 
+    // Once speculation has failed too often, calls are diverted to the baseline JIT's code
+    // for the function; check this before touching the call frame.
+    move(TrustedImmPtr(m_codeBlock->addressOfSpeculationFailures()), regT3);
+    m_tooManySpeculationFailures = branch32(AboveOrEqual, Address(regT3), TrustedImm32(CodeBlock::speculationFailureThresholdForBaseline));
+
     // This is the main entry point, without performing an arity check.
     // FIXME: https://bugs.webkit.org/show_bug.cgi?id=56292
     // We'll need to convert the remaining cti_ style calls (specifically the register file
@@ -239,6 +317,8 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
     // Setup a pointer to the codeblock in the CallFrameHeader.
     emitPutImmediateToCallFrameHeader(m_codeBlock, RegisterFile::CodeBlock);
 
+    store32(TrustedImm32(1), m_codeBlock->addressOfWasExecuted());
+
     // Plant a check that sufficient space is available in the RegisterFile.
     // FIXME: https://bugs.webkit.org/show_bug.cgi?id=56291
     addPtr(Imm32(m_codeBlock->m_numCalleeRegisters * sizeof(Register)), callFrameRegister, regT1);
@@ -261,30 +341,41 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
     breakpoint();
 #endif
 
-    // First generate the speculative path.
-    Label speculativePathBegin = label();
+    // First generate the speculative path. If this fails the function is left
+    // in the baseline JIT; the non-speculative path alone would be no faster.
+#if ENABLE(SAMPLING_PROFILER)
+    m_mapsMachineCode = m_globalData->samplingProfiler;
+#endif
     SpeculativeJIT speculative(*this);
-    bool compiledSpeculative = speculative.compile();
+    if (!speculative.compile())
+        return false;
+#if ENABLE(SAMPLING_PROFILER)
+    mapMachineCode(MachineCodeToBytecodeOffset::noBytecodeOffset);
+#endif
+
+    // The baseline JIT's code may enter the function at the head of any loop.
+    Vector<BasicBlock>& blocks = graph().m_blocks;
+    m_blockHeads.resize(blocks.size());
+    for (BlockIndex block = 0; block < blocks.size(); ++block)
+        m_blockHeads[block] = speculative.blockHead(block);
+
+    // Link the bail-outs from the speculative path back to the baseline JIT.
+    linkOSRExits(speculative);
 
     // Next, generate the non-speculative path. We pass this a SpeculationCheckIndexIterator
     // to allow it to check which nodes in the graph may bail out, and may need to reenter the
-    // non-speculative path.
-    if (compiledSpeculative) {
+    // non-speculative path. Most bail-outs exit directly to the baseline JIT; the
+    // non-speculative path is only needed for those that cannot.
+    if (speculative.speculationChecks().size()) {
         SpeculationCheckIndexIterator checkIterator(speculative.speculationChecks());
         NonSpeculativeJIT nonSpeculative(*this);
         nonSpeculative.compile(checkIterator);
+#if ENABLE(SAMPLING_PROFILER)
+        mapMachineCode(MachineCodeToBytecodeOffset::noBytecodeOffset);
+#endif
 
         // Link the bail-outs from the speculative path to the corresponding entry points into the non-speculative one.
         linkSpeculationChecks(speculative, nonSpeculative);
-    } else {
-        // If compilation through the SpeculativeJIT failed, throw away the code we generated.
-        m_calls.clear();
-        rewindToLabel(speculativePathBegin);
-
-        SpeculationCheckVector noChecks;
-        SpeculationCheckIndexIterator checkIterator(noChecks);
-        NonSpeculativeJIT nonSpeculative(*this);
-        nonSpeculative.compile(checkIterator);
     }
 
     // === Stage 3 - Function footer code generation ===
@@ -295,16 +386,15 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
 
     // Iterate over the m_calls vector, checking for exception checks,
     // and linking them to here.
-    unsigned exceptionCheckCount = 0;
     for (unsigned i = 0; i < m_calls.size(); ++i) {
         Jump& exceptionCheck = m_calls[i].m_exceptionCheck;
         if (exceptionCheck.isSet()) {
             exceptionCheck.link(this);
-            ++exceptionCheckCount;
+            ++m_exceptionCheckCount;
         }
     }
     // If any exception checks were linked, generate code to lookup a handler.
-    if (exceptionCheckCount) {
+    if (m_exceptionCheckCount) {
         // lookupExceptionHandler is passed two arguments, exec (the CallFrame*), and
         // an identifier for the operation that threw the exception, which we can use
         // to look up handler information. The identifier we use is the return address
@@ -324,7 +414,7 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
     registerFileCheck.link(this);
     move(stackPointerRegister, argumentRegister0);
     poke(callFrameRegister, OBJECT_OFFSETOF(struct JITStackFrame, callFrame) / sizeof(void*));
-    Call callRegisterFileCheck = call();
+    m_callRegisterFileCheck = call();
     jump(fromRegisterFileCheck);
 
     // The fast entry point into a function does not check the correct number of arguments
@@ -332,21 +422,28 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
     // determine the correct number of arguments have been passed, or have already checked).
     // In cases where an arity check is necessary, we enter here.
     // FIXME: change this from a cti call to a DFG style operation (normal C calling conventions).
-    Label arityCheck = label();
+    m_arityCheck = label();
+    move(TrustedImmPtr(m_codeBlock->addressOfSpeculationFailures()), regT3);
+    m_tooManySpeculationFailuresWithArityCheck = branch32(AboveOrEqual, Address(regT3), TrustedImm32(CodeBlock::speculationFailureThresholdForBaseline));
     preserveReturnAddressAfterCall(regT2);
     emitPutToCallFrameHeader(regT2, RegisterFile::ReturnPC);
     branch32(Equal, regT1, Imm32(m_codeBlock->m_numParameters)).linkTo(fromArityCheck, this);
     move(stackPointerRegister, argumentRegister0);
     poke(callFrameRegister, OBJECT_OFFSETOF(struct JITStackFrame, callFrame) / sizeof(void*));
-    Call callArityCheck = call();
+    m_callArityCheck = call();
     move(regT0, callFrameRegister);
     jump(fromArityCheck);
 
+    return true;
+}
 
+void JITCompiler::linkFunction(JITCode& entry, MacroAssemblerCodePtr& entryWithArityCheck)
+{
     // === Stage 4 - Link ===
     //
     // Link the code, populate data in CodeBlock data structures.
 
+    ASSERT(m_codeBlock->hasOptimizedJITCode());
     LinkBuffer linkBuffer(this, m_globalData->executableAllocator.poolForSize(m_assembler.size()), 0);
 
 #if DFG_DEBUG_VERBOSE
@@ -358,7 +455,7 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
         linkBuffer.link(m_calls[i].m_call, m_calls[i].m_function);
 
     if (m_codeBlock->needsCallReturnIndices()) {
-        m_codeBlock->callReturnIndexVector().reserveCapacity(exceptionCheckCount);
+        m_codeBlock->callReturnIndexVector().reserveCapacity(m_exceptionCheckCount);
         for (unsigned i = 0; i < m_calls.size(); ++i) {
             if (m_calls[i].m_exceptionCheck.isSet()) {
                 unsigned returnAddressOffset = linkBuffer.returnAddressOffset(m_calls[i].m_call);
@@ -369,10 +466,32 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
     }
 
     // FIXME: switch the register file check & arity check over to DFGOpertaion style calls, not JIT stubs.
-    linkBuffer.link(callRegisterFileCheck, cti_register_file_check);
-    linkBuffer.link(callArityCheck, m_codeBlock->m_isConstructor ? cti_op_construct_arityCheck : cti_op_call_arityCheck);
+    linkBuffer.link(m_callRegisterFileCheck, cti_register_file_check);
+    linkBuffer.link(m_callArityCheck, m_codeBlock->m_isConstructor ? cti_op_construct_arityCheck : cti_op_call_arityCheck);
+
+    linkBuffer.link(m_tooManySpeculationFailures, CodeLocationLabel(m_codeBlock->getBaselineJITCode().start()));
+    linkBuffer.link(m_tooManySpeculationFailuresWithArityCheck, CodeLocationLabel(m_codeBlock->baselineJITCodeWithArityCheck()));
+
+    Vector<BasicBlock>& blocks = graph().m_blocks;
+    Vector<BytecodeOffsetToMachineCode>& optimizedEntryMap = m_codeBlock->optimizedEntryMap();
+    for (BlockIndex block = 0; block < blocks.size(); ++block) {
+        if (!blocks[block].isLoopHeader)
+            continue;
+        optimizedEntryMap.append(BytecodeOffsetToMachineCode(blocks[block].bytecodeBegin, std::numeric_limits<int>::max()));
+        optimizedEntryMap.last().machineCode = linkBuffer.locationOf(m_blockHeads[block]);
+    }
+
+#if ENABLE(SAMPLING_PROFILER)
+    if (m_mapsMachineCode) {
+        Vector<MachineCodeToBytecodeOffset> machineCodeMap;
+        machineCodeMap.reserveCapacity(m_machineCodeMap.size());
+        for (unsigned i = 0; i < m_machineCodeMap.size(); ++i)
+            machineCodeMap.append(MachineCodeToBytecodeOffset(linkBuffer.locationOf(m_machineCodeMap[i].first).executableAddress(), m_machineCodeMap[i].second));
+        m_codeBlock->addMachineCodeMap(machineCodeMap);
+    }
+#endif
 
-    entryWithArityCheck = linkBuffer.locationOf(arityCheck);
+    entryWithArityCheck = linkBuffer.locationOf(m_arityCheck);
     entry = linkBuffer.finalizeCode();
 }
 
@@ -47,6 +47,7 @@ class SpeculativeJIT;
 class SpeculationRecovery;
 
 struct EntryLocation;
+struct OSRExit;
 struct SpeculationCheck;
 
 // Abstracted sequential numbering of available machine registers (as opposed to MacroAssembler::RegisterID,
@@ -110,10 +111,23 @@ public:
         : m_globalData(globalData)
         , m_graph(dfg)
         , m_codeBlock(codeBlock)
+        , m_exceptionCheckCount(0)
+#if ENABLE(SAMPLING_PROFILER)
+        , m_mapsMachineCode(false)
+#endif
     {
     }
 
-    void compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWithArityCheck);
+    // Returns false, generating no code, if the function cannot be compiled speculatively.
+    bool compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWithArityCheck);
+
+    // compileFunction() in two steps. generateFunction() only writes to the JITCompiler,
+    // so it may run on a thread other than the one running JavaScript, as long as the
+    // CodeBlock is kept alive. linkFunction() copies the code into executable memory and
+    // fills in the CodeBlock; the CodeBlock must already hold the baseline JIT's code as
+    // its alternative.
+    bool generateFunction();
+    void linkFunction(JITCode& entry, MacroAssemblerCodePtr& entryWithArityCheck);
 
     // Accessors for properties.
     Graph& graph() { return m_graph; }
@@ -301,13 +315,27 @@ public:
     void emitCount(AbstractSamplingCounter&, uint32_t increment = 1);
 #endif
 
+#if ENABLE(SAMPLING_PROFILER)
+    // Marks the start of the code generated for a node, so the sampling profiler can
+    // attribute samples in it to the node's bytecode offset.
+    void mapMachineCode(ExceptionInfo bytecodeOffset)
+    {
+        if (m_mapsMachineCode)
+            m_machineCodeMap.append(std::make_pair(label(), bytecodeOffset));
+    }
+#endif
+
 private:
     // These methods used in linking the speculative & non-speculative paths together.
     void fillNumericToDouble(NodeIndex, FPRReg, GPRReg temporary);
     void fillInt32ToInteger(NodeIndex, GPRReg);
     void fillToJS(NodeIndex, GPRReg);
+    void linkSpeculationCheck(const SpeculationCheck&, SpeculationRecovery*);
     void jumpFromSpeculativeToNonSpeculative(const SpeculationCheck&, const EntryLocation&, SpeculationRecovery*);
     void linkSpeculationChecks(SpeculativeJIT&, NonSpeculativeJIT&);
+    // These methods used in exiting from the speculative path to the baseline JIT.
+    void exitSpeculativeToBaseline(const OSRExit&, SpeculationRecovery*);
+    void linkOSRExits(SpeculativeJIT&);
 
     // The globalData, used to access constants such as the vPtrs.
     JSGlobalData* m_globalData;
@@ -320,6 +348,20 @@ private:
 
     // Vector of calls out from JIT code, including exception handler information.
     Vector<CallRecord> m_calls;
+
+    // Recorded by generateFunction() for linkFunction().
+    Jump m_tooManySpeculationFailures;
+    Jump m_tooManySpeculationFailuresWithArityCheck;
+    Call m_callRegisterFileCheck;
+    Call m_callArityCheck;
+    Label m_arityCheck;
+    Vector<Label> m_blockHeads;
+    unsigned m_exceptionCheckCount;
+
+#if ENABLE(SAMPLING_PROFILER)
+    bool m_mapsMachineCode;
+    Vector<std::pair<Label, unsigned> > m_machineCodeMap;
+#endif
 };
 
 } } // namespace JSC::DFG
@@ -46,6 +46,7 @@
 
 #if ENABLE(DFG_JIT)
 
+#include <limits.h>
 #include <wtf/Vector.h>
 
 namespace JSC { namespace DFG {
@@ -659,6 +659,9 @@ void NonSpeculativeJIT::compile(SpeculationCheckIndexIterator& checkIterator, Ba
     m_jit.breakpoint();
 #endif
 
+    if (block.isLoopHeader)
+        emitTimeoutCheck(block);
+
     for (; m_compileIndex < block.end; ++m_compileIndex) {
         Node& node = m_jit.graph()[m_compileIndex];
         if (!node.refCount)
@@ -671,6 +674,9 @@ void NonSpeculativeJIT::compile(SpeculationCheckIndexIterator& checkIterator, Ba
     m_jit.breakpoint();
 #endif
 
+#if ENABLE(SAMPLING_PROFILER)
+        m_jit.mapMachineCode(node.exceptionInfo);
+#endif
         compile(checkIterator, node);
     }
 }
@@ -29,6 +29,7 @@
 #if ENABLE(DFG_JIT)
 
 #include "CodeBlock.h"
+#include "ExceptionHelpers.h"
 #include "Interpreter.h"
 #include "JSByteArray.h"
 #include "JSGlobalData.h"
@@ -212,6 +213,19 @@ bool operationCompareStrictEq(ExecState* exec, EncodedJSValue encodedOp1, Encode
     return JSValue::strictEqual(exec, JSValue::decode(encodedOp1), JSValue::decode(encodedOp2));
 }
 
+int32_t operationTimeoutCheck(ExecState* exec)
+{
+    JSGlobalData* globalData = &exec->globalData();
+    TimeoutChecker& timeoutChecker = globalData->timeoutChecker;
+
+    if (globalData->terminator.shouldTerminate())
+        globalData->exception = createTerminatedExecutionException(globalData);
+    else if (timeoutChecker.didTimeOut(exec))
+        globalData->exception = createInterruptedExecutionException(globalData);
+
+    return timeoutChecker.ticksUntilNextCheck();
+}
+
 DFGHandler lookupExceptionHandler(ExecState* exec, ReturnAddressPtr faultLocation)
 {
     JSValue exceptionValue = exec->exception();
@@ -165,6 +165,43 @@ SpeculationCheck::SpeculationCheck(MacroAssembler::Jump check, SpeculativeJIT* j
     }
 }
 
+void SpeculativeJIT::addSpeculationCheck(const SpeculationCheck& check)
+{
+    OSRExit exit(check, m_jit.graph()[m_compileIndex].exceptionInfo);
+
+    // Temporaries do not live across basic blocks, so only those defined in
+    // this block may be read by the baseline JIT's code at the exit.
+    BasicBlock& block = m_jit.graph().m_blocks[m_block];
+    for (unsigned i = block.temporaryLiveRangesBegin; i < block.temporaryLiveRangesEnd; ++i) {
+        TemporaryLiveRange& range = m_jit.graph().m_temporaryLiveRanges[i];
+        if (!range.isLiveAt(exit.m_bytecodeIndex))
+            continue;
+        if (!isRecoverableAtExit(range.nodeIndex)) {
+            m_speculationChecks.append(check);
+            return;
+        }
+        OSRExit::Operand operand = { range.operand, range.nodeIndex };
+        exit.m_operands.append(operand);
+    }
+
+    m_osrExits.append(exit);
+}
+
+bool SpeculativeJIT::isRecoverableAtExit(NodeIndex nodeIndex)
+{
+    Node& node = m_jit.graph()[nodeIndex];
+    if (node.isConstant())
+        return true;
+    // The node may never have been generated, or its value may have been discarded
+    // after its last use (in which case its VirtualRegister may have been reused).
+    if (node.virtualRegister == InvalidVirtualRegister)
+        return false;
+    GenerationInfo& info = m_generationInfo[node.virtualRegister];
+    if (info.nodeIndex() != nodeIndex || !info.alive())
+        return false;
+    return info.registerFormat() != DataFormatNone || info.spillFormat() != DataFormatNone;
+}
+
 GPRReg SpeculativeJIT::fillSpeculateInt(NodeIndex nodeIndex, DataFormat& returnFormat)
 {
     return fillSpeculateIntInternal<false>(nodeIndex, returnFormat);
@@ -239,6 +276,118 @@ GPRReg SpeculativeJIT::fillSpeculateCell(NodeIndex nodeIndex)
     return InvalidGPRReg;
 }
 
+bool SpeculativeJIT::isKnownNumeric(NodeIndex nodeIndex)
+{
+    Node& node = m_jit.graph()[nodeIndex];
+    if (node.isConstant())
+        return isInt32Constant(nodeIndex) || isDoubleConstant(nodeIndex) || valueOfJSConstant(nodeIndex).isNumber();
+
+    GenerationInfo& info = m_generationInfo[node.virtualRegister];
+    DataFormat format = info.registerFormat() != DataFormatNone ? info.registerFormat() : info.spillFormat();
+    return (format | DataFormatJS) == DataFormatJSInteger || (format | DataFormatJS) == DataFormatJSDouble;
+}
+
+bool SpeculativeJIT::isKnownInteger(NodeIndex nodeIndex)
+{
+    Node& node = m_jit.graph()[nodeIndex];
+    if (node.isConstant())
+        return isInt32Constant(nodeIndex);
+
+    GenerationInfo& info = m_generationInfo[node.virtualRegister];
+    DataFormat format = info.registerFormat() != DataFormatNone ? info.registerFormat() : info.spillFormat();
+    return (format | DataFormatJS) == DataFormatJSInteger;
+}
+
+bool SpeculativeJIT::isKnownDouble(NodeIndex nodeIndex)
+{
+    Node& node = m_jit.graph()[nodeIndex];
+    if (node.isConstant()) {
+        int32_t unused;
+        if (isDoubleConstant(nodeIndex))
+            return !isDoubleConstantWithInt32Value(nodeIndex, unused);
+        return isJSConstant(nodeIndex) && valueOfJSConstant(nodeIndex).isDouble();
+    }
+
+    GenerationInfo& info = m_generationInfo[node.virtualRegister];
+    DataFormat format = info.registerFormat() != DataFormatNone ? info.registerFormat() : info.spillFormat();
+    return (format | DataFormatJS) == DataFormatJSDouble;
+}
+
+void SpeculativeJIT::updateArrayVectorType(MacroAssembler::RegisterID storageReg, NodeIndex value, MacroAssembler::RegisterID valueReg)
+{
+    // Integers can be stored into an array of any type.
+    if (isKnownInteger(value))
+        return;
+
+    MacroAssembler::Address vectorType(storageReg, OBJECT_OFFSETOF(ArrayStorage, m_vectorType));
+    MacroAssembler::Jump vectorIsGeneric = m_jit.branch32(MacroAssembler::Equal, vectorType, TrustedImm32(GenericArrayStorage));
+    MacroAssembler::Jump valueIsInt32 = m_jit.branchPtr(MacroAssembler::AboveOrEqual, valueReg, JITCompiler::tagTypeNumberRegister);
+    MacroAssembler::Jump valueIsNotNumber = m_jit.branchTestPtr(MacroAssembler::Zero, valueReg, JITCompiler::tagTypeNumberRegister);
+    m_jit.store32(TrustedImm32(DoubleArrayStorage), vectorType);
+    MacroAssembler::Jump vectorTypeUpdated = m_jit.jump();
+    valueIsNotNumber.link(&m_jit);
+    m_jit.store32(TrustedImm32(GenericArrayStorage), vectorType);
+    vectorIsGeneric.link(&m_jit);
+    valueIsInt32.link(&m_jit);
+    vectorTypeUpdated.link(&m_jit);
+}
+
+bool SpeculativeJIT::compilePeepHoleBranch(Node& node, MacroAssembler::Condition condition, MacroAssembler::Condition inverse)
+{
+    // The branch must be the comparison's only use (other than the implicit
+    // use by which 'mustGenerate' nodes are kept alive).
+    NodeIndex branchNodeIndex = m_compileIndex + 1;
+    if (node.refCount != (node.mustGenerate() ? 2u : 1u) || branchNodeIndex >= m_jit.graph().m_blocks[m_block].end)
+        return false;
+    Node& branchNode = m_jit.graph()[branchNodeIndex];
+    if (branchNode.op != Branch || branchNode.child1 != m_compileIndex)
+        return false;
+
+    BlockIndex taken = m_jit.graph().blockIndexForBytecodeOffset(branchNode.takenBytecodeOffset());
+    BlockIndex notTaken = m_jit.graph().blockIndexForBytecodeOffset(branchNode.notTakenBytecodeOffset());
+
+    // The branch to the next block can be omitted by inverting the condition.
+    if (taken == (m_block + 1)) {
+        condition = inverse;
+        BlockIndex tmp = taken;
+        taken = notTaken;
+        notTaken = tmp;
+    }
+
+    int32_t imm;
+    bool hasImmediate = false;
+    if (isInt32Constant(node.child2)) {
+        imm = valueOfInt32Constant(node.child2);
+        hasImmediate = true;
+    } else if (isDoubleConstantWithInt32Value(node.child2, imm))
+        hasImmediate = true;
+    else if (isJSConstant(node.child2) && valueOfJSConstant(node.child2).isInt32()) {
+        imm = valueOfJSConstant(node.child2).asInt32();
+        hasImmediate = true;
+    }
+
+    SpeculateIntegerOperand op1(this, node.child1);
+    if (hasImmediate)
+        addBranch(m_jit.branch32(condition, op1.registerID(), Imm32(imm)), taken);
+    else {
+        SpeculateIntegerOperand op2(this, node.child2);
+        addBranch(m_jit.branch32(condition, op1.registerID(), op2.registerID()), taken);
+    }
+    if (notTaken != (m_block + 1))
+        addBranch(m_jit.jump(), notTaken);
+
+    // The comparison produces no value; its only use was the branch, which we have
+    // now generated, so account for both nodes and continue after the branch.
+    use(node.child1);
+    use(node.child2);
+    m_generationInfo[node.virtualRegister].initNone(m_compileIndex, node.refCount);
+    if (node.mustGenerate())
+        use(m_compileIndex);
+    m_compileIndex = branchNodeIndex;
+    noResult(branchNodeIndex);
+    return true;
+}
+
 bool SpeculativeJIT::compile(Node& node)
 {
     checkConsistency();
@@ -356,6 +505,14 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case ValueToNumber: {
+        if (isKnownDouble(node.child1)) {
+            DoubleOperand op1(this, node.child1);
+            FPRTemporary result(this, op1);
+            m_jit.moveDouble(op1.registerID(), result.registerID());
+            doubleResult(result.fpr(), m_compileIndex);
+            break;
+        }
+
         SpeculateIntegerOperand op1(this, node.child1);
         GPRTemporary result(this, op1);
         m_jit.move(op1.registerID(), result.registerID());
@@ -365,6 +522,17 @@ bool SpeculativeJIT::compile(Node& node)
 
     case ValueAdd:
     case ArithAdd: {
+        if (shouldSpeculateDouble(node.child1, node.child2)) {
+            DoubleOperand op1(this, node.child1);
+            DoubleOperand op2(this, node.child2);
+            FPRTemporary result(this, op1, op2);
+
+            m_jit.addDouble(op1.registerID(), op2.registerID(), result.registerID());
+
+            doubleResult(result.fpr(), m_compileIndex);
+            break;
+        }
+
         int32_t imm1;
         if (isDoubleConstantWithInt32Value(node.child1, imm1)) {
             SpeculateIntegerOperand op2(this, node.child2);
@@ -410,6 +578,17 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case ArithSub: {
+        if (shouldSpeculateDouble(node.child1, node.child2)) {
+            DoubleOperand op1(this, node.child1);
+            DoubleOperand op2(this, node.child2);
+            FPRTemporary result(this, op1);
+
+            m_jit.subDouble(op1.registerID(), op2.registerID(), result.registerID());
+
+            doubleResult(result.fpr(), m_compileIndex);
+            break;
+        }
+
         int32_t imm2;
         if (isDoubleConstantWithInt32Value(node.child2, imm2)) {
             SpeculateIntegerOperand op1(this, node.child1);
@@ -435,6 +614,17 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case ArithMul: {
+        if (shouldSpeculateDouble(node.child1, node.child2)) {
+            DoubleOperand op1(this, node.child1);
+            DoubleOperand op2(this, node.child2);
+            FPRTemporary result(this, op1, op2);
+
+            m_jit.mulDouble(op1.registerID(), op2.registerID(), result.registerID());
+
+            doubleResult(result.fpr(), m_compileIndex);
+            break;
+        }
+
         SpeculateIntegerOperand op1(this, node.child1);
         SpeculateIntegerOperand op2(this, node.child2);
         GPRTemporary result(this);
@@ -453,13 +643,19 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case ArithDiv: {
-        SpeculateIntegerOperand op1(this, node.child1);
-        SpeculateIntegerOperand op2(this, node.child2);
-        GPRTemporary result(this, op1, op2);
+        // Division is performed on doubles; the result is not speculated to be an integer.
+        if (!isKnownNumeric(node.child1) || !isKnownNumeric(node.child2)) {
+            terminateSpeculativeExecution();
+            break;
+        }
 
-        terminateSpeculativeExecution();
+        DoubleOperand op1(this, node.child1);
+        DoubleOperand op2(this, node.child2);
+        FPRTemporary result(this, op1);
 
-        integerResult(result.gpr(), m_compileIndex);
+        m_jit.divDouble(op1.registerID(), op2.registerID(), result.registerID());
+
+        doubleResult(result.fpr(), m_compileIndex);
         break;
     }
 
@@ -489,6 +685,9 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case CompareLess: {
+        if (compilePeepHoleBranch(node, JITCompiler::LessThan, JITCompiler::GreaterThanOrEqual))
+            break;
+
         SpeculateIntegerOperand op1(this, node.child1);
         SpeculateIntegerOperand op2(this, node.child2);
         GPRTemporary result(this, op1, op2);
@@ -502,6 +701,9 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case CompareLessEq: {
+        if (compilePeepHoleBranch(node, JITCompiler::LessThanOrEqual, JITCompiler::GreaterThan))
+            break;
+
         SpeculateIntegerOperand op1(this, node.child1);
         SpeculateIntegerOperand op2(this, node.child2);
         GPRTemporary result(this, op1, op2);
@@ -515,6 +717,9 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case CompareEq: {
+        if (compilePeepHoleBranch(node, JITCompiler::Equal, JITCompiler::NotEqual))
+            break;
+
         SpeculateIntegerOperand op1(this, node.child1);
         SpeculateIntegerOperand op2(this, node.child2);
         GPRTemporary result(this, op1, op2);
@@ -528,6 +733,9 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case CompareStrictEq: {
+        if (compilePeepHoleBranch(node, JITCompiler::Equal, JITCompiler::NotEqual))
+            break;
+
         SpeculateIntegerOperand op1(this, node.child1);
         SpeculateIntegerOperand op2(this, node.child2);
         GPRTemporary result(this, op1, op2);
@@ -610,6 +818,8 @@ bool SpeculativeJIT::compile(Node& node)
         lengthDoesNotNeedUpdate.link(&m_jit);
         notHoleValue.link(&m_jit);
 
+        updateArrayVectorType(storageReg, node.child3, valueReg);
+
         // Store the value to the array.
         m_jit.storePtr(valueReg, MacroAssembler::BaseIndex(storageReg, propertyReg, MacroAssembler::ScalePtr, OBJECT_OFFSETOF(ArrayStorage, m_vector[0])));
 
@@ -631,6 +841,8 @@ bool SpeculativeJIT::compile(Node& node)
         MacroAssembler::RegisterID propertyReg = property.registerID();
         MacroAssembler::RegisterID valueReg = value.registerID();
 
+        updateArrayVectorType(storageReg, node.child3, valueReg);
+
         // Store the value to the array.
         m_jit.storePtr(valueReg, MacroAssembler::BaseIndex(storageReg, propertyReg, MacroAssembler::ScalePtr, OBJECT_OFFSETOF(ArrayStorage, m_vector[0])));
 
@@ -647,6 +859,24 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case Branch: {
+        if (isKnownInteger(node.child1)) {
+            SpeculateIntegerOperand value(this, node.child1);
+
+            BlockIndex taken = m_jit.graph().blockIndexForBytecodeOffset(node.takenBytecodeOffset());
+            BlockIndex notTaken = m_jit.graph().blockIndexForBytecodeOffset(node.notTakenBytecodeOffset());
+
+            if (taken == (m_block + 1))
+                addBranch(m_jit.branchTest32(MacroAssembler::Zero, value.registerID()), notTaken);
+            else {
+                addBranch(m_jit.branchTest32(MacroAssembler::NonZero, value.registerID()), taken);
+                if (notTaken != (m_block + 1))
+                    addBranch(m_jit.jump(), notTaken);
+            }
+
+            noResult(m_compileIndex);
+            break;
+        }
+
         JSValueOperand value(this, node.child1);
         MacroAssembler::RegisterID valueReg = value.registerID();
 
@@ -774,7 +1004,8 @@ bool SpeculativeJIT::compile(Node& node)
     if (m_didTerminate)
         return false;
 
-    if (node.mustGenerate())
+    // If the node was fused with the one following it, m_compileIndex now refers to the latter.
+    if (m_jit.graph()[m_compileIndex].mustGenerate())
         use(m_compileIndex);
 
     checkConsistency();
@@ -790,6 +1021,9 @@ bool SpeculativeJIT::compile(BasicBlock& block)
     m_jit.breakpoint();
 #endif
 
+    if (block.isLoopHeader)
+        emitTimeoutCheck(block);
+
     for (; m_compileIndex < block.end; ++m_compileIndex) {
         Node& node = m_jit.graph()[m_compileIndex];
         if (!node.refCount)
@@ -800,6 +1034,9 @@ bool SpeculativeJIT::compile(BasicBlock& block)
 #endif
 #if DFG_JIT_BREAK_ON_EVERY_NODE
     m_jit.breakpoint();
+#endif
+#if ENABLE(SAMPLING_PROFILER)
+        m_jit.mapMachineCode(node.exceptionInfo);
 #endif
         if (!compile(node))
             return false;
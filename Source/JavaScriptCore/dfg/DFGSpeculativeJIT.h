@@ -90,6 +90,32 @@ struct SpeculationCheck {
 };
 typedef SegmentedVector<SpeculationCheck, 16> SpeculationCheckVector;
 
+// === OSRExit ===
+//
+// This structure records a bail-out from the speculative path directly back
+// into the baseline JIT's code for the function. This is only possible where
+// the values of all bytecode temporaries live at that point can be recovered;
+// locals and arguments are always up to date in the RegisterFile.
+struct OSRExit {
+    OSRExit(const SpeculationCheck& check, unsigned bytecodeIndex)
+        : m_check(check)
+        , m_bytecodeIndex(bytecodeIndex)
+    {
+    }
+
+    struct Operand {
+        int operand;
+        NodeIndex nodeIndex;
+    };
+
+    SpeculationCheck m_check;
+    // The bytecode instruction at which the baseline JIT's code resumes execution.
+    unsigned m_bytecodeIndex;
+    // The temporaries read by the baseline JIT's code, and the nodes holding their values.
+    Vector<Operand, 8> m_operands;
+};
+typedef SegmentedVector<OSRExit, 16> OSRExitVector;
+
 
 // === SpeculativeJIT ===
 //
@@ -118,6 +144,11 @@ public:
     {
         return m_speculationChecks;
     }
+    // Retrieve the list of bail-outs from the speculative path to the baseline JIT.
+    OSRExitVector& osrExits()
+    {
+        return m_osrExits;
+    }
     SpeculationRecovery* speculationRecovery(size_t index)
     {
         // SpeculationCheck::m_recoveryIndex is offset by 1,
@@ -151,17 +182,38 @@ private:
         return true;
     }
 
+    // What is known about the type of a node's value, from the format in which it is held.
+    bool isKnownInteger(NodeIndex);
+    bool isKnownNumeric(NodeIndex);
+    bool isKnownDouble(NodeIndex);
+    // Arithmetic is performed on doubles where an operand is already known to
+    // hold a double value, and both are known to be numeric.
+    bool shouldSpeculateDouble(NodeIndex op1, NodeIndex op2)
+    {
+        return (isKnownDouble(op1) || isKnownDouble(op2)) && isKnownNumeric(op1) && isKnownNumeric(op2);
+    }
+
+    // Move an array's vector type on as needed to hold the value about to be stored.
+    void updateArrayVectorType(MacroAssembler::RegisterID storageReg, NodeIndex value, MacroAssembler::RegisterID valueReg);
+
+    // Fuse an integer comparison with the Branch that immediately follows it,
+    // if the branch is its only use. Returns true if the branch was generated.
+    bool compilePeepHoleBranch(Node&, MacroAssembler::Condition, MacroAssembler::Condition inverse);
+
     // Add a speculation check without additional recovery.
     void speculationCheck(MacroAssembler::Jump jumpToFail)
     {
-        m_speculationChecks.append(SpeculationCheck(jumpToFail, this));
+        addSpeculationCheck(SpeculationCheck(jumpToFail, this));
     }
     // Add a speculation check with additional recovery.
     void speculationCheck(MacroAssembler::Jump jumpToFail, const SpeculationRecovery& recovery)
     {
         m_speculationRecoveryList.append(recovery);
-        m_speculationChecks.append(SpeculationCheck(jumpToFail, this, m_speculationRecoveryList.size()));
+        addSpeculationCheck(SpeculationCheck(jumpToFail, this, m_speculationRecoveryList.size()));
     }
+    // Records the check as an OSRExit if possible, otherwise as a bail-out to the non-speculative path.
+    void addSpeculationCheck(const SpeculationCheck&);
+    bool isRecoverableAtExit(NodeIndex);
 
     // Called when we statically determine that a speculation will fail.
     void terminateSpeculativeExecution()
@@ -182,6 +234,8 @@ private:
     bool m_didTerminate;
     // This vector tracks bail-outs from the speculative path to the non-speculative one.
     SpeculationCheckVector m_speculationChecks;
+    // This vector tracks bail-outs from the speculative path to the baseline JIT.
+    OSRExitVector m_osrExits;
     // Some bail-outs need to record additional information recording specific recovery
     // to be performed (for example, on detected overflow from an add, we may need to
     // reverse the addition if an operand is being overwritten).
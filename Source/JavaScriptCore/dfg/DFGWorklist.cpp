@@ -0,0 +1,202 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE COMPUTER, INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "DFGWorklist.h"
+
+#if ENABLE(DFG_JIT)
+
+#include "CodeBlock.h"
+#include "DFGByteCodeParser.h"
+
+namespace JSC { namespace DFG {
+
+PassOwnPtr<Plan> Plan::create(JSGlobalData* globalData, CodeBlock* codeBlock)
+{
+    OwnPtr<Plan> plan = adoptPtr(new Plan(globalData, codeBlock));
+    if (!parse(plan->m_graph, globalData, codeBlock))
+        return 0;
+    return plan.release();
+}
+
+Plan::Plan(JSGlobalData* globalData, CodeBlock* codeBlock)
+    : m_codeBlock(codeBlock)
+    , m_jit(globalData, m_graph, codeBlock)
+    , m_isGenerated(false)
+    , m_generatedCode(false)
+{
+}
+
+void Plan::generate()
+{
+    m_generatedCode = m_jit.generateFunction();
+
+    // Linking only needs the basic blocks; don't hold on to the nodes while the plan waits.
+    m_graph.clear();
+}
+
+bool Plan::link(JITCode& entry, MacroAssemblerCodePtr& entryWithArityCheck)
+{
+    if (!m_generatedCode)
+        return false;
+
+    // The baseline JIT's code is retained by the CodeBlock, for optimized code to exit in to.
+    m_codeBlock->setAlternativeJITCode(entry, entryWithArityCheck);
+    m_jit.linkFunction(entry, entryWithArityCheck);
+    return true;
+}
+
+PassOwnPtr<Worklist> Worklist::create()
+{
+    OwnPtr<Worklist> worklist = adoptPtr(new Worklist);
+    worklist->m_thread = createThread(threadStart, worklist.get(), "JSC::DFG::Worklist");
+    if (!worklist->m_thread)
+        return 0;
+    return worklist.release();
+}
+
+Worklist::Worklist()
+    : m_generatingPlan(0)
+    , m_shouldStop(false)
+    , m_thread(0)
+{
+}
+
+Worklist::~Worklist()
+{
+    {
+        MutexLocker locker(m_lock);
+        m_shouldStop = true;
+        m_planEnqueued.signal();
+    }
+    waitForThreadCompletion(m_thread, 0);
+
+    deleteAllValues(m_plans);
+}
+
+void Worklist::enqueue(PassOwnPtr<Plan> passedPlan)
+{
+    Plan* plan = passedPlan.leakPtr();
+
+    MutexLocker locker(m_lock);
+    ASSERT(!m_plans.contains(plan->codeBlock()));
+    m_plans.set(plan->codeBlock(), plan);
+    m_queue.append(plan);
+    m_planEnqueued.signal();
+}
+
+Worklist::State Worklist::compilationState(CodeBlock* codeBlock)
+{
+    MutexLocker locker(m_lock);
+    Plan* plan = m_plans.get(codeBlock);
+    if (!plan)
+        return NotQueued;
+    return plan->m_isGenerated ? Compiled : Compiling;
+}
+
+PassOwnPtr<Plan> Worklist::takeCompiledPlan(CodeBlock* codeBlock)
+{
+    MutexLocker locker(m_lock);
+    Plan* plan = m_plans.get(codeBlock);
+    ASSERT(plan && plan->m_isGenerated);
+    m_plans.remove(codeBlock);
+    removeReadyCodeBlock(codeBlock);
+    return adoptPtr(plan);
+}
+
+void Worklist::completeReadyPlans()
+{
+    Vector<CodeBlock*> readyCodeBlocks;
+    {
+        MutexLocker locker(m_lock);
+        readyCodeBlocks.swap(m_readyCodeBlocks);
+    }
+    for (size_t i = 0; i < readyCodeBlocks.size(); ++i)
+        readyCodeBlocks[i]->optimizeSoon();
+}
+
+void Worklist::removeReadyCodeBlock(CodeBlock* codeBlock)
+{
+    size_t index = m_readyCodeBlocks.find(codeBlock);
+    if (index != notFound)
+        m_readyCodeBlocks.remove(index);
+}
+
+void Worklist::cancel(CodeBlock* codeBlock)
+{
+    MutexLocker locker(m_lock);
+    Plan* plan = m_plans.get(codeBlock);
+    if (!plan)
+        return;
+
+    while (m_generatingPlan == plan)
+        m_planGenerated.wait(m_lock);
+
+    m_plans.remove(codeBlock);
+    removeReadyCodeBlock(codeBlock);
+    if (!plan->m_isGenerated) {
+        for (Deque<Plan*>::iterator it = m_queue.begin(); it != m_queue.end(); ++it) {
+            if (*it == plan) {
+                m_queue.remove(it);
+                break;
+            }
+        }
+    }
+    delete plan;
+}
+
+void* Worklist::threadStart(void* worklist)
+{
+    static_cast<Worklist*>(worklist)->runThread();
+    return 0;
+}
+
+void Worklist::runThread()
+{
+    MutexLocker locker(m_lock);
+    while (true) {
+        while (m_queue.isEmpty() && !m_shouldStop)
+            m_planEnqueued.wait(m_lock);
+        if (m_shouldStop)
+            return;
+
+        Plan* plan = m_queue.first();
+        m_queue.removeFirst();
+        m_generatingPlan = plan;
+
+        m_lock.unlock();
+        plan->generate();
+        m_lock.lock();
+
+        plan->m_isGenerated = true;
+        m_readyCodeBlocks.append(plan->codeBlock());
+        m_generatingPlan = 0;
+        m_planGenerated.broadcast();
+    }
+}
+
+} } // namespace JSC::DFG
+
+#endif
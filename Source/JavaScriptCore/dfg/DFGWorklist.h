@@ -0,0 +1,124 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE COMPUTER, INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DFGWorklist_h
+#define DFGWorklist_h
+
+#if ENABLE(DFG_JIT)
+
+#include <dfg/DFGGraph.h>
+#include <dfg/DFGJITCompiler.h>
+#include <wtf/Deque.h>
+#include <wtf/HashMap.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/PassOwnPtr.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+class CodeBlock;
+class JSGlobalData;
+
+namespace DFG {
+
+// A function being optimized: its graph, parsed on the thread running JavaScript, and
+// the code generated from it, which is linked back on that thread.
+class Plan {
+    WTF_MAKE_NONCOPYABLE(Plan); WTF_MAKE_FAST_ALLOCATED;
+public:
+    // Returns 0 if the DFG JIT cannot parse the CodeBlock's bytecode.
+    static PassOwnPtr<Plan> create(JSGlobalData*, CodeBlock*);
+
+    CodeBlock* codeBlock() const { return m_codeBlock; }
+
+    // May be called on any thread.
+    void generate();
+    // Returns false if no code could be generated. Otherwise the baseline JIT's code
+    // becomes the CodeBlock's alternative, and entry points into the optimized code
+    // are returned.
+    bool link(JITCode& entry, MacroAssemblerCodePtr& entryWithArityCheck);
+
+private:
+    friend class Worklist;
+
+    Plan(JSGlobalData*, CodeBlock*);
+
+    CodeBlock* m_codeBlock;
+    Graph m_graph;
+    JITCompiler m_jit;
+    bool m_isGenerated;
+    bool m_generatedCode;
+};
+
+// Generates optimized code on a thread of its own, so that the thread running
+// JavaScript does not stall while a hot function is compiled; it keeps running the
+// baseline JIT's code, and links the optimized code the next time that code asks to
+// be optimized.
+class Worklist {
+    WTF_MAKE_NONCOPYABLE(Worklist); WTF_MAKE_FAST_ALLOCATED;
+public:
+    enum State { NotQueued, Compiling, Compiled };
+
+    static PassOwnPtr<Worklist> create();
+    ~Worklist();
+
+    void enqueue(PassOwnPtr<Plan>);
+    State compilationState(CodeBlock*);
+    PassOwnPtr<Plan> takeCompiledPlan(CodeBlock*);
+
+    // Asks the CodeBlocks whose code has been generated since the last call to be
+    // optimized on their next count down. Must be called on the thread running JavaScript,
+    // which is the only one that touches their execute counters.
+    void completeReadyPlans();
+
+    // Called as a CodeBlock is destroyed. Waits for the compilation thread if it is
+    // generating code for the CodeBlock.
+    void cancel(CodeBlock*);
+
+private:
+    Worklist();
+
+    // Must be called with m_lock held.
+    void removeReadyCodeBlock(CodeBlock*);
+
+    static void* threadStart(void*);
+    void runThread();
+
+    Mutex m_lock;
+    ThreadCondition m_planEnqueued;
+    ThreadCondition m_planGenerated;
+    Deque<Plan*> m_queue;
+    HashMap<CodeBlock*, Plan*> m_plans;
+    Vector<CodeBlock*> m_readyCodeBlocks;
+    Plan* m_generatingPlan;
+    bool m_shouldStop;
+    ThreadIdentifier m_thread;
+};
+
+} } // namespace JSC::DFG
+
+#endif
+#endif
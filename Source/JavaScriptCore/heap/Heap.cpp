@@ -394,6 +394,11 @@ void Heap::reset(SweepToggle sweepToggle)
     markRoots();
     m_handleHeap.finalizeWeakHandles();
 
+#if ENABLE(JIT)
+    // Unmarked Structures are about to be freed, and their addresses may be reused.
+    m_globalData->jitStubs->megamorphicGetByIdCache().clear();
+#endif
+
     JAVASCRIPTCORE_GC_MARKED();
 
     m_markedSpace.reset();
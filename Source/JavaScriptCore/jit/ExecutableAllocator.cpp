@@ -77,6 +77,16 @@ size_t ExecutableAllocator::committedByteCount()
     return 0;
 } 
 
+size_t ExecutableAllocator::freeByteCount()
+{
+    return 0;
+}
+
+size_t ExecutableAllocator::largestFreeBlockByteCount()
+{
+    return 0;
+}
+
 #endif
 
 #if ENABLE(ASSEMBLER_WX_EXCLUSIVE)
@@ -330,6 +330,8 @@ public:
     #error "The cacheFlush support is missing on this platform."
 #endif
     static size_t committedByteCount();
+    static size_t freeByteCount();
+    static size_t largestFreeBlockByteCount();
 
 private:
 
@@ -34,7 +34,8 @@
 #include "TCSpinLock.h"
 #include <sys/mman.h>
 #include <unistd.h>
-#include <wtf/AVLTree.h>
+#include <wtf/DoublyLinkedList.h>
+#include <wtf/HashMap.h>
 #include <wtf/PageReservation.h>
 #include <wtf/VMTags.h>
 
@@ -46,408 +47,102 @@ using namespace WTF;
 
 namespace JSC {
     
-#define TwoPow(n) (1ull << n)
-
-class AllocationTableSizeClass {
-public:
-    AllocationTableSizeClass(size_t size, size_t blockSize, unsigned log2BlockSize)
-        : m_blockSize(blockSize)
-    {
-        ASSERT(blockSize == TwoPow(log2BlockSize));
-
-        // Calculate the number of blocks needed to hold size.
-        size_t blockMask = blockSize - 1;
-        m_blockCount = (size + blockMask) >> log2BlockSize;
-
-        // Align to the smallest power of two >= m_blockCount.
-        m_blockAlignment = 1;
-        while (m_blockAlignment < m_blockCount)
-            m_blockAlignment += m_blockAlignment;
-    }
-
-    size_t blockSize() const { return m_blockSize; }
-    size_t blockCount() const { return m_blockCount; }
-    size_t blockAlignment() const { return m_blockAlignment; }
-
-    size_t size()
-    {
-        return m_blockSize * m_blockCount;
-    }
-
-private:
-    size_t m_blockSize;
-    size_t m_blockCount;
-    size_t m_blockAlignment;
-};
-
-template<unsigned log2Entries>
-class AllocationTableLeaf {
-    typedef uint64_t BitField;
-
-public:
-    static const unsigned log2SubregionSize = 12; // 2^12 == pagesize
-    static const unsigned log2RegionSize = log2SubregionSize + log2Entries;
-
-    static const size_t subregionSize = TwoPow(log2SubregionSize);
-    static const size_t regionSize = TwoPow(log2RegionSize);
-    static const unsigned entries = TwoPow(log2Entries);
-    COMPILE_ASSERT(entries <= (sizeof(BitField) * 8), AllocationTableLeaf_entries_fit_in_BitField);
-
-    AllocationTableLeaf()
-        : m_allocated(0)
-    {
-    }
-
-    ~AllocationTableLeaf()
-    {
-        ASSERT(isEmpty());
-    }
-
-    size_t allocate(AllocationTableSizeClass& sizeClass)
-    {
-        ASSERT(sizeClass.blockSize() == subregionSize);
-        ASSERT(!isFull());
-
-        size_t alignment = sizeClass.blockAlignment();
-        size_t count = sizeClass.blockCount();
-        // Use this mask to check for spans of free blocks.
-        BitField mask = ((1ull << count) - 1) << (alignment - count);
-
-        // Step in units of alignment size.
-        for (unsigned i = 0; i < entries; i += alignment) {
-            if (!(m_allocated & mask)) {
-                m_allocated |= mask;
-                return (i + (alignment - count)) << log2SubregionSize;
-            }
-            mask <<= alignment;
-        }
-        return notFound;
-    }
-
-    void free(size_t location, AllocationTableSizeClass& sizeClass)
-    {
-        ASSERT(sizeClass.blockSize() == subregionSize);
-
-        size_t entry = location >> log2SubregionSize;
-        size_t count = sizeClass.blockCount();
-        BitField mask = ((1ull << count) - 1) << entry;
-
-        ASSERT((m_allocated & mask) == mask);
-        m_allocated &= ~mask;
-    }
-
-    bool isEmpty()
-    {
-        return !m_allocated;
-    }
-
-    bool isFull()
-    {
-        return !~m_allocated;
-    }
-
-    static size_t size()
-    {
-        return regionSize;
-    }
-
-    static AllocationTableSizeClass classForSize(size_t size)
-    {
-        return AllocationTableSizeClass(size, subregionSize, log2SubregionSize);
-    }
-
-#ifndef NDEBUG
-    void dump(size_t parentOffset = 0, unsigned indent = 0)
-    {
-        for (unsigned i = 0; i < indent; ++i)
-            fprintf(stderr, "    ");
-        fprintf(stderr, "%08x: [%016llx]\n", (int)parentOffset, m_allocated);
-    }
-#endif
-
-private:
-    BitField m_allocated;
-};
-
-
-template<class NextLevel>
-class LazyAllocationTable {
-public:
-    static const unsigned log2RegionSize = NextLevel::log2RegionSize;
-    static const unsigned entries = NextLevel::entries;
-
-    LazyAllocationTable()
-        : m_ptr(0)
-    {
-    }
-
-    ~LazyAllocationTable()
-    {
-        ASSERT(isEmpty());
-    }
-
-    size_t allocate(AllocationTableSizeClass& sizeClass)
-    {
-        if (!m_ptr)
-            m_ptr = new NextLevel();
-        return m_ptr->allocate(sizeClass);
-    }
-
-    void free(size_t location, AllocationTableSizeClass& sizeClass)
-    {
-        ASSERT(m_ptr);
-        m_ptr->free(location, sizeClass);
-        if (m_ptr->isEmpty()) {
-            delete m_ptr;
-            m_ptr = 0;
-        }
-    }
-
-    bool isEmpty()
-    {
-        return !m_ptr;
-    }
-
-    bool isFull()
-    {
-        return m_ptr && m_ptr->isFull();
-    }
-
-    static size_t size()
-    {
-        return NextLevel::size();
-    }
-
-#ifndef NDEBUG
-    void dump(size_t parentOffset = 0, unsigned indent = 0)
-    {
-        ASSERT(m_ptr);
-        m_ptr->dump(parentOffset, indent);
-    }
+#if CPU(ARM)
+static const size_t fixedPoolSize = 16 * 1024 * 1024;
+#elif CPU(X86_64)
+static const size_t fixedPoolSize = 1024 * 1024 * 1024;
+#else
+static const size_t fixedPoolSize = 32 * 1024 * 1024;
 #endif
 
-    static AllocationTableSizeClass classForSize(size_t size)
-    {
-        return NextLevel::classForSize(size);
-    }
-
-private:
-    NextLevel* m_ptr;
-};
-
-template<class NextLevel, unsigned log2Entries>
-class AllocationTableDirectory {
-    typedef uint64_t BitField;
-
+// A run of free pages in the pool. Free pages are decommitted, so this bookkeeping is kept
+// outside the pool itself.
+class FreeExtent {
 public:
-    static const unsigned log2SubregionSize = NextLevel::log2RegionSize;
-    static const unsigned log2RegionSize = log2SubregionSize + log2Entries;
-
-    static const size_t subregionSize = TwoPow(log2SubregionSize);
-    static const size_t regionSize = TwoPow(log2RegionSize);
-    static const unsigned entries = TwoPow(log2Entries);
-    COMPILE_ASSERT(entries <= (sizeof(BitField) * 8), AllocationTableDirectory_entries_fit_in_BitField);
-
-    AllocationTableDirectory()
-        : m_full(0)
-        , m_hasSuballocation(0)
+    FreeExtent(char* start, size_t size)
+        : m_start(start)
+        , m_size(size)
+        , m_prev(0)
+        , m_next(0)
     {
     }
 
-    ~AllocationTableDirectory()
-    {
-        ASSERT(isEmpty());
-    }
-
-    size_t allocate(AllocationTableSizeClass& sizeClass)
-    {
-        ASSERT(sizeClass.blockSize() <= subregionSize);
-        ASSERT(!isFull());
-
-        if (sizeClass.blockSize() < subregionSize) {
-            BitField bit = 1;
-            for (unsigned i = 0; i < entries; ++i, bit += bit) {
-                if (m_full & bit)
-                    continue;
-                size_t location = m_suballocations[i].allocate(sizeClass);
-                if (location != notFound) {
-                    // If this didn't already have a subregion, it does now!
-                    m_hasSuballocation |= bit;
-                    // Mirror the suballocation's full bit.
-                    if (m_suballocations[i].isFull())
-                        m_full |= bit;
-                    return (i * subregionSize) | location;
-                }
-            }
-            return notFound;
-        }
-
-        // A block is allocated if either it is fully allocated or contains suballocations.
-        BitField allocated = m_full | m_hasSuballocation;
+    char* start() const { return m_start; }
+    char* end() const { return m_start + m_size; }
+    size_t size() const { return m_size; }
 
-        size_t alignment = sizeClass.blockAlignment();
-        size_t count = sizeClass.blockCount();
-        // Use this mask to check for spans of free blocks.
-        BitField mask = ((1ull << count) - 1) << (alignment - count);
+    void setStart(char* start) { m_start = start; }
+    void setSize(size_t size) { m_size = size; }
 
-        // Step in units of alignment size.
-        for (unsigned i = 0; i < entries; i += alignment) {
-            if (!(allocated & mask)) {
-                m_full |= mask;
-                return (i + (alignment - count)) << log2SubregionSize;
-            }
-            mask <<= alignment;
-        }
-        return notFound;
-    }
-
-    void free(size_t location, AllocationTableSizeClass& sizeClass)
-    {
-        ASSERT(sizeClass.blockSize() <= subregionSize);
-
-        size_t entry = location >> log2SubregionSize;
-
-        if (sizeClass.blockSize() < subregionSize) {
-            BitField bit = 1ull << entry;
-            m_suballocations[entry].free(location & (subregionSize - 1), sizeClass);
-            // Check if the suballocation is now empty.
-            if (m_suballocations[entry].isEmpty())
-                m_hasSuballocation &= ~bit;
-            // No need to check, it clearly isn't full any more!
-            m_full &= ~bit;
-        } else {
-            size_t count = sizeClass.blockCount();
-            BitField mask = ((1ull << count) - 1) << entry;
-            ASSERT((m_full & mask) == mask);
-            ASSERT(!(m_hasSuballocation & mask));
-            m_full &= ~mask;
-        }
-    }
-
-    bool isEmpty()
-    {
-        return !(m_full | m_hasSuballocation);
-    }
-
-    bool isFull()
-    {   
-        return !~m_full;
-    }
-
-    static size_t size()
-    {
-        return regionSize;
-    }
-
-    static AllocationTableSizeClass classForSize(size_t size)
-    {
-        if (size < subregionSize) {
-            AllocationTableSizeClass sizeClass = NextLevel::classForSize(size);
-            if (sizeClass.size() < NextLevel::size())
-                return sizeClass;
-        }
-        return AllocationTableSizeClass(size, subregionSize, log2SubregionSize);
-    }
-
-#ifndef NDEBUG
-    void dump(size_t parentOffset = 0, unsigned indent = 0)
-    {
-        for (unsigned i = 0; i < indent; ++i)
-            fprintf(stderr, "    ");
-        fprintf(stderr, "%08x: [", (int)parentOffset);
-        for (unsigned i = 0; i < entries; ++i) {
-            BitField bit = 1ull << i;
-            char c = m_hasSuballocation & bit
-                ? (m_full & bit ? 'N' : 'n')
-                : (m_full & bit ? 'F' : '-');
-            fprintf(stderr, "%c", c);
-        }
-        fprintf(stderr, "]\n");
-
-        for (unsigned i = 0; i < entries; ++i) {
-            BitField bit = 1ull << i;
-            size_t offset = parentOffset | (subregionSize * i);
-            if (m_hasSuballocation & bit)
-                m_suballocations[i].dump(offset, indent + 1);
-        }
-    }
-#endif
+    FreeExtent* prev() const { return m_prev; }
+    FreeExtent* next() const { return m_next; }
+    void setPrev(FreeExtent* prev) { m_prev = prev; }
+    void setNext(FreeExtent* next) { m_next = next; }
 
 private:
-    NextLevel m_suballocations[entries];
-    // Subregions exist in one of four states:
-    // (1) empty (both bits clear)
-    // (2) fully allocated as a single allocation (m_full set)
-    // (3) partially allocated through suballocations (m_hasSuballocation set)
-    // (4) fully allocated through suballocations (both bits set)
-    BitField m_full;
-    BitField m_hasSuballocation;
+    char* m_start;
+    size_t m_size;
+    FreeExtent* m_prev;
+    FreeExtent* m_next;
 };
 
-
-typedef AllocationTableLeaf<6> PageTables256KB;
-typedef AllocationTableDirectory<PageTables256KB, 6> PageTables16MB;
-typedef AllocationTableDirectory<LazyAllocationTable<PageTables16MB>, 1> PageTables32MB;
-typedef AllocationTableDirectory<LazyAllocationTable<PageTables16MB>, 6> PageTables1GB;
-
-#if CPU(ARM)
-typedef PageTables16MB FixedVMPoolPageTables;
-#elif CPU(X86_64)
-typedef PageTables1GB FixedVMPoolPageTables;
-#else
-typedef PageTables32MB FixedVMPoolPageTables;
-#endif
-
-
+// Allocates whole pages from a single fixed reservation. Free extents are kept on one list per
+// size class, where size class n holds extents of between 2^n and 2^(n+1) - 1 pages. Allocation
+// takes the first extent that fits, searching up from the request's own size class and
+// splitting off whatever is left over. Freed pages are merged with any free neighbours, so the
+// pool does not splinter into runs too short to use.
 class FixedVMPoolAllocator
 {
+    static const unsigned numberOfSizeClasses = sizeof(size_t) * 8;
+
 public:
     FixedVMPoolAllocator()
+        : m_freeBytes(0)
+        , m_largestFreeExtent(0)
+        , m_largestFreeExtentIsStale(false)
     {
-        ASSERT(PageTables256KB::size() == 256 * 1024);
-        ASSERT(PageTables16MB::size() == 16 * 1024 * 1024);
-        ASSERT(PageTables32MB::size() == 32 * 1024 * 1024);
-        ASSERT(PageTables1GB::size() == 1024 * 1024 * 1024);
-
-        m_reservation = PageReservation::reserve(FixedVMPoolPageTables::size(), OSAllocator::JSJITCodePages, EXECUTABLE_POOL_WRITABLE, true);
+        m_reservation = PageReservation::reserve(fixedPoolSize, OSAllocator::JSJITCodePages, EXECUTABLE_POOL_WRITABLE, true);
 #if !ENABLE(INTERPRETER)
         if (!isValid())
             CRASH();
 #endif
+        if (isValid())
+            addFreeExtent(static_cast<char*>(m_reservation.base()), fixedPoolSize);
     }
  
     ExecutablePool::Allocation alloc(size_t requestedSize)
     {
         ASSERT(requestedSize);
-        AllocationTableSizeClass sizeClass = classForSize(requestedSize);
-        size_t size = sizeClass.size();
-        ASSERT(size);
+        size_t size = roundUpAllocationSize(requestedSize, ExecutableAllocator::pageSize);
 
-        if (size >= FixedVMPoolPageTables::size())
-            CRASH();
-        if (m_pages.isFull())
+        FreeExtent* extent = findFreeExtent(size);
+        if (!extent)
             CRASH();
 
-        size_t offset = m_pages.allocate(sizeClass);
-        if (offset == notFound)
-            CRASH();
+        char* pointer = extent->start();
+        removeFreeExtent(extent);
+        if (extent->size() > size) {
+            extent->setStart(pointer + size);
+            extent->setSize(extent->size() - size);
+            insertFreeExtent(extent);
+        } else
+            delete extent;
+        updateLargestFreeExtent();
 
-        void* pointer = offsetToPointer(offset);
         m_reservation.commit(pointer, size);
         return ExecutablePool::Allocation(pointer, size);
     }
 
     void free(ExecutablePool::Allocation allocation)
     {
-        void* pointer = allocation.base();
+        char* pointer = static_cast<char*>(allocation.base());
         size_t size = allocation.size();
         ASSERT(size);
+        ASSERT(!(size % ExecutableAllocator::pageSize));
 
         m_reservation.decommit(pointer, size);
-
-        AllocationTableSizeClass sizeClass = classForSize(size);
-        ASSERT(sizeClass.size() == size);
-        m_pages.free(pointerToOffset(pointer), sizeClass);
+        addFreeExtent(pointer, size);
+        updateLargestFreeExtent();
     }
 
     size_t allocated()
@@ -455,29 +150,123 @@ public:
         return m_reservation.committed();
     }
 
+    size_t freeBytes() const
+    {
+        return m_freeBytes;
+    }
+
+    size_t largestFreeExtent() const
+    {
+        return m_largestFreeExtent;
+    }
+
     bool isValid() const
     {
         return !!m_reservation;
     }
 
 private:
-    AllocationTableSizeClass classForSize(size_t size)
+    static unsigned sizeClassFor(size_t size)
     {
-        return FixedVMPoolPageTables::classForSize(size);
+        size_t pages = size / ExecutableAllocator::pageSize;
+        ASSERT(pages);
+        unsigned sizeClass = 0;
+        while (pages >>= 1)
+            ++sizeClass;
+        return sizeClass;
     }
 
-    void* offsetToPointer(size_t offset)
+    FreeExtent* findFreeExtent(size_t size)
     {
-        return reinterpret_cast<void*>(reinterpret_cast<intptr_t>(m_reservation.base()) + offset);
+        unsigned sizeClass = sizeClassFor(size);
+
+        // Extents in the request's own size class may still be too small.
+        for (FreeExtent* extent = m_freeLists[sizeClass].head(); extent; extent = extent->next()) {
+            if (extent->size() >= size)
+                return extent;
+        }
+
+        // Any extent in a larger size class will do.
+        for (++sizeClass; sizeClass < numberOfSizeClasses; ++sizeClass) {
+            if (FreeExtent* extent = m_freeLists[sizeClass].head())
+                return extent;
+        }
+        return 0;
+    }
+
+    // Removing the largest free extent only marks m_largestFreeExtent as stale, since an
+    // allocation or free usually puts a piece of it back straight away. It is brought up to
+    // date once the free lists have settled, by walking the highest non-empty size class.
+    void updateLargestFreeExtent()
+    {
+        if (!m_largestFreeExtentIsStale)
+            return;
+        m_largestFreeExtentIsStale = false;
+        m_largestFreeExtent = 0;
+        for (unsigned sizeClass = numberOfSizeClasses; sizeClass--; ) {
+            for (FreeExtent* extent = m_freeLists[sizeClass].head(); extent; extent = extent->next())
+                m_largestFreeExtent = std::max(m_largestFreeExtent, extent->size());
+            if (m_largestFreeExtent)
+                return;
+        }
     }
 
-    size_t pointerToOffset(void* pointer)
+    void addFreeExtent(char* start, size_t size)
     {
-        return reinterpret_cast<intptr_t>(pointer) - reinterpret_cast<intptr_t>(m_reservation.base());
+        FreeExtent* extent = 0;
+
+        // Coalesce with the free extents on either side, if there are any.
+        if (FreeExtent* before = m_freeExtentsByEnd.get(start)) {
+            removeFreeExtent(before);
+            before->setSize(before->size() + size);
+            extent = before;
+        }
+        if (FreeExtent* after = m_freeExtentsByStart.get(start + size)) {
+            removeFreeExtent(after);
+            if (extent) {
+                extent->setSize(extent->size() + after->size());
+                delete after;
+            } else {
+                after->setStart(start);
+                after->setSize(after->size() + size);
+                extent = after;
+            }
+        }
+        if (!extent)
+            extent = new FreeExtent(start, size);
+
+        insertFreeExtent(extent);
+    }
+
+    void insertFreeExtent(FreeExtent* extent)
+    {
+        m_freeLists[sizeClassFor(extent->size())].append(extent);
+        m_freeExtentsByStart.set(extent->start(), extent);
+        m_freeExtentsByEnd.set(extent->end(), extent);
+        m_freeBytes += extent->size();
+        if (extent->size() >= m_largestFreeExtent) {
+            m_largestFreeExtent = extent->size();
+            m_largestFreeExtentIsStale = false;
+        }
+    }
+
+    void removeFreeExtent(FreeExtent* extent)
+    {
+        m_freeLists[sizeClassFor(extent->size())].remove(extent);
+        m_freeExtentsByStart.remove(extent->start());
+        m_freeExtentsByEnd.remove(extent->end());
+        m_freeBytes -= extent->size();
+        if (extent->size() == m_largestFreeExtent)
+            m_largestFreeExtentIsStale = true;
     }
 
     PageReservation m_reservation;
-    FixedVMPoolPageTables m_pages;
+    DoublyLinkedList<FreeExtent> m_freeLists[numberOfSizeClasses];
+    HashMap<char*, FreeExtent*> m_freeExtentsByStart;
+    HashMap<char*, FreeExtent*> m_freeExtentsByEnd;
+    size_t m_freeBytes;
+    size_t m_largestFreeExtent;
+    bool m_largestFreeExtentIsStale;
 };
 
 
@@ -504,11 +293,29 @@ bool ExecutableAllocator::isValid() const
     return allocator->isValid();
 }
 
+size_t ExecutableAllocator::freeByteCount()
+{
+    SpinLockHolder lockHolder(&spinlock);
+    return allocator ? allocator->freeBytes() : 0;
+}
+
+size_t ExecutableAllocator::largestFreeBlockByteCount()
+{
+    SpinLockHolder lockHolder(&spinlock);
+    return allocator ? allocator->largestFreeExtent() : 0;
+}
+
 bool ExecutableAllocator::underMemoryPressure()
 {
     // Technically we should take the spin lock here, but we don't care if we get stale data.
     // This is only really a heuristic anyway.
-    return allocator && (allocator->allocated() > (FixedVMPoolPageTables::size() / 2));
+    if (!allocator)
+        return false;
+    if (allocator->allocated() > fixedPoolSize / 2)
+        return true;
+
+    // Plenty of free space is no use if it is all in small pieces.
+    return allocator->largestFreeExtent() < fixedPoolSize / 16;
 }
 
 ExecutablePool::Allocation ExecutablePool::systemAlloc(size_t size)
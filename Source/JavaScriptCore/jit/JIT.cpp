@@ -44,6 +44,7 @@ JSC::MacroAssemblerX86Common::SSE2CheckState JSC::MacroAssemblerX86Common::s_sse
 #include "RepatchBuffer.h"
 #include "ResultType.h"
 #include "SamplingTool.h"
+#include "dfg/DFGByteCodeParser.h"
 #include "dfg/DFGNode.h" // for DFG_SUCCESS_STATS
 
 using namespace std;
@@ -85,6 +86,12 @@ JIT::JIT(JSGlobalData* globalData, CodeBlock* codeBlock, void* linkerOffset)
 #else
     , m_lastResultBytecodeRegister(std::numeric_limits<int>::max())
     , m_jumpTargetsPosition(0)
+#endif
+#if ENABLE(DFG_JIT)
+    , m_canBeOptimized(false)
+#endif
+#if ENABLE(SAMPLING_PROFILER)
+    , m_mapsMachineCode(false)
 #endif
     , m_linkerOffset(linkerOffset)
 {
@@ -189,6 +196,20 @@ void JIT::privateCompileMainPass()
 #endif
 
         m_labels[m_bytecodeOffset] = label();
+#if ENABLE(SAMPLING_PROFILER)
+        if (m_mapsMachineCode)
+            m_machineCodeMap.append(MachineCodeMapRecord(m_labels[m_bytecodeOffset], m_bytecodeOffset));
+#endif
+
+#if ENABLE(DFG_JIT)
+        if (m_canBeOptimized) {
+            // Loop heads are jump targets, so nothing is cached in regT0 here.
+            if (m_isLoopHeader[m_bytecodeOffset])
+                emitOptimizationCheck(true);
+            // Record where optimized code may exit back in to this code.
+            m_codeBlock->baselineCodeMap().append(BytecodeOffsetToMachineCode(m_bytecodeOffset, m_lastResultBytecodeRegister));
+        }
+#endif
 
         switch (m_interpreter->getOpcodeID(currentInstruction->u.opcode)) {
         DEFINE_BINARY_OP(op_del_by_val)
@@ -377,6 +398,10 @@ void JIT::privateCompileSlowCases()
         m_bytecodeOffset = iter->to;
 #ifndef NDEBUG
         unsigned firstTo = m_bytecodeOffset;
+#endif
+#if ENABLE(SAMPLING_PROFILER)
+        if (m_mapsMachineCode)
+            m_machineCodeMap.append(MachineCodeMapRecord(label(), m_bytecodeOffset));
 #endif
         Instruction* currentInstruction = instructionsBegin + m_bytecodeOffset;
 
@@ -457,6 +482,71 @@ void JIT::privateCompileSlowCases()
 #endif
 }
 
+#if ENABLE(DFG_JIT)
+void JIT::findLoopHeaders()
+{
+    Instruction* instructionsBegin = m_codeBlock->instructions().begin();
+    unsigned instructionCount = m_codeBlock->instructions().size();
+    m_isLoopHeader.fill(false, instructionCount);
+
+    for (unsigned bytecodeOffset = 0; bytecodeOffset < instructionCount; ) {
+        Instruction* currentInstruction = instructionsBegin + bytecodeOffset;
+        OpcodeID opcodeID = m_interpreter->getOpcodeID(currentInstruction->u.opcode);
+        switch (opcodeID) {
+        case op_loop:
+            m_isLoopHeader[bytecodeOffset + currentInstruction[1].u.operand] = true;
+            break;
+        case op_loop_if_true:
+        case op_loop_if_false:
+            m_isLoopHeader[bytecodeOffset + currentInstruction[2].u.operand] = true;
+            break;
+        case op_loop_if_less:
+        case op_loop_if_lesseq:
+            m_isLoopHeader[bytecodeOffset + currentInstruction[3].u.operand] = true;
+            break;
+        default:
+            break;
+        }
+        bytecodeOffset += opcodeLengths[opcodeID];
+    }
+}
+
+void JIT::emitOptimizationCheck(bool isLoopHeader)
+{
+    move(TrustedImmPtr(m_codeBlock->addressOfExecuteCounter()), regT1);
+    Jump trigger = branchSub32(Zero, TrustedImm32(1), Address(regT1));
+    m_optimizationChecks.append(OptimizationCheckRecord(trigger, label(), isLoopHeader ? m_bytecodeOffset : 0, isLoopHeader));
+}
+
+void JIT::privateCompileOptimizationChecks()
+{
+    for (unsigned i = 0; i < m_optimizationChecks.size(); ++i) {
+        OptimizationCheckRecord& check = m_optimizationChecks[i];
+        check.trigger.link(this);
+        m_bytecodeOffset = check.bytecodeOffset;
+
+        // On function entry the optimized code is only used by subsequent calls.
+        if (!check.isLoopHeader) {
+            JITStubCall(this, cti_optimize_from_prologue).call();
+            jump(check.done);
+            continue;
+        }
+
+        // At a loop head we may be able to continue running in the optimized code.
+        JITStubCall stubCall(this, cti_optimize_from_loop);
+        stubCall.addArgument(TrustedImm32(check.bytecodeOffset));
+        stubCall.call();
+        branchTestPtr(Zero, regT0).linkTo(check.done, this);
+        jump(regT0);
+    }
+
+#ifndef NDEBUG
+    // Reset this, in order to guard its use with ASSERTs.
+    m_bytecodeOffset = (unsigned)-1;
+#endif
+}
+#endif
+
 JITCode JIT::privateCompile(CodePtr* functionEntryArityCheck)
 {
     // Could use a pop_m, but would need to offset the following instruction if so.
@@ -465,6 +555,10 @@ JITCode JIT::privateCompile(CodePtr* functionEntryArityCheck)
 
     Label beginLabel(this);
 
+#if ENABLE(SAMPLING_PROFILER)
+    m_mapsMachineCode = m_globalData->samplingProfiler;
+#endif
+
     sampleCodeBlock(m_codeBlock);
 #if ENABLE(OPCODE_SAMPLING)
     sampleInstruction(m_codeBlock->instructions().begin());
@@ -480,8 +574,18 @@ JITCode JIT::privateCompile(CodePtr* functionEntryArityCheck)
         // In the case of a fast linked call, we do not set this up in the caller.
         emitPutImmediateToCallFrameHeader(m_codeBlock, RegisterFile::CodeBlock);
 
+        store32(TrustedImm32(1), m_codeBlock->addressOfWasExecuted());
+
         addPtr(Imm32(m_codeBlock->m_numCalleeRegisters * sizeof(Register)), callFrameRegister, regT1);
         registerFileCheck = branchPtr(Below, AbsoluteAddress(m_globalData->interpreter->registerFile().addressOfEnd()), regT1);
+
+#if ENABLE(DFG_JIT)
+        m_canBeOptimized = !m_codeBlock->m_isConstructor && DFG::canCompileOpcodes(m_globalData, m_codeBlock);
+        if (m_canBeOptimized) {
+            findLoopHeaders();
+            emitOptimizationCheck(false);
+        }
+#endif
     }
 
     Label functionBody = label();
@@ -489,6 +593,13 @@ JITCode JIT::privateCompile(CodePtr* functionEntryArityCheck)
     privateCompileMainPass();
     privateCompileLinkPass();
     privateCompileSlowCases();
+#if ENABLE(SAMPLING_PROFILER)
+    if (m_mapsMachineCode)
+        m_machineCodeMap.append(MachineCodeMapRecord(label(), MachineCodeToBytecodeOffset::noBytecodeOffset));
+#endif
+#if ENABLE(DFG_JIT)
+    privateCompileOptimizationChecks();
+#endif
 
     Label arityCheck;
     if (m_codeBlock->codeType() == FunctionCode) {
@@ -559,6 +670,12 @@ JITCode JIT::privateCompile(CodePtr* functionEntryArityCheck)
             m_codeBlock->callReturnIndexVector().append(CallReturnOffsetToBytecodeOffset(patchBuffer.returnAddressOffset(iter->from), iter->bytecodeOffset));
     }
 
+#if ENABLE(DFG_JIT)
+    Vector<BytecodeOffsetToMachineCode>& baselineCodeMap = m_codeBlock->baselineCodeMap();
+    for (unsigned i = 0; i < baselineCodeMap.size(); ++i)
+        baselineCodeMap[i].machineCode = patchBuffer.locationOf(m_labels[baselineCodeMap[i].bytecodeOffset]);
+#endif
+
     // Link absolute addresses for jsr
     for (Vector<JSRInfo>::iterator iter = m_jsrSites.begin(); iter != m_jsrSites.end(); ++iter)
         patchBuffer.patch(iter->storeLocation, patchBuffer.locationOf(iter->target).executableAddress());
@@ -573,6 +690,7 @@ JITCode JIT::privateCompile(CodePtr* functionEntryArityCheck)
 #if ENABLE(JIT_OPTIMIZE_CALL)
     for (unsigned i = 0; i < m_codeBlock->numberOfCallLinkInfos(); ++i) {
         CallLinkInfo& info = m_codeBlock->callLinkInfo(i);
+        info.ownerCodeBlock = m_codeBlock;
         info.callReturnLocation = patchBuffer.locationOfNearCall(m_callStructureStubCompilationInfo[i].callReturnLocation);
         info.hotPathBegin = patchBuffer.locationOf(m_callStructureStubCompilationInfo[i].hotPathBegin);
         info.hotPathOther = patchBuffer.locationOfNearCall(m_callStructureStubCompilationInfo[i].hotPathOther);
@@ -586,6 +704,16 @@ JITCode JIT::privateCompile(CodePtr* functionEntryArityCheck)
         info.callReturnLocation = m_codeBlock->structureStubInfo(m_methodCallCompilationInfo[i].propertyAccessIndex).callReturnLocation;
     }
 
+#if ENABLE(SAMPLING_PROFILER)
+    if (m_mapsMachineCode) {
+        Vector<MachineCodeToBytecodeOffset> machineCodeMap;
+        machineCodeMap.reserveCapacity(m_machineCodeMap.size());
+        for (unsigned i = 0; i < m_machineCodeMap.size(); ++i)
+            machineCodeMap.append(MachineCodeToBytecodeOffset(patchBuffer.locationOf(m_machineCodeMap[i].label).executableAddress(), m_machineCodeMap[i].bytecodeOffset));
+        m_codeBlock->addMachineCodeMap(machineCodeMap);
+    }
+#endif
+
     if (m_codeBlock->codeType() == FunctionCode && functionEntryArityCheck)
         *functionEntryArityCheck = patchBuffer.locationOf(arityCheck);
 
@@ -603,6 +731,9 @@ void JIT::linkCall(JSFunction* callee, CodeBlock* callerCodeBlock, CodeBlock* ca
     if (!calleeCodeBlock || (callerArgCount == calleeCodeBlock->m_numParameters)) {
         ASSERT(!callLinkInfo->isLinked());
         callLinkInfo->callee.set(*globalData, callerCodeBlock->ownerExecutable(), callee);
+        callLinkInfo->isCall = true;
+        if (calleeCodeBlock)
+            calleeCodeBlock->linkIncomingCall(callLinkInfo);
         repatchBuffer.repatch(callLinkInfo->hotPathBegin, callee);
         repatchBuffer.relink(callLinkInfo->hotPathOther, code);
     }
@@ -620,6 +751,9 @@ void JIT::linkConstruct(JSFunction* callee, CodeBlock* callerCodeBlock, CodeBloc
     if (!calleeCodeBlock || (callerArgCount == calleeCodeBlock->m_numParameters)) {
         ASSERT(!callLinkInfo->isLinked());
         callLinkInfo->callee.set(*globalData, callerCodeBlock->ownerExecutable(), callee);
+        callLinkInfo->isCall = false;
+        if (calleeCodeBlock)
+            calleeCodeBlock->linkIncomingCall(callLinkInfo);
         repatchBuffer.repatch(callLinkInfo->hotPathBegin, callee);
         repatchBuffer.relink(callLinkInfo->hotPathOther, code);
     }
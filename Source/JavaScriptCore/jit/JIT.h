@@ -139,6 +139,25 @@ namespace JSC {
         }
     };
 
+#if ENABLE(DFG_JIT)
+    // A check of the execute counter, in the function's prologue or at the head of a loop,
+    // that calls out to have the function optimized once it reaches zero.
+    struct OptimizationCheckRecord {
+        OptimizationCheckRecord(MacroAssembler::Jump trigger, MacroAssembler::Label done, unsigned bytecodeOffset, bool isLoopHeader)
+            : trigger(trigger)
+            , done(done)
+            , bytecodeOffset(bytecodeOffset)
+            , isLoopHeader(isLoopHeader)
+        {
+        }
+
+        MacroAssembler::Jump trigger;
+        MacroAssembler::Label done;
+        unsigned bytecodeOffset;
+        bool isLoopHeader;
+    };
+#endif
+
     struct PropertyStubCompilationInfo {
         MacroAssembler::Call callReturnLocation;
         MacroAssembler::Label hotPathBegin;
@@ -258,11 +277,29 @@ namespace JSC {
             }
         };
 
+#if ENABLE(SAMPLING_PROFILER)
+        struct MachineCodeMapRecord {
+            Label label;
+            unsigned bytecodeOffset;
+
+            MachineCodeMapRecord(Label label, unsigned bytecodeOffset)
+                : label(label)
+                , bytecodeOffset(bytecodeOffset)
+            {
+            }
+        };
+#endif
+
         JIT(JSGlobalData*, CodeBlock* = 0, void* = 0);
 
         void privateCompileMainPass();
         void privateCompileLinkPass();
         void privateCompileSlowCases();
+#if ENABLE(DFG_JIT)
+        void findLoopHeaders();
+        void emitOptimizationCheck(bool isLoopHeader);
+        void privateCompileOptimizationChecks();
+#endif
         JITCode privateCompile(CodePtr* functionEntryArityCheck);
         void privateCompileGetByIdProto(StructureStubInfo*, Structure*, Structure* prototypeStructure, const Identifier&, const PropertySlot&, size_t cachedOffset, ReturnAddressPtr returnAddress, CallFrame* callFrame);
         void privateCompileGetByIdSelfList(StructureStubInfo*, PolymorphicAccessStructureList*, int, Structure*, const Identifier&, const PropertySlot&, size_t cachedOffset);
@@ -987,6 +1024,17 @@ namespace JSC {
         unsigned m_jumpTargetsPosition;
 #endif
 
+#if ENABLE(DFG_JIT)
+        bool m_canBeOptimized;
+        Vector<bool> m_isLoopHeader;
+        Vector<OptimizationCheckRecord> m_optimizationChecks;
+#endif
+
+#if ENABLE(SAMPLING_PROFILER)
+        bool m_mapsMachineCode;
+        Vector<MachineCodeMapRecord> m_machineCodeMap;
+#endif
+
 #ifndef NDEBUG
 #if defined(ASSEMBLER_HAS_CONSTANT_POOL) && ASSEMBLER_HAS_CONSTANT_POOL
         Label m_uninterruptedInstructionSequenceBegin;
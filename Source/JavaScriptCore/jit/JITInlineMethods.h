@@ -89,6 +89,8 @@ ALWAYS_INLINE void JIT::emitLoadCharacterString(RegisterID src, RegisterID dst,
     failures.append(branch32(NotEqual, MacroAssembler::Address(src, ThunkHelpers::jsStringLengthOffset()), TrustedImm32(1)));
     loadPtr(MacroAssembler::Address(src, ThunkHelpers::jsStringValueOffset()), dst);
     loadPtr(MacroAssembler::Address(dst, ThunkHelpers::stringImplDataOffset()), dst);
+    // 8-bit strings have no UTF-16 data until the slow case asks for it.
+    failures.append(branchTestPtr(Zero, dst));
     load16(MacroAssembler::Address(dst, 0), dst);
 }
 
@@ -61,6 +61,8 @@ JIT::CodePtr JIT::stringGetByValStubGenerator(JSGlobalData* globalData, Executab
     jit.load32(Address(regT0, ThunkHelpers::jsStringLengthOffset()), regT2);
     jit.loadPtr(Address(regT0, ThunkHelpers::jsStringValueOffset()), regT0);
     jit.loadPtr(Address(regT0, ThunkHelpers::stringImplDataOffset()), regT0);
+    // 8-bit strings have no UTF-16 data until the slow case asks for it.
+    failures.append(jit.branchTestPtr(Zero, regT0));
     
     // Do an unsigned compare to simultaneously filter negative indices as well as indices that are too large
     failures.append(jit.branch32(AboveOrEqual, regT1, regT2));
@@ -205,6 +207,19 @@ void JIT::emit_op_put_by_val(Instruction* currentInstruction)
 
     Label storeResult(this);
     emitGetVirtualRegister(value, regT0);
+
+    // Keep the vector type in step with the value being stored; see ArrayStorageType.
+    Jump vectorIsGeneric = branch32(Equal, Address(regT2, OBJECT_OFFSETOF(ArrayStorage, m_vectorType)), TrustedImm32(GenericArrayStorage));
+    Jump valueIsInt32 = emitJumpIfImmediateInteger(regT0);
+    Jump valueIsNotNumber = emitJumpIfNotImmediateNumber(regT0);
+    store32(TrustedImm32(DoubleArrayStorage), Address(regT2, OBJECT_OFFSETOF(ArrayStorage, m_vectorType)));
+    Jump vectorTypeUpdated = jump();
+    valueIsNotNumber.link(this);
+    store32(TrustedImm32(GenericArrayStorage), Address(regT2, OBJECT_OFFSETOF(ArrayStorage, m_vectorType)));
+    vectorIsGeneric.link(this);
+    valueIsInt32.link(this);
+    vectorTypeUpdated.link(this);
+
     storePtr(regT0, BaseIndex(regT2, regT1, ScalePtr, OBJECT_OFFSETOF(ArrayStorage, m_vector[0])));
     Jump end = jump();
     
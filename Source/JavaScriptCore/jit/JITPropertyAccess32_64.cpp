@@ -278,6 +278,8 @@ JIT::CodePtr JIT::stringGetByValStubGenerator(JSGlobalData* globalData, Executab
     jit.load32(Address(regT0, ThunkHelpers::jsStringLengthOffset()), regT1);
     jit.loadPtr(Address(regT0, ThunkHelpers::jsStringValueOffset()), regT0);
     jit.loadPtr(Address(regT0, ThunkHelpers::stringImplDataOffset()), regT0);
+    // 8-bit strings have no UTF-16 data until the slow case asks for it.
+    failures.append(jit.branchTestPtr(Zero, regT0));
     
     // Do an unsigned compare to simultaneously filter negative indices as well as indices that are too large
     failures.append(jit.branch32(AboveOrEqual, regT2, regT1));
@@ -370,6 +372,19 @@ void JIT::emit_op_put_by_val(Instruction* currentInstruction)
     
     Label storeResult(this);
     emitLoad(value, regT1, regT0);
+
+    // Keep the vector type in step with the value being stored; see ArrayStorageType.
+    Jump vectorIsGeneric = branch32(Equal, Address(regT3, OBJECT_OFFSETOF(ArrayStorage, m_vectorType)), TrustedImm32(GenericArrayStorage));
+    Jump valueIsInt32 = branch32(Equal, regT1, TrustedImm32(JSValue::Int32Tag));
+    Jump valueIsNotNumber = branch32(AboveOrEqual, regT1, TrustedImm32(JSValue::LowestTag));
+    store32(TrustedImm32(DoubleArrayStorage), Address(regT3, OBJECT_OFFSETOF(ArrayStorage, m_vectorType)));
+    Jump vectorTypeUpdated = jump();
+    valueIsNotNumber.link(this);
+    store32(TrustedImm32(GenericArrayStorage), Address(regT3, OBJECT_OFFSETOF(ArrayStorage, m_vectorType)));
+    vectorIsGeneric.link(this);
+    valueIsInt32.link(this);
+    vectorTypeUpdated.link(this);
+
     store32(regT0, BaseIndex(regT3, regT2, TimesEight, OBJECT_OFFSETOF(ArrayStorage, m_vector[0]) + OBJECT_OFFSETOF(JSValue, u.asBits.payload))); // payload
     store32(regT1, BaseIndex(regT3, regT2, TimesEight, OBJECT_OFFSETOF(ArrayStorage, m_vector[0]) + OBJECT_OFFSETOF(JSValue, u.asBits.tag))); // tag
     Jump end = jump();
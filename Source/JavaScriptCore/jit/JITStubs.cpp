@@ -1374,6 +1374,47 @@ DEFINE_STUB_FUNCTION(void*, register_file_check)
     return callFrame;
 }
 
+#if ENABLE(DFG_JIT)
+DEFINE_STUB_FUNCTION(void, optimize_from_prologue)
+{
+    STUB_INIT_STACK_FRAME(stackFrame);
+    CallFrame* callFrame = stackFrame.callFrame;
+    CodeBlock* codeBlock = callFrame->codeBlock();
+
+    // Either we already tried, or the optimized code has been abandoned after
+    // failed speculation and calls are being diverted back to this code.
+    if (!codeBlock->canBeOptimized()) {
+        codeBlock->dontOptimizeAnytimeSoon();
+        return;
+    }
+
+    static_cast<FunctionExecutable*>(codeBlock->ownerExecutable())->optimizeForCall(*stackFrame.globalData);
+}
+
+DEFINE_STUB_FUNCTION(void*, optimize_from_loop)
+{
+    STUB_INIT_STACK_FRAME(stackFrame);
+    CallFrame* callFrame = stackFrame.callFrame;
+    CodeBlock* codeBlock = callFrame->codeBlock();
+    unsigned bytecodeOffset = stackFrame.args[0].int32();
+
+    if (codeBlock->canBeOptimized()) {
+        if (!static_cast<FunctionExecutable*>(codeBlock->ownerExecutable())->optimizeForCall(*stackFrame.globalData))
+            return 0;
+    } else if (!codeBlock->hasOptimizedJITCode() || codeBlock->hasTooManySpeculationFailures()) {
+        codeBlock->dontOptimizeAnytimeSoon();
+        return 0;
+    }
+    codeBlock->optimizeAfterWarmUp();
+
+    // The optimized code may use more registers than the baseline code checked for on entry.
+    if (!stackFrame.registerFile->grow(&callFrame->registers()[codeBlock->m_numCalleeRegisters]))
+        return 0;
+
+    return codeBlock->optimizedEntryForBytecodeOffset(bytecodeOffset).executableAddress();
+}
+#endif
+
 DEFINE_STUB_FUNCTION(int, op_loop_if_lesseq)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
@@ -1412,6 +1453,65 @@ DEFINE_STUB_FUNCTION(void, op_put_by_id_direct_generic)
     CHECK_FOR_EXCEPTION_AT_END();
 }
 
+static inline bool getByIdFromMegamorphicCache(CallFrame* callFrame, JSValue baseValue, const Identifier& propertyName, JSValue& result)
+{
+    if (!baseValue.isCell())
+        return false;
+
+    MegamorphicGetByIdCache& cache = callFrame->globalData().jitStubs->megamorphicGetByIdCache();
+    Structure* structure = baseValue.asCell()->structure();
+    MegamorphicGetByIdCache::Entry& entry = cache.entryFor(structure, propertyName.impl());
+    if (entry.structure != structure || entry.propertyName != propertyName.impl()) {
+        cache.didMiss();
+        return false;
+    }
+
+    if (!entry.prototypeStructure) {
+        result = asObject(baseValue)->getDirectOffset(entry.offset);
+        cache.didHit();
+        return true;
+    }
+
+    // The base structure cannot have changed, so neither can the prototype object. Only the
+    // layout of the prototype needs to be checked.
+    JSValue prototype = structure->storedPrototype();
+    if (!prototype.isCell() || prototype.asCell()->structure() != entry.prototypeStructure) {
+        cache.didMiss();
+        return false;
+    }
+
+    result = asObject(prototype)->getDirectOffset(entry.offset);
+    cache.didHit();
+    return true;
+}
+
+static inline void addToMegamorphicCache(CallFrame* callFrame, JSValue baseValue, const Identifier& propertyName, const PropertySlot& slot)
+{
+    if (!baseValue.isCell() || !slot.isCacheableValue())
+        return;
+
+    Structure* structure = baseValue.asCell()->structure();
+    if (structure->isUncacheableDictionary())
+        return;
+
+    Structure* prototypeStructure = 0;
+    if (slot.slotBase() != baseValue) {
+        // Properties added to a dictionary don't change its structure, so a dictionary
+        // base could start shadowing the prototype without the cache noticing.
+        if (structure->isDictionary() || slot.slotBase() != structure->storedPrototype())
+            return;
+        prototypeStructure = asObject(slot.slotBase())->structure();
+        if (prototypeStructure->isDictionary())
+            return;
+    }
+
+    MegamorphicGetByIdCache::Entry& entry = callFrame->globalData().jitStubs->megamorphicGetByIdCache().entryFor(structure, propertyName.impl());
+    entry.structure = structure;
+    entry.propertyName = propertyName.impl();
+    entry.prototypeStructure = prototypeStructure;
+    entry.offset = slot.cachedOffset();
+}
+
 DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_generic)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
@@ -1420,10 +1520,15 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_generic)
     Identifier& ident = stackFrame.args[1].identifier();
 
     JSValue baseValue = stackFrame.args[0].jsValue();
+    JSValue result;
+    if (getByIdFromMegamorphicCache(callFrame, baseValue, ident, result))
+        return JSValue::encode(result);
+
     PropertySlot slot(baseValue);
-    JSValue result = baseValue.get(callFrame, ident, slot);
+    result = baseValue.get(callFrame, ident, slot);
+    CHECK_FOR_EXCEPTION();
 
-    CHECK_FOR_EXCEPTION_AT_END();
+    addToMegamorphicCache(callFrame, baseValue, ident, slot);
     return JSValue::encode(result);
 }
 
@@ -1640,8 +1745,10 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_self_fail)
             stubInfo->u.getByIdSelfList.listSize++;
             JIT::compileGetByIdSelfList(callFrame->scopeChain()->globalData, codeBlock, stubInfo, polymorphicStructureList, listIndex, baseValue.asCell()->structure(), ident, slot, slot.cachedOffset());
 
-            if (listIndex == (POLYMORPHIC_LIST_CACHE_SIZE - 1))
+            if (listIndex == (POLYMORPHIC_LIST_CACHE_SIZE - 1)) {
+                stubInfo->setMegamorphic();
                 ctiPatchCallByReturnAddress(codeBlock, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_generic));
+            }
         }
     } else
         ctiPatchCallByReturnAddress(callFrame->codeBlock(), STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_generic));
@@ -1752,8 +1859,10 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_proto_list)
         if (listIndex < POLYMORPHIC_LIST_CACHE_SIZE) {
             JIT::compileGetByIdProtoList(callFrame->scopeChain()->globalData, callFrame, codeBlock, stubInfo, prototypeStructureList, listIndex, structure, slotBaseObject->structure(), propertyName, slot, offset);
 
-            if (listIndex == (POLYMORPHIC_LIST_CACHE_SIZE - 1))
+            if (listIndex == (POLYMORPHIC_LIST_CACHE_SIZE - 1)) {
+                stubInfo->setMegamorphic();
                 ctiPatchCallByReturnAddress(codeBlock, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_proto_list_full));
+            }
         }
     } else if (size_t count = normalizePrototypeChain(callFrame, baseValue, slot.slotBase(), propertyName, offset)) {
         ASSERT(!baseValue.asCell()->structure()->isDictionary());
@@ -1764,8 +1873,10 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_proto_list)
             StructureChain* protoChain = structure->prototypeChain(callFrame);
             JIT::compileGetByIdChainList(callFrame->scopeChain()->globalData, callFrame, codeBlock, stubInfo, prototypeStructureList, listIndex, structure, protoChain, count, propertyName, slot, offset);
 
-            if (listIndex == (POLYMORPHIC_LIST_CACHE_SIZE - 1))
+            if (listIndex == (POLYMORPHIC_LIST_CACHE_SIZE - 1)) {
+                stubInfo->setMegamorphic();
                 ctiPatchCallByReturnAddress(codeBlock, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_proto_list_full));
+            }
         }
     } else
         ctiPatchCallByReturnAddress(codeBlock, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_proto_fail));
@@ -1777,11 +1888,19 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_proto_list_full)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
 
+    CallFrame* callFrame = stackFrame.callFrame;
+    const Identifier& propertyName = stackFrame.args[1].identifier();
+
     JSValue baseValue = stackFrame.args[0].jsValue();
+    JSValue result;
+    if (getByIdFromMegamorphicCache(callFrame, baseValue, propertyName, result))
+        return JSValue::encode(result);
+
     PropertySlot slot(baseValue);
-    JSValue result = baseValue.get(stackFrame.callFrame, stackFrame.args[1].identifier(), slot);
+    result = baseValue.get(callFrame, propertyName, slot);
+    CHECK_FOR_EXCEPTION();
 
-    CHECK_FOR_EXCEPTION_AT_END();
+    addToMegamorphicCache(callFrame, baseValue, propertyName, slot);
     return JSValue::encode(result);
 }
 
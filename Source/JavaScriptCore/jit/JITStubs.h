@@ -34,6 +34,7 @@
 #include "MacroAssemblerCodeRef.h"
 #include "Register.h"
 #include "ThunkGenerators.h"
+#include <wtf/Forward.h>
 #include <wtf/HashMap.h>
 
 #if ENABLE(JIT)
@@ -58,6 +59,7 @@ namespace JSC {
     class PutPropertySlot;
     class RegisterFile;
     class RegExp;
+    class Structure;
 
     union JITStubArg {
         void* asPointer;
@@ -277,6 +279,46 @@ namespace JSC {
 
     template <typename T> class Strong;
 
+    // Shared by all get_by_id sites that have seen more structures than fit in their
+    // polymorphic lists. Maps a (Structure, property name) pair to the offset of the
+    // property, either on the base object itself or on its immediate prototype. Entries
+    // hold no references, so the cache is cleared by every garbage collection.
+    class MegamorphicGetByIdCache {
+    public:
+        struct Entry {
+            Structure* structure;
+            StringImpl* propertyName;
+            Structure* prototypeStructure;
+            size_t offset;
+        };
+
+        MegamorphicGetByIdCache()
+            : m_hits(0)
+            , m_misses(0)
+        {
+            clear();
+        }
+
+        Entry& entryFor(Structure* structure, StringImpl* propertyName)
+        {
+            unsigned hash = (static_cast<unsigned>(reinterpret_cast<uintptr_t>(structure)) >> 4) ^ static_cast<unsigned>(reinterpret_cast<uintptr_t>(propertyName) >> 3);
+            return m_entries[hash & (cacheSize - 1)];
+        }
+
+        void clear() { memset(m_entries, 0, sizeof(m_entries)); }
+
+        void didHit() { ++m_hits; }
+        void didMiss() { ++m_misses; }
+        unsigned hits() const { return m_hits; }
+        unsigned misses() const { return m_misses; }
+
+    private:
+        static const unsigned cacheSize = 512;
+        Entry m_entries[cacheSize];
+        unsigned m_hits;
+        unsigned m_misses;
+    };
+
     class JITThunks {
     public:
         JITThunks(JSGlobalData*);
@@ -301,6 +343,8 @@ namespace JSC {
 
         void clearHostFunctionStubs();
 
+        MegamorphicGetByIdCache& megamorphicGetByIdCache() { return m_megamorphicGetByIdCache; }
+
     private:
         typedef HashMap<ThunkGenerator, MacroAssemblerCodePtr> CTIStubMap;
         CTIStubMap m_ctiStubMap;
@@ -309,6 +353,7 @@ namespace JSC {
         RefPtr<ExecutablePool> m_executablePool;
 
         TrampolineStructure m_trampolineStructure;
+        MegamorphicGetByIdCache m_megamorphicGetByIdCache;
     };
 
 extern "C" {
@@ -419,6 +464,9 @@ extern "C" {
     void JIT_STUB cti_op_tear_off_activation(STUB_ARGS_DECLARATION);
     void JIT_STUB cti_op_tear_off_arguments(STUB_ARGS_DECLARATION);
     void JIT_STUB cti_op_throw_reference_error(STUB_ARGS_DECLARATION);
+#if ENABLE(DFG_JIT)
+    void JIT_STUB cti_optimize_from_prologue(STUB_ARGS_DECLARATION);
+#endif
     void* JIT_STUB cti_op_call_arityCheck(STUB_ARGS_DECLARATION);
     void* JIT_STUB cti_op_construct_arityCheck(STUB_ARGS_DECLARATION);
     void* JIT_STUB cti_op_call_jitCompile(STUB_ARGS_DECLARATION);
@@ -428,6 +476,9 @@ extern "C" {
     void* JIT_STUB cti_op_switch_string(STUB_ARGS_DECLARATION);
     void* JIT_STUB cti_op_throw(STUB_ARGS_DECLARATION);
     void* JIT_STUB cti_register_file_check(STUB_ARGS_DECLARATION);
+#if ENABLE(DFG_JIT)
+    void* JIT_STUB cti_optimize_from_loop(STUB_ARGS_DECLARATION);
+#endif
     void* JIT_STUB cti_vm_lazyLinkCall(STUB_ARGS_DECLARATION);
     void* JIT_STUB cti_vm_lazyLinkConstruct(STUB_ARGS_DECLARATION);
     void* JIT_STUB cti_vm_throw(STUB_ARGS_DECLARATION);
@@ -31,7 +31,11 @@
 #include "JSFunction.h"
 #include "JSLock.h"
 #include "JSString.h"
+#include "RegExpCache.h"
+#include "SamplingProfiler.h"
 #include "SamplingTool.h"
+#include "SourceCode.h"
+#include "UStringConcatenate.h"
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -70,6 +74,8 @@ using namespace WTF;
 
 static void cleanupGlobalData(JSGlobalData*);
 static bool fillBufferWithContentsOfFile(const UString& fileName, Vector<char>& buffer);
+static unsigned loadParseCache(JSGlobalData*, const UString& fileName, SourceProvider*);
+static void saveParseCache(const UString& fileName, SourceProvider*);
 
 static EncodedJSValue JSC_HOST_CALL functionPrint(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionDebug(ExecState*);
@@ -79,6 +85,7 @@ static EncodedJSValue JSC_HOST_CALL functionRun(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionLoad(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionCheckSyntax(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionReadline(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionRegExpCacheStatistics(ExecState*);
 static NO_RETURN_WITH_VALUE EncodedJSValue JSC_HOST_CALL functionQuit(ExecState*);
 
 #if ENABLE(SAMPLING_FLAGS)
@@ -101,11 +108,15 @@ struct Options {
     Options()
         : interactive(false)
         , dump(false)
+        , useParseCache(false)
+        , samplingInterval(0)
     {
     }
 
     bool interactive;
     bool dump;
+    bool useParseCache;
+    unsigned samplingInterval;
     Vector<Script> scripts;
     Vector<UString> arguments;
 };
@@ -159,6 +170,7 @@ GlobalObject::GlobalObject(JSGlobalData& globalData, const Vector<UString>& argu
     putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 1, Identifier(globalExec(), "load"), functionLoad));
     putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 1, Identifier(globalExec(), "checkSyntax"), functionCheckSyntax));
     putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "readline"), functionReadline));
+    putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "regExpCacheStatistics"), functionRegExpCacheStatistics));
 
 #if ENABLE(SAMPLING_FLAGS)
     putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 1, Identifier(globalExec(), "setSamplingFlags"), functionSetSamplingFlags));
@@ -291,6 +303,20 @@ EncodedJSValue JSC_HOST_CALL functionReadline(ExecState* exec)
     return JSValue::encode(jsString(exec, line.data()));
 }
 
+EncodedJSValue JSC_HOST_CALL functionRegExpCacheStatistics(ExecState* exec)
+{
+    RegExpCache* cache = exec->globalData().regExpCache();
+    const RegExpCache::Statistics& statistics = cache->statistics();
+
+    JSObject* result = constructEmptyObject(exec);
+    result->putDirect(exec->globalData(), Identifier(exec, "hits"), jsNumber(statistics.hits));
+    result->putDirect(exec->globalData(), Identifier(exec, "misses"), jsNumber(statistics.misses));
+    result->putDirect(exec->globalData(), Identifier(exec, "evictions"), jsNumber(statistics.evictions));
+    result->putDirect(exec->globalData(), Identifier(exec, "entries"), jsNumber(cache->entryCount()));
+    result->putDirect(exec->globalData(), Identifier(exec, "bytes"), jsNumber(cache->size()));
+    return JSValue::encode(result);
+}
+
 EncodedJSValue JSC_HOST_CALL functionQuit(ExecState* exec)
 {
     // Technically, destroying the heap in the middle of JS execution is a no-no,
@@ -371,7 +397,7 @@ static void cleanupGlobalData(JSGlobalData* globalData)
     globalData->deref();
 }
 
-static bool runWithScripts(GlobalObject* globalObject, const Vector<Script>& scripts, bool dump)
+static bool runWithScripts(GlobalObject* globalObject, const Vector<Script>& scripts, bool dump, bool useParseCache, unsigned samplingInterval)
 {
     UString script;
     UString fileName;
@@ -385,6 +411,15 @@ static bool runWithScripts(GlobalObject* globalObject, const Vector<Script>& scr
 #if ENABLE(SAMPLING_FLAGS)
     SamplingFlags::start();
 #endif
+#if ENABLE(SAMPLING_PROFILER)
+    if (samplingInterval) {
+        globalData.samplingProfiler = adoptPtr(new SamplingProfiler(globalData, samplingInterval));
+        if (!globalData.samplingProfiler->start())
+            fprintf(stderr, "Could not start the sampling profiler\n");
+    }
+#else
+    UNUSED_PARAM(samplingInterval);
+#endif
 
     bool success = true;
     for (size_t i = 0; i < scripts.size(); i++) {
@@ -400,7 +435,11 @@ static bool runWithScripts(GlobalObject* globalObject, const Vector<Script>& scr
 
         globalData.startSampling();
 
-        Completion completion = evaluate(globalObject->globalExec(), globalObject->globalScopeChain(), makeSource(script, fileName));
+        SourceCode source = makeSource(script, fileName);
+        bool cacheParse = useParseCache && scripts[i].isFile;
+        unsigned loadedParseCacheSize = cacheParse ? loadParseCache(&globalData, fileName, source.provider()) : 0;
+
+        Completion completion = evaluate(globalObject->globalExec(), globalObject->globalScopeChain(), source);
         success = success && completion.complType() != Throw;
         if (dump) {
             if (completion.complType() == Throw)
@@ -411,10 +450,20 @@ static bool runWithScripts(GlobalObject* globalObject, const Vector<Script>& scr
 
         globalData.stopSampling();
         globalObject->globalExec()->clearException();
+
+        // Only rewrite the parse cache if this run added function info to it.
+        if (cacheParse && source.provider()->cache()->byteSize() != loadedParseCacheSize)
+            saveParseCache(fileName, source.provider());
     }
 
 #if ENABLE(SAMPLING_FLAGS)
     SamplingFlags::stop();
+#endif
+#if ENABLE(SAMPLING_PROFILER)
+    if (globalData.samplingProfiler) {
+        globalData.samplingProfiler->stop();
+        globalData.samplingProfiler->dump();
+    }
 #endif
     globalData.dumpSampleData(globalObject->globalExec());
 #if ENABLE(SAMPLING_COUNTERS)
@@ -467,11 +516,15 @@ static void runInteractive(GlobalObject* globalObject)
 static NO_RETURN void printUsageStatement(JSGlobalData* globalData, bool help = false)
 {
     fprintf(stderr, "Usage: jsc [options] [files] [-- arguments]\n");
+    fprintf(stderr, "  -c         Reads and writes a parse cache (<file>.jsccache) for each source file\n");
     fprintf(stderr, "  -d         Dumps bytecode (debug builds only)\n");
     fprintf(stderr, "  -e         Evaluate argument as script code\n");
     fprintf(stderr, "  -f         Specifies a source file (deprecated)\n");
     fprintf(stderr, "  -h|--help  Prints this help message\n");
     fprintf(stderr, "  -i         Enables interactive mode (default if no files are specified)\n");
+#if ENABLE(SAMPLING_PROFILER)
+    fprintf(stderr, "  -p <us>    Samples the running script every <us> microseconds and prints a profile\n");
+#endif
 #if HAVE(SIGNAL_H)
     fprintf(stderr, "  -s         Installs signal handlers that exit on a crash (Unix platforms only)\n");
 #endif
@@ -505,6 +558,18 @@ static void parseArguments(int argc, char** argv, Options& options, JSGlobalData
             options.dump = true;
             continue;
         }
+        if (!strcmp(arg, "-c")) {
+            options.useParseCache = true;
+            continue;
+        }
+#if ENABLE(SAMPLING_PROFILER)
+        if (!strcmp(arg, "-p")) {
+            if (++i == argc || atoi(argv[i]) <= 0)
+                printUsageStatement(globalData);
+            options.samplingInterval = atoi(argv[i]);
+            continue;
+        }
+#endif
         if (!strcmp(arg, "-s")) {
 #if HAVE(SIGNAL_H)
             signal(SIGILL, _exit);
@@ -538,7 +603,7 @@ int jscmain(int argc, char** argv, JSGlobalData* globalData)
     parseArguments(argc, argv, options, globalData);
 
     GlobalObject* globalObject = new (globalData) GlobalObject(*globalData, options.arguments);
-    bool success = runWithScripts(globalObject, options.scripts, options.dump);
+    bool success = runWithScripts(globalObject, options.scripts, options.dump, options.useParseCache, options.samplingInterval);
     if (options.interactive && success)
         runInteractive(globalObject);
 
@@ -573,3 +638,43 @@ static bool fillBufferWithContentsOfFile(const UString& fileName, Vector<char>&
 
     return true;
 }
+
+static CString parseCacheFileName(const UString& fileName)
+{
+    return makeUString(fileName, ".jsccache").utf8();
+}
+
+static unsigned loadParseCache(JSGlobalData* globalData, const UString& fileName, SourceProvider* provider)
+{
+    FILE* f = fopen(parseCacheFileName(fileName).data(), "rb");
+    if (!f)
+        return 0;
+
+    Vector<char> buffer;
+    char chunk[4096];
+    size_t chunkSize;
+    while ((chunkSize = fread(chunk, 1, sizeof(chunk), f)))
+        buffer.append(chunk, chunkSize);
+    fclose(f);
+
+    if (!provider->cache()->deserialize(globalData, provider, buffer.data(), buffer.size())) {
+        fprintf(stderr, "Ignoring stale parse cache for %s\n", fileName.utf8().data());
+        return 0;
+    }
+    return provider->cache()->byteSize();
+}
+
+static void saveParseCache(const UString& fileName, SourceProvider* provider)
+{
+    Vector<char> buffer;
+    provider->cache()->serialize(provider, buffer);
+
+    CString cacheFileName = parseCacheFileName(fileName);
+    FILE* f = fopen(cacheFileName.data(), "wb");
+    if (!f) {
+        fprintf(stderr, "Could not write parse cache: %s\n", cacheFileName.data());
+        return;
+    }
+    fwrite(buffer.data(), 1, buffer.size(), f);
+    fclose(f);
+}
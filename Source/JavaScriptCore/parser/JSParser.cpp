@@ -105,6 +105,14 @@ private:
         m_lexer->setLastLineNumber(m_lastLine);
         m_token.m_type = m_lexer->lex(&m_token.m_data, &m_token.m_info, lexType, strictMode());
     }
+
+    // Object literals are validated by their property names, so a string literal that
+    // may be one is always built, even while the lexer skips the contents of the rest.
+    void nextPropertyName(Lexer::LexType lexType = Lexer::IdentifyReservedWords)
+    {
+        StringBuildingManager stringBuilding(m_lexer, true);
+        next(lexType);
+    }
     
     bool nextTokenIsColon()
     {
@@ -278,6 +286,24 @@ private:
         int* m_depth;
     };
     
+    struct StringBuildingManager {
+        StringBuildingManager(Lexer* lexer, bool shouldBuildStrings)
+            : m_lexer(lexer)
+            , m_originalShouldBuildStrings(lexer->shouldBuildStrings())
+        {
+            lexer->setShouldBuildStrings(shouldBuildStrings);
+        }
+
+        ~StringBuildingManager()
+        {
+            m_lexer->setShouldBuildStrings(m_originalShouldBuildStrings);
+        }
+
+    private:
+        Lexer* m_lexer;
+        bool m_originalShouldBuildStrings;
+    };
+
     struct Scope {
         Scope(JSGlobalData* globalData, bool isFunction, bool strictMode)
             : m_globalData(globalData)
@@ -1283,7 +1309,9 @@ template <class TreeBuilder> TreeFunctionBody JSParser::parseFunctionBody(TreeBu
         return context.createFunctionBody(strictMode());
     DepthManager statementDepth(&m_statementDepth);
     m_statementDepth = 0;
-    typename TreeBuilder::FunctionBodyBuilder bodyBuilder(m_globalData, m_lexer);
+    typedef typename TreeBuilder::FunctionBodyBuilder FunctionBodyBuilder;
+    StringBuildingManager stringBuilding(m_lexer, FunctionBodyBuilder::CreatesAST);
+    FunctionBodyBuilder bodyBuilder(m_globalData, m_lexer);
     failIfFalse(parseSourceElements<CheckForStrictMode>(bodyBuilder));
     return context.createFunctionBody(strictMode());
 }
@@ -1703,7 +1731,7 @@ template <bool complete, class TreeBuilder> TreeProperty JSParser::parseProperty
         wasIdent = true;
     case STRING: {
         const Identifier* ident = m_token.m_data.ident;
-        next(Lexer::IgnoreReservedWords);
+        nextPropertyName(Lexer::IgnoreReservedWords);
         if (match(COLON)) {
             next();
             TreeExpression node = parseAssignmentExpression(context);
@@ -1745,7 +1773,8 @@ template <bool complete, class TreeBuilder> TreeProperty JSParser::parseProperty
 template <class TreeBuilder> TreeExpression JSParser::parseObjectLiteral(TreeBuilder& context)
 {
     int startOffset = m_token.m_data.intValue;
-    consumeOrFail(OPENBRACE);
+    matchOrFail(OPENBRACE);
+    nextPropertyName();
 
     if (match(CLOSEBRACE)) {
         next();
@@ -1762,7 +1791,7 @@ template <class TreeBuilder> TreeExpression JSParser::parseObjectLiteral(TreeBui
     TreePropertyList propertyList = context.createPropertyList(property);
     TreePropertyList tail = propertyList;
     while (match(COMMA)) {
-        next();
+        nextPropertyName();
         // allow extra comma, see http://bugs.webkit.org/show_bug.cgi?id=5939
         if (match(CLOSEBRACE))
             break;
@@ -1783,7 +1812,8 @@ template <class TreeBuilder> TreeExpression JSParser::parseObjectLiteral(TreeBui
 
 template <class TreeBuilder> TreeExpression JSParser::parseStrictObjectLiteral(TreeBuilder& context)
 {
-    consumeOrFail(OPENBRACE);
+    matchOrFail(OPENBRACE);
+    nextPropertyName();
     
     if (match(CLOSEBRACE)) {
         next();
@@ -1802,7 +1832,7 @@ template <class TreeBuilder> TreeExpression JSParser::parseStrictObjectLiteral(T
     TreePropertyList propertyList = context.createPropertyList(property);
     TreePropertyList tail = propertyList;
     while (match(COMMA)) {
-        next();
+        nextPropertyName();
         // allow extra comma, see http://bugs.webkit.org/show_bug.cgi?id=5939
         if (match(CLOSEBRACE))
             break;
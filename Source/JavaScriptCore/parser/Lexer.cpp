@@ -223,6 +223,7 @@ static const unsigned short typesOfASCIICharacters[128] = {
 
 Lexer::Lexer(JSGlobalData* globalData)
     : m_isReparsing(false)
+    , m_shouldBuildStrings(true)
     , m_globalData(globalData)
     , m_keywordTable(JSC::mainTable)
 {
@@ -255,6 +256,7 @@ void Lexer::setCode(const SourceCode& source, ParserArena& arena)
     const UChar* data = source.provider()->data();
 
     m_source = &source;
+    m_shouldBuildStrings = true;
     m_codeStart = data;
     m_code = data + source.startOffset();
     m_codeEnd = data + source.endOffset();
@@ -535,6 +537,17 @@ ALWAYS_INLINE bool Lexer::parseString(JSTokenData* lvalp, bool strictMode)
         shift();
     }
 
+    if (UNLIKELY(!m_shouldBuildStrings) && !strictMode) {
+        // The only string literal whose contents matter when pre-parsing is a "use strict"
+        // directive, and strict mode code needs the contents to validate object literals.
+        static const size_t useStrictLength = 10;
+        if (m_buffer16.size() + (currentCharacter() - stringStart) != useStrictLength) {
+            lvalp->ident = &m_globalData->propertyNames->emptyIdentifier;
+            m_buffer16.resize(0);
+            return true;
+        }
+    }
+
     if (currentCharacter() != stringStart)
         m_buffer16.append(stringStart, currentCharacter() - stringStart);
     lvalp->ident = makeIdentifier(m_buffer16.data(), m_buffer16.size());
@@ -51,6 +51,11 @@ namespace JSC {
         void setIsReparsing() { m_isReparsing = true; }
         bool isReparsing() const { return m_isReparsing; }
 
+        // When pre-parsing function bodies, the parser only needs to know that string
+        // literals are well formed, so their contents don't need to become identifiers.
+        void setShouldBuildStrings(bool shouldBuildStrings) { m_shouldBuildStrings = shouldBuildStrings; }
+        bool shouldBuildStrings() const { return m_shouldBuildStrings; }
+
         // Functions for the parser itself.
         enum LexType { IdentifyReservedWords, IgnoreReservedWords };
         JSTokenType lex(JSTokenData* lvalp, JSTokenInfo* llocp, LexType, bool strictMode);
@@ -134,6 +139,7 @@ namespace JSC {
         const UChar* m_codeStart;
         const UChar* m_codeEnd;
         bool m_isReparsing;
+        bool m_shouldBuildStrings;
         bool m_atLineStart;
         bool m_error;
 
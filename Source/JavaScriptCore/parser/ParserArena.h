@@ -27,6 +27,7 @@
 #define ParserArena_h
 
 #include "Identifier.h"
+#include <wtf/FixedArray.h>
 #include <wtf/SegmentedVector.h>
 
 namespace JSC {
@@ -37,20 +38,56 @@ namespace JSC {
     class IdentifierArena {
         WTF_MAKE_FAST_ALLOCATED;
     public:
+        IdentifierArena()
+        {
+            clear();
+        }
+
         ALWAYS_INLINE const Identifier& makeIdentifier(JSGlobalData*, const UChar* characters, size_t length);
         const Identifier& makeNumericIdentifier(JSGlobalData*, double number);
 
-        void clear() { m_identifiers.clear(); }
+        void clear()
+        {
+            m_identifiers.clear();
+            for (unsigned i = 0; i < MaximumCachableCharacter; ++i) {
+                m_shortIdentifiers[i] = 0;
+                m_recentIdentifiers[i] = 0;
+            }
+        }
+
         bool isEmpty() const { return m_identifiers.isEmpty(); }
 
     private:
+        static const unsigned MaximumCachableCharacter = 128;
         typedef SegmentedVector<Identifier, 64> IdentifierVector;
         IdentifierVector m_identifiers;
+
+        // Source code uses the same few names over and over. The identifier made for each
+        // single character name, and the one most recently made for each leading character,
+        // are remembered so that repeats need not be hashed and looked up in the identifier
+        // table again.
+        FixedArray<Identifier*, MaximumCachableCharacter> m_shortIdentifiers;
+        FixedArray<Identifier*, MaximumCachableCharacter> m_recentIdentifiers;
     };
 
     ALWAYS_INLINE const Identifier& IdentifierArena::makeIdentifier(JSGlobalData* globalData, const UChar* characters, size_t length)
     {
+        if (!length || characters[0] >= MaximumCachableCharacter) {
+            m_identifiers.append(Identifier(globalData, characters, length));
+            return m_identifiers.last();
+        }
+        if (length == 1) {
+            if (Identifier* identifier = m_shortIdentifiers[characters[0]])
+                return *identifier;
+            m_identifiers.append(Identifier(globalData, characters, length));
+            m_shortIdentifiers[characters[0]] = &m_identifiers.last();
+            return m_identifiers.last();
+        }
+        Identifier* identifier = m_recentIdentifiers[characters[0]];
+        if (identifier && Identifier::equal(identifier->impl(), characters, length))
+            return *identifier;
         m_identifiers.append(Identifier(globalData, characters, length));
+        m_recentIdentifiers[characters[0]] = &m_identifiers.last();
         return m_identifiers.last();
     }
 
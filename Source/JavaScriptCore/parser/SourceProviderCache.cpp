@@ -26,10 +26,106 @@
 #include "config.h"
 #include "SourceProviderCache.h"
 
+#include "Identifier.h"
+#include "SourceProvider.h"
 #include "SourceProviderCacheItem.h"
+#include <wtf/StringHasher.h>
 
 namespace JSC {
 
+static const uint32_t serializedCacheMagic = 0x4a534350; // 'JSCP'
+static const uint32_t serializedCacheVersion = 2;
+static const uint32_t serializedCacheByteOrderMark = 0x01020304;
+
+// Two independent hashes of the source text. Together with the length check and the
+// brace checks for every function in deserialize() this makes accepting data that was
+// written for different source text vanishingly unlikely, and is far cheaper than a
+// cryptographic digest over a multi-megabyte script.
+struct SourceHash {
+    uint32_t stringHash;
+    uint32_t fnvHash;
+};
+
+static SourceHash computeSourceHash(const SourceProvider* provider)
+{
+    const UChar* data = provider->data();
+    unsigned length = provider->length();
+
+    SourceHash hash;
+    hash.stringHash = StringHasher::computeHash(data, length);
+    hash.fnvHash = 2166136261u;
+    for (unsigned i = 0; i < length; ++i) {
+        hash.fnvHash ^= data[i];
+        hash.fnvHash *= 16777619u;
+    }
+    return hash;
+}
+
+template <typename T> static void appendValue(Vector<char>& buffer, T value)
+{
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void appendIdentifiers(Vector<char>& buffer, const Vector<RefPtr<StringImpl> >& identifiers)
+{
+    appendValue<uint32_t>(buffer, identifiers.size());
+    for (size_t i = 0; i < identifiers.size(); ++i) {
+        StringImpl* identifier = identifiers[i].get();
+        appendValue<uint32_t>(buffer, identifier->length());
+        buffer.append(reinterpret_cast<const char*>(identifier->characters()), identifier->length() * sizeof(UChar));
+    }
+}
+
+class SerializedCacheReader {
+public:
+    SerializedCacheReader(const char* data, size_t length)
+        : m_position(data)
+        , m_end(data + length)
+    {
+    }
+
+    template <typename T> bool read(T& value)
+    {
+        const char* bytes = readBytes(sizeof(T));
+        if (!bytes)
+            return false;
+        memcpy(&value, bytes, sizeof(T));
+        return true;
+    }
+
+    const char* readBytes(size_t length)
+    {
+        if (static_cast<size_t>(m_end - m_position) < length)
+            return 0;
+        const char* bytes = m_position;
+        m_position += length;
+        return bytes;
+    }
+
+    bool readIdentifiers(JSGlobalData* globalData, Vector<RefPtr<StringImpl> >& identifiers)
+    {
+        uint32_t count;
+        if (!read(count))
+            return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t length;
+            if (!read(length) || !length || length > static_cast<size_t>(m_end - m_position) / sizeof(UChar))
+                return false;
+            Vector<UChar> characters(length);
+            memcpy(characters.data(), readBytes(length * sizeof(UChar)), length * sizeof(UChar));
+            identifiers.append(Identifier(globalData, characters.data(), length).impl());
+        }
+        identifiers.shrinkToFit();
+        return true;
+    }
+
+    bool atEnd() const { return m_position == m_end; }
+
+private:
+    const char* m_position;
+    const char* m_end;
+};
+
 SourceProviderCache::~SourceProviderCache()
 {
     clear();
@@ -49,8 +145,114 @@ unsigned SourceProviderCache::byteSize() const
 
 void SourceProviderCache::add(int sourcePosition, PassOwnPtr<SourceProviderCacheItem> item, unsigned size)
 {
-    m_map.add(sourcePosition, item.leakPtr());
+    // Keep the first item for a position; a later one for the same function is freed here.
+    OwnPtr<SourceProviderCacheItem> ownedItem = item;
+    if (m_map.contains(sourcePosition))
+        return;
+    m_map.set(sourcePosition, ownedItem.leakPtr());
     m_contentByteSize += size;
 }
 
+void SourceProviderCache::serialize(const SourceProvider* provider, Vector<char>& buffer) const
+{
+    SourceHash hash = computeSourceHash(provider);
+
+    appendValue<uint32_t>(buffer, serializedCacheMagic);
+    appendValue<uint32_t>(buffer, serializedCacheByteOrderMark);
+    appendValue<uint32_t>(buffer, serializedCacheVersion);
+    appendValue<uint32_t>(buffer, provider->length());
+    appendValue<uint32_t>(buffer, hash.stringHash);
+    appendValue<uint32_t>(buffer, hash.fnvHash);
+    appendValue<uint32_t>(buffer, m_map.size());
+
+    HashMap<int, SourceProviderCacheItem*>::const_iterator end = m_map.end();
+    for (HashMap<int, SourceProviderCacheItem*>::const_iterator it = m_map.begin(); it != end; ++it) {
+        const SourceProviderCacheItem* item = it->second;
+        appendValue<int32_t>(buffer, it->first);
+        appendValue<int32_t>(buffer, item->closeBraceLine);
+        appendValue<int32_t>(buffer, item->closeBracePos);
+        appendValue<uint8_t>(buffer, item->usesEval);
+        appendIdentifiers(buffer, item->usedVariables);
+        appendIdentifiers(buffer, item->writtenVariables);
+    }
+}
+
+static bool readHeader(SerializedCacheReader& reader)
+{
+    uint32_t magic;
+    uint32_t byteOrderMark;
+    uint32_t version;
+    if (!reader.read(magic) || magic != serializedCacheMagic)
+        return false;
+    if (!reader.read(byteOrderMark) || byteOrderMark != serializedCacheByteOrderMark)
+        return false;
+    return reader.read(version) && version == serializedCacheVersion;
+}
+
+bool SourceProviderCache::hasCompatibleHeader(const char* data, size_t length)
+{
+    SerializedCacheReader reader(data, length);
+    return readHeader(reader);
+}
+
+bool SourceProviderCache::deserialize(JSGlobalData* globalData, const SourceProvider* provider, const char* data, size_t length)
+{
+    SerializedCacheReader reader(data, length);
+
+    uint32_t sourceLength;
+    if (!readHeader(reader))
+        return false;
+    if (!reader.read(sourceLength) || sourceLength != static_cast<uint32_t>(provider->length()))
+        return false;
+
+    SourceHash hash = computeSourceHash(provider);
+    uint32_t stringHash;
+    uint32_t fnvHash;
+    if (!reader.read(stringHash) || stringHash != hash.stringHash || !reader.read(fnvHash) || fnvHash != hash.fnvHash)
+        return false;
+
+    uint32_t itemCount;
+    if (!reader.read(itemCount))
+        return false;
+
+    // Read everything into a scratch cache first, so that a truncated or corrupt
+    // file can never leave partial function info behind.
+    const UChar* source = provider->data();
+    SourceProviderCache items;
+    for (uint32_t i = 0; i < itemCount; ++i) {
+        int32_t openBracePos;
+        int32_t closeBraceLine;
+        int32_t closeBracePos;
+        uint8_t usesEval;
+        if (!reader.read(openBracePos) || !reader.read(closeBraceLine) || !reader.read(closeBracePos) || !reader.read(usesEval))
+            return false;
+        if (openBracePos <= 0 || closeBracePos <= openBracePos || static_cast<uint32_t>(closeBracePos) >= sourceLength)
+            return false;
+        if (source[openBracePos] != '{' || source[closeBracePos] != '}')
+            return false;
+
+        OwnPtr<SourceProviderCacheItem> item = adoptPtr(new SourceProviderCacheItem(closeBraceLine, closeBracePos));
+        item->usesEval = usesEval;
+        if (!reader.readIdentifiers(globalData, item->usedVariables) || !reader.readIdentifiers(globalData, item->writtenVariables))
+            return false;
+        unsigned size = item->approximateByteSize();
+        items.add(openBracePos, item.release(), size);
+    }
+    if (!reader.atEnd())
+        return false;
+
+    HashMap<int, SourceProviderCacheItem*>::iterator end = items.m_map.end();
+    for (HashMap<int, SourceProviderCacheItem*>::iterator it = items.m_map.begin(); it != end; ++it) {
+        if (m_map.contains(it->first)) {
+            delete it->second;
+            continue;
+        }
+        m_map.add(it->first, it->second);
+        m_contentByteSize += it->second->approximateByteSize();
+    }
+    items.m_map.clear();
+    items.m_contentByteSize = 0;
+    return true;
+}
+
 }
@@ -23,11 +23,17 @@
  * THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#ifndef SourceProviderCache_h
+#define SourceProviderCache_h
+
 #include <wtf/HashMap.h>
 #include <wtf/PassOwnPtr.h>
+#include <wtf/Vector.h>
 
 namespace JSC {
 
+class JSGlobalData;
+class SourceProvider;
 class SourceProviderCacheItem;
 
 class SourceProviderCache {
@@ -37,12 +43,25 @@ public:
 
     void clear();
     unsigned byteSize() const;
+    bool isEmpty() const { return m_map.isEmpty(); }
     void add(int sourcePosition, PassOwnPtr<SourceProviderCacheItem>, unsigned size);
     const SourceProviderCacheItem* get(int sourcePosition) const { return m_map.get(sourcePosition); }
 
+    // The cached function info only depends on the source text, so it can be written out and
+    // reused by a later load of the same source. deserialize() rejects data that was produced
+    // for a different source, and leaves the cache untouched in that case.
+    void serialize(const SourceProvider*, Vector<char>&) const;
+    bool deserialize(JSGlobalData*, const SourceProvider*, const char* data, size_t length);
+
+    // The serialized form is written in the native byte order. This checks that the data was
+    // written by this format version on a machine with the same byte order.
+    static bool hasCompatibleHeader(const char* data, size_t length);
+
 private:
     HashMap<int, SourceProviderCacheItem*> m_map;
     unsigned m_contentByteSize;
 };
 
 }
+
+#endif // SourceProviderCache_h
@@ -0,0 +1,427 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE COMPUTER, INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "SamplingProfiler.h"
+
+#if ENABLE(SAMPLING_PROFILER)
+
+#include "CodeBlock.h"
+#include "Executable.h"
+#include "Interpreter.h"
+#include "JSFunction.h"
+#include "JSGlobalData.h"
+#include "RegisterFile.h"
+#include "UStringConcatenate.h"
+#include <algorithm>
+#include <stdio.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+namespace JSC {
+
+SamplingProfiler* SamplingProfiler::s_sampling = 0;
+
+static inline void* programCounterFromContext(ucontext_t* context)
+{
+#if CPU(X86_64)
+    return reinterpret_cast<void*>(context->uc_mcontext.gregs[REG_RIP]);
+#elif CPU(X86)
+    return reinterpret_cast<void*>(context->uc_mcontext.gregs[REG_EIP]);
+#elif CPU(ARM)
+    return reinterpret_cast<void*>(context->uc_mcontext.arm_pc);
+#else
+#error "Need to read the program counter from a ucontext on this platform"
+#endif
+}
+
+// JIT code keeps the current CallFrame in callFrameRegister (see JSInterfaceJIT.h).
+// In C++ code the register holds whatever the compiler put there, which is why
+// takeSample() checks every frame before following it.
+static inline Register* callFrameFromContext(ucontext_t* context)
+{
+#if CPU(X86_64)
+    return reinterpret_cast<Register*>(context->uc_mcontext.gregs[REG_R13]);
+#elif CPU(X86)
+    return reinterpret_cast<Register*>(context->uc_mcontext.gregs[REG_EDI]);
+#elif CPU(ARM_THUMB2)
+    return reinterpret_cast<Register*>(context->uc_mcontext.arm_r5);
+#elif CPU(ARM_TRADITIONAL)
+    return reinterpret_cast<Register*>(context->uc_mcontext.arm_r4);
+#else
+#error "Need to read the call frame register from a ucontext on this platform"
+#endif
+}
+
+SamplingProfiler::CallTreeNode* SamplingProfiler::CallTreeNode::child(unsigned function)
+{
+    for (size_t i = 0; i < children.size(); ++i) {
+        if (children[i]->function == function)
+            return children[i].get();
+    }
+    children.append(adoptPtr(new CallTreeNode(function)));
+    return children.last().get();
+}
+
+SamplingProfiler::SamplingProfiler(JSGlobalData& globalData, unsigned intervalInMicroseconds)
+    : m_globalData(globalData)
+    , m_intervalInMicroseconds(intervalInMicroseconds)
+    , m_timerThread(0)
+    , m_stopRequested(false)
+    , m_sampleCount(0)
+    , m_frameCount(0)
+    , m_droppedSampleCount(0)
+    , m_isProcessing(false)
+    , m_callTree(UINT_MAX)
+    , m_processedSampleCount(0)
+    , m_samplesOutsideJavaScript(0)
+    , m_samplesInUnknownCode(0)
+{
+    addFunction("(host function)");
+    addFunction("(unknown code)");
+    ASSERT(m_functions[hostFunction]->description == "(host function)");
+    ASSERT(m_functions[unknownCode]->description == "(unknown code)");
+}
+
+SamplingProfiler::~SamplingProfiler()
+{
+    stop();
+}
+
+class ExistingCodeBlockRegistrar {
+public:
+    ExistingCodeBlockRegistrar(SamplingProfiler* profiler)
+        : m_profiler(profiler)
+    {
+    }
+
+    void operator()(JSCell*);
+
+private:
+    SamplingProfiler* m_profiler;
+};
+
+inline void ExistingCodeBlockRegistrar::operator()(JSCell* cell)
+{
+    if (!cell->inherits(&JSFunction::s_info))
+        return;
+    JSFunction* function = asFunction(cell);
+    if (function->executable()->isHostFunction())
+        return;
+    // Functions sharing an executable register the same CodeBlocks again, which is harmless.
+    FunctionExecutable* executable = function->jsExecutable();
+    if (executable->isGeneratedForCall())
+        m_profiler->didCreateCodeBlock(&executable->generatedBytecodeForCall());
+    if (executable->isGeneratedForConstruct())
+        m_profiler->didCreateCodeBlock(&executable->generatedBytecodeForConstruct());
+}
+
+bool SamplingProfiler::start()
+{
+    ASSERT(!isSampling());
+    if (s_sampling || !m_globalData.canUseJIT())
+        return false;
+
+    ExistingCodeBlockRegistrar registrar(this);
+    m_globalData.heap.forEach(registrar);
+
+    static bool signalHandlerInstalled = false;
+    if (!signalHandlerInstalled) {
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = signalHandler;
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        if (sigaction(SIGPROF, &action, 0))
+            return false;
+        signalHandlerInstalled = true;
+    }
+
+    m_samples = adoptArrayPtr(new Sample[sampleCapacity]);
+    m_frames = adoptArrayPtr(new CodeBlock*[frameCapacity]);
+    m_sampleCount = 0;
+    m_frameCount = 0;
+    m_sampledThread = pthread_self();
+    m_stopRequested = false;
+    s_sampling = this;
+
+    m_timerThread = createThread(timerThreadStart, this, "JSC::SamplingProfiler");
+    if (!m_timerThread) {
+        s_sampling = 0;
+        return false;
+    }
+    return true;
+}
+
+void SamplingProfiler::stop()
+{
+    if (!isSampling())
+        return;
+
+    m_stopRequested = true;
+    waitForThreadCompletion(m_timerThread, 0);
+    m_timerThread = 0;
+    s_sampling = 0;
+
+    processSamples();
+}
+
+void* SamplingProfiler::timerThreadStart(void* profiler)
+{
+    static_cast<SamplingProfiler*>(profiler)->runTimerThread();
+    return 0;
+}
+
+void SamplingProfiler::runTimerThread()
+{
+    while (!m_stopRequested) {
+        usleep(m_intervalInMicroseconds);
+        if (!m_stopRequested)
+            pthread_kill(m_sampledThread, SIGPROF);
+    }
+}
+
+void SamplingProfiler::signalHandler(int, siginfo_t*, void* context)
+{
+    SamplingProfiler* profiler = s_sampling;
+    if (!profiler || !pthread_equal(pthread_self(), profiler->m_sampledThread))
+        return;
+
+    ucontext_t* userContext = static_cast<ucontext_t*>(context);
+    profiler->takeSample(programCounterFromContext(userContext), callFrameFromContext(userContext));
+}
+
+// Runs in the signal handler, so may interrupt the JavaScript thread anywhere,
+// including in the middle of processSamples().
+void SamplingProfiler::takeSample(void* pc, Register* callFrame)
+{
+    if (m_isProcessing || m_sampleCount == sampleCapacity) {
+        ++m_droppedSampleCount;
+        return;
+    }
+
+    Sample& sample = m_samples[m_sampleCount];
+    sample.pc = pc;
+    sample.firstFrame = m_frameCount;
+    sample.frameCount = 0;
+    sample.inJavaScript = m_globalData.dynamicGlobalObject;
+
+    if (sample.inJavaScript) {
+        // Every CallFrame lies within the RegisterFile, below the frame it called;
+        // anything else means the register did not hold a CallFrame.
+        RegisterFile& registerFile = m_globalData.interpreter->registerFile();
+        Register* start = registerFile.start();
+        Register* callee = registerFile.end() + 1;
+        unsigned frameCount = m_frameCount;
+        while (callFrame >= start + RegisterFile::CallFrameHeaderSize && callFrame < callee
+            && !(reinterpret_cast<uintptr_t>(callFrame) % sizeof(Register))
+            && frameCount - sample.firstFrame < maximumStackDepth) {
+            if (frameCount == frameCapacity) {
+                ++m_droppedSampleCount;
+                return;
+            }
+            m_frames[frameCount++] = callFrame[RegisterFile::CodeBlock].codeBlock();
+            callee = callFrame;
+            callFrame = callFrame[RegisterFile::CallerFrame].callFrame()->removeHostCallFrameFlag()->registers();
+        }
+        sample.frameCount = frameCount - sample.firstFrame;
+        m_frameCount = frameCount;
+    }
+
+    m_sampleCount = m_sampleCount + 1;
+}
+
+void SamplingProfiler::processSamples()
+{
+    if (!m_sampleCount)
+        return;
+
+    // Samples taken from here on are dropped, so the buffers are not written while
+    // they are read. Those already taken are complete.
+    m_isProcessing = true;
+
+    unsigned sampleCount = m_sampleCount;
+    for (unsigned i = 0; i < sampleCount; ++i) {
+        const Sample& sample = m_samples[i];
+        ++m_processedSampleCount;
+        if (!sample.frameCount) {
+            if (sample.inJavaScript)
+                ++m_samplesInUnknownCode;
+            else
+                ++m_samplesOutsideJavaScript;
+            continue;
+        }
+
+        CallTreeNode* node = &m_callTree;
+        ++node->totalCount;
+        for (unsigned frame = sample.frameCount; frame--; ) {
+            node = node->child(functionForCodeBlock(m_frames[sample.firstFrame + frame]));
+            ++node->totalCount;
+        }
+        ++node->selfCount;
+
+        Function& function = *m_functions[node->function];
+        ++function.selfCount;
+        if (node->function == hostFunction || node->function == unknownCode)
+            continue;
+        unsigned bytecodeOffset;
+        if (m_frames[sample.firstFrame]->bytecodeOffsetForMachineCode(sample.pc, bytecodeOffset))
+            ++function.selfCountByBytecodeOffset.add(bytecodeOffset + 1, 0).first->second;
+    }
+
+    m_sampleCount = 0;
+    m_frameCount = 0;
+    m_isProcessing = false;
+}
+
+unsigned SamplingProfiler::functionForCodeBlock(CodeBlock* codeBlock)
+{
+    if (!codeBlock)
+        return hostFunction;
+    // A frame whose CodeBlock slot held garbage could otherwise hit the hash table's
+    // deleted value.
+    if (HashTraits<CodeBlock*>::isDeletedValue(codeBlock))
+        return unknownCode;
+    HashMap<CodeBlock*, unsigned>::iterator it = m_codeBlockFunctions.find(codeBlock);
+    if (it == m_codeBlockFunctions.end())
+        return unknownCode;
+    return it->second;
+}
+
+unsigned SamplingProfiler::addFunction(const UString& description)
+{
+    pair<HashMap<RefPtr<StringImpl>, unsigned, StringHash>::iterator, bool> result = m_functionsByDescription.add(description.impl(), m_functions.size());
+    if (result.second)
+        m_functions.append(adoptPtr(new Function(description)));
+    return result.first->second;
+}
+
+void SamplingProfiler::didCreateCodeBlock(CodeBlock* codeBlock)
+{
+    ScriptExecutable* executable = codeBlock->ownerExecutable();
+    UString name;
+    switch (codeBlock->codeType()) {
+    case GlobalCode:
+        name = "(program)";
+        break;
+    case EvalCode:
+        name = "(eval)";
+        break;
+    case FunctionCode:
+        name = static_cast<FunctionExecutable*>(executable)->name().ustring();
+        if (name.isEmpty())
+            name = "(anonymous function)";
+        break;
+    }
+
+    UString description = makeUString(name, " ", executable->sourceURL(), ":", UString::number(executable->lineNo()));
+    m_codeBlockFunctions.set(codeBlock, addFunction(description));
+}
+
+void SamplingProfiler::willDestroyCodeBlock(CodeBlock* codeBlock)
+{
+    // Attribute the samples that may refer to the CodeBlock while it still exists.
+    processSamples();
+    m_codeBlockFunctions.remove(codeBlock);
+}
+
+bool SamplingProfiler::hasMoreSamples(const CallTreeNode* a, const CallTreeNode* b)
+{
+    return a->totalCount > b->totalCount;
+}
+
+void SamplingProfiler::dumpCallTree(CallTreeNode* node, unsigned depth, unsigned threshold)
+{
+    if (node->totalCount <= threshold)
+        return;
+
+    printf("%8u %8u  %*s%s\n", node->totalCount, node->selfCount, depth * 2, "", m_functions[node->function]->description.utf8().data());
+
+    Vector<CallTreeNode*> children;
+    for (size_t i = 0; i < node->children.size(); ++i)
+        children.append(node->children[i].get());
+    std::sort(children.begin(), children.end(), hasMoreSamples);
+    for (size_t i = 0; i < children.size(); ++i)
+        dumpCallTree(children[i], depth + 1, threshold);
+}
+
+bool SamplingProfiler::hasMoreSelfSamples(const Function* a, const Function* b)
+{
+    return a->selfCount > b->selfCount;
+}
+
+static bool bytecodeOffsetHasMoreSamples(const pair<unsigned, unsigned>& a, const pair<unsigned, unsigned>& b)
+{
+    return a.second > b.second;
+}
+
+void SamplingProfiler::dump()
+{
+    processSamples();
+
+    printf("\nSampling profile: %u samples at %u microsecond intervals", m_processedSampleCount, m_intervalInMicroseconds);
+    if (m_droppedSampleCount)
+        printf(", %u dropped", m_droppedSampleCount);
+    printf("\n");
+    if (!m_processedSampleCount)
+        return;
+    printf("%u outside JavaScript, %u in the runtime or in code that could not be identified\n", m_samplesOutsideJavaScript, m_samplesInUnknownCode);
+
+    // Leave out call paths with less than 0.1% of the samples.
+    unsigned threshold = m_processedSampleCount / 1000;
+    printf("\nCall tree:\n%8s %8s  %s\n", "total", "self", "function");
+    Vector<CallTreeNode*> roots;
+    for (size_t i = 0; i < m_callTree.children.size(); ++i)
+        roots.append(m_callTree.children[i].get());
+    std::sort(roots.begin(), roots.end(), hasMoreSamples);
+    for (size_t i = 0; i < roots.size(); ++i)
+        dumpCallTree(roots[i], 0, threshold);
+
+    Vector<Function*> functions;
+    for (size_t i = 0; i < m_functions.size(); ++i) {
+        if (m_functions[i]->selfCount)
+            functions.append(m_functions[i].get());
+    }
+    std::sort(functions.begin(), functions.end(), hasMoreSelfSamples);
+
+    printf("\nFunctions by self samples:\n%8s %6s  %s\n", "self", "%", "function [hottest bytecode offsets]");
+    for (size_t i = 0; i < functions.size() && i < 20; ++i) {
+        Function* function = functions[i];
+        printf("%8u %5.1f%%  %s", function->selfCount, 100.0 * function->selfCount / m_processedSampleCount, function->description.utf8().data());
+
+        Vector<pair<unsigned, unsigned> > offsets;
+        HashMap<unsigned, unsigned>::iterator end = function->selfCountByBytecodeOffset.end();
+        for (HashMap<unsigned, unsigned>::iterator it = function->selfCountByBytecodeOffset.begin(); it != end; ++it)
+            offsets.append(std::make_pair(it->first - 1, it->second));
+        std::sort(offsets.begin(), offsets.end(), bytecodeOffsetHasMoreSamples);
+        for (size_t j = 0; j < offsets.size() && j < 3; ++j)
+            printf("%s%u: %u", j ? ", " : " [", offsets[j].first, offsets[j].second);
+        printf("%s\n", offsets.isEmpty() ? "" : "]");
+    }
+}
+
+} // namespace JSC
+
+#endif // ENABLE(SAMPLING_PROFILER)
@@ -0,0 +1,174 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE COMPUTER, INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SamplingProfiler_h
+#define SamplingProfiler_h
+
+#if ENABLE(SAMPLING_PROFILER)
+
+#include "UString.h"
+#include <pthread.h>
+#include <signal.h>
+#include <wtf/FastAllocBase.h>
+#include <wtf/HashMap.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/OwnArrayPtr.h>
+#include <wtf/OwnPtr.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+#include <wtf/text/StringHash.h>
+
+namespace JSC {
+
+    class CodeBlock;
+    class JSGlobalData;
+    class Register;
+
+    // A statistical profiler for JavaScript, cheap enough to leave running.
+    //
+    // A timer thread periodically sends SIGPROF to the thread running JavaScript. The
+    // signal handler reads the JIT's call frame register from the interrupted context
+    // and copies the chain of CallFrames, checking each against the bounds of the
+    // RegisterFile, into a preallocated buffer; it does not allocate, lock, or follow
+    // any pointer it has not checked. The samples are attributed to CodeBlocks and
+    // bytecode offsets later on the JavaScript thread, when the TimeoutChecker runs
+    // and before any CodeBlock is destroyed, and are aggregated into a call tree.
+    //
+    // Code is only attributed once the profiler knows about its CodeBlock: those
+    // created while it is attached to a JSGlobalData, and, when it is started, those
+    // of functions that survived the last collection. PCs in JIT code are mapped back
+    // to bytecode offsets only for code compiled while the profiler was attached.
+    class SamplingProfiler {
+        WTF_MAKE_NONCOPYABLE(SamplingProfiler); WTF_MAKE_FAST_ALLOCATED;
+    public:
+        static const unsigned defaultIntervalInMicroseconds = 1000;
+
+        SamplingProfiler(JSGlobalData&, unsigned intervalInMicroseconds = defaultIntervalInMicroseconds);
+        ~SamplingProfiler();
+
+        // Samples the calling thread, which must be the one running JavaScript for the
+        // JSGlobalData. Only one profiler may sample at a time; returns false if
+        // another already is.
+        bool start();
+        void stop();
+        bool isSampling() const { return m_timerThread; }
+
+        void processSamples();
+
+        void didCreateCodeBlock(CodeBlock*);
+        void willDestroyCodeBlock(CodeBlock*);
+
+        // Prints the call tree and the functions with the most samples to stdout.
+        void dump();
+
+    private:
+        // The CodeBlocks of a sample's frames are stored innermost first; a null
+        // CodeBlock is a host function.
+        struct Sample {
+            void* pc;
+            unsigned firstFrame;
+            unsigned frameCount;
+            bool inJavaScript;
+        };
+
+        struct Function {
+            Function(const UString& description)
+                : description(description)
+                , selfCount(0)
+            {
+            }
+
+            UString description;
+            unsigned selfCount;
+            HashMap<unsigned, unsigned> selfCountByBytecodeOffset; // Keyed by bytecode offset + 1.
+        };
+
+        struct CallTreeNode {
+            WTF_MAKE_FAST_ALLOCATED;
+        public:
+            CallTreeNode(unsigned function)
+                : function(function)
+                , totalCount(0)
+                , selfCount(0)
+            {
+            }
+
+            CallTreeNode* child(unsigned function);
+
+            unsigned function;
+            unsigned totalCount;
+            unsigned selfCount;
+            Vector<OwnPtr<CallTreeNode> > children;
+        };
+
+        static const unsigned sampleCapacity = 1024;
+        static const unsigned frameCapacity = 16 * 1024;
+        static const unsigned maximumStackDepth = 128;
+
+        static const unsigned hostFunction = 0;
+        static const unsigned unknownCode = 1;
+
+        static void* timerThreadStart(void*);
+        void runTimerThread();
+
+        static void signalHandler(int, siginfo_t*, void*);
+        void takeSample(void* pc, Register* callFrame);
+
+        unsigned functionForCodeBlock(CodeBlock*);
+        unsigned addFunction(const UString& description);
+        void dumpCallTree(CallTreeNode*, unsigned depth, unsigned threshold);
+        static bool hasMoreSamples(const CallTreeNode*, const CallTreeNode*);
+        static bool hasMoreSelfSamples(const Function*, const Function*);
+
+        static SamplingProfiler* s_sampling;
+
+        JSGlobalData& m_globalData;
+        unsigned m_intervalInMicroseconds;
+        ThreadIdentifier m_timerThread;
+        pthread_t m_sampledThread;
+        volatile bool m_stopRequested;
+
+        // Written by the signal handler, which drops samples while they are being processed.
+        OwnArrayPtr<Sample> m_samples;
+        OwnArrayPtr<CodeBlock*> m_frames;
+        volatile unsigned m_sampleCount;
+        volatile unsigned m_frameCount;
+        volatile unsigned m_droppedSampleCount;
+        volatile bool m_isProcessing;
+
+        HashMap<CodeBlock*, unsigned> m_codeBlockFunctions;
+        HashMap<RefPtr<StringImpl>, unsigned, StringHash> m_functionsByDescription;
+        Vector<OwnPtr<Function> > m_functions;
+        CallTreeNode m_callTree;
+        unsigned m_processedSampleCount;
+        unsigned m_samplesOutsideJavaScript;
+        unsigned m_samplesInUnknownCode;
+    };
+
+} // namespace JSC
+
+#endif // ENABLE(SAMPLING_PROFILER)
+
+#endif // SamplingProfiler_h
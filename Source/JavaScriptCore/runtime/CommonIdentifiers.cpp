@@ -25,14 +25,61 @@ namespace JSC {
 
 static const char* const nullCString = 0;
 
-#define INITIALIZE_PROPERTY_NAME(name) , name(globalData, #name)
+// The names of the common identifiers are interned once, as static strings that every
+// thread's IdentifierTable starts out with; setting up a JSGlobalData neither allocates
+// nor hashes them again.
+enum SharedName {
+    UnderscoreProtoName,
+    ThisName,
+    UseStrictName,
+#define JSC_SHARED_NAME_INDEX(name) name##Name,
+    JSC_COMMON_IDENTIFIERS_EACH_PROPERTY_NAME(JSC_SHARED_NAME_INDEX)
+#undef JSC_SHARED_NAME_INDEX
+    SharedNameCount
+};
+
+static const char* const sharedNameCStrings[SharedNameCount] = {
+    "__proto__",
+    "this",
+    "use strict",
+#define JSC_SHARED_NAME_CSTRING(name) #name,
+    JSC_COMMON_IDENTIFIERS_EACH_PROPERTY_NAME(JSC_SHARED_NAME_CSTRING)
+#undef JSC_SHARED_NAME_CSTRING
+};
+
+static StringImpl** sharedNames;
+
+void CommonIdentifiers::initializeSharedNames()
+{
+    if (sharedNames)
+        return;
+
+    sharedNames = new StringImpl*[SharedNameCount];
+    for (unsigned i = 0; i < SharedNameCount; ++i) {
+        const char* cString = sharedNameCStrings[i];
+        unsigned length = strlen(cString);
+        UChar* characters = static_cast<UChar*>(fastMalloc(length * sizeof(UChar)));
+        for (unsigned j = 0; j < length; ++j)
+            characters[j] = cString[j];
+        sharedNames[i] = new StringImpl(characters, length, StringImpl::ConstructStaticString);
+    }
+}
+
+void CommonIdentifiers::addSharedNames(IdentifierTable& identifierTable)
+{
+    initializeSharedNames();
+    for (unsigned i = 0; i < SharedNameCount; ++i)
+        identifierTable.add(sharedNames[i]);
+}
+
+#define INITIALIZE_PROPERTY_NAME(name) , name(globalData, sharedNames[name##Name])
 
 CommonIdentifiers::CommonIdentifiers(JSGlobalData* globalData)
     : nullIdentifier(globalData, nullCString)
     , emptyIdentifier(globalData, "")
-    , underscoreProto(globalData, "__proto__")
-    , thisIdentifier(globalData, "this")
-    , useStrictIdentifier(globalData, "use strict")
+    , underscoreProto(globalData, sharedNames[UnderscoreProtoName])
+    , thisIdentifier(globalData, sharedNames[ThisName])
+    , useStrictIdentifier(globalData, sharedNames[UseStrictName])
     JSC_COMMON_IDENTIFIERS_EACH_PROPERTY_NAME(INITIALIZE_PROPERTY_NAME)
 {
 }
@@ -84,6 +84,11 @@ namespace JSC {
         friend class JSGlobalData;
 
     public:
+        // Every thread's IdentifierTable starts out with the names of the common identifiers.
+        // They are created once, before a second thread can make an IdentifierTable.
+        static void initializeSharedNames();
+        static void addSharedNames(IdentifierTable&);
+
         const Identifier nullIdentifier;
         const Identifier emptyIdentifier;
         const Identifier underscoreProto;
@@ -34,8 +34,7 @@
 #include "Vector.h"
 
 #if ENABLE(DFG_JIT)
-#include "DFGByteCodeParser.h"
-#include "DFGJITCompiler.h"
+#include "DFGWorklist.h"
 #endif
 
 namespace JSC {
@@ -193,34 +192,6 @@ JSObject* ProgramExecutable::compileInternal(ExecState* exec, ScopeChainNode* sc
    return 0;
 }
 
-#if ENABLE(JIT)
-static bool tryDFGCompile(JSGlobalData* globalData, CodeBlock* codeBlock, JITCode& jitCode, MacroAssemblerCodePtr& jitCodeWithArityCheck)
-{
-#if ENABLE(DFG_JIT)
-#if ENABLE(DFG_JIT_RESTRICTIONS)
-    // FIXME: No flow control yet supported, don't bother scanning the bytecode if there are any jump targets.
-    // FIXME: temporarily disable property accesses until we fix regressions.
-    if (codeBlock->numberOfJumpTargets() || codeBlock->numberOfStructureStubInfos())
-        return false;
-#endif
-
-    DFG::Graph dfg;
-    if (!parse(dfg, globalData, codeBlock))
-        return false;
-
-    DFG::JITCompiler dataFlowJIT(globalData, dfg, codeBlock);
-    dataFlowJIT.compileFunction(jitCode, jitCodeWithArityCheck);
-    return true;
-#else
-    UNUSED_PARAM(globalData);
-    UNUSED_PARAM(codeBlock);
-    UNUSED_PARAM(jitCode);
-    UNUSED_PARAM(jitCodeWithArityCheck);
-    return false;
-#endif
-}
-#endif
-
 void ProgramExecutable::markChildren(MarkStack& markStack)
 {
     ScriptExecutable::markChildren(markStack);
@@ -262,12 +233,11 @@ JSObject* FunctionExecutable::compileForCallInternal(ExecState* exec, ScopeChain
 
 #if ENABLE(JIT)
     if (exec->globalData().canUseJIT()) {
-        bool dfgCompiled = tryDFGCompile(&exec->globalData(), m_codeBlockForCall.get(), m_jitCodeForCall, m_jitCodeForCallWithArityCheck);
-        if (!dfgCompiled)
-            m_jitCodeForCall = JIT::compile(scopeChainNode->globalData, m_codeBlockForCall.get(), &m_jitCodeForCallWithArityCheck);
+        m_jitCodeForCall = JIT::compile(scopeChainNode->globalData, m_codeBlockForCall.get(), &m_jitCodeForCallWithArityCheck);
 
 #if !ENABLE(OPCODE_SAMPLING)
-        if (!BytecodeGenerator::dumpsGeneratedCode())
+        // Functions that may later be optimized keep their bytecode until then.
+        if (!BytecodeGenerator::dumpsGeneratedCode() && !m_codeBlockForCall->canBeOptimized())
             m_codeBlockForCall->discardBytecode();
 #endif
     }
@@ -276,6 +246,59 @@ JSObject* FunctionExecutable::compileForCallInternal(ExecState* exec, ScopeChain
     return 0;
 }
 
+#if ENABLE(DFG_JIT)
+bool FunctionExecutable::optimizeForCall(JSGlobalData& globalData)
+{
+    ASSERT(m_codeBlockForCall && m_codeBlockForCall->canBeOptimized());
+    CodeBlock* codeBlock = m_codeBlockForCall.get();
+
+    if (!globalData.dfgWorklist && !globalData.dfgWorklistFailedToStart) {
+        globalData.dfgWorklist = DFG::Worklist::create();
+        globalData.dfgWorklistFailedToStart = !globalData.dfgWorklist;
+    }
+    DFG::Worklist* worklist = globalData.dfgWorklist.get();
+    if (worklist)
+        worklist->completeReadyPlans();
+
+    OwnPtr<DFG::Plan> plan;
+    switch (worklist ? worklist->compilationState(codeBlock) : DFG::Worklist::NotQueued) {
+    case DFG::Worklist::NotQueued:
+        plan = DFG::Plan::create(&globalData, codeBlock);
+        if (plan && worklist) {
+            worklist->enqueue(plan.release());
+            // Keep running the baseline JIT's code, and check back for the optimized code later.
+            codeBlock->optimizeAfterWarmUp();
+            return false;
+        }
+        if (plan)
+            plan->generate();
+        break;
+    case DFG::Worklist::Compiling:
+        codeBlock->optimizeAfterWarmUp();
+        return false;
+    case DFG::Worklist::Compiled:
+        plan = worklist->takeCompiledPlan(codeBlock);
+        break;
+    }
+
+    bool optimized = plan && plan->link(m_jitCodeForCall, m_jitCodeForCallWithArityCheck);
+    if (optimized) {
+        // Calls linked to the baseline JIT's code will relink to the optimized code.
+        codeBlock->unlinkIncomingCalls();
+        codeBlock->optimizeAfterWarmUp();
+    } else
+        codeBlock->dontOptimizeAnytimeSoon();
+
+    // Only one attempt is made; exits from the optimized code have been linked already.
+    codeBlock->baselineCodeMap().clear();
+#if !ENABLE(OPCODE_SAMPLING)
+    if (!BytecodeGenerator::dumpsGeneratedCode())
+        codeBlock->discardBytecode();
+#endif
+    return optimized;
+}
+#endif
+
 JSObject* FunctionExecutable::compileForConstructInternal(ExecState* exec, ScopeChainNode* scopeChainNode)
 {
     JSObject* exception = 0;
@@ -342,6 +365,27 @@ void FunctionExecutable::discardCode()
 #endif
 }
 
+#if ENABLE(JIT)
+// Discards the compiled code unless it has run since the last time this was called, and
+// returns whether it did. The code is regenerated the next time the function is called.
+bool FunctionExecutable::discardCodeIfCold()
+{
+    if (!m_codeBlockForCall && !m_codeBlockForConstruct)
+        return false;
+
+    bool wasExecuted = false;
+    if (m_codeBlockForCall)
+        wasExecuted |= m_codeBlockForCall->checkAndClearWasExecuted();
+    if (m_codeBlockForConstruct)
+        wasExecuted |= m_codeBlockForConstruct->checkAndClearWasExecuted();
+    if (wasExecuted)
+        return false;
+
+    discardCode();
+    return true;
+}
+#endif
+
 FunctionExecutable* FunctionExecutable::fromGlobalCode(const Identifier& functionName, ExecState* exec, Debugger* debugger, const SourceCode& source, JSObject** exception)
 {
     JSGlobalObject* lexicalGlobalObject = exec->lexicalGlobalObject();
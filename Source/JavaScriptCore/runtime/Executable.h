@@ -370,6 +370,15 @@ namespace JSC {
         SharedSymbolTable* symbolTable() const { return m_symbolTable; }
 
         void discardCode();
+#if ENABLE(JIT)
+        bool discardCodeIfCold();
+#endif
+#if ENABLE(DFG_JIT)
+        // Recompiles the function with the DFG JIT, once the baseline JIT's code has
+        // found it to be hot. Where possible the code is generated on another thread and
+        // linked in on a later call; returns true once the optimized code is in place.
+        bool optimizeForCall(JSGlobalData&);
+#endif
         void markChildren(MarkStack&);
         static FunctionExecutable* fromGlobalCode(const Identifier&, ExecState*, Debugger*, const SourceCode&, JSObject** exception);
         static Structure* createStructure(JSGlobalData& globalData, JSValue proto) { return Structure::create(globalData, proto, TypeInfo(CompoundType, StructureFlags), AnonymousSlotCount, 0); }
@@ -22,6 +22,7 @@
 #include "Identifier.h"
 
 #include "CallFrame.h"
+#include "CommonIdentifiers.h"
 #include "JSObject.h"
 #include "NumericStrings.h"
 #include "ScopeChain.h"
@@ -37,23 +38,32 @@ using WTF::ThreadSpecific;
 
 namespace JSC {
 
+IdentifierTable::IdentifierTable()
+{
+    CommonIdentifiers::addSharedNames(*this);
+}
+
 IdentifierTable::~IdentifierTable()
 {
     HashSet<StringImpl*>::iterator end = m_table.end();
-    for (HashSet<StringImpl*>::iterator iter = m_table.begin(); iter != end; ++iter)
-        (*iter)->setIsIdentifier(false);
+    for (HashSet<StringImpl*>::iterator iter = m_table.begin(); iter != end; ++iter) {
+        if (!(*iter)->isStatic())
+            (*iter)->setIsIdentifier(false);
+    }
 }
 std::pair<HashSet<StringImpl*>::iterator, bool> IdentifierTable::add(StringImpl* value)
 {
     std::pair<HashSet<StringImpl*>::iterator, bool> result = m_table.add(value);
-    (*result.first)->setIsIdentifier(true);
+    if (!(*result.first)->isIdentifier())
+        (*result.first)->setIsIdentifier(true);
     return result;
 }
 template<typename U, typename V>
 std::pair<HashSet<StringImpl*>::iterator, bool> IdentifierTable::add(U value)
 {
     std::pair<HashSet<StringImpl*>::iterator, bool> result = m_table.add<U, V>(value);
-    (*result.first)->setIsIdentifier(true);
+    if (!(*result.first)->isIdentifier())
+        (*result.first)->setIsIdentifier(true);
     return result;
 }
 
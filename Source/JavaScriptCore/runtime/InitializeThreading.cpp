@@ -29,6 +29,7 @@
 #include "config.h"
 #include "InitializeThreading.h"
 
+#include "CommonIdentifiers.h"
 #include "Heap.h"
 #include "dtoa.h"
 #include "Identifier.h"
@@ -48,9 +49,10 @@ static pthread_once_t initializeThreadingKeyOnce = PTHREAD_ONCE_INIT;
 
 static void initializeThreadingOnce()
 {
-    // StringImpl::empty() does not construct its static string in a threadsafe fashion,
-    // so ensure it has been initialized from here.
+    // StringImpl::empty() and the common identifiers' shared names are not constructed
+    // in a threadsafe fashion, so ensure they have been initialized from here.
     StringImpl::empty();
+    CommonIdentifiers::initializeSharedNames();
 
     WTF::initializeThreading();
     wtfThreadData();
@@ -167,6 +167,7 @@ JSArray::JSArray(JSGlobalData& globalData, Structure* structure, unsigned initia
     m_storage->m_sparseValueMap = 0;
     m_storage->subclassData = 0;
     m_storage->reportedMapCapacity = 0;
+    m_storage->m_vectorType = Int32ArrayStorage;
 
     if (creationMode == CreateCompact) {
 #if CHECK_ARRAY_CONSISTENCY
@@ -214,6 +215,7 @@ JSArray::JSArray(JSGlobalData& globalData, Structure* structure, const ArgList&
     m_storage->m_sparseValueMap = 0;
     m_storage->subclassData = 0;
     m_storage->reportedMapCapacity = 0;
+    m_storage->m_vectorType = Int32ArrayStorage;
 #if CHECK_ARRAY_CONSISTENCY
     m_storage->m_inCompactInitialization = false;
 #endif
@@ -221,8 +223,10 @@ JSArray::JSArray(JSGlobalData& globalData, Structure* structure, const ArgList&
     size_t i = 0;
     WriteBarrier<Unknown>* vector = m_storage->m_vector;
     ArgList::const_iterator end = list.end();
-    for (ArgList::const_iterator it = list.begin(); it != end; ++it, ++i)
+    for (ArgList::const_iterator it = list.begin(); it != end; ++it, ++i) {
+        updateVectorType(*it);
         vector[i].set(globalData, this, *it);
+    }
     for (; i < initialStorage; i++)
         vector[i].clear();
 
@@ -344,6 +348,8 @@ void JSArray::put(ExecState* exec, unsigned i, JSValue value)
 {
     checkConsistency();
 
+    updateVectorType(value);
+
     ArrayStorage* storage = m_storage;
 
     unsigned length = storage->m_length;
@@ -733,6 +739,8 @@ JSValue JSArray::pop()
 void JSArray::push(ExecState* exec, JSValue value)
 {
     checkConsistency();
+
+    updateVectorType(value);
     
     ArrayStorage* storage = m_storage;
 
@@ -869,6 +877,13 @@ static int compareNumbersForQSort(const void* a, const void* b)
     return (da > db) - (da < db);
 }
 
+static int compareInt32sForQSort(const void* a, const void* b)
+{
+    int32_t ia = static_cast<const JSValue*>(a)->asInt32();
+    int32_t ib = static_cast<const JSValue*>(b)->asInt32();
+    return (ia > ib) - (ia < ib);
+}
+
 static int compareByStringPairForQSort(const void* a, const void* b)
 {
     const ValueStringPair* va = static_cast<const ValueStringPair*>(a);
@@ -888,23 +903,28 @@ void JSArray::sortNumeric(ExecState* exec, JSValue compareFunction, CallType cal
 
     if (!lengthNotIncludingUndefined)
         return;
-        
-    bool allValuesAreNumbers = true;
+
     size_t size = storage->m_numValuesInVector;
-    for (size_t i = 0; i < size; ++i) {
-        if (!storage->m_vector[i].isNumber()) {
-            allValuesAreNumbers = false;
-            break;
+
+    // Arrays with a numeric vector type are known to hold only numbers; anything
+    // else has to be checked.
+    if (storage->m_vectorType == GenericArrayStorage) {
+        bool allValuesAreNumbers = true;
+        for (size_t i = 0; i < size; ++i) {
+            if (!storage->m_vector[i].isNumber()) {
+                allValuesAreNumbers = false;
+                break;
+            }
         }
-    }
 
-    if (!allValuesAreNumbers)
-        return sort(exec, compareFunction, callType, callData);
+        if (!allValuesAreNumbers)
+            return sort(exec, compareFunction, callType, callData);
+    }
 
     // For numeric comparison, which is fast, qsort is faster than mergesort. We
     // also don't require mergesort's stability, since there's no user visible
     // side-effect from swapping the order of equal primitive values.
-    qsort(storage->m_vector, size, sizeof(JSValue), compareNumbersForQSort);
+    qsort(storage->m_vector, size, sizeof(JSValue), storage->m_vectorType == Int32ArrayStorage ? compareInt32sForQSort : compareNumbersForQSort);
 
     checkConsistency(SortConsistencyCheck);
 }
@@ -1294,6 +1314,8 @@ void JSArray::checkConsistency(ConsistencyCheckType type)
             ASSERT(i < storage->m_length);
             if (type != DestructorConsistencyCheck)
                 value.isUndefined(); // Likely to crash if the object was deallocated.
+            ASSERT(storage->m_vectorType != Int32ArrayStorage || value.isInt32());
+            ASSERT(storage->m_vectorType != DoubleArrayStorage || value.isNumber());
             ++numValuesInVector;
         } else {
             if (type == SortConsistencyCheck)
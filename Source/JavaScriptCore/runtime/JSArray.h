@@ -29,6 +29,14 @@ namespace JSC {
 
     typedef HashMap<unsigned, WriteBarrier<Unknown> > SparseArrayValueMap;
 
+    // The vector type records what kind of values an array holds.  Every value in an
+    // Int32ArrayStorage array is an int32, and every value in a DoubleArrayStorage array
+    // is a number.  Storing any other value moves the array to a more general type; an
+    // array never moves back.  All three types share the JSValue vector layout, so a
+    // conversion is a single store and readers of the vector need not care about the type.
+    // Numeric arrays hold no cells, which lets the collector skip over their vectors.
+    enum ArrayStorageType { Int32ArrayStorage = 0, DoubleArrayStorage, GenericArrayStorage };
+
     // This struct holds the actual data values of an array.  A JSArray object points to it's contained ArrayStorage
     // struct by pointing to m_vector.  To access the contained ArrayStorage struct, use the getStorage() and 
     // setStorage() methods.  It is important to note that there may be space before the ArrayStorage that 
@@ -41,6 +49,7 @@ namespace JSC {
         void* subclassData; // A JSArray subclass can use this to fill the vector lazily.
         void* m_allocBase; // Pointer to base address returned by malloc().  Keeping this pointer does eliminate false positives from the leak detector.
         size_t reportedMapCapacity;
+        unsigned m_vectorType; // An ArrayStorageType.
 #if CHECK_ARRAY_CONSISTENCY
         bool m_inCompactInitialization;
 #endif
@@ -107,6 +116,7 @@ namespace JSC {
                 if (i >= storage->m_length)
                     storage->m_length = i + 1;
             }
+            updateVectorType(v);
             x.set(globalData, this, v);
         }
         
@@ -117,9 +127,12 @@ namespace JSC {
 #if CHECK_ARRAY_CONSISTENCY
             ASSERT(storage->m_inCompactInitialization);
 #endif
+            updateVectorType(v);
             storage->m_vector[i].set(globalData, this, v);
         }
 
+        ArrayStorageType vectorType() const { return static_cast<ArrayStorageType>(m_storage->m_vectorType); }
+
         void fillArgList(ExecState*, MarkedArgumentBuffer&);
         void copyToRegisters(ExecState*, Register*, uint32_t);
 
@@ -155,6 +168,14 @@ namespace JSC {
         bool getOwnPropertySlotSlowCase(ExecState*, unsigned propertyName, PropertySlot&);
         void putSlowCase(ExecState*, unsigned propertyName, JSValue);
 
+        void updateVectorType(JSValue value)
+        {
+            ArrayStorage* storage = m_storage;
+            if (storage->m_vectorType == GenericArrayStorage || value.isInt32())
+                return;
+            storage->m_vectorType = value.isNumber() ? DoubleArrayStorage : GenericArrayStorage;
+        }
+
         unsigned getNewVectorLength(unsigned desiredLength);
         bool increaseVectorLength(unsigned newLength);
         bool increaseVectorPrefixLength(unsigned newLength);
@@ -191,8 +212,10 @@ namespace JSC {
         
         ArrayStorage* storage = m_storage;
 
-        unsigned usedVectorLength = std::min(storage->m_length, m_vectorLength);
-        markStack.appendValues(storage->m_vector, usedVectorLength, MayContainNullValues);
+        if (storage->m_vectorType == GenericArrayStorage) {
+            unsigned usedVectorLength = std::min(storage->m_length, m_vectorLength);
+            markStack.appendValues(storage->m_vector, usedVectorLength, MayContainNullValues);
+        }
 
         if (SparseArrayValueMap* map = storage->m_sparseValueMap) {
             SparseArrayValueMap::iterator end = map->end();
@@ -32,6 +32,7 @@
 #include "ArgList.h"
 #include "Heap.h"
 #include "CommonIdentifiers.h"
+#include "DFGWorklist.h"
 #include "FunctionConstructor.h"
 #include "GetterSetter.h"
 #include "Interpreter.h"
@@ -51,7 +52,9 @@
 #include "Nodes.h"
 #include "Parser.h"
 #include "RegExpCache.h"
+#include "SamplingProfiler.h"
 #include "StrictEvalActivation.h"
+#include <wtf/CurrentTime.h>
 #include <wtf/WTFThreadData.h>
 #if ENABLE(REGEXP_TRACING)
 #include "RegExp.h"
@@ -88,6 +91,35 @@ inline void Recompiler::operator()(JSCell* cell)
     function->jsExecutable()->discardCode();
 }
 
+#if ENABLE(JIT)
+class ColdCodeDiscarder {
+public:
+    void operator()(JSCell*);
+    void discard();
+
+private:
+    HashSet<FunctionExecutable*> m_executables;
+};
+
+inline void ColdCodeDiscarder::operator()(JSCell* cell)
+{
+    if (!cell->inherits(&JSFunction::s_info))
+        return;
+    JSFunction* function = asFunction(cell);
+    if (function->executable()->isHostFunction())
+        return;
+    // Many closures can share one executable; it must only be checked once per pass.
+    m_executables.add(function->jsExecutable());
+}
+
+void ColdCodeDiscarder::discard()
+{
+    HashSet<FunctionExecutable*>::iterator end = m_executables.end();
+    for (HashSet<FunctionExecutable*>::iterator it = m_executables.begin(); it != end; ++it)
+        (*it)->discardCodeIfCold();
+}
+#endif
+
 } // namespace
 
 namespace JSC {
@@ -162,6 +194,9 @@ JSGlobalData::JSGlobalData(GlobalDataType globalDataType, ThreadStackType thread
     , parser(new Parser)
     , interpreter(0)
     , heap(this)
+#if ENABLE(DFG_JIT)
+    , dfgWorklistFailedToStart(false)
+#endif
     , globalObjectCount(0)
     , dynamicGlobalObject(0)
     , cachedUTCOffset(NaN)
@@ -173,6 +208,9 @@ JSGlobalData::JSGlobalData(GlobalDataType globalDataType, ThreadStackType thread
 #ifndef NDEBUG
     , exclusiveThread(0)
 #endif
+#if ENABLE(JIT)
+    , m_lastColdJITCodeDiscardTime(0)
+#endif
 {
     interpreter = new Interpreter(*this);
     if (globalDataType == Default)
@@ -406,6 +444,28 @@ void JSGlobalData::recompileAllJSFunctions()
     heap.forEach(recompiler);
 }
 
+#if ENABLE(JIT)
+// Throws away the JIT code of functions that have not run since the previous call, rather than
+// all of it, so that code in active use does not have to be regenerated.
+void JSGlobalData::discardColdJITCode()
+{
+    // If JavaScript is running, it's not safe to discard code that may be live on the stack.
+    ASSERT(!dynamicGlobalObject);
+
+    // A pass touches every function in the heap, and code needs some time to show it is
+    // still in use.
+    static const double minimumDiscardInterval = 1.0;
+    double now = currentTime();
+    if (now - m_lastColdJITCodeDiscardTime < minimumDiscardInterval)
+        return;
+    m_lastColdJITCodeDiscardTime = now;
+
+    ColdCodeDiscarder discarder;
+    heap.forEach(discarder);
+    discarder.discard();
+}
+#endif
+
 #if ENABLE(REGEXP_TRACING)
 void JSGlobalData::addRegExpToTrace(PassRefPtr<RegExp> regExp)
 {
@@ -67,6 +67,14 @@ namespace JSC {
     class NativeExecutable;
     class Parser;
     class RegExpCache;
+#if ENABLE(SAMPLING_PROFILER)
+    class SamplingProfiler;
+#endif
+#if ENABLE(DFG_JIT)
+    namespace DFG {
+    class Worklist;
+    }
+#endif
     class Stringifier;
     class Structure;
     class UString;
@@ -219,6 +227,15 @@ namespace JSC {
         TimeoutChecker timeoutChecker;
         Terminator terminator;
         Heap heap;
+#if ENABLE(SAMPLING_PROFILER)
+        OwnPtr<SamplingProfiler> samplingProfiler;
+#endif
+#if ENABLE(DFG_JIT)
+        // Generates optimized code off the thread running JavaScript; created on demand.
+        OwnPtr<DFG::Worklist> dfgWorklist;
+        // Set once the worklist's thread could not be started, so that it isn't retried.
+        bool dfgWorklistFailedToStart;
+#endif
 
         JSValue exception;
 #if ENABLE(JIT)
@@ -260,6 +277,9 @@ namespace JSC {
         void stopSampling();
         void dumpSampleData(ExecState* exec);
         void recompileAllJSFunctions();
+#if ENABLE(JIT)
+        void discardColdJITCode();
+#endif
         RegExpCache* regExpCache() { return m_regExpCache; }
 #if ENABLE(REGEXP_TRACING)
         void addRegExpToTrace(PassRefPtr<RegExp> regExp);
@@ -275,6 +295,9 @@ namespace JSC {
         void createNativeThunk();
 #if ENABLE(JIT) && ENABLE(INTERPRETER)
         bool m_canUseJIT;
+#endif
+#if ENABLE(JIT)
+        double m_lastColdJITCodeDiscardTime;
 #endif
         StackBounds m_stack;
     };
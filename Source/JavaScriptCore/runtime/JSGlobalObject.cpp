@@ -438,9 +438,9 @@ DynamicGlobalObjectScope::DynamicGlobalObjectScope(JSGlobalData& globalData, JSG
     , m_savedDynamicGlobalObject(m_dynamicGlobalObjectSlot)
 {
     if (!m_dynamicGlobalObjectSlot) {
-#if ENABLE(ASSEMBLER)
+#if ENABLE(JIT)
         if (ExecutableAllocator::underMemoryPressure())
-            globalData.recompileAllJSFunctions();
+            globalData.discardColdJITCode();
 #endif
 
         m_dynamicGlobalObjectSlot = dynamicGlobalObject;
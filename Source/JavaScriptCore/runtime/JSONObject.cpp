@@ -39,6 +39,7 @@
 #include "UStringBuilder.h"
 #include "UStringConcatenate.h"
 #include <wtf/MathExtras.h>
+#include <wtf/dtoa.h>
 
 namespace JSC {
 
@@ -102,6 +103,9 @@ private:
     friend class Holder;
 
     static void appendQuotedString(UStringBuilder&, const UString&);
+    static void appendNumber(UStringBuilder&, JSValue);
+
+    PassRefPtr<PropertyNameArrayData> ownPropertyNames(JSObject*);
 
     JSValue toJSON(JSValue, const PropertyNameForFunctionCall&);
 
@@ -124,6 +128,10 @@ private:
     Vector<Holder, 16> m_holderStack;
     UString m_repeatedGap;
     UString m_indent;
+
+    // The property names of the last object seen whose names follow from its Structure.
+    Local<Structure> m_propertyNamesStructure;
+    RefPtr<PropertyNameArrayData> m_propertyNames;
 };
 
 // ------------------------------ helper functions --------------------------------
@@ -204,6 +212,7 @@ Stringifier::Stringifier(ExecState* exec, const Local<Unknown>& replacer, const
     , m_arrayReplacerPropertyNames(exec)
     , m_replacerCallType(CallTypeNone)
     , m_gap(gap(exec, space.get()))
+    , m_propertyNamesStructure(exec->globalData())
 {
     if (!m_replacer.isObject())
         return;
@@ -262,6 +271,19 @@ Local<Unknown> Stringifier::stringify(Handle<Unknown> value)
     return Local<Unknown>(m_exec->globalData(), jsString(m_exec, result.toUString()));
 }
 
+// The escaped form of each ASCII character: 0 if it needs no escaping, or the character
+// to follow the backslash, where 'u' means a \uXXXX escape.
+static const char escapedASCIICharacters[128] = {
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    0,   0,   '"', 0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   '\\', 0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+};
+
 void Stringifier::appendQuotedString(UStringBuilder& builder, const UString& value)
 {
     int length = value.length();
@@ -271,52 +293,78 @@ void Stringifier::appendQuotedString(UStringBuilder& builder, const UString& val
     const UChar* data = value.characters();
     for (int i = 0; i < length; ++i) {
         int start = i;
-        while (i < length && (data[i] > 0x1F && data[i] != '"' && data[i] != '\\'))
+        while (i < length && (data[i] >= WTF_ARRAY_LENGTH(escapedASCIICharacters) || !escapedASCIICharacters[data[i]]))
             ++i;
         builder.append(data + start, i - start);
         if (i >= length)
             break;
-        switch (data[i]) {
-            case '\t':
-                builder.append('\\');
-                builder.append('t');
-                break;
-            case '\r':
-                builder.append('\\');
-                builder.append('r');
-                break;
-            case '\n':
-                builder.append('\\');
-                builder.append('n');
-                break;
-            case '\f':
-                builder.append('\\');
-                builder.append('f');
-                break;
-            case '\b':
-                builder.append('\\');
-                builder.append('b');
-                break;
-            case '"':
-                builder.append('\\');
-                builder.append('"');
-                break;
-            case '\\':
-                builder.append('\\');
-                builder.append('\\');
-                break;
-            default:
-                static const char hexDigits[] = "0123456789abcdef";
-                UChar ch = data[i];
-                UChar hex[] = { '\\', 'u', hexDigits[(ch >> 12) & 0xF], hexDigits[(ch >> 8) & 0xF], hexDigits[(ch >> 4) & 0xF], hexDigits[ch & 0xF] };
-                builder.append(hex, WTF_ARRAY_LENGTH(hex));
-                break;
+
+        UChar ch = data[i];
+        char escaped = escapedASCIICharacters[ch];
+        if (escaped != 'u') {
+            UChar escape[] = { '\\', static_cast<UChar>(escaped) };
+            builder.append(escape, WTF_ARRAY_LENGTH(escape));
+            continue;
         }
+        static const char hexDigits[] = "0123456789abcdef";
+        UChar hex[] = { '\\', 'u',
+            static_cast<UChar>(hexDigits[(ch >> 12) & 0xF]), static_cast<UChar>(hexDigits[(ch >> 8) & 0xF]),
+            static_cast<UChar>(hexDigits[(ch >> 4) & 0xF]), static_cast<UChar>(hexDigits[ch & 0xF]) };
+        builder.append(hex, WTF_ARRAY_LENGTH(hex));
     }
 
     builder.append('"');
 }
 
+// Formats the number in place, rather than through a temporary UString.
+void Stringifier::appendNumber(UStringBuilder& builder, JSValue value)
+{
+    ASSERT(value.isNumber());
+    if (value.isInt32()) {
+        int32_t integer = value.asInt32();
+        UChar buffer[1 + sizeof(integer) * 3];
+        UChar* end = buffer + WTF_ARRAY_LENGTH(buffer);
+        UChar* p = end;
+        uint32_t magnitude = integer < 0 ? -static_cast<uint32_t>(integer) : integer;
+        do {
+            *--p = static_cast<UChar>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude);
+        if (integer < 0)
+            *--p = '-';
+        builder.append(p, end - p);
+        return;
+    }
+
+    double number = value.asDouble();
+    if (!isfinite(number)) {
+        builder.append("null", 4);
+        return;
+    }
+    NumberToStringBuffer buffer;
+    unsigned length = numberToString(number, buffer);
+    builder.append(buffer, length);
+}
+
+// Objects built by the same code share a Structure, and so have the same property names;
+// the names found for the last such object are reused while the Structure stays the same.
+PassRefPtr<PropertyNameArrayData> Stringifier::ownPropertyNames(JSObject* object)
+{
+    Structure* structure = object->structure();
+    bool namesFollowFromStructure = !structure->isDictionary() && !structure->typeInfo().overridesGetPropertyNames();
+    if (namesFollowFromStructure && structure == m_propertyNamesStructure.get())
+        return m_propertyNames;
+
+    PropertyNameArray propertyNames(m_exec);
+    object->getOwnPropertyNames(m_exec, propertyNames);
+    RefPtr<PropertyNameArrayData> names = propertyNames.releaseData();
+    if (namesFollowFromStructure) {
+        m_propertyNamesStructure = structure;
+        m_propertyNames = names;
+    }
+    return names.release();
+}
+
 inline JSValue Stringifier::toJSON(JSValue value, const PropertyNameForFunctionCall& propertyName)
 {
     ASSERT(!m_exec->hadException());
@@ -381,12 +429,8 @@ Stringifier::StringifyResult Stringifier::appendStringifiedValue(UStringBuilder&
         return StringifySucceeded;
     }
 
-    double numericValue;
-    if (value.getNumber(numericValue)) {
-        if (!isfinite(numericValue))
-            builder.append("null");
-        else
-            builder.append(UString::number(numericValue));
+    if (value.isNumber()) {
+        appendNumber(builder, value);
         return StringifySucceeded;
     }
 
@@ -488,11 +532,8 @@ bool Stringifier::Holder::appendNextProperty(Stringifier& stringifier, UStringBu
         } else {
             if (stringifier.m_usingArrayReplacer)
                 m_propertyNames = stringifier.m_arrayReplacerPropertyNames.data();
-            else {
-                PropertyNameArray objectPropertyNames(exec);
-                m_object->getOwnPropertyNames(exec, objectPropertyNames);
-                m_propertyNames = objectPropertyNames.releaseData();
-            }
+            else
+                m_propertyNames = stringifier.ownPropertyNames(m_object.get());
             m_size = m_propertyNames->propertyNameVector().size();
             builder.append('{');
         }
@@ -33,6 +33,8 @@
 namespace JSC {
     
 static const unsigned substringFromRopeCutoff = 4;
+static const unsigned ropeTraversalCutoff = 32;
+static const unsigned ropeSearchPatternLengthCutoff = 32;
 
 // Overview: this methods converts a JSString from holding a string in rope form
 // down to a simple UString representation.  It does so by building up the string
@@ -214,16 +216,130 @@ JSValue JSString::replaceCharacter(ExecState* exec, UChar character, const UStri
     return JSValue(new (globalData) JSString(globalData, builder.release()));
 }
 
-JSString* JSString::getIndexSlowCase(ExecState* exec, unsigned i)
+// Descends through the rope towards the fiber holding the character, skipping whole fibers
+// that end before it. Gives up once the rope turns out to be nested too deeply.
+static bool characterInFibers(RopeImpl::Fiber* fibers, unsigned fiberCount, unsigned index, UChar& character)
+{
+    for (unsigned depth = 0; depth < ropeTraversalCutoff; ++depth) {
+        unsigned i = 0;
+        while (index >= fibers[i]->length()) {
+            index -= fibers[i]->length();
+            ++i;
+            ASSERT_UNUSED(fiberCount, i < fiberCount);
+        }
+
+        RopeImpl::Fiber fiber = fibers[i];
+        if (!RopeImpl::isRope(fiber)) {
+            character = static_cast<StringImpl*>(fiber)->characters()[index];
+            return true;
+        }
+
+        RopeImpl* rope = static_cast<RopeImpl*>(fiber);
+        fibers = rope->fibers();
+        fiberCount = rope->fiberCount();
+    }
+    return false;
+}
+
+// Code that walks a deep rope one character at a time would pay for the descent on every
+// access, so such ropes are flattened once instead.
+UChar JSString::characterAtSlowCase(ExecState* exec, unsigned i)
 {
     ASSERT(isRope());
+    ASSERT(i < m_length);
+
+    UChar character;
+    if (characterInFibers(m_other.m_fibers.data(), m_fiberCount, i, character))
+        return character;
+
     resolveRope(exec);
     // Return a safe no-value result, this should never be used, since the excetion will be thrown.
     if (exec->exception())
-        return jsString(exec, "");
+        return 0;
     ASSERT(!isRope());
     ASSERT(i < m_value.length());
-    return jsSingleCharacterSubstring(exec, m_value, i);
+    return m_value.characters()[i];
+}
+
+JSString* JSString::getIndexSlowCase(ExecState* exec, unsigned i)
+{
+    ASSERT(isRope());
+    UChar character = characterAtSlowCase(exec, i);
+    // Return a safe no-value result, this should never be used, since the excetion will be thrown.
+    if (exec->exception())
+        return jsString(exec, "");
+    return jsSingleCharacterString(exec, character);
+}
+
+static bool matchesAcrossFibers(const Vector<StringImpl*, 32>& fibers, size_t fiberIndex, unsigned offset, const UChar* pattern, unsigned patternLength)
+{
+    for (unsigned i = 0; i < patternLength; ++i) {
+        while (offset == fibers[fiberIndex]->length()) {
+            if (++fiberIndex == fibers.size())
+                return false;
+            offset = 0;
+        }
+        if (fibers[fiberIndex]->characters()[offset++] != pattern[i])
+            return false;
+    }
+    return true;
+}
+
+// Searches each fiber in turn, then checks the few positions near its end where a match could
+// straddle into the following fibers. Ropes with many fibers, and long patterns, are flattened
+// and searched as a whole instead.
+size_t JSString::findInRope(ExecState* exec, const UString& pattern, unsigned start)
+{
+    ASSERT(isRope());
+
+    unsigned patternLength = pattern.length();
+    if (!patternLength)
+        return std::min(start, m_length);
+
+    Vector<StringImpl*, 32> fibers;
+    bool searchFibers = patternLength <= ropeSearchPatternLengthCutoff;
+    if (searchFibers) {
+        RopeIterator end;
+        for (RopeIterator it(m_other.m_fibers.data(), m_fiberCount); it != end; ++it) {
+            if (fibers.size() == ropeTraversalCutoff) {
+                searchFibers = false;
+                break;
+            }
+            fibers.append(*it);
+        }
+    }
+
+    if (!searchFibers) {
+        resolveRope(exec);
+        if (exec->exception())
+            return notFound;
+        return m_value.find(pattern, start);
+    }
+
+    const UChar* patternCharacters = pattern.characters();
+    unsigned fiberStart = 0;
+    for (size_t i = 0; i < fibers.size(); ++i) {
+        StringImpl* fiber = fibers[i];
+        unsigned fiberLength = fiber->length();
+        if (fiberStart + fiberLength <= start) {
+            fiberStart += fiberLength;
+            continue;
+        }
+        unsigned searchStart = start > fiberStart ? start - fiberStart : 0;
+
+        // A match that lies entirely within this fiber starts before any match that straddles its end.
+        size_t matchPosition = fiber->find(pattern.impl(), searchStart);
+        if (matchPosition != notFound)
+            return fiberStart + matchPosition;
+
+        unsigned straddleStart = fiberLength >= patternLength ? fiberLength - patternLength + 1 : 0;
+        for (unsigned position = std::max(searchStart, straddleStart); position < fiberLength; ++position) {
+            if (matchesAcrossFibers(fibers, i, position, patternCharacters, patternLength))
+                return fiberStart + position;
+        }
+        fiberStart += fiberLength;
+    }
+    return notFound;
 }
 
 JSValue JSString::toPrimitive(ExecState*, PreferredPrimitiveType) const
@@ -346,6 +346,10 @@ namespace JSC {
         bool canGetIndex(unsigned i) { return i < m_length; }
         JSString* getIndex(ExecState*, unsigned);
         JSString* getIndexSlowCase(ExecState*, unsigned);
+        UChar characterAt(ExecState*, unsigned);
+
+        // Like UString::find, but searches short ropes without flattening them.
+        size_t find(ExecState*, const UString&, unsigned start);
 
         JSValue replaceCharacter(ExecState*, UChar, const UString& replacement);
 
@@ -360,6 +364,8 @@ namespace JSC {
 
         void resolveRope(ExecState*) const;
         JSString* substringFromRope(ExecState*, unsigned offset, unsigned length);
+        UChar characterAtSlowCase(ExecState*, unsigned);
+        size_t findInRope(ExecState*, const UString&, unsigned start);
 
         void appendStringInConstruct(unsigned& index, const UString& string)
         {
@@ -505,6 +511,21 @@ namespace JSC {
         return jsSingleCharacterSubstring(exec, m_value, i);
     }
 
+    inline UChar JSString::characterAt(ExecState* exec, unsigned i)
+    {
+        ASSERT(canGetIndex(i));
+        if (isRope())
+            return characterAtSlowCase(exec, i);
+        return m_value.characters()[i];
+    }
+
+    inline size_t JSString::find(ExecState* exec, const UString& pattern, unsigned start)
+    {
+        if (isRope())
+            return findInRope(exec, pattern, start);
+        return m_value.find(pattern, start);
+    }
+
     inline JSString* jsString(JSGlobalData* globalData, const UString& s)
     {
         int size = s.length();
@@ -141,8 +141,21 @@ template <LiteralParser::ParserMode mode> static inline bool isSafeStringCharact
 template <LiteralParser::ParserMode mode> inline LiteralParser::TokenType LiteralParser::Lexer::lexString(LiteralParserToken& token)
 {
     ++m_ptr;
-    const UChar* runStart;
+    const UChar* runStart = m_ptr;
+    while (m_ptr < m_end && isSafeStringCharacter<mode>(*m_ptr))
+        ++m_ptr;
+    if (m_ptr < m_end && *m_ptr == '"') {
+        // Most strings have no escapes, and are used without being copied in to a builder.
+        token.stringBuffer = runStart;
+        token.stringLength = m_ptr - runStart;
+        token.stringToken = UString();
+        token.type = TokString;
+        token.end = ++m_ptr;
+        return TokString;
+    }
+
     UStringBuilder builder;
+    builder.append(runStart, m_ptr - runStart);
     do {
         runStart = m_ptr;
         while (m_ptr < m_end && isSafeStringCharacter<mode>(*m_ptr))
@@ -208,6 +221,8 @@ template <LiteralParser::ParserMode mode> inline LiteralParser::TokenType Litera
         return TokError;
 
     token.stringToken = builder.toUString();
+    token.stringBuffer = token.stringToken.characters();
+    token.stringLength = token.stringToken.length();
     token.type = TokString;
     token.end = ++m_ptr;
     return TokString;
@@ -243,6 +258,23 @@ LiteralParser::TokenType LiteralParser::Lexer::lexNumber(LiteralParserToken& tok
     } else
         return TokError;
 
+    // Integers short enough to be exact in an int are by far the most common numbers,
+    // and are converted without going through strtod.
+    const int maximumShortIntegerLength = 9;
+    if ((m_ptr >= m_end || (*m_ptr != '.' && *m_ptr != 'e' && *m_ptr != 'E')) && m_ptr - token.start <= maximumShortIntegerLength) {
+        const UChar* digit = token.start;
+        bool negative = *digit == '-';
+        if (negative)
+            ++digit;
+        int result = 0;
+        for (; digit < m_ptr; ++digit)
+            result = result * 10 + (*digit - '0');
+        token.type = TokNumber;
+        token.end = m_ptr;
+        token.numberToken = negative ? -static_cast<double>(result) : result;
+        return TokNumber;
+    }
+
     // ('.' [0-9]+)?
     if (m_ptr < m_end && *m_ptr == '.') {
         ++m_ptr;
@@ -287,6 +319,37 @@ LiteralParser::TokenType LiteralParser::Lexer::lexNumber(LiteralParserToken& tok
     return TokNumber;
 }
 
+Identifier LiteralParser::makeIdentifier(const UChar* characters, unsigned length)
+{
+    if (!length)
+        return m_exec->globalData().propertyNames->emptyIdentifier;
+    if (characters[0] >= maximumCachableCharacter)
+        return Identifier(&m_exec->globalData(), characters, length);
+
+    if (length == 1) {
+        Identifier& identifier = m_shortIdentifiers[characters[0]];
+        if (identifier.isNull())
+            identifier = Identifier(&m_exec->globalData(), characters, length);
+        return identifier;
+    }
+
+    Identifier& identifier = m_recentIdentifiers[characters[0]];
+    if (!identifier.isNull() && static_cast<unsigned>(identifier.length()) == length && !memcmp(identifier.characters(), characters, length * sizeof(UChar)))
+        return identifier;
+    identifier = Identifier(&m_exec->globalData(), characters, length);
+    return identifier;
+}
+
+inline JSValue LiteralParser::makeString(const Lexer::LiteralParserToken& token)
+{
+    ASSERT(token.type == TokString);
+    if (token.stringLength == 1)
+        return jsSingleCharacterString(m_exec, token.stringBuffer[0]);
+    if (!token.stringToken.isNull())
+        return jsString(m_exec, token.stringToken);
+    return jsString(m_exec, UString(token.stringBuffer, token.stringLength));
+}
+
 JSValue LiteralParser::parse(ParserState initialState)
 {
     ParserState state = initialState;
@@ -345,7 +408,7 @@ JSValue LiteralParser::parse(ParserState initialState)
                         return JSValue();
                     
                     m_lexer.next();
-                    identifierStack.append(Identifier(m_exec, identifierToken.stringToken));
+                    identifierStack.append(makeIdentifier(identifierToken.stringBuffer, identifierToken.stringLength));
                     stateStack.append(DoParseObjectEndExpression);
                     goto startParseExpression;
                 } else if (type != TokRBrace) 
@@ -367,7 +430,7 @@ JSValue LiteralParser::parse(ParserState initialState)
                     return JSValue();
 
                 m_lexer.next();
-                identifierStack.append(Identifier(m_exec, identifierToken.stringToken));
+                identifierStack.append(makeIdentifier(identifierToken.stringBuffer, identifierToken.stringLength));
                 stateStack.append(DoParseObjectEndExpression);
                 goto startParseExpression;
             }
@@ -394,7 +457,7 @@ JSValue LiteralParser::parse(ParserState initialState)
                     case TokString: {
                         Lexer::LiteralParserToken stringToken = m_lexer.currentToken();
                         m_lexer.next();
-                        lastValue = jsString(m_exec, stringToken.stringToken);
+                        lastValue = makeString(stringToken);
                         break;
                     }
                     case TokNumber: {
@@ -26,9 +26,11 @@
 #ifndef LiteralParser_h
 #define LiteralParser_h
 
+#include "Identifier.h"
 #include "JSGlobalObjectFunctions.h"
 #include "JSValue.h"
 #include "UString.h"
+#include <wtf/FixedArray.h>
 
 namespace JSC {
 
@@ -66,6 +68,10 @@ namespace JSC {
                 TokenType type;
                 const UChar* start;
                 const UChar* end;
+                // The characters of a string token. A string without escapes is left in
+                // the source; otherwise the characters are those of stringToken.
+                const UChar* stringBuffer;
+                unsigned stringLength;
                 UString stringToken;
                 double numberToken;
             };
@@ -101,9 +107,18 @@ namespace JSC {
         class StackGuard;
         JSValue parse(ParserState);
 
+        // JSON tends to repeat the same few property names many times over, so the most
+        // recent identifier for each leading character is remembered, saving the cost of
+        // hashing the name into the identifier table again.
+        static const unsigned maximumCachableCharacter = 128;
+        Identifier makeIdentifier(const UChar* characters, unsigned length);
+        JSValue makeString(const Lexer::LiteralParserToken&);
+
         ExecState* m_exec;
         LiteralParser::Lexer m_lexer;
         ParserMode m_mode;
+        FixedArray<Identifier, maximumCachableCharacter> m_shortIdentifiers;
+        FixedArray<Identifier, maximumCachableCharacter> m_recentIdentifiers;
     };
 }
 
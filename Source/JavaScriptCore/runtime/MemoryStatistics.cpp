@@ -39,8 +39,12 @@ GlobalMemoryStatistics globalMemoryStatistics()
     stats.stackBytes = RegisterFile::committedByteCount();
 #if ENABLE(EXECUTABLE_ALLOCATOR_FIXED)
     stats.JITBytes = ExecutableAllocator::committedByteCount();
+    stats.JITFreeBytes = ExecutableAllocator::freeByteCount();
+    stats.JITLargestFreeBlockBytes = ExecutableAllocator::largestFreeBlockByteCount();
 #else
     stats.JITBytes = 0;
+    stats.JITFreeBytes = 0;
+    stats.JITLargestFreeBlockBytes = 0;
 #endif
     return stats;
 }
@@ -25,6 +25,8 @@
 #include "WriteBarrier.h"
 #include <wtf/HashTable.h>
 #include <wtf/PassOwnPtr.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/RefCounted.h>
 #include <wtf/Vector.h>
 
 
@@ -85,7 +87,8 @@ struct PropertyMapEntry {
     }
 };
 
-class PropertyTable {
+// A PropertyTable may be shared by the Structures along a transition chain; see Structure.h.
+class PropertyTable : public RefCounted<PropertyTable> {
     WTF_MAKE_FAST_ALLOCATED;
 
     // This is the implementation for 'iterator' and 'const_iterator',
@@ -141,10 +144,10 @@ public:
     // give the point in m_index where an entry should be inserted.
     typedef std::pair<ValueType*, unsigned> find_iterator;
 
-    // Constructor is passed an initial capacity, a PropertyTable to copy, or both.
-    explicit PropertyTable(unsigned initialCapacity);
-    PropertyTable(JSGlobalData&, JSCell*, const PropertyTable&);
-    PropertyTable(JSGlobalData&, JSCell*, unsigned initialCapacity, const PropertyTable&);
+    // Created with an initial capacity, a PropertyTable to copy, or both.
+    static PassRefPtr<PropertyTable> create(unsigned initialCapacity);
+    static PassRefPtr<PropertyTable> create(JSGlobalData&, JSCell* owner, const PropertyTable&);
+    static PassRefPtr<PropertyTable> create(JSGlobalData&, JSCell* owner, unsigned initialCapacity, const PropertyTable&);
     ~PropertyTable();
 
     // Ordered iteration methods.
@@ -177,7 +180,7 @@ public:
     void addDeletedOffset(unsigned offset);
 
     // Copy this PropertyTable, ensuring the copy has at least the capacity provided.
-    PassOwnPtr<PropertyTable> copy(JSGlobalData&, JSCell* owner, unsigned newCapacity);
+    PassRefPtr<PropertyTable> copy(JSGlobalData&, JSCell* owner, unsigned newCapacity);
 
 #ifndef NDEBUG
     size_t sizeInMemory();
@@ -185,6 +188,9 @@ public:
 #endif
 
 private:
+    explicit PropertyTable(unsigned initialCapacity);
+    PropertyTable(JSGlobalData&, JSCell*, const PropertyTable&);
+    PropertyTable(JSGlobalData&, JSCell*, unsigned initialCapacity, const PropertyTable&);
     PropertyTable(const PropertyTable&);
     // Used to insert a value known not to be in the table, and where we know capacity to be available.
     void reinsert(const ValueType& entry);
@@ -235,6 +241,21 @@ private:
     static const unsigned EmptyEntryIndex = 0;
 };
 
+inline PassRefPtr<PropertyTable> PropertyTable::create(unsigned initialCapacity)
+{
+    return adoptRef(new PropertyTable(initialCapacity));
+}
+
+inline PassRefPtr<PropertyTable> PropertyTable::create(JSGlobalData& globalData, JSCell* owner, const PropertyTable& other)
+{
+    return adoptRef(new PropertyTable(globalData, owner, other));
+}
+
+inline PassRefPtr<PropertyTable> PropertyTable::create(JSGlobalData& globalData, JSCell* owner, unsigned initialCapacity, const PropertyTable& other)
+{
+    return adoptRef(new PropertyTable(globalData, owner, initialCapacity, other));
+}
+
 inline PropertyTable::PropertyTable(unsigned initialCapacity)
     : m_indexSize(sizeForCapacity(initialCapacity))
     , m_indexMask(m_indexSize - 1)
@@ -448,15 +469,15 @@ inline void PropertyTable::addDeletedOffset(unsigned offset)
     m_deletedOffsets->append(offset);
 }
 
-inline PassOwnPtr<PropertyTable> PropertyTable::copy(JSGlobalData& globalData, JSCell* owner, unsigned newCapacity)
+inline PassRefPtr<PropertyTable> PropertyTable::copy(JSGlobalData& globalData, JSCell* owner, unsigned newCapacity)
 {
     ASSERT(newCapacity >= m_keyCount);
 
     // Fast case; if the new table will be the same m_indexSize as this one, we can memcpy it,
     // save rehashing all keys.
     if (sizeForCapacity(newCapacity) == m_indexSize)
-        return new PropertyTable(globalData, owner, *this);
-    return new PropertyTable(globalData, owner, newCapacity, *this);
+        return create(globalData, owner, *this);
+    return create(globalData, owner, newCapacity, *this);
 }
 
 #ifndef NDEBUG
@@ -100,6 +100,39 @@ PassRefPtr<RegExp> RegExp::create(JSGlobalData* globalData, const UString& patte
     return res.release();
 }
 
+// Patterns that are nothing but a sequence of characters, such as /,/ or /\r\n/, are matched
+// with a plain string search instead of running the compiled matcher.
+// Quantifiers can make the literal far longer than the pattern, as in /a{4000000000}/,
+// so longer literals are left to the matcher.
+static const unsigned maximumLiteralPatternLength = 256;
+
+static bool isLiteralPattern(const Yarr::YarrPattern& pattern, UString& literal)
+{
+    if (pattern.m_ignoreCase || pattern.m_body->m_alternatives.size() != 1)
+        return false;
+
+    const Vector<Yarr::PatternTerm>& terms = pattern.m_body->m_alternatives[0]->m_terms;
+    if (terms.isEmpty())
+        return false;
+
+    Vector<UChar> characters;
+    for (size_t i = 0; i < terms.size(); ++i) {
+        const Yarr::PatternTerm& term = terms[i];
+        if (term.type != Yarr::PatternTerm::TypePatternCharacter || term.quantityType != Yarr::QuantifierFixedCount)
+            return false;
+        if (term.quantityCount > maximumLiteralPatternLength - characters.size())
+            return false;
+        for (unsigned j = 0; j < term.quantityCount; ++j)
+            characters.append(term.patternCharacter);
+    }
+
+    if (characters.isEmpty())
+        return false;
+
+    literal = UString::adopt(characters);
+    return true;
+}
+
 RegExp::RegExpState RegExp::compile(JSGlobalData* globalData)
 {
     Yarr::YarrPattern pattern(m_patternString, ignoreCase(), multiline(), &m_constructionError);
@@ -108,6 +141,9 @@ RegExp::RegExpState RegExp::compile(JSGlobalData* globalData)
 
     m_numSubpatterns = pattern.m_numSubpatterns;
 
+    if (isLiteralPattern(pattern, m_literal))
+        return Literal;
+
     RegExpState res = ByteCode;
 
 #if ENABLE(YARR_JIT)
@@ -130,15 +166,40 @@ RegExp::RegExpState RegExp::compile(JSGlobalData* globalData)
     return res;
 }
 
-int RegExp::match(const UString& s, int startOffset, Vector<int, 32>* ovector)
+inline int RegExp::execute(const UString& s, int startOffset, int* offsetVector)
 {
-    if (startOffset < 0)
-        startOffset = 0;
-
 #if ENABLE(REGEXP_TRACING)
     m_rtMatchCallCount++;
 #endif
 
+    if (m_state == Literal) {
+        size_t position = s.find(m_literal, startOffset);
+        if (position == notFound)
+            return -1;
+        offsetVector[0] = position;
+        offsetVector[1] = position + m_literal.length();
+        return position;
+    }
+
+    int result;
+#if ENABLE(YARR_JIT)
+    if (m_state == JITCode) {
+        result = Yarr::execute(m_representation->m_regExpJITCode, s.characters(), startOffset, s.length(), offsetVector);
+#if ENABLE(YARR_JIT_DEBUG)
+        matchCompareWithInterpreter(s, startOffset, offsetVector, result);
+#endif
+    } else
+#endif
+        result = Yarr::interpret(m_representation->m_regExpBytecode.get(), s.characters(), startOffset, s.length(), offsetVector);
+    ASSERT(result >= -1);
+    return result;
+}
+
+int RegExp::match(const UString& s, int startOffset, Vector<int, 32>* ovector)
+{
+    if (startOffset < 0)
+        startOffset = 0;
+
     if (static_cast<unsigned>(startOffset) > s.length() || s.isNull())
         return -1;
 
@@ -161,17 +222,7 @@ int RegExp::match(const UString& s, int startOffset, Vector<int, 32>* ovector)
         for (unsigned j = 0, i = 0; i < m_numSubpatterns + 1; j += 2, i++)            
             offsetVector[j] = -1;
 
-        int result;
-#if ENABLE(YARR_JIT)
-        if (m_state == JITCode) {
-            result = Yarr::execute(m_representation->m_regExpJITCode, s.characters(), startOffset, s.length(), offsetVector);
-#if ENABLE(YARR_JIT_DEBUG)
-            matchCompareWithInterpreter(s, startOffset, offsetVector, result);
-#endif
-        } else
-#endif
-            result = Yarr::interpret(m_representation->m_regExpBytecode.get(), s.characters(), startOffset, s.length(), offsetVector);
-        ASSERT(result >= -1);
+        int result = execute(s, startOffset, offsetVector);
 
 #if ENABLE(REGEXP_TRACING)
         if (result != -1)
@@ -184,6 +235,53 @@ int RegExp::match(const UString& s, int startOffset, Vector<int, 32>* ovector)
     return -1;
 }
 
+size_t RegExp::estimatedSize() const
+{
+    size_t size = sizeof(RegExp) + sizeof(RegExpRepresentation) + (m_patternString.length() + m_literal.length()) * sizeof(UChar);
+#if ENABLE(YARR_JIT)
+    size += m_representation->m_regExpJITCode.size();
+#endif
+    if (Yarr::BytecodePattern* bytecode = m_representation->m_regExpBytecode.get())
+        size += sizeof(Yarr::BytecodePattern) + bytecode->m_body->terms.size() * sizeof(Yarr::ByteTerm);
+    return size;
+}
+
+unsigned RegExp::matchAll(const UString& s, int startOffset, Vector<int, 32>& matches)
+{
+    if (startOffset < 0)
+        startOffset = 0;
+
+    if (m_state == ParseError || s.isNull())
+        return 0;
+
+    // Each match writes its offset vector straight into 'matches', so no temporary vectors are
+    // needed however many matches there are.
+    unsigned offsetVectorSize = (m_numSubpatterns + 1) * 2;
+    unsigned length = s.length();
+    unsigned matchCount = 0;
+    for (unsigned position = startOffset; position <= length; ) {
+        size_t base = matches.size();
+        matches.grow(base + offsetVectorSize);
+        int* offsetVector = matches.data() + base;
+        for (unsigned i = 0; i < offsetVectorSize; i += 2)
+            offsetVector[i] = -1;
+
+        int result = execute(s, position, offsetVector);
+        if (result < 0) {
+            matches.shrink(base);
+            break;
+        }
+
+#if ENABLE(REGEXP_TRACING)
+        m_rtMatchFoundCount++;
+#endif
+        ++matchCount;
+        // Step over empty matches, so the next search makes progress.
+        position = offsetVector[1] == result ? offsetVector[1] + 1 : offsetVector[1];
+    }
+    return matchCount;
+}
+
 
 #if ENABLE(YARR_JIT_DEBUG)
 void RegExp::matchCompareWithInterpreter(const UString& s, int startOffset, int* offsetVector, int jitResult)
@@ -51,6 +51,14 @@ namespace JSC {
 
         int match(const UString&, int startOffset, Vector<int, 32>* ovector = 0);
         unsigned numSubpatterns() const { return m_numSubpatterns; }
+
+        // Finds every match from startOffset onwards, advancing past empty matches as a global
+        // replace does, and appends the offset vector of each one to 'matches'. Returns the
+        // number of matches found.
+        unsigned matchAll(const UString&, int startOffset, Vector<int, 32>& matches);
+
+        // Approximate number of bytes held by this RegExp, including its compiled code.
+        size_t estimatedSize() const;
         
 #if ENABLE(REGEXP_TRACING)
         void printTraceData();
@@ -62,16 +70,19 @@ namespace JSC {
         enum RegExpState {
             ParseError,
             JITCode,
-            ByteCode
+            ByteCode,
+            Literal
         } m_state;
 
         RegExpState compile(JSGlobalData*);
+        int execute(const UString&, int startOffset, int* offsetVector);
 
 #if ENABLE(YARR_JIT_DEBUG)
         void matchCompareWithInterpreter(const UString&, int startOffset, int* offsetVector, int jitResult);
 #endif
 
         UString m_patternString;
+        UString m_literal;
         RegExpFlags m_flags;
         const char* m_constructionError;
         unsigned m_numSubpatterns;
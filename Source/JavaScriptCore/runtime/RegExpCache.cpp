@@ -33,45 +33,54 @@ namespace JSC {
 
 PassRefPtr<RegExp> RegExpCache::lookupOrCreate(const UString& patternString, RegExpFlags flags)
 {
-    if (patternString.length() < maxCacheablePatternLength) {
-        pair<RegExpCacheMap::iterator, bool> result = m_cacheMap.add(RegExpKey(flags, patternString), 0);
-        if (!result.second)
-            return result.first->second;
-        else
-            return create(patternString, flags, result.first);
+    RegExpKey key(flags, patternString);
+    RegExpCacheMap::iterator iterator = m_cacheMap.find(key);
+    if (iterator != m_cacheMap.end()) {
+        ++m_statistics.hits;
+        Entry* entry = iterator->second;
+        m_lruList.remove(entry);
+        m_lruList.append(entry);
+        return entry->regExp();
     }
-    return create(patternString, flags, m_cacheMap.end());
-}
 
-PassRefPtr<RegExp> RegExpCache::create(const UString& patternString, RegExpFlags flags, RegExpCacheMap::iterator iterator) 
-{
+    ++m_statistics.misses;
     RefPtr<RegExp> regExp = RegExp::create(m_globalData, patternString, flags);
 
-    if (patternString.length() >= maxCacheablePatternLength)
-        return regExp;
+    size_t size = regExp->estimatedSize();
+    if (size > maxCacheableEntryBytes)
+        return regExp.release();
 
-    RegExpKey key = RegExpKey(flags, patternString);
-    iterator->first = key;
-    iterator->second = regExp;
+    evictToBudget(maxCacheableBytes - size);
 
-    ++m_nextKeyToEvict;
-    if (m_nextKeyToEvict == maxCacheableEntries) {
-        m_nextKeyToEvict = 0;
-        m_isFull = true;
-    }
-    if (m_isFull)
-        m_cacheMap.remove(RegExpKey(patternKeyArray[m_nextKeyToEvict].flagsValue, patternKeyArray[m_nextKeyToEvict].pattern));
+    Entry* entry = new Entry(key, regExp, size);
+    m_cacheMap.set(key, entry);
+    m_lruList.append(entry);
+    m_size += size;
+    return regExp.release();
+}
 
-    patternKeyArray[m_nextKeyToEvict].flagsValue = key.flagsValue;
-    patternKeyArray[m_nextKeyToEvict].pattern = patternString.impl();
-    return regExp;
+void RegExpCache::evictToBudget(size_t budget)
+{
+    while (m_size > budget) {
+        Entry* entry = m_lruList.head();
+        ASSERT(entry);
+        m_lruList.remove(entry);
+        m_cacheMap.remove(entry->key());
+        m_size -= entry->size();
+        ++m_statistics.evictions;
+        delete entry;
+    }
 }
 
 RegExpCache::RegExpCache(JSGlobalData* globalData)
-    : m_globalData(globalData)
-    , m_nextKeyToEvict(-1)
-    , m_isFull(false)
+    : m_size(0)
+    , m_globalData(globalData)
+{
+}
+
+RegExpCache::~RegExpCache()
 {
+    deleteAllValues(m_cacheMap);
 }
 
 }
@@ -28,39 +28,94 @@
 #include "RegExp.h"
 #include "RegExpKey.h"
 #include "UString.h"
-#include <wtf/FixedArray.h>
+#include <wtf/DoublyLinkedList.h>
 #include <wtf/HashMap.h>
+#include <wtf/Noncopyable.h>
 
 #ifndef RegExpCache_h
 #define RegExpCache_h
 
 namespace JSC {
 
+// Keeps recently used RegExps alive, so that re-evaluating a regular expression literal or
+// calling String.prototype.match with the same pattern string does not recompile it. Entries
+// are evicted in least recently used order once their estimated size, which includes any JIT
+// code, exceeds the cache's byte budget.
 class RegExpCache {
+    WTF_MAKE_NONCOPYABLE(RegExpCache);
 
-typedef HashMap<RegExpKey, RefPtr<RegExp> > RegExpCacheMap;
+    class Entry {
+    public:
+        Entry(const RegExpKey& key, PassRefPtr<RegExp> regExp, size_t size)
+            : m_key(key)
+            , m_regExp(regExp)
+            , m_size(size)
+            , m_prev(0)
+            , m_next(0)
+        {
+        }
+
+        const RegExpKey& key() const { return m_key; }
+        RegExp* regExp() const { return m_regExp.get(); }
+        size_t size() const { return m_size; }
+
+        Entry* prev() const { return m_prev; }
+        Entry* next() const { return m_next; }
+        void setPrev(Entry* prev) { m_prev = prev; }
+        void setNext(Entry* next) { m_next = next; }
+
+    private:
+        RegExpKey m_key;
+        RefPtr<RegExp> m_regExp;
+        size_t m_size;
+        Entry* m_prev;
+        Entry* m_next;
+    };
+
+    typedef HashMap<RegExpKey, Entry*> RegExpCacheMap;
 
 public:
-    PassRefPtr<RegExp> lookupOrCreate(const UString& patternString, RegExpFlags);
-    PassRefPtr<RegExp> create(const UString& patternString, RegExpFlags, RegExpCacheMap::iterator);
+    struct Statistics {
+        Statistics()
+            : hits(0)
+            , misses(0)
+            , evictions(0)
+        {
+        }
+
+        unsigned hits;
+        unsigned misses;
+        unsigned evictions;
+    };
+
     RegExpCache(JSGlobalData* globalData);
+    ~RegExpCache();
+
+    PassRefPtr<RegExp> lookupOrCreate(const UString& patternString, RegExpFlags);
+
+    const Statistics& statistics() const { return m_statistics; }
+    unsigned entryCount() const { return m_cacheMap.size(); }
+    size_t size() const { return m_size; }
 
 private:
-    static const unsigned maxCacheablePatternLength = 256;
+    void evictToBudget(size_t budget);
 
 #if PLATFORM(IOS)
     // The RegExpCache can currently hold onto multiple Mb of memory;
     // as a short-term fix some embedded platforms may wish to reduce the cache size.
-    static const int maxCacheableEntries = 32;
+    static const size_t maxCacheableBytes = 128 * 1024;
 #else
-    static const int maxCacheableEntries = 256;
+    static const size_t maxCacheableBytes = 1024 * 1024;
 #endif
+    // A single huge pattern should not be able to flush the whole cache.
+    static const size_t maxCacheableEntryBytes = maxCacheableBytes / 16;
 
-    FixedArray<RegExpKey, maxCacheableEntries> patternKeyArray;
     RegExpCacheMap m_cacheMap;
+    // Ordered from least to most recently used.
+    DoublyLinkedList<Entry> m_lruList;
+    size_t m_size;
+    Statistics m_statistics;
     JSGlobalData* m_globalData;
-    int m_nextKeyToEvict;
-    bool m_isFull;
 };
 
 } // namespace JSC
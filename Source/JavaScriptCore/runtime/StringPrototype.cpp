@@ -375,6 +375,32 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncReplace(ExecState* exec)
                         break;
                 }
             }
+        } else if (global && callType == CallTypeNone) {
+            // Nothing can observe the intermediate matches here, so find them all in one pass
+            // and only update the RegExp statics for the last one.
+            Vector<int, 32> matches;
+            unsigned matchCount = reg->matchAll(source, 0, matches);
+            unsigned offsetVectorSize = (reg->numSubpatterns() + 1) * 2;
+            int replLen = replacementString.length();
+            for (unsigned i = 0; i < matchCount; ++i) {
+                int* ovector = matches.data() + i * offsetVectorSize;
+                int matchIndex = ovector[0];
+                if (lastIndex < matchIndex || replLen) {
+                    sourceRanges.append(StringRange(lastIndex, matchIndex - lastIndex));
+
+                    if (replLen)
+                        replacements.append(substituteBackreferences(replacementString, source, ovector, reg));
+                    else
+                        replacements.append(UString());
+                }
+                lastIndex = ovector[1];
+            }
+
+            if (matchCount) {
+                int matchIndex;
+                int matchLen;
+                regExpConstructor->performMatch(reg, source, matches[(matchCount - 1) * offsetVectorSize], matchIndex, matchLen);
+            }
         } else {
             do {
                 int matchIndex;
@@ -484,6 +510,15 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncToString(ExecState* exec)
 EncodedJSValue JSC_HOST_CALL stringProtoFuncCharAt(ExecState* exec)
 {
     JSValue thisValue = exec->hostThisValue();
+    if (thisValue.isString()) {
+        // Avoid flattening ropes just to read a single character.
+        JSString* jsString = asString(thisValue);
+        JSValue a0 = exec->argument(0);
+        double dpos = a0.isUInt32() ? a0.asUInt32() : a0.toInteger(exec);
+        if (dpos >= 0 && dpos < jsString->length())
+            return JSValue::encode(jsString->getIndex(exec, static_cast<unsigned>(dpos)));
+        return JSValue::encode(jsEmptyString(exec));
+    }
     if (thisValue.isUndefinedOrNull()) // CheckObjectCoercible
         return throwVMTypeError(exec);
     UString s = thisValue.toThisString(exec);
@@ -504,6 +539,15 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncCharAt(ExecState* exec)
 EncodedJSValue JSC_HOST_CALL stringProtoFuncCharCodeAt(ExecState* exec)
 {
     JSValue thisValue = exec->hostThisValue();
+    if (thisValue.isString()) {
+        // Avoid flattening ropes just to read a single character.
+        JSString* jsString = asString(thisValue);
+        JSValue a0 = exec->argument(0);
+        double dpos = a0.isUInt32() ? a0.asUInt32() : a0.toInteger(exec);
+        if (dpos >= 0 && dpos < jsString->length())
+            return JSValue::encode(jsNumber(jsString->characterAt(exec, static_cast<unsigned>(dpos))));
+        return JSValue::encode(jsNaN());
+    }
     if (thisValue.isUndefinedOrNull()) // CheckObjectCoercible
         return throwVMTypeError(exec);
     UString s = thisValue.toThisString(exec);
@@ -540,8 +584,16 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncIndexOf(ExecState* exec)
     JSValue thisValue = exec->hostThisValue();
     if (thisValue.isUndefinedOrNull()) // CheckObjectCoercible
         return throwVMTypeError(exec);
-    UString s = thisValue.toThisString(exec);
-    int len = s.length();
+    int len;
+    JSString* jsString = 0;
+    UString s;
+    if (thisValue.isString()) {
+        jsString = asString(thisValue);
+        len = jsString->length();
+    } else {
+        s = thisValue.toThisString(exec);
+        len = s.length();
+    }
 
     JSValue a0 = exec->argument(0);
     JSValue a1 = exec->argument(1);
@@ -560,7 +612,7 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncIndexOf(ExecState* exec)
         pos = static_cast<int>(dpos);
     }
 
-    size_t result = s.find(u2, pos);
+    size_t result = jsString ? jsString->find(exec, u2, pos) : s.find(u2, pos);
     if (result == notFound)
         return JSValue::encode(jsNumber(-1));
     return JSValue::encode(jsNumber(result));
@@ -677,8 +729,16 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncSlice(ExecState* exec)
     JSValue thisValue = exec->hostThisValue();
     if (thisValue.isUndefinedOrNull()) // CheckObjectCoercible
         return throwVMTypeError(exec);
-    UString s = thisValue.toThisString(exec);
-    int len = s.length();
+    int len;
+    JSString* jsString = 0;
+    UString s;
+    if (thisValue.isString()) {
+        jsString = asString(thisValue);
+        len = jsString->length();
+    } else {
+        s = thisValue.toThisString(exec);
+        len = s.length();
+    }
 
     JSValue a0 = exec->argument(0);
     JSValue a1 = exec->argument(1);
@@ -693,7 +753,11 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncSlice(ExecState* exec)
             from = 0;
         if (to > len)
             to = len;
-        return JSValue::encode(jsSubstring(exec, s, static_cast<unsigned>(from), static_cast<unsigned>(to) - static_cast<unsigned>(from)));
+        unsigned substringStart = static_cast<unsigned>(from);
+        unsigned substringLength = static_cast<unsigned>(to) - substringStart;
+        if (jsString)
+            return JSValue::encode(jsSubstring(exec, jsString, substringStart, substringLength));
+        return JSValue::encode(jsSubstring(exec, s, substringStart, substringLength));
     }
 
     return JSValue::encode(jsEmptyString(exec));
@@ -719,12 +783,24 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncSplit(ExecState* exec)
             // empty string matched by regexp -> empty array
             return JSValue::encode(result);
         }
+        // Without a limit every match is going to be needed, so find them all in one pass.
+        bool findAllMatches = limit == 0xFFFFFFFFU;
+        Vector<int, 32> matches;
+        unsigned matchCount = findAllMatches ? reg->matchAll(s, 0, matches) : 0;
+        unsigned offsetVectorSize = (reg->numSubpatterns() + 1) * 2;
         unsigned pos = 0;
-        while (i != limit && pos < s.length()) {
-            Vector<int, 32> ovector;
-            int mpos = reg->match(s, pos, &ovector);
-            if (mpos < 0)
-                break;
+        for (unsigned matchNumber = 0; i != limit && pos < s.length(); ++matchNumber) {
+            const int* ovector;
+            if (findAllMatches) {
+                if (matchNumber == matchCount)
+                    break;
+                ovector = matches.data() + matchNumber * offsetVectorSize;
+            } else {
+                if (reg->match(s, pos, &matches) < 0)
+                    break;
+                ovector = matches.data();
+            }
+            int mpos = ovector[0];
             int mlen = ovector[1] - ovector[0];
             pos = mpos + (mlen == 0 ? 1 : mlen);
             if (static_cast<unsigned>(mpos) != p0 || mlen) {
@@ -137,6 +137,7 @@ void Structure::dumpStatistics()
     unsigned numberSingletons = 0;
     unsigned numberWithPropertyMaps = 0;
     unsigned totalPropertyMapsSize = 0;
+    HashSet<PropertyTable*> propertyMaps;
 
     HashSet<Structure*>::const_iterator end = liveStructureSet.end();
     for (HashSet<Structure*>::const_iterator it = liveStructureSet.begin(); it != end; ++it) {
@@ -156,7 +157,8 @@ void Structure::dumpStatistics()
 
         if (structure->m_propertyTable) {
             ++numberWithPropertyMaps;
-            totalPropertyMapsSize += structure->m_propertyTable->sizeInMemory();
+            if (propertyMaps.add(structure->m_propertyTable.get()).second)
+                totalPropertyMapsSize += structure->m_propertyTable->sizeInMemory();
         }
     }
 
@@ -165,6 +167,7 @@ void Structure::dumpStatistics()
     printf("Number of Structures that are leaf nodes: %d\n", numberLeaf);
     printf("Number of Structures that singletons: %d\n", numberSingletons);
     printf("Number of Structures with PropertyMaps: %d\n", numberWithPropertyMaps);
+    printf("Number of distinct PropertyMaps: %d\n", propertyMaps.size());
 
     printf("Size of a single Structures: %d\n", static_cast<unsigned>(sizeof(Structure)));
     printf("Size of sum of all property maps: %d\n", totalPropertyMapsSize);
@@ -189,6 +192,7 @@ Structure::Structure(JSGlobalData& globalData, JSValue prototype, const TypeInfo
     , m_specificFunctionThrashCount(0)
     , m_anonymousSlotCount(anonymousSlotCount)
     , m_preventExtensions(false)
+    , m_hasBeenFlattenedBefore(false)
 {
     ASSERT(m_prototype);
     ASSERT(m_prototype.isObject() || m_prototype.isNull());
@@ -211,6 +215,7 @@ Structure::Structure(JSGlobalData& globalData)
     , m_specificFunctionThrashCount(0)
     , m_anonymousSlotCount(0)
     , m_preventExtensions(false)
+    , m_hasBeenFlattenedBefore(false)
 {
     ASSERT(m_prototype);
     ASSERT(m_prototype.isNull());
@@ -232,6 +237,7 @@ Structure::Structure(JSGlobalData& globalData, const Structure* previous)
     , m_specificFunctionThrashCount(previous->m_specificFunctionThrashCount)
     , m_anonymousSlotCount(previous->anonymousSlotCount())
     , m_preventExtensions(previous->m_preventExtensions)
+    , m_hasBeenFlattenedBefore(previous->m_hasBeenFlattenedBefore)
 {
     ASSERT(m_prototype);
     ASSERT(m_prototype.isObject() || m_prototype.isNull());
@@ -252,11 +258,8 @@ void Structure::materializePropertyMap(JSGlobalData& globalData)
 
     // Search for the last Structure with a property table.
     while ((structure = structure->previousID())) {
-        if (structure->m_isPinnedPropertyTable) {
-            ASSERT(structure->m_propertyTable);
-            ASSERT(!structure->m_previous);
-
-            m_propertyTable = structure->m_propertyTable->copy(globalData, 0, m_offset + 1);
+        if (structure->m_propertyTable) {
+            m_propertyTable = structure->copyPropertyTable(globalData, this, structures.size());
             break;
         }
 
@@ -333,7 +336,10 @@ Structure* Structure::addPropertyTransition(JSGlobalData& globalData, Structure*
     if (structure->m_specificFunctionThrashCount == maxSpecificFunctionThrashCount)
         specificValue = 0;
 
-    if (structure->transitionCount() > s_maxTransitionLength) {
+    // An object that has been a dictionary before is a singleton, such as a prototype or
+    // a global object, whose transitions no other object will share; add its properties
+    // in place rather than copying its property table for every one of them.
+    if (structure->transitionCount() > s_maxTransitionLength || structure->m_hasBeenFlattenedBefore) {
         Structure* transition = toCacheableDictionaryTransition(globalData, structure);
         ASSERT(structure != transition);
         offset = transition->putSpecificValue(globalData, propertyName, attributes, specificValue);
@@ -355,8 +361,13 @@ Structure* Structure::addPropertyTransition(JSGlobalData& globalData, Structure*
     if (structure->m_propertyTable) {
         if (structure->m_isPinnedPropertyTable)
             transition->m_propertyTable = structure->m_propertyTable->copy(globalData, 0, structure->m_propertyTable->size() + 1);
-        else
-            transition->m_propertyTable = structure->m_propertyTable.release();
+        else if (structure->m_propertyTable->size() == static_cast<unsigned>(structure->transitionCount())) {
+            // No other transition has extended the table past this Structure yet, so
+            // the new one can share it.
+            ASSERT(!structure->m_propertyTable->hasDeletedOffset());
+            transition->m_propertyTable = structure->m_propertyTable;
+        } else
+            transition->m_propertyTable = structure->copyPropertyTable(globalData, transition, 1);
     } else {
         if (structure->m_previous)
             transition->materializePropertyMap(globalData);
@@ -367,10 +378,10 @@ Structure* Structure::addPropertyTransition(JSGlobalData& globalData, Structure*
     offset = transition->putSpecificValue(globalData, propertyName, attributes, specificValue);
     ASSERT(offset >= structure->m_anonymousSlotCount);
     ASSERT(structure->m_anonymousSlotCount == transition->m_anonymousSlotCount);
+    transition->m_offset = offset - structure->m_anonymousSlotCount;
     if (transition->propertyStorageSize() > transition->propertyStorageCapacity())
         transition->growPropertyStorageCapacity();
 
-    transition->m_offset = offset - structure->m_anonymousSlotCount;
     ASSERT(structure->anonymousSlotCount() == transition->anonymousSlotCount());
     structure->m_transitionTable.add(globalData, transition);
     return transition;
@@ -524,6 +535,8 @@ bool Structure::isSealed(JSGlobalData& globalData)
 
     PropertyTable::iterator end = m_propertyTable->end();
     for (PropertyTable::iterator iter = m_propertyTable->begin(); iter != end; ++iter) {
+        if (!isVisibleInPropertyTable(&*iter))
+            continue;
         if ((iter->attributes & DontDelete) != DontDelete)
             return false;
     }
@@ -542,6 +555,8 @@ bool Structure::isFrozen(JSGlobalData& globalData)
 
     PropertyTable::iterator end = m_propertyTable->end();
     for (PropertyTable::iterator iter = m_propertyTable->begin(); iter != end; ++iter) {
+        if (!isVisibleInPropertyTable(&*iter))
+            continue;
         if ((iter->attributes & (DontDelete | ReadOnly)) != (DontDelete | ReadOnly))
             return false;
     }
@@ -574,6 +589,7 @@ Structure* Structure::flattenDictionaryStructure(JSGlobalData& globalData, JSObj
     }
 
     m_dictionaryKind = NoneDictionaryKind;
+    m_hasBeenFlattenedBefore = true;
     return this;
 }
 
@@ -585,6 +601,7 @@ size_t Structure::addPropertyWithoutTransition(JSGlobalData& globalData, const I
         specificValue = 0;
 
     materializePropertyMapIfNecessary(globalData);
+    unsharePropertyTable(globalData);
 
     m_isPinnedPropertyTable = true;
 
@@ -601,6 +618,7 @@ size_t Structure::removePropertyWithoutTransition(JSGlobalData& globalData, cons
     ASSERT(!m_enumerationCache);
 
     materializePropertyMapIfNecessary(globalData);
+    unsharePropertyTable(globalData);
 
     m_isPinnedPropertyTable = true;
     size_t offset = remove(propertyName);
@@ -635,9 +653,27 @@ inline void Structure::checkConsistency()
 
 #endif
 
-PropertyTable* Structure::copyPropertyTable(JSGlobalData& globalData, Structure* owner)
+PassRefPtr<PropertyTable> Structure::copyPropertyTable(JSGlobalData& globalData, Structure* owner, unsigned extraCapacity)
 {
-    return m_propertyTable ? new PropertyTable(globalData, owner, *m_propertyTable) : 0;
+    if (!m_propertyTable)
+        return 0;
+    if (!isSharingPropertyTable())
+        return m_propertyTable->copy(globalData, owner, m_propertyTable->size() + extraCapacity);
+
+    // Copy only the properties this Structure can see; entries were added in offset order.
+    RefPtr<PropertyTable> table = PropertyTable::create(transitionCount() + extraCapacity);
+    PropertyTable::iterator end = m_propertyTable->end();
+    for (PropertyTable::iterator iter = m_propertyTable->begin(); iter != end; ++iter) {
+        if (isVisibleInPropertyTable(&*iter))
+            table->add(PropertyMapEntry(globalData, owner, iter->key, iter->offset, iter->attributes, iter->specificValue.get()));
+    }
+    return table.release();
+}
+
+void Structure::unsharePropertyTable(JSGlobalData& globalData)
+{
+    if (isSharingPropertyTable())
+        m_propertyTable = copyPropertyTable(globalData, this);
 }
 
 size_t Structure::get(JSGlobalData& globalData, StringImpl* propertyName, unsigned& attributes, JSCell*& specificValue)
@@ -647,7 +683,7 @@ size_t Structure::get(JSGlobalData& globalData, StringImpl* propertyName, unsign
         return WTF::notFound;
 
     PropertyMapEntry* entry = m_propertyTable->find(propertyName).first;
-    if (!entry)
+    if (!entry || !isVisibleInPropertyTable(entry))
         return WTF::notFound;
 
     attributes = entry->attributes;
@@ -741,7 +777,7 @@ void Structure::createPropertyMap(unsigned capacity)
     ASSERT(!m_propertyTable);
 
     checkConsistency();
-    m_propertyTable = new PropertyTable(capacity);
+    m_propertyTable = PropertyTable::create(capacity);
     checkConsistency();
 }
 
@@ -755,6 +791,8 @@ void Structure::getPropertyNames(JSGlobalData& globalData, PropertyNameArray& pr
 
     PropertyTable::iterator end = m_propertyTable->end();
     for (PropertyTable::iterator iter = m_propertyTable->begin(); iter != end; ++iter) {
+        if (!isVisibleInPropertyTable(&*iter))
+            continue;
         ASSERT(m_hasNonEnumerableProperties || !(iter->attributes & DontEnum));
         if (!(iter->attributes & DontEnum) || (mode == IncludeDontEnumProperties)) {
             if (knownUnique)
@@ -778,7 +816,9 @@ void Structure::markChildren(MarkStack& markStack)
         markStack.append(&m_specificValueInPrevious);
     if (m_enumerationCache)
         markStack.append(&m_enumerationCache);
-    if (m_propertyTable) {
+    // The specific values in a shared table are also held by m_specificValueInPrevious
+    // of the Structures that added them, which the chain keeps alive.
+    if (m_isPinnedPropertyTable && m_propertyTable) {
         PropertyTable::iterator end = m_propertyTable->end();
         for (PropertyTable::iterator ptr = m_propertyTable->begin(); ptr != end; ++ptr) {
             if (ptr->specificValue)
@@ -851,13 +891,17 @@ void Structure::checkConsistency()
     if (!m_propertyTable)
         return;
 
-    if (!m_hasNonEnumerableProperties) {
-        PropertyTable::iterator end = m_propertyTable->end();
-        for (PropertyTable::iterator iter = m_propertyTable->begin(); iter != end; ++iter) {
-            ASSERT(!(iter->attributes & DontEnum));
-            ASSERT(iter->offset >= m_anonymousSlotCount);
-        }
+    // Entries added by later Structures on a shared table are not properties of this one.
+    unsigned visibleCount = 0;
+    PropertyTable::iterator end = m_propertyTable->end();
+    for (PropertyTable::iterator iter = m_propertyTable->begin(); iter != end; ++iter) {
+        if (!isVisibleInPropertyTable(&*iter))
+            continue;
+        ++visibleCount;
+        ASSERT(m_hasNonEnumerableProperties || !(iter->attributes & DontEnum));
+        ASSERT(iter->offset >= m_anonymousSlotCount);
     }
+    ASSERT(!isSharingPropertyTable() || visibleCount == propertyStorageSize() - m_anonymousSlotCount);
 
     m_propertyTable->checkConsistency();
 }
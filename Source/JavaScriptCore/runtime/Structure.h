@@ -83,6 +83,7 @@ namespace JSC {
         bool isExtensible() const { return !m_preventExtensions; }
 
         Structure* flattenDictionaryStructure(JSGlobalData&, JSObject*);
+        bool hasBeenFlattenedBefore() const { return m_hasBeenFlattenedBefore; }
 
         ~Structure();
 
@@ -105,7 +106,7 @@ namespace JSC {
 
         void growPropertyStorageCapacity();
         unsigned propertyStorageCapacity() const { return m_propertyStorageCapacity; }
-        unsigned propertyStorageSize() const { return m_anonymousSlotCount + (m_propertyTable ? m_propertyTable->propertyStorageSize() : static_cast<unsigned>(m_offset + 1)); }
+        unsigned propertyStorageSize() const { return m_anonymousSlotCount + (m_isPinnedPropertyTable && m_propertyTable ? m_propertyTable->propertyStorageSize() : static_cast<unsigned>(m_offset + 1)); }
         bool isUsingInlineStorage() const;
 
         size_t get(JSGlobalData&, const Identifier& propertyName);
@@ -124,7 +125,7 @@ namespace JSC {
         bool hasAnonymousSlots() const { return !!m_anonymousSlotCount; }
         unsigned anonymousSlotCount() const { return m_anonymousSlotCount; }
         
-        bool isEmpty() const { return m_propertyTable ? m_propertyTable->isEmpty() : m_offset == noOffset; }
+        bool isEmpty() const { return m_isPinnedPropertyTable && m_propertyTable ? m_propertyTable->isEmpty() : m_offset == noOffset; }
 
         void despecifyDictionaryFunction(JSGlobalData&, const Identifier& propertyName);
         void disableSpecificFunctionTracking() { m_specificFunctionThrashCount = maxSpecificFunctionThrashCount; }
@@ -185,7 +186,7 @@ namespace JSC {
         bool despecifyFunction(JSGlobalData&, const Identifier&);
         void despecifyAllFunctions(JSGlobalData&);
 
-        PropertyTable* copyPropertyTable(JSGlobalData&, Structure* owner);
+        PassRefPtr<PropertyTable> copyPropertyTable(JSGlobalData&, Structure* owner, unsigned extraCapacity = 0);
         void materializePropertyMap(JSGlobalData&);
         void materializePropertyMapIfNecessary(JSGlobalData& globalData)
         {
@@ -193,7 +194,14 @@ namespace JSC {
                 materializePropertyMap(globalData);
         }
 
-        signed char transitionCount() const
+        // The Structures along a transition chain share a single PropertyTable, which holds
+        // the properties of the longest of them; each Structure sees only the entries stored
+        // below its own propertyStorageSize(). A Structure whose table is pinned owns it.
+        bool isSharingPropertyTable() const { return m_propertyTable && !m_isPinnedPropertyTable; }
+        bool isVisibleInPropertyTable(const PropertyMapEntry* entry) const { return !isSharingPropertyTable() || entry->offset < propertyStorageSize(); }
+        void unsharePropertyTable(JSGlobalData&);
+
+        int transitionCount() const
         {
             // Since the number of transitions is always the same as m_offset, we keep the size of Structure down by not storing both.
             return m_offset == noOffset ? 0 : m_offset + 1;
@@ -201,9 +209,9 @@ namespace JSC {
 
         bool isValid(ExecState*, StructureChain* cachedPrototypeChain) const;
 
-        static const signed char s_maxTransitionLength = 64;
+        static const int s_maxTransitionLength = 64;
 
-        static const signed char noOffset = -1;
+        static const int noOffset = -1;
 
         static const unsigned maxSpecificFunctionThrashCount = 3;
 
@@ -222,12 +230,12 @@ namespace JSC {
 
         WriteBarrier<JSPropertyNameIterator> m_enumerationCache;
 
-        OwnPtr<PropertyTable> m_propertyTable;
+        RefPtr<PropertyTable> m_propertyTable;
 
         uint32_t m_propertyStorageCapacity;
 
         // m_offset does not account for anonymous slots
-        signed char m_offset;
+        int m_offset;
 
         unsigned m_dictionaryKind : 2;
         bool m_isPinnedPropertyTable : 1;
@@ -244,7 +252,8 @@ namespace JSC {
         unsigned m_specificFunctionThrashCount : 2;
         unsigned m_anonymousSlotCount : 5;
         unsigned m_preventExtensions : 1;
-        // 4 free bits
+        unsigned m_hasBeenFlattenedBefore : 1;
+        // 3 free bits
     };
 
     inline size_t Structure::get(JSGlobalData& globalData, const Identifier& propertyName)
@@ -254,8 +263,10 @@ namespace JSC {
             return notFound;
 
         PropertyMapEntry* entry = m_propertyTable->find(propertyName.impl()).first;
-        ASSERT(!entry || entry->offset >= m_anonymousSlotCount);
-        return entry ? entry->offset : notFound;
+        if (!entry || !isVisibleInPropertyTable(entry))
+            return notFound;
+        ASSERT(entry->offset >= m_anonymousSlotCount);
+        return entry->offset;
     }
 
     inline bool JSCell::isObject() const
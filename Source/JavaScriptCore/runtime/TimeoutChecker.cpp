@@ -32,6 +32,7 @@
 
 #include "CallFrame.h"
 #include "JSGlobalObject.h"
+#include "SamplingProfiler.h"
 
 #if OS(DARWIN)
 #include <mach/mach.h>
@@ -121,6 +122,13 @@ void TimeoutChecker::reset()
 
 bool TimeoutChecker::didTimeOut(ExecState* exec)
 {
+#if ENABLE(SAMPLING_PROFILER)
+    // Long-running loops come through here regularly, so this keeps the profiler's
+    // sample buffer from filling up.
+    if (SamplingProfiler* profiler = exec->globalData().samplingProfiler.get())
+        profiler->processSamples();
+#endif
+
     unsigned currentTime = getCPUTime();
     
     if (!m_timeAtLastCheck) {
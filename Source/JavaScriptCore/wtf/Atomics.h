@@ -88,17 +88,26 @@ inline int atomicIncrement(int volatile* addend) { return InterlockedIncrement(r
 inline int atomicDecrement(int volatile* addend) { return InterlockedDecrement(reinterpret_cast<long volatile*>(addend)); }
 #endif
 
+#define WTF_USE_LOCKFREE_COMPARE_AND_SWAP 1
+inline bool compareAndSwapPointer(void* volatile* location, void* expected, void* newValue) { return InterlockedCompareExchangePointer(location, newValue, expected) == expected; }
+
 #elif OS(DARWIN)
 #define WTF_USE_LOCKFREE_THREADSAFEREFCOUNTED 1
 
 inline int atomicIncrement(int volatile* addend) { return OSAtomicIncrement32Barrier(const_cast<int*>(addend)); }
 inline int atomicDecrement(int volatile* addend) { return OSAtomicDecrement32Barrier(const_cast<int*>(addend)); }
 
+#define WTF_USE_LOCKFREE_COMPARE_AND_SWAP 1
+inline bool compareAndSwapPointer(void* volatile* location, void* expected, void* newValue) { return OSAtomicCompareAndSwapPtrBarrier(expected, newValue, location); }
+
 #elif OS(ANDROID)
 
 inline int atomicIncrement(int volatile* addend) { return android_atomic_inc(addend); }
 inline int atomicDecrement(int volatile* addend) { return android_atomic_dec(addend); }
 
+#define WTF_USE_LOCKFREE_COMPARE_AND_SWAP 1
+inline bool compareAndSwapPointer(void* volatile* location, void* expected, void* newValue) { return __sync_bool_compare_and_swap(location, expected, newValue); }
+
 #elif COMPILER(GCC) && !CPU(SPARC64) && !OS(SYMBIAN) // sizeof(_Atomic_word) != sizeof(int) on sparc64 gcc
 #define WTF_USE_LOCKFREE_THREADSAFEREFCOUNTED 1
 
@@ -107,6 +116,11 @@ inline int atomicDecrement(int volatile* addend) { return __gnu_cxx::__exchange_
 
 #endif
 
+#if COMPILER(GCC) && !OS(WINDOWS) && !OS(DARWIN) && !OS(ANDROID) && !OS(SYMBIAN)
+#define WTF_USE_LOCKFREE_COMPARE_AND_SWAP 1
+inline bool compareAndSwapPointer(void* volatile* location, void* expected, void* newValue) { return __sync_bool_compare_and_swap(location, expected, newValue); }
+#endif
+
 } // namespace WTF
 
 #if USE(LOCKFREE_THREADSAFEREFCOUNTED)
@@ -114,4 +128,11 @@ using WTF::atomicDecrement;
 using WTF::atomicIncrement;
 #endif
 
+// compareAndSwapPointer() stores newValue at location if it still holds expected, and
+// returns whether it did. It is a full memory barrier, so anything written before a
+// successful swap is visible to a thread that reads newValue from location.
+#if USE(LOCKFREE_COMPARE_AND_SWAP)
+using WTF::compareAndSwapPointer;
+#endif
+
 #endif // Atomics_h
@@ -1122,11 +1122,10 @@
 #define ENABLE_JIT 1
 #endif
 
-/* Currently only implemented for JSVALUE64, only tested on PLATFORM(MAC) */
-#if ENABLE(JIT) && USE(JSVALUE64) && PLATFORM(MAC)
+/* Currently only implemented for JSVALUE64 on X86_64, tested on PLATFORM(MAC) and OS(LINUX).
+   Hot functions are promoted to the DFG JIT from the baseline JIT, see CodeBlock::m_executeCounter. */
+#if !defined(ENABLE_DFG_JIT) && ENABLE(JIT) && USE(JSVALUE64) && CPU(X86_64) && (PLATFORM(MAC) || OS(LINUX))
 #define ENABLE_DFG_JIT 1
-/* Enabled with restrictions to circumvent known performance regressions. */
-#define ENABLE_DFG_JIT_RESTRICTIONS 1
 #endif
 
 /* Ensure that either the JIT or the interpreter has been enabled. */
@@ -1167,6 +1166,13 @@
     #endif
 #endif
 
+/* The sampling profiler reads the JIT's call frame register from the signal context,
+   so needs the ucontext layout of glibc (bionic does not provide ucontext.h). */
+#if !defined(ENABLE_SAMPLING_PROFILER) && ENABLE(JIT) && OS(LINUX) && !OS(ANDROID) \
+    && (CPU(X86) || CPU(X86_64) || CPU(ARM_THUMB2) || CPU(ARM_TRADITIONAL))
+#define ENABLE_SAMPLING_PROFILER 1
+#endif
+
 #if CPU(X86) && COMPILER(MSVC)
 #define JSC_HOST_CALL __fastcall
 #elif CPU(X86) && COMPILER(GCC)
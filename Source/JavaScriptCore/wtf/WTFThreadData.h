@@ -55,6 +55,7 @@ typedef HashMap<const char*, RefPtr<StringImpl>, PtrHash<const char*> > LiteralI
 class IdentifierTable {
     WTF_MAKE_FAST_ALLOCATED;
 public:
+    IdentifierTable();
     ~IdentifierTable();
 
     std::pair<HashSet<StringImpl*>::iterator, bool> add(StringImpl* value);
@@ -92,19 +92,14 @@ struct CStringTranslator {
 
     static bool equal(StringImpl* r, const char* s)
     {
-        int length = r->length();
-        const UChar* d = r->characters();
-        for (int i = 0; i != length; ++i) {
-            unsigned char c = s[i];
-            if (d[i] != c)
-                return false;
-        }
-        return !s[length];
+        return WTF::equal(r, s);
     }
 
     static void translate(StringImpl*& location, const char* const& c, unsigned hash)
     {
-        location = StringImpl::create(c).leakRef();
+        // Atoms made from C strings are Latin-1 by construction, so they are
+        // stored 8-bit; most are names that are only ever hashed and compared.
+        location = StringImpl::create8Bit(c, strlen(c)).leakRef();
         location->setHash(hash);
         location->setIsAtomic(true);
     }
@@ -113,9 +108,9 @@ struct CStringTranslator {
 bool operator==(const AtomicString& a, const char* b)
 { 
     StringImpl* impl = a.impl();
-    if ((!impl || !impl->characters()) && !b)
+    if (!impl && !b)
         return true;
-    if ((!impl || !impl->characters()) || !b)
+    if (!impl || !b)
         return false;
     return CStringTranslator::equal(impl, b); 
 }
@@ -140,6 +135,9 @@ static inline bool equal(StringImpl* string, const UChar* characters, unsigned l
     if (string->length() != length)
         return false;
 
+    if (string->is8Bit())
+        return equal(string->characters8(), characters, length);
+
     // FIXME: perhaps we should have a more abstract macro that indicates when
     // going 4 bytes at a time is unsafe
 #if CPU(ARM) || CPU(SH4) || CPU(MIPS) || CPU(SPARC)
@@ -236,6 +234,15 @@ struct HashAndUTF8CharactersTranslator {
         if (buffer.utf16Length != string->length())
             return false;
 
+        if (string->is8Bit() && buffer.utf16Length == buffer.length) {
+            const LChar* stringCharacters = string->characters8();
+            for (unsigned i = 0; i < buffer.length; ++i) {
+                if (stringCharacters[i] != static_cast<LChar>(buffer.characters[i]))
+                    return false;
+            }
+            return true;
+        }
+
         const UChar* stringCharacters = string->characters();
 
         // If buffer contains only ASCII characters UTF-8 and UTF16 length are the same.
@@ -313,6 +320,10 @@ PassRefPtr<StringImpl> AtomicString::addSlowCase(StringImpl* r)
     if (!r->length())
         return StringImpl::empty();
 
+    // A static string may be shared with other threads, so it can't join this thread's table.
+    if (r->isStatic())
+        return add(r->characters(), r->length(), r->existingHash());
+
     StringImpl* result = *stringTable().add(r).first;
     if (result == r)
         r->setIsAtomic(true);
@@ -53,6 +53,9 @@ namespace WTF {
             if (aLength != bLength)
                 return false;
 
+            if (a->is8Bit() || b->is8Bit())
+                return equalCharacters(a, b);
+
             // FIXME: perhaps we should have a more abstract macro that indicates when
             // going 4 bytes at a time is unsafe
 #if CPU(ARM) || CPU(SH4) || CPU(MIPS)
@@ -45,6 +45,7 @@ typedef const struct __CFString * CFStringRef;
 // FIXME: This is a temporary layering violation while we move string code to WTF.
 // Landing the file moves in one patch, will follow on with patches to change the namespaces.
 namespace JSC {
+class CommonIdentifiers;
 struct IdentifierCStringTranslator;
 struct IdentifierUCharBufferTranslator;
 }
@@ -63,6 +64,7 @@ typedef CrossThreadRefCounted<SharableUChar> SharedUChar;
 typedef bool (*CharacterMatchFunctionPtr)(UChar);
 
 class StringImpl : public StringImplBase {
+    friend class JSC::CommonIdentifiers;
     friend struct JSC::IdentifierCStringTranslator;
     friend struct JSC::IdentifierUCharBufferTranslator;
     friend struct WTF::CStringTranslator;
@@ -97,6 +99,18 @@ private:
         ASSERT(m_length);
     }
 
+    // Create a string with internal 8-bit storage (BufferInternal). Its UTF-16
+    // characters are only made, and cached in m_data, when someone asks for them.
+    enum Force8Bit { Force8BitConstructor };
+    StringImpl(unsigned length, Force8Bit)
+        : StringImplBase(length, BufferInternal)
+        , m_data(0)
+        , m_buffer(0)
+        , m_hash(0)
+    {
+        ASSERT(m_length);
+    }
+
     // Create a StringImpl adopting ownership of the provided buffer (BufferOwned)
     StringImpl(const UChar* characters, unsigned length)
         : StringImplBase(length, BufferOwned)
@@ -136,7 +150,7 @@ private:
     {
         ASSERT(!isStatic());
         ASSERT(!m_hash);
-        ASSERT(hash == StringHasher::computeHash(m_data, m_length));
+        ASSERT(hash == (is8Bit() ? StringHasher::computeHash(characters8(), m_length) : StringHasher::computeHash(m_data, m_length)));
         m_hash = hash;
     }
 
@@ -155,11 +169,18 @@ public:
         if (!length)
             return empty();
 
+        if (rep->is8Bit())
+            return create8Bit(rep->characters8() + offset, length);
+
         StringImpl* ownerRep = (rep->bufferOwnership() == BufferSubstring) ? rep->m_substringBuffer : rep.get();
         return adoptRef(new StringImpl(rep->m_data + offset, length, ownerRep));
     }
 
+    static PassRefPtr<StringImpl> create8Bit(const LChar*, unsigned length);
+    static PassRefPtr<StringImpl> create8Bit(const char* characters, unsigned length) { return create8Bit(reinterpret_cast<const LChar*>(characters), length); }
+
     static PassRefPtr<StringImpl> createUninitialized(unsigned length, UChar*& data);
+    static PassRefPtr<StringImpl> createUninitialized(unsigned length, LChar*& data);
     static ALWAYS_INLINE PassRefPtr<StringImpl> tryCreateUninitialized(unsigned length, UChar*& output)
     {
         if (!length) {
@@ -180,6 +201,7 @@ public:
         return adoptRef(new(resultImpl) StringImpl(length));
     }
 
+    // m_data is null for an 8-bit string whose UTF-16 characters have not been made yet.
     static unsigned dataOffset() { return OBJECT_OFFSETOF(StringImpl, m_data); }
     static PassRefPtr<StringImpl> createWithTerminatingNullCharacter(const StringImpl&);
     static PassRefPtr<StringImpl> createStrippingNullCharacters(const UChar*, unsigned length);
@@ -198,7 +220,16 @@ public:
     static PassRefPtr<StringImpl> adopt(StringBuffer&);
 
     SharedUChar* sharedBuffer();
-    const UChar* characters() const { return m_data; }
+    const UChar* characters() const
+    {
+        if (UNLIKELY(!m_data) && is8Bit())
+            return upconvertCharacters();
+        return m_data;
+    }
+
+    // 8-bit strings keep their Latin-1 characters inline, after the StringImpl.
+    bool is8Bit() const { return bufferOwnership() == BufferInternal && m_data != reinterpret_cast<const UChar*>(this + 1); }
+    const LChar* characters8() const { ASSERT(is8Bit()); return reinterpret_cast<const LChar*>(this + 1); }
 
     size_t cost()
     {
@@ -213,6 +244,9 @@ public:
         return 0;
     }
 
+    // Static strings are never destroyed, and may be shared between threads.
+    bool isStatic() const { return m_static; }
+
     bool isIdentifier() const { return m_identifier; }
     void setIsIdentifier(bool isIdentifier) { ASSERT(!isStatic()); m_identifier = isIdentifier; }
 
@@ -224,7 +258,12 @@ public:
     bool isLower() const { return m_lower; }
     void setIsLower(bool isLower) { m_lower = isLower; }
 
-    unsigned hash() const { if (!m_hash) m_hash = StringHasher::computeHash(m_data, m_length); return m_hash; }
+    unsigned hash() const
+    {
+        if (!m_hash)
+            m_hash = is8Bit() ? StringHasher::computeHash(characters8(), m_length) : StringHasher::computeHash(m_data, m_length);
+        return m_hash;
+    }
     unsigned existingHash() const { ASSERT(m_hash); return m_hash; }
 
     ALWAYS_INLINE void deref() { --m_refCount; if (!m_refCount && !m_static) delete this; }
@@ -250,7 +289,13 @@ public:
 
     PassRefPtr<StringImpl> substring(unsigned pos, unsigned len = UINT_MAX);
 
-    UChar operator[](unsigned i) { ASSERT(i < m_length); return m_data[i]; }
+    UChar operator[](unsigned i)
+    {
+        ASSERT(i < m_length);
+        if (is8Bit())
+            return characters8()[i];
+        return m_data[i];
+    }
     UChar32 characterStartingAt(unsigned);
 
     bool containsOnlyWhitespace();
@@ -316,10 +361,11 @@ private:
     static const unsigned s_copyCharsInlineCutOff = 20;
 
     static PassRefPtr<StringImpl> createStrippingNullCharactersSlowCase(const UChar*, unsigned length);
+    const UChar* upconvertCharacters() const;
     
     BufferOwnership bufferOwnership() const { return static_cast<BufferOwnership>(m_bufferOwnership); }
-    bool isStatic() const { return m_static; }
-    const UChar* m_data;
+    // For an 8-bit string this starts out null, and is set at most once by upconvertCharacters().
+    mutable const UChar* m_data;
     union {
         void* m_buffer;
         StringImpl* m_substringBuffer;
@@ -330,6 +376,32 @@ private:
 
 bool equal(const StringImpl*, const StringImpl*);
 bool equal(const StringImpl*, const char*);
+
+inline bool equal(const LChar* a, const UChar* b, unsigned length)
+{
+    for (unsigned i = 0; i < length; ++i) {
+        if (a[i] != b[i])
+            return false;
+    }
+    return true;
+}
+inline bool equal(const UChar* a, const LChar* b, unsigned length) { return equal(b, a, length); }
+
+// Compares the characters of two strings of the same length without making
+// UTF-16 copies of 8-bit strings.
+inline bool equalCharacters(const StringImpl* a, const StringImpl* b)
+{
+    ASSERT(a->length() == b->length());
+    unsigned length = a->length();
+    if (a->is8Bit()) {
+        if (b->is8Bit())
+            return !memcmp(a->characters8(), b->characters8(), length);
+        return equal(a->characters8(), b->characters(), length);
+    }
+    if (b->is8Bit())
+        return equal(a->characters(), b->characters8(), length);
+    return !memcmp(a->characters(), b->characters(), length * sizeof(UChar));
+}
 inline bool equal(const char* a, StringImpl* b) { return equal(b, a); }
 
 bool equalIgnoringCase(StringImpl*, StringImpl*);
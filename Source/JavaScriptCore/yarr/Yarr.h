@@ -48,6 +48,9 @@ static const unsigned quantifyInfinite = UINT_MAX;
 // avoid spending exponential time on complex regular expressions.
 static const unsigned matchLimit = 1000000;
 
+// Leading literals are cut off at this length, so that every skip distance fits in a byte.
+static const unsigned maximumLeadingLiteralLength = 255;
+
 enum JSRegExpResult {
     JSRegExpMatch = 1,
     JSRegExpNoMatch = 0,
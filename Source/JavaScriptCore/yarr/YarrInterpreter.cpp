@@ -272,6 +272,33 @@ public:
             return (pos + position) > length;
         }
 
+        // Moves to the next position at which 'literal' occurs, or to the end of the input
+        // if it does not occur again.
+        void skipToLiteral(const Vector<UChar>& literal, const unsigned char* skipTable)
+        {
+            unsigned literalLength = literal.size();
+            const UChar* literalCharacters = literal.data();
+            UChar first = literalCharacters[0];
+
+            if (literalLength < BytecodePattern::minimumLeadingLiteralLengthForSkipTable) {
+                for (; pos + literalLength <= length; ++pos) {
+                    if (input[pos] == first && (literalLength == 1 || input[pos + 1] == literalCharacters[1]))
+                        return;
+                }
+                pos = length;
+                return;
+            }
+
+            UChar last = literalCharacters[literalLength - 1];
+            while (pos + literalLength <= length) {
+                UChar character = input[pos + literalLength - 1];
+                if (character == last && !memcmp(input + pos, literalCharacters, (literalLength - 1) * sizeof(UChar)))
+                    return;
+                pos += skipTable[character & 0xFF];
+            }
+            pos = length;
+        }
+
     private:
         const UChar* input;
         unsigned pos;
@@ -1044,6 +1071,11 @@ public:
         return JSRegExpErrorNoMatch;
     }
 
+    void lookupForLeadingLiteral()
+    {
+        input.skipToLiteral(pattern->m_leadingLiteral, pattern->m_leadingLiteralSkipTable);
+    }
+
     void lookupForBeginChars()
     {
         int character;
@@ -1084,8 +1116,12 @@ public:
         if (btrack)
             BACKTRACK();
 
-        if (pattern->m_containsBeginChars && isBody)
-            lookupForBeginChars();
+        if (isBody) {
+            if (!pattern->m_leadingLiteral.isEmpty())
+                lookupForLeadingLiteral();
+            else if (pattern->m_containsBeginChars)
+                lookupForBeginChars();
+        }
 
         context->matchBegin = input.getPos();
         context->term = 0;
@@ -1264,8 +1300,12 @@ public:
 
             input.next();
 
-            if (pattern->m_containsBeginChars && isBody)
-                lookupForBeginChars();
+            if (isBody) {
+                if (!pattern->m_leadingLiteral.isEmpty())
+                    lookupForLeadingLiteral();
+                else if (pattern->m_containsBeginChars)
+                    lookupForBeginChars();
+            }
 
             context->matchBegin = input.getPos();
 
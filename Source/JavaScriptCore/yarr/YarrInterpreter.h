@@ -342,6 +342,16 @@ public:
         pattern.m_userCharacterClasses.clear();
 
         m_beginChars.append(pattern.m_beginChars);
+
+        m_leadingLiteral.append(pattern.m_leadingLiteral);
+        if (m_leadingLiteral.size() >= minimumLeadingLiteralLengthForSkipTable) {
+            // Horspool skip distances, keyed on the low byte of the character. Characters that
+            // share a low byte share the smallest distance, which keeps every skip safe.
+            unsigned length = m_leadingLiteral.size();
+            memset(m_leadingLiteralSkipTable, length, sizeof(m_leadingLiteralSkipTable));
+            for (unsigned i = 0; i < length - 1; ++i)
+                m_leadingLiteralSkipTable[m_leadingLiteral[i] & 0xFF] = length - 1 - i;
+        }
     }
 
     ~BytecodePattern()
@@ -363,6 +373,10 @@ public:
 
     Vector<BeginChar> m_beginChars;
 
+    static const unsigned minimumLeadingLiteralLengthForSkipTable = 3;
+    Vector<UChar> m_leadingLiteral;
+    unsigned char m_leadingLiteralSkipTable[256];
+
 private:
     Vector<ByteDisjunction*> m_allParenthesesInfo;
     Vector<CharacterClass*> m_userCharacterClasses;
@@ -1918,6 +1918,32 @@ class YarrGenerator : private MacroAssembler {
         }
     }
 
+    // Advances index to the next start position at which the first one or two characters of the
+    // leading literal occur, before the body is matched there. On entry index is the start
+    // position plus 'countChecked', and at least that much input is known to be available.
+    void generateLeadingLiteralScan(int countChecked, JumpList& notFound)
+    {
+        const Vector<UChar>& literal = m_pattern.m_leadingLiteral;
+        ASSERT(literal.size() <= static_cast<unsigned>(countChecked));
+
+        Jump firstCandidate = jump();
+
+        Label nextCandidate(this);
+        notFound.append(jumpIfNoAvailableInput(1));
+
+        firstCandidate.link(this);
+        jumpIfCharNotEquals(literal[0], -countChecked).linkTo(nextCandidate, this);
+        if (literal.size() > 1)
+            jumpIfCharNotEquals(literal[1], 1 - countChecked).linkTo(nextCandidate, this);
+
+        // Keep the preserved start position in step with the scan.
+        if (!m_pattern.m_body->m_hasFixedSize) {
+            move(index, regT0);
+            sub32(Imm32(countChecked), regT0);
+            store32(regT0, Address(output));
+        }
+    }
+
     void generateDisjunction(PatternDisjunction* disjunction)
     {
         TermGenerationState state(disjunction, 0);
@@ -1950,9 +1976,14 @@ class YarrGenerator : private MacroAssembler {
             countCheckedForCurrentAlternative = countToCheckForFirstAlternative;
         }
 
-        if (setRepeatAlternativeLabels)
+        JumpList leadingLiteralNotFound;
+        if (setRepeatAlternativeLabels) {
             firstAlternativeInputChecked = Label(this);
 
+            if (disjunction == m_pattern.m_body && !m_pattern.m_leadingLiteral.isEmpty())
+                generateLeadingLiteralScan(countToCheckForFirstAlternative, leadingLiteralNotFound);
+        }
+
         while (state.alternativeValid()) {
             PatternAlternative* alternative = state.alternative();
             optimizeAlternative(alternative);
@@ -2147,6 +2178,8 @@ class YarrGenerator : private MacroAssembler {
             // but since we're about to return a failure this doesn't really matter!)
         }
 
+        leadingLiteralNotFound.link(this);
+
         if (m_pattern.m_body->m_callFrameSize)
             addPtr(Imm32(m_pattern.m_body->m_callFrameSize * sizeof(void*)), stackPointerRegister);
 
@@ -888,11 +888,39 @@ public:
         return true;
     }
 
+    // Patterns such as /foo\d+/ can only match where their leading literal occurs, so the
+    // matchers can scan ahead for it instead of trying every start position in turn.
+    void setupLeadingLiteral()
+    {
+        if (m_pattern.m_ignoreCase || m_pattern.m_body->m_alternatives.size() != 1)
+            return;
+
+        PatternAlternative* alternative = m_pattern.m_body->m_alternatives[0];
+        if (alternative->onceThrough())
+            return;
+
+        Vector<UChar>& literal = m_pattern.m_leadingLiteral;
+        for (unsigned i = 0; i < alternative->m_terms.size(); ++i) {
+            PatternTerm& term = alternative->m_terms[i];
+            if (term.type != PatternTerm::TypePatternCharacter || term.quantityType != QuantifierFixedCount)
+                break;
+            if (literal.size() + term.quantityCount > maximumLeadingLiteralLength)
+                break;
+            ASSERT(term.inputPosition == static_cast<int>(literal.size()));
+            for (unsigned j = 0; j < term.quantityCount; ++j)
+                literal.append(term.patternCharacter);
+        }
+    }
+
     void setupBeginChars()
     {
         Vector<TermChain> beginTerms;
         bool containsFixedCharacter = false;
 
+        // Scanning for a leading literal subsumes the beginning character look-up.
+        if (!m_pattern.m_leadingLiteral.isEmpty())
+            return;
+
         if ((!m_pattern.m_body->m_hasFixedSize || m_pattern.m_body->m_alternatives.size() > 1)
                 && setupDisjunctionBeginTerms(m_pattern.m_body, &beginTerms, 0)) {
             unsigned size = beginTerms.size();
@@ -984,6 +1012,7 @@ const char* YarrPattern::compile(const UString& patternString)
     constructor.optimizeBOL();
         
     constructor.setupOffsets();
+    constructor.setupLeadingLiteral();
     constructor.setupBeginChars();
 
     return 0;
@@ -343,6 +343,7 @@ struct YarrPattern {
         deleteAllValues(m_userCharacterClasses);
         m_userCharacterClasses.clear();
         m_beginChars.clear();
+        m_leadingLiteral.clear();
     }
 
     bool containsIllegalBackReference()
@@ -404,6 +405,8 @@ struct YarrPattern {
     Vector<PatternDisjunction*, 4> m_disjunctions;
     Vector<CharacterClass*> m_userCharacterClasses;
     Vector<BeginChar> m_beginChars;
+    // The characters every match must start with, if the pattern begins with a literal.
+    Vector<UChar> m_leadingLiteral;
 
 private:
     const char* compile(const UString& patternString);
@@ -114,15 +114,6 @@ $(GEN): $(LOCAL_PATH)/platform/ColorData.gperf
 LOCAL_GENERATED_SOURCES += $(GEN)
 
 
-# CSS tokenizer
-
-GEN := $(intermediates)/css/tokenizer.cpp
-$(GEN): PRIVATE_CUSTOM_TOOL = $(OLD_FLEX) -t $< | perl $(dir $<)/maketokenizer > $@
-$(GEN): $(LOCAL_PATH)/css/tokenizer.flex $(LOCAL_PATH)/css/maketokenizer
-	$(transform-generated-source)
-# we have to do this dep by hand:
-$(intermediates)/css/CSSParser.o : $(GEN)
-
 # CSS grammar
 
 GEN := $(intermediates)/CSSGrammar.cpp
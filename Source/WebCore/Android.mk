@@ -313,7 +313,9 @@ LOCAL_SRC_FILES := $(LOCAL_SRC_FILES) \
 	html/CheckboxInputType.cpp \
 	html/ClassList.cpp \
 	html/CollectionCache.cpp \
+	html/parser/BackgroundHTMLParser.cpp \
 	html/parser/CSSPreloadScanner.cpp \
+	html/parser/CompactHTMLToken.cpp \
 	html/ColorInputType.cpp \
 	html/DOMFormData.cpp \
 	html/DOMSettableTokenList.cpp \
@@ -424,6 +426,7 @@ LOCAL_SRC_FILES := $(LOCAL_SRC_FILES) \
 	html/parser/HTMLMetaCharsetParser.cpp \
 	html/parser/HTMLParserIdioms.cpp \
 	html/parser/HTMLParserScheduler.cpp \
+	html/parser/HTMLParserThread.cpp \
 	html/parser/HTMLPreloadScanner.cpp \
 	html/parser/HTMLScriptRunner.cpp \
 	html/parser/HTMLSourceTracker.cpp \
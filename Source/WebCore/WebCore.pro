@@ -784,7 +784,9 @@ SOURCES += \
     html/canvas/Uint16Array.cpp \
     html/canvas/Uint32Array.cpp \
     html/canvas/Uint8Array.cpp \
+    html/parser/BackgroundHTMLParser.cpp \
     html/parser/CSSPreloadScanner.cpp \
+    html/parser/CompactHTMLToken.cpp \
     html/parser/HTMLConstructionSite.cpp \
     html/parser/HTMLDocumentParser.cpp \
     html/parser/HTMLElementStack.cpp \
@@ -794,6 +796,7 @@ SOURCES += \
     html/parser/HTMLMetaCharsetParser.cpp \
     html/parser/HTMLParserIdioms.cpp \
     html/parser/HTMLParserScheduler.cpp \
+    html/parser/HTMLParserThread.cpp \
     html/parser/HTMLPreloadScanner.cpp \
     html/parser/HTMLScriptRunner.cpp \
     html/parser/HTMLSourceTracker.cpp \
@@ -1735,7 +1738,9 @@ HEADERS += \
     html/TextDocument.h \
     html/TimeRanges.h \
     html/ValidityState.h \
+    html/parser/BackgroundHTMLParser.h \
     html/parser/CSSPreloadScanner.h \
+    html/parser/CompactHTMLToken.h \
     html/parser/HTMLConstructionSite.h \
     html/parser/HTMLDocumentParser.h \
     html/parser/HTMLElementStack.h \
@@ -1744,6 +1749,7 @@ HEADERS += \
     html/parser/HTMLEntityTable.h \
     html/parser/HTMLFormattingElementList.h \
     html/parser/HTMLParserScheduler.h \
+    html/parser/HTMLParserThread.h \
     html/parser/HTMLPreloadScanner.h \
     html/parser/HTMLScriptRunner.h \
     html/parser/HTMLScriptRunnerHost.h \
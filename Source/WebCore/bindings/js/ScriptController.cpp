@@ -22,6 +22,7 @@
 #include "ScriptController.h"
 
 #include "ScriptableDocumentParser.h"
+#include "CachedMetadata.h"
 #include "Event.h"
 #include "EventNames.h"
 #include "Frame.h"
@@ -43,6 +44,8 @@
 #include "npruntime_impl.h"
 #include "runtime_root.h"
 #include <debugger/Debugger.h>
+#include <parser/SourceProvider.h>
+#include <parser/SourceProviderCache.h>
 #include <runtime/InitializeThreading.h>
 #include <runtime/JSLock.h>
 #include <wtf/Threading.h>
@@ -115,6 +118,58 @@ JSDOMWindowShell* ScriptController::createWindowShell(DOMWrapperWorld* world)
     return windowShell.get();
 }
 
+// A pseudo-randomly chosen ID used to store and retrieve the parser's function info
+// from the CachedScript. If the serialization format changes, this ID should be changed too.
+static const unsigned sourceProviderCacheDataTypeID = 0x5A1C38E2;
+
+// Very small scripts are not worth keeping parser state for.
+static const int minimumLengthToCacheFunctionInfo = 1024;
+
+static bool shouldCacheFunctionInfo(const ScriptSourceCode& sourceCode)
+{
+    return sourceCode.cachedScript() && sourceCode.jsSourceCode().length() >= minimumLengthToCacheFunctionInfo;
+}
+
+// The CachedScript's SourceProviderCache is thrown away with its decoded data, but its
+// cached metadata is kept, and may also have been stored by the platform with the resource.
+static void restoreFunctionInfo(JSGlobalData& globalData, const ScriptSourceCode& sourceCode)
+{
+    if (!shouldCacheFunctionInfo(sourceCode))
+        return;
+
+    CachedMetadata* cachedMetadata = sourceCode.cachedScript()->cachedMetadata(sourceProviderCacheDataTypeID);
+    if (!cachedMetadata || !SourceProviderCache::hasCompatibleHeader(cachedMetadata->data(), cachedMetadata->size()))
+        return;
+
+    SourceProvider* provider = sourceCode.jsSourceCode().provider();
+    SourceProviderCache* cache = provider->cache();
+    if (!cache->isEmpty())
+        return;
+
+    unsigned oldCacheSize = cache->byteSize();
+    if (cache->deserialize(&globalData, provider, cachedMetadata->data(), cachedMetadata->size()))
+        provider->notifyCacheSizeChanged(cache->byteSize() - oldCacheSize);
+}
+
+static void storeFunctionInfo(const ScriptSourceCode& sourceCode)
+{
+    if (!shouldCacheFunctionInfo(sourceCode))
+        return;
+
+    // A resource only holds one piece of cached metadata, of any type, and it is never replaced.
+    CachedScript* cachedScript = sourceCode.cachedScript();
+    if (cachedScript->hasCachedMetadata())
+        return;
+
+    SourceProvider* provider = sourceCode.jsSourceCode().provider();
+    if (provider->cache()->isEmpty())
+        return;
+
+    Vector<char> serializedCache;
+    provider->cache()->serialize(provider, serializedCache);
+    cachedScript->setCachedMetadata(sourceProviderCacheDataTypeID, serializedCache.data(), serializedCache.size());
+}
+
 ScriptValue ScriptController::evaluateInWorld(const ScriptSourceCode& sourceCode, DOMWrapperWorld* world)
 {
     const SourceCode& jsSourceCode = sourceCode.jsSourceCode();
@@ -138,10 +193,14 @@ ScriptValue ScriptController::evaluateInWorld(const ScriptSourceCode& sourceCode
 
     InspectorInstrumentationCookie cookie = InspectorInstrumentation::willEvaluateScript(m_frame, sourceURL, sourceCode.startLine());
 
+    restoreFunctionInfo(exec->globalData(), sourceCode);
+
     exec->globalData().timeoutChecker.start();
     Completion comp = JSMainThreadExecState::evaluate(exec, exec->dynamicGlobalObject()->globalScopeChain(), jsSourceCode, shell);
     exec->globalData().timeoutChecker.stop();
 
+    storeFunctionInfo(sourceCode);
+
     InspectorInstrumentation::didEvaluateScript(cookie);
 
     // Evaluating the JavaScript could cause the frame to be deallocated
@@ -46,12 +46,14 @@ public:
         : m_provider(StringSourceProvider::create(source, url.isNull() ? String() : url.string(), startPosition))
         , m_code(m_provider, startPosition.m_line.oneBasedInt())
         , m_url(url)
+        , m_cachedScript(0)
     {
     }
 
     ScriptSourceCode(CachedScript* cs)
         : m_provider(CachedScriptSourceProvider::create(cs))
         , m_code(m_provider)
+        , m_cachedScript(cs)
     {
     }
 
@@ -64,6 +66,8 @@ public:
     int startLine() const { return m_code.firstLine(); }
 
     const KURL& url() const { return m_url; }
+
+    CachedScript* cachedScript() const { return m_cachedScript.get(); }
     
 private:
     RefPtr<ScriptSourceProvider> m_provider;
@@ -72,6 +76,7 @@ private:
     
     KURL m_url;
 
+    CachedResourceHandle<CachedScript> m_cachedScript;
 };
 
 } // namespace WebCore
@@ -74,6 +74,7 @@
 #include "WebKitCSSTransformValue.h"
 #include <limits.h>
 #include <wtf/HexNumber.h>
+#include <wtf/StdLibExtras.h>
 #include <wtf/dtoa.h>
 #include <wtf/text/StringBuffer.h>
 
@@ -154,7 +155,11 @@ CSSParser::CSSParser(bool strictParsing)
     , m_ruleRangeMap(0)
     , m_currentRuleData(0)
     , m_data(0)
-    , yy_start(1)
+    , m_currentCharacter(0)
+    , m_tokenStart(0)
+    , m_tokenLength(0)
+    , m_token(0)
+    , m_inMediaQuery(false)
     , m_lineNumber(0)
     , m_lastSelectorLineNumber(0)
     , m_allowImportRules(true)
@@ -207,7 +212,18 @@ void CSSParser::setupParser(const char* prefix, const String& string, const char
     for (unsigned i = 0; i < strlen(prefix); i++)
         m_data[i] = prefix[i];
 
-    memcpy(m_data + strlen(prefix), string.characters(), string.length() * sizeof(UChar));
+    // The tokenizer scans a single mutable UTF-16 buffer, since text() unescapes
+    // identifiers and strings in place and the values keep pointers into it.
+    // 8-bit strings are widened straight into that buffer rather than through
+    // characters(), which would also cache a UTF-16 copy on the string itself.
+    StringImpl* impl = string.impl();
+    if (impl && impl->is8Bit()) {
+        const LChar* characters = impl->characters8();
+        UChar* destination = m_data + strlen(prefix);
+        for (unsigned i = 0; i < impl->length(); ++i)
+            destination[i] = characters[i];
+    } else
+        memcpy(m_data + strlen(prefix), string.characters(), string.length() * sizeof(UChar));
 
     unsigned start = strlen(prefix) + string.length();
     unsigned end = start + strlen(suffix);
@@ -217,10 +233,8 @@ void CSSParser::setupParser(const char* prefix, const String& string, const char
     m_data[length - 1] = 0;
     m_data[length - 2] = 0;
 
-    yy_hold_char = 0;
-    yyleng = 0;
-    yytext = yy_c_buf_p = m_data;
-    yy_hold_char = *yy_c_buf_p;
+    m_currentCharacter = m_tokenStart = m_data;
+    m_tokenLength = 0;
     resetRuleBodyMarks();
 }
 
@@ -406,12 +420,146 @@ static bool parseSimpleLengthValue(CSSMutableStyleDeclaration* declaration, int
     return true;
 }
 
+static inline bool isValidKeywordPropertyAndValue(int propertyId, int valueID)
+{
+    // These mirror the identifier checks in CSSParser::parseValue(int, bool) for properties
+    // whose value is often a single keyword.
+    switch (propertyId) {
+    case CSSPropertyBorderCollapse: // collapse | separate | inherit
+        return valueID == CSSValueCollapse || valueID == CSSValueSeparate;
+    case CSSPropertyBorderTopStyle: // <border-style> | inherit
+    case CSSPropertyBorderRightStyle:
+    case CSSPropertyBorderBottomStyle:
+    case CSSPropertyBorderLeftStyle:
+    case CSSPropertyWebkitBorderStartStyle:
+    case CSSPropertyWebkitBorderEndStyle:
+    case CSSPropertyWebkitBorderBeforeStyle:
+    case CSSPropertyWebkitBorderAfterStyle:
+    case CSSPropertyWebkitColumnRuleStyle:
+        return valueID >= CSSValueNone && valueID <= CSSValueDouble;
+    case CSSPropertyBottom: // <length> | <percentage> | auto | inherit
+    case CSSPropertyLeft:
+    case CSSPropertyRight:
+    case CSSPropertyTop:
+    case CSSPropertyMarginTop:
+    case CSSPropertyMarginRight:
+    case CSSPropertyMarginBottom:
+    case CSSPropertyMarginLeft:
+    case CSSPropertyWebkitMarginStart:
+    case CSSPropertyWebkitMarginEnd:
+    case CSSPropertyWebkitMarginBefore:
+    case CSSPropertyWebkitMarginAfter:
+    case CSSPropertyZIndex: // auto | <integer> | inherit
+        return valueID == CSSValueAuto;
+    case CSSPropertyCaptionSide: // top | bottom | left | right | inherit
+        return valueID == CSSValueLeft || valueID == CSSValueRight || valueID == CSSValueTop || valueID == CSSValueBottom;
+    case CSSPropertyClear: // none | left | right | both | inherit
+        return valueID == CSSValueNone || valueID == CSSValueLeft || valueID == CSSValueRight || valueID == CSSValueBoth;
+    case CSSPropertyDirection: // ltr | rtl | inherit
+        return valueID == CSSValueLtr || valueID == CSSValueRtl;
+    case CSSPropertyDisplay:
+#if ENABLE(WCSS)
+        return (valueID >= CSSValueInline && valueID <= CSSValueWapMarquee) || valueID == CSSValueNone;
+#else
+        return (valueID >= CSSValueInline && valueID <= CSSValueWebkitInlineBox) || valueID == CSSValueNone;
+#endif
+    case CSSPropertyEmptyCells: // show | hide | inherit
+        return valueID == CSSValueShow || valueID == CSSValueHide;
+    case CSSPropertyFloat: // left | right | none | inherit + center for buggy CSS
+        return valueID == CSSValueLeft || valueID == CSSValueRight || valueID == CSSValueNone || valueID == CSSValueCenter;
+    case CSSPropertyFontSize: // <absolute-size> | <relative-size> | <length> | <percentage> | inherit
+        return valueID >= CSSValueXxSmall && valueID <= CSSValueLarger;
+    case CSSPropertyHeight: // <length> | <percentage> | auto | inherit
+    case CSSPropertyWidth:
+    case CSSPropertyWebkitLogicalWidth:
+    case CSSPropertyWebkitLogicalHeight:
+        return valueID == CSSValueAuto || valueID == CSSValueIntrinsic || valueID == CSSValueMinIntrinsic;
+    case CSSPropertyListStylePosition: // inside | outside | inherit
+        return valueID == CSSValueInside || valueID == CSSValueOutside;
+    case CSSPropertyListStyleType:
+        return (valueID >= CSSValueDisc && valueID <= CSSValueKatakanaIroha) || valueID == CSSValueNone;
+    case CSSPropertyMaxHeight: // <length> | <percentage> | none | inherit
+    case CSSPropertyMaxWidth:
+    case CSSPropertyWebkitMaxLogicalWidth:
+    case CSSPropertyWebkitMaxLogicalHeight:
+        return valueID == CSSValueNone || valueID == CSSValueIntrinsic || valueID == CSSValueMinIntrinsic;
+    case CSSPropertyMinHeight: // <length> | <percentage> | inherit
+    case CSSPropertyMinWidth:
+    case CSSPropertyWebkitMinLogicalWidth:
+    case CSSPropertyWebkitMinLogicalHeight:
+        return valueID == CSSValueIntrinsic || valueID == CSSValueMinIntrinsic;
+    case CSSPropertyOutlineStyle: // (<border-style> except hidden) | auto | inherit
+        return valueID == CSSValueAuto || valueID == CSSValueNone || (valueID >= CSSValueInset && valueID <= CSSValueDouble);
+    case CSSPropertyOverflowX: // visible | hidden | scroll | auto | marquee | overlay | inherit
+    case CSSPropertyOverflowY:
+        return valueID == CSSValueVisible || valueID == CSSValueHidden || valueID == CSSValueScroll || valueID == CSSValueAuto
+            || valueID == CSSValueOverlay || valueID == CSSValueWebkitMarquee;
+    case CSSPropertyPageBreakAfter: // auto | always | avoid | left | right | inherit
+    case CSSPropertyPageBreakBefore:
+    case CSSPropertyWebkitColumnBreakAfter:
+    case CSSPropertyWebkitColumnBreakBefore:
+        return valueID == CSSValueAuto || valueID == CSSValueAlways || valueID == CSSValueAvoid || valueID == CSSValueLeft || valueID == CSSValueRight;
+    case CSSPropertyPageBreakInside: // avoid | auto | inherit
+    case CSSPropertyWebkitColumnBreakInside:
+        return valueID == CSSValueAuto || valueID == CSSValueAvoid;
+    case CSSPropertyPosition: // static | relative | absolute | fixed | inherit
+        return valueID == CSSValueStatic || valueID == CSSValueRelative || valueID == CSSValueAbsolute || valueID == CSSValueFixed;
+    case CSSPropertyTextAlign:
+        return (valueID >= CSSValueWebkitAuto && valueID <= CSSValueWebkitMatchParent) || valueID == CSSValueStart || valueID == CSSValueEnd;
+    case CSSPropertyTextTransform: // capitalize | uppercase | lowercase | none | inherit
+        return (valueID >= CSSValueCapitalize && valueID <= CSSValueLowercase) || valueID == CSSValueNone;
+    case CSSPropertyUnicodeBidi: // normal | embed | bidi-override | isolate | inherit
+        return valueID == CSSValueNormal || valueID == CSSValueEmbed || valueID == CSSValueBidiOverride || valueID == CSSValueWebkitIsolate;
+    case CSSPropertyVerticalAlign:
+        return valueID >= CSSValueBaseline && valueID <= CSSValueWebkitBaselineMiddle;
+    case CSSPropertyVisibility: // visible | hidden | collapse | inherit
+        return valueID == CSSValueVisible || valueID == CSSValueHidden || valueID == CSSValueCollapse;
+    case CSSPropertyWhiteSpace: // normal | pre | nowrap | inherit
+        return valueID == CSSValueNormal || valueID == CSSValuePre || valueID == CSSValuePreWrap || valueID == CSSValuePreLine || valueID == CSSValueNowrap;
+    default:
+        return false;
+    }
+}
+
+static bool parseKeywordValue(CSSMutableStyleDeclaration* declaration, int propertyId, const String& string, bool important)
+{
+    if (!string.length())
+        return false;
+    CSSParserString cssString;
+    cssString.characters = const_cast<UChar*>(string.characters());
+    cssString.length = string.length();
+    int valueID = cssValueKeywordID(cssString);
+    if (!valueID)
+        return false;
+
+    CSSStyleSheet* stylesheet = static_cast<CSSStyleSheet*>(declaration->stylesheet());
+    if (!stylesheet || !stylesheet->document())
+        return false;
+
+    // A lone inherit or initial is accepted for every property, shorthands included.
+    RefPtr<CSSValue> value;
+    if (valueID == CSSValueInherit)
+        value = CSSInheritedValue::create();
+    else if (valueID == CSSValueInitial)
+        value = CSSInitialValue::createExplicit();
+    else if (isValidKeywordPropertyAndValue(propertyId, valueID))
+        value = stylesheet->document()->cssPrimitiveValueCache()->createIdentifierValue(valueID);
+    else
+        return false;
+
+    CSSProperty property(propertyId, value.release(), important);
+    declaration->addParsedProperty(property);
+    return true;
+}
+
 bool CSSParser::parseValue(CSSMutableStyleDeclaration* declaration, int propertyId, const String& string, bool important, bool strict)
 {
     if (parseSimpleLengthValue(declaration, propertyId, string, important, strict))
         return true;
     if (parseColorValue(declaration, propertyId, string, important, strict))
         return true;
+    if (parseKeywordValue(declaration, propertyId, string, important))
+        return true;
     CSSParser parser(strict);
     return parser.parseValue(declaration, propertyId, string, important);
 }
@@ -5917,6 +6065,20 @@ static inline int yyerror(const char*) { return 1; }
 
 #include "CSSGrammar.h"
 
+static inline double parseCSSNumber(const UChar* characters, int length)
+{
+    // Integers of up to 15 digits are exact as doubles and need no conversion through strtod.
+    if (length <= 15) {
+        double value = 0;
+        int i = 0;
+        for (; i < length && isASCIIDigit(characters[i]); ++i)
+            value = value * 10 + (characters[i] - '0');
+        if (i == length)
+            return value;
+    }
+    return charactersToDouble(characters, length);
+}
+
 int CSSParser::lex(void* yylvalWithoutType)
 {
     YYSTYPE* yylval = static_cast<YYSTYPE*>(yylvalWithoutType);
@@ -5988,7 +6150,7 @@ int CSSParser::lex(void* yylvalWithoutType)
         length--;
     case FLOATTOKEN:
     case INTEGER:
-        yylval->number = charactersToDouble(t, length);
+        yylval->number = parseCSSNumber(t, length);
         break;
 
     default:
@@ -6002,28 +6164,28 @@ void CSSParser::recheckAtKeyword(const UChar* str, int len)
 {
     String ruleName(str, len);
     if (equalIgnoringCase(ruleName, "@import"))
-        yyTok = IMPORT_SYM;
+        m_token = IMPORT_SYM;
     else if (equalIgnoringCase(ruleName, "@page"))
-        yyTok = PAGE_SYM;
+        m_token = PAGE_SYM;
     else if (equalIgnoringCase(ruleName, "@media"))
-        yyTok = MEDIA_SYM;
+        m_token = MEDIA_SYM;
     else if (equalIgnoringCase(ruleName, "@font-face"))
-        yyTok = FONT_FACE_SYM;
+        m_token = FONT_FACE_SYM;
     else if (equalIgnoringCase(ruleName, "@charset"))
-        yyTok = CHARSET_SYM;
+        m_token = CHARSET_SYM;
     else if (equalIgnoringCase(ruleName, "@namespace"))
-        yyTok = NAMESPACE_SYM;
+        m_token = NAMESPACE_SYM;
     else if (equalIgnoringCase(ruleName, "@-webkit-keyframes"))
-        yyTok = WEBKIT_KEYFRAMES_SYM;
+        m_token = WEBKIT_KEYFRAMES_SYM;
     else if (equalIgnoringCase(ruleName, "@-webkit-mediaquery"))
-        yyTok = WEBKIT_MEDIAQUERY_SYM;
+        m_token = WEBKIT_MEDIAQUERY_SYM;
 }
 
 UChar* CSSParser::text(int *length)
 {
-    UChar* start = yytext;
-    int l = yyleng;
-    switch (yyTok) {
+    UChar* start = m_tokenStart;
+    int l = m_tokenLength;
+    switch (m_token) {
     case STRING:
         l--;
         /* nobreak */
@@ -6055,18 +6217,27 @@ UChar* CSSParser::text(int *length)
         break;
     }
 
+    // Most tokens have no escapes, and the characters before the first backslash stay where they are.
+    UChar* firstBackSlash = start;
+    while (firstBackSlash < start + l && *firstBackSlash != '\\')
+        ++firstBackSlash;
+    if (firstBackSlash == start + l) {
+        *length = l;
+        return start;
+    }
+
     // process escapes
-    UChar* out = start;
+    UChar* out = firstBackSlash;
     UChar* escape = 0;
 
     bool sawEscape = false;
 
-    for (int i = 0; i < l; i++) {
+    for (int i = firstBackSlash - start; i < l; i++) {
         UChar* current = start + i;
         if (escape == current - 1) {
             if (isASCIIHexDigit(*current))
                 continue;
-            if (yyTok == STRING &&
+            if (m_token == STRING &&
                  (*current == '\n' || *current == '\r' || *current == '\f')) {
                 // ### handle \r\n case
                 if (*current != '\r')
@@ -6079,7 +6250,7 @@ UChar* CSSParser::text(int *length)
             escape = 0;
             continue;
         }
-        if (escape == current - 2 && yyTok == STRING &&
+        if (escape == current - 2 && m_token == STRING &&
              *(current-1) == '\r' && *current == '\n') {
             escape = 0;
             continue;
@@ -6128,8 +6299,8 @@ UChar* CSSParser::text(int *length)
     *length = out - start;
 
     // If we have an unrecognized @-keyword, and if we handled any escapes at all, then
-    // we should attempt to adjust yyTok to the correct type.
-    if (yyTok == ATKEYWORD && sawEscape)
+    // we should attempt to adjust m_token to the correct type.
+    if (m_token == ATKEYWORD && sawEscape)
         recheckAtKeyword(start, *length);
 
     return start;
@@ -6137,7 +6308,7 @@ UChar* CSSParser::text(int *length)
 
 void CSSParser::countLines()
 {
-    for (UChar* current = yytext; current < yytext + yyleng; ++current) {
+    for (UChar* current = m_tokenStart; current < m_tokenStart + m_tokenLength; ++current) {
         if (*current == '\n')
             ++m_lineNumber;
     }
@@ -6500,14 +6671,14 @@ void CSSParser::updateLastSelectorLineAndPosition()
 
 void CSSParser::markSelectorListStart()
 {
-    m_selectorListRange.start = yytext - m_data;
+    m_selectorListRange.start = m_tokenStart - m_data;
 }
 
 void CSSParser::markSelectorListEnd()
 {
     if (!m_currentRuleData)
         return;
-    UChar* listEnd = yytext;
+    UChar* listEnd = m_tokenStart;
     while (listEnd > m_data + 1) {
         if (isHTMLSpace(*(listEnd - 1)))
             --listEnd;
@@ -6519,8 +6690,8 @@ void CSSParser::markSelectorListEnd()
 
 void CSSParser::markRuleBodyStart()
 {
-    unsigned offset = yytext - m_data;
-    if (*yytext == '{')
+    unsigned offset = m_tokenStart - m_data;
+    if (*m_tokenStart == '{')
         ++offset; // Skip the rule body opening brace.
     if (offset > m_ruleBodyRange.start)
         m_ruleBodyRange.start = offset;
@@ -6529,7 +6700,7 @@ void CSSParser::markRuleBodyStart()
 
 void CSSParser::markRuleBodyEnd()
 {
-    unsigned offset = yytext - m_data;
+    unsigned offset = m_tokenStart - m_data;
     if (offset > m_ruleBodyRange.end)
         m_ruleBodyRange.end = offset;
 }
@@ -6538,15 +6709,15 @@ void CSSParser::markPropertyStart()
 {
     if (!m_inStyleRuleOrDeclaration)
         return;
-    m_propertyRange.start = yytext - m_data;
+    m_propertyRange.start = m_tokenStart - m_data;
 }
 
 void CSSParser::markPropertyEnd(bool isImportantFound, bool isPropertyParsed)
 {
     if (!m_inStyleRuleOrDeclaration)
         return;
-    unsigned offset = yytext - m_data;
-    if (*yytext == ';') // Include semicolon into the property text.
+    unsigned offset = m_tokenStart - m_data;
+    if (*m_tokenStart == ';') // Include semicolon into the property text.
         ++offset;
     m_propertyRange.end = offset;
     if (m_propertyRange.start != UINT_MAX && m_currentRuleData) {
@@ -6794,33 +6965,766 @@ bool isValidNthToken(const CSSParserString& token)
     return equalIgnoringCase(token, "odd") || equalIgnoringCase(token, "even");
 }
 
-#define YY_DECL int CSSParser::lex()
-#define yyconst const
-typedef int yy_state_type;
-typedef unsigned YY_CHAR;
-// The following line makes sure we treat non-Latin-1 Unicode characters correctly.
-#define YY_SC_TO_UI(c) (c > 0xff ? 0xff : c)
-#define YY_DO_BEFORE_ACTION \
-        yytext = yy_bp; \
-        yyleng = (int) (yy_cp - yy_bp); \
-        yy_hold_char = *yy_cp; \
-        *yy_cp = 0; \
-        yy_c_buf_p = yy_cp;
-#define YY_BREAK break;
-#define ECHO
-#define YY_RULE_SETUP
-#define INITIAL 0
-#define YY_STATE_EOF(state) (YY_END_OF_BUFFER + state + 1)
-#define yyterminate() yyTok = END_TOKEN; return yyTok
-#define YY_FATAL_ERROR(a)
-// The following line is needed to build the tokenizer with a condition stack.
-// The macro is used in the tokenizer grammar with lines containing
-// BEGIN(mediaqueries) and BEGIN(initial). yy_start acts as index to
-// tokenizer transition table, and 'mediaqueries' and 'initial' are
-// offset multipliers that specify which transitions are active
-// in the tokenizer during in each condition (tokenizer state).
-#define BEGIN yy_start = 1 + 2 *
-
-#include "tokenizer.cpp"
+// The tokenizer below is written by hand to match the longest-match rules of the
+// CSS2.1 tokenizer grammar: at every position the longest possible token is returned,
+// and when several tokens have the same length the one listed first in the grammar wins.
+
+enum CSSCharacterType {
+    CSSCharacterOther,
+    CSSCharacterNull,
+    CSSCharacterWhiteSpace,
+    CSSCharacterNameStart,
+    CSSCharacterDigit,
+    CSSCharacterDash,
+    CSSCharacterPlus,
+    CSSCharacterDot,
+    CSSCharacterQuote,
+    CSSCharacterHash,
+    CSSCharacterAt,
+    CSSCharacterExclamationMark,
+    CSSCharacterSlash,
+    CSSCharacterLess,
+    CSSCharacterBackSlash,
+    CSSCharacterBeforeEquals,
+    CSSCharacterEndMediaQuery
+};
+
+static const unsigned char cssCharacterTypes[128] = {
+    CSSCharacterNull, CSSCharacterOther, CSSCharacterOther, CSSCharacterOther, // 0-3
+    CSSCharacterOther, CSSCharacterOther, CSSCharacterOther, CSSCharacterOther, // 4-7
+    CSSCharacterOther, CSSCharacterWhiteSpace, CSSCharacterWhiteSpace, CSSCharacterOther, // 8-11: \t \n
+    CSSCharacterWhiteSpace, CSSCharacterWhiteSpace, CSSCharacterOther, CSSCharacterOther, // 12-15: \f \r
+    CSSCharacterOther, CSSCharacterOther, CSSCharacterOther, CSSCharacterOther, // 16-19
+    CSSCharacterOther, CSSCharacterOther, CSSCharacterOther, CSSCharacterOther, // 20-23
+    CSSCharacterOther, CSSCharacterOther, CSSCharacterOther, CSSCharacterOther, // 24-27
+    CSSCharacterOther, CSSCharacterOther, CSSCharacterOther, CSSCharacterOther, // 28-31
+    CSSCharacterWhiteSpace, CSSCharacterExclamationMark, CSSCharacterQuote, CSSCharacterHash, // 32-35: space ! " #
+    CSSCharacterBeforeEquals, CSSCharacterOther, CSSCharacterOther, CSSCharacterQuote, // 36-39: $ % & '
+    CSSCharacterOther, CSSCharacterOther, CSSCharacterBeforeEquals, CSSCharacterPlus, // 40-43: ( ) * +
+    CSSCharacterOther, CSSCharacterDash, CSSCharacterDot, CSSCharacterSlash, // 44-47: , - . /
+    CSSCharacterDigit, CSSCharacterDigit, CSSCharacterDigit, CSSCharacterDigit, // 48-51: 0-3
+    CSSCharacterDigit, CSSCharacterDigit, CSSCharacterDigit, CSSCharacterDigit, // 52-55: 4-7
+    CSSCharacterDigit, CSSCharacterDigit, CSSCharacterOther, CSSCharacterEndMediaQuery, // 56-59: 8 9 : ;
+    CSSCharacterLess, CSSCharacterOther, CSSCharacterOther, CSSCharacterOther, // 60-63: < = > ?
+    CSSCharacterAt, CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, // 64-67: @ A-C
+    CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, // 68-71: D-G
+    CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, // 72-75: H-K
+    CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, // 76-79: L-O
+    CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, // 80-83: P-S
+    CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, // 84-87: T-W
+    CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterOther, // 88-91: X-Z [
+    CSSCharacterBackSlash, CSSCharacterOther, CSSCharacterBeforeEquals, CSSCharacterNameStart, // 92-95: \ ] ^ _
+    CSSCharacterOther, CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, // 96-99: ` a-c
+    CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, // 100-103: d-g
+    CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, // 104-107: h-k
+    CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, // 108-111: l-o
+    CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, // 112-115: p-s
+    CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, // 116-119: t-w
+    CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterNameStart, CSSCharacterEndMediaQuery, // 120-123: x-z {
+    CSSCharacterBeforeEquals, CSSCharacterOther, CSSCharacterBeforeEquals, CSSCharacterOther // 124-127: | } ~ DEL
+};
+
+static inline CSSCharacterType cssCharacterType(UChar c)
+{
+    // Every non-ASCII character may start a name.
+    return c < 128 ? static_cast<CSSCharacterType>(cssCharacterTypes[c]) : CSSCharacterNameStart;
+}
+
+static inline bool isCSSWhiteSpace(UChar c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+static inline bool isCSSNameCharacter(UChar c)
+{
+    CSSCharacterType type = cssCharacterType(c);
+    return type == CSSCharacterNameStart || type == CSSCharacterDigit || type == CSSCharacterDash;
+}
+
+static inline bool isCSSEscape(UChar* p)
+{
+    return p[0] == '\\' && ((p[1] >= ' ' && p[1] <= '~') || p[1] >= 128);
+}
+
+// Skips an escape; p must point at its backslash. A hexadecimal escape may be followed by one
+// white space character, which belongs to it.
+static inline UChar* skipEscape(UChar* p)
+{
+    ++p;
+    if (!isASCIIHexDigit(*p))
+        return p + 1;
+    UChar* end = p + 6;
+    do
+        ++p;
+    while (p < end && isASCIIHexDigit(*p));
+    if (isCSSWhiteSpace(*p))
+        ++p;
+    return p;
+}
+
+static inline UChar* skipNameCharacters(UChar* p)
+{
+    while (true) {
+        if (isCSSNameCharacter(*p))
+            ++p;
+        else if (isCSSEscape(p))
+            p = skipEscape(p);
+        else
+            return p;
+    }
+}
+
+// The helpers below set reachedEnd when the input ends where their token could still go on.
+
+static inline bool nameCouldContinueAtEnd(UChar* p)
+{
+    return !p[0] || (p[0] == '\\' && !p[1]);
+}
+
+// Returns the end of the identifier starting at p, or 0 if there is none.
+static inline UChar* identifierEnd(UChar* p, bool& reachedEnd)
+{
+    if (*p == '-')
+        ++p;
+    UChar* end;
+    if (cssCharacterType(*p) == CSSCharacterNameStart)
+        end = skipNameCharacters(p + 1);
+    else if (isCSSEscape(p))
+        end = skipNameCharacters(skipEscape(p));
+    else {
+        if (nameCouldContinueAtEnd(p))
+            reachedEnd = true;
+        return 0;
+    }
+    if (nameCouldContinueAtEnd(end))
+        reachedEnd = true;
+    return end;
+}
+
+// Returns the end of the number starting at p, or 0 if there is none.
+static inline UChar* numberEnd(UChar* p, bool& reachedEnd)
+{
+    UChar* end = p;
+    while (isASCIIDigit(*end))
+        ++end;
+    if (*end == '.') {
+        if (!end[1])
+            reachedEnd = true;
+        else if (isASCIIDigit(end[1])) {
+            end += 2;
+            while (isASCIIDigit(*end))
+                ++end;
+        }
+    }
+    if (!*end)
+        reachedEnd = true;
+    return end == p ? 0 : end;
+}
+
+static inline bool isNthWhiteSpace(UChar c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Returns the end of the an+b expression starting at p, or 0 if there is none.
+static inline UChar* nthEnd(UChar* p, bool& reachedEnd)
+{
+    if (*p == '+' || *p == '-')
+        ++p;
+    while (isASCIIDigit(*p))
+        ++p;
+    if ((*p | 0x20) != 'n') {
+        if (!*p)
+            reachedEnd = true;
+        return 0;
+    }
+    UChar* end = ++p;
+    while (isNthWhiteSpace(*p))
+        ++p;
+    if (*p == '+' || *p == '-') {
+        ++p;
+        while (isNthWhiteSpace(*p))
+            ++p;
+        if (isASCIIDigit(*p)) {
+            do
+                ++p;
+            while (isASCIIDigit(*p));
+            end = p;
+        }
+    }
+    if (!*p)
+        reachedEnd = true;
+    return end;
+}
+
+// Returns the end of the unicode range starting at p, which points after "U+", or 0 if there is none.
+static inline UChar* unicodeRangeEnd(UChar* p, bool& reachedEnd)
+{
+    UChar* end = p;
+    while (end < p + 6 && isASCIIHexDigit(*end))
+        ++end;
+    if (!*end)
+        reachedEnd = true;
+    else if (*end == '-' && end > p) {
+        UChar* rangeEnd = end + 1;
+        UChar* limit = rangeEnd + 6;
+        while (rangeEnd < limit && isASCIIHexDigit(*rangeEnd))
+            ++rangeEnd;
+        if (rangeEnd < limit && !*rangeEnd)
+            reachedEnd = true;
+        if (rangeEnd > end + 1)
+            return rangeEnd;
+    } else if (*end == '?') {
+        UChar* limit = p + 6;
+        while (end < limit && *end == '?')
+            ++end;
+        if (end < limit && !*end)
+            reachedEnd = true;
+    }
+    return end == p ? 0 : end;
+}
+
+// Compares raw characters with a lower case keyword, ignoring the case of ASCII letters.
+static inline bool equalToCSSKeyword(UChar* characters, int length, const char* keyword)
+{
+    for (int i = 0; i < length; ++i) {
+        if (!keyword[i] || toASCIILower(characters[i]) != keyword[i])
+            return false;
+    }
+    return !keyword[length];
+}
+
+// A backslash in a string is both a character of its own and the start of an escape, so the
+// string can end at several of its quotes. This follows all the ways of reading it at once and
+// returns each place where it could end, shortest first.
+class CSSStringScanner {
+public:
+    CSSStringScanner(UChar* openingQuote)
+        : m_position(openingQuote + 1)
+        , m_quote(*openingQuote)
+        , m_states(InContent)
+        , m_hexDigits(0)
+        , m_reachedEnd(false)
+    {
+    }
+
+    UChar* nextEnd()
+    {
+        while (m_states || m_hexDigits) {
+            UChar c = *m_position++;
+            if (!c) {
+                m_reachedEnd = true;
+                m_states = 0;
+                m_hexDigits = 0;
+                return 0;
+            }
+            unsigned states = 0;
+            unsigned hexDigits = 0;
+            bool isEnd = false;
+            if (m_states & InContent) {
+                if (c == m_quote)
+                    isEnd = true;
+                else if ((c >= ' ' && c <= '~') || c == '\t' || c >= 128) {
+                    states |= InContent;
+                    if (c == '\\')
+                        states |= AfterBackSlash;
+                }
+            }
+            if (m_states & AfterBackSlash) {
+                if (c == '\n' || c == '\f')
+                    states |= InContent;
+                else if (c == '\r')
+                    states |= InContent | AfterCarriageReturn;
+                else if ((c >= ' ' && c <= '~') || c >= 128) {
+                    states |= InContent;
+                    if (isASCIIHexDigit(c))
+                        hexDigits = 1;
+                }
+            }
+            if ((m_states & AfterCarriageReturn) && c == '\n')
+                states |= InContent;
+            if (m_hexDigits) {
+                if (m_hexDigits < 6 && isASCIIHexDigit(c)) {
+                    states |= InContent;
+                    hexDigits = m_hexDigits + 1;
+                } else if (isCSSWhiteSpace(c))
+                    states |= InContent;
+            }
+            m_states = states;
+            m_hexDigits = hexDigits;
+            if (isEnd)
+                return m_position;
+        }
+        return 0;
+    }
+
+    bool reachedEnd() const { return m_reachedEnd; }
+
+private:
+    enum {
+        InContent = 1,
+        AfterBackSlash = 2,
+        AfterCarriageReturn = 4
+    };
+
+    UChar* m_position;
+    UChar m_quote;
+    unsigned m_states;
+    unsigned m_hexDigits; // Set while a hexadecimal escape may go on.
+    bool m_reachedEnd;
+};
+
+static inline UChar* skipCSSWhiteSpace(UChar* p)
+{
+    while (isCSSWhiteSpace(*p))
+        ++p;
+    return p;
+}
+
+static inline UChar* stringEnd(UChar* openingQuote, bool& reachedEnd)
+{
+    CSSStringScanner scanner(openingQuote);
+    UChar* end = 0;
+    while (UChar* nextEnd = scanner.nextEnd())
+        end = nextEnd;
+    if (scanner.reachedEnd())
+        reachedEnd = true;
+    return end;
+}
+
+static inline bool isURLCharacter(UChar c)
+{
+    return c == '!' || (c >= '#' && c <= '&') || (c >= '*' && c <= '~') || c >= 128;
+}
+
+// Returns the end of the url() starting at p, which points after "url(", or 0 if there is none.
+static UChar* urlEnd(UChar* p, bool& reachedEnd)
+{
+    p = skipCSSWhiteSpace(p);
+    UChar* end = 0;
+
+    if (*p == '"' || *p == '\'') {
+        CSSStringScanner scanner(p);
+        while (UChar* quoteEnd = scanner.nextEnd()) {
+            UChar* closingParenthesis = skipCSSWhiteSpace(quoteEnd);
+            if (*closingParenthesis == ')')
+                end = closingParenthesis + 1;
+            else if (!*closingParenthesis)
+                reachedEnd = true;
+        }
+        if (scanner.reachedEnd())
+            reachedEnd = true;
+        return end;
+    }
+
+    // As in strings, a backslash is a character of its own as well as the start of an escape.
+    enum { InURL = 1, AfterBackSlash = 2, InTrailingWhiteSpace = 4 };
+    unsigned states = InURL;
+    unsigned hexDigits = 0;
+    while (states || hexDigits) {
+        UChar c = *p++;
+        if (!c) {
+            reachedEnd = true;
+            break;
+        }
+        if (c == ')' && (states & (InURL | InTrailingWhiteSpace)))
+            end = p;
+        unsigned nextStates = 0;
+        unsigned nextHexDigits = 0;
+        if (states & InURL) {
+            if (isURLCharacter(c)) {
+                nextStates |= InURL;
+                if (c == '\\')
+                    nextStates |= AfterBackSlash;
+            } else if (isCSSWhiteSpace(c))
+                nextStates |= InTrailingWhiteSpace;
+        }
+        if ((states & AfterBackSlash) && ((c >= ' ' && c <= '~') || c >= 128)) {
+            nextStates |= InURL;
+            if (isASCIIHexDigit(c))
+                nextHexDigits = 1;
+        }
+        if ((states & InTrailingWhiteSpace) && isCSSWhiteSpace(c))
+            nextStates |= InTrailingWhiteSpace;
+        if (hexDigits) {
+            if (hexDigits < 6 && isASCIIHexDigit(c)) {
+                nextStates |= InURL;
+                nextHexDigits = hexDigits + 1;
+            } else if (isCSSWhiteSpace(c))
+                nextStates |= InURL;
+        }
+        states = nextStates;
+        hexDigits = nextHexDigits;
+    }
+    return end;
+}
+
+static int cssUnitToken(UChar* characters, int length)
+{
+    switch (length) {
+    case 1:
+        if (equalToCSSKeyword(characters, length, "s"))
+            return SECS;
+        break;
+    case 2:
+        if (equalToCSSKeyword(characters, length, "px"))
+            return PXS;
+        if (equalToCSSKeyword(characters, length, "em"))
+            return EMS;
+        if (equalToCSSKeyword(characters, length, "ex"))
+            return EXS;
+        if (equalToCSSKeyword(characters, length, "pt"))
+            return PTS;
+        if (equalToCSSKeyword(characters, length, "cm"))
+            return CMS;
+        if (equalToCSSKeyword(characters, length, "mm"))
+            return MMS;
+        if (equalToCSSKeyword(characters, length, "in"))
+            return INS;
+        if (equalToCSSKeyword(characters, length, "pc"))
+            return PCS;
+        if (equalToCSSKeyword(characters, length, "ms"))
+            return MSECS;
+        if (equalToCSSKeyword(characters, length, "hz"))
+            return HERTZ;
+        break;
+    case 3:
+        if (equalToCSSKeyword(characters, length, "deg"))
+            return DEGS;
+        if (equalToCSSKeyword(characters, length, "rem"))
+            return REMS;
+        if (equalToCSSKeyword(characters, length, "rad"))
+            return RADS;
+        if (equalToCSSKeyword(characters, length, "khz"))
+            return KHERTZ;
+        break;
+    case 4:
+        if (equalToCSSKeyword(characters, length, "grad"))
+            return GRADS;
+        if (equalToCSSKeyword(characters, length, "turn"))
+            return TURNS;
+        break;
+    case 5:
+        if (equalToCSSKeyword(characters, length, "__qem"))
+            return QEMS;
+        break;
+    }
+    return DIMEN;
+}
+
+struct CSSAtRule {
+    const char* name;
+    int token;
+    bool startsMediaQuery;
+};
+
+static const CSSAtRule cssAtRules[] = {
+    { "import", IMPORT_SYM, true },
+    { "page", PAGE_SYM, false },
+    { "top-left-corner", TOPLEFTCORNER_SYM, false },
+    { "top-left", TOPLEFT_SYM, false },
+    { "top-center", TOPCENTER_SYM, false },
+    { "top-right", TOPRIGHT_SYM, false },
+    { "top-right-corner", TOPRIGHTCORNER_SYM, false },
+    { "bottom-left-corner", BOTTOMLEFTCORNER_SYM, false },
+    { "bottom-left", BOTTOMLEFT_SYM, false },
+    { "bottom-center", BOTTOMCENTER_SYM, false },
+    { "bottom-right", BOTTOMRIGHT_SYM, false },
+    { "bottom-right-corner", BOTTOMRIGHTCORNER_SYM, false },
+    { "left-top", LEFTTOP_SYM, false },
+    { "left-middle", LEFTMIDDLE_SYM, false },
+    { "left-bottom", LEFTBOTTOM_SYM, false },
+    { "right-top", RIGHTTOP_SYM, false },
+    { "right-middle", RIGHTMIDDLE_SYM, false },
+    { "right-bottom", RIGHTBOTTOM_SYM, false },
+    { "media", MEDIA_SYM, true },
+    { "font-face", FONT_FACE_SYM, false },
+    { "charset", CHARSET_SYM, false },
+    { "namespace", NAMESPACE_SYM, false },
+    { "-webkit-rule", WEBKIT_RULE_SYM, false },
+    { "-webkit-decls", WEBKIT_DECLS_SYM, false },
+    { "-webkit-value", WEBKIT_VALUE_SYM, false },
+    { "-webkit-mediaquery", WEBKIT_MEDIAQUERY_SYM, true },
+    { "-webkit-selector", WEBKIT_SELECTOR_SYM, false },
+    { "-webkit-keyframes", WEBKIT_KEYFRAMES_SYM, false },
+    { "-webkit-keyframe-rule", WEBKIT_KEYFRAME_RULE_SYM, false }
+};
+
+// Returns the token of an identifier followed by '(', looking for the functions the grammar treats specially.
+static inline int cssFunctionToken(UChar* characters, int length)
+{
+    if (length == 3 && equalToCSSKeyword(characters, length, "not"))
+        return NOTFUNCTION;
+    if (length > 8 && characters[0] == '-') {
+        if (equalToCSSKeyword(characters, length, "-webkit-any"))
+            return ANYFUNCTION;
+        if (equalToCSSKeyword(characters, length, "-webkit-calc"))
+            return CALCFUNCTION;
+        if (equalToCSSKeyword(characters, length, "-webkit-min"))
+            return MINFUNCTION;
+        if (equalToCSSKeyword(characters, length, "-webkit-max"))
+            return MAXFUNCTION;
+    }
+    return FUNCTION;
+}
+
+int CSSParser::lex()
+{
+    UChar* p;
+    UChar* end;
+    bool reachedEnd;
+
+restartAfterComment:
+    p = m_currentCharacter;
+    end = p + 1;
+    reachedEnd = false;
+    m_token = *p;
+
+    switch (cssCharacterType(*p)) {
+    case CSSCharacterOther:
+        break;
+
+    case CSSCharacterNull:
+        reachedEnd = true;
+        break;
+
+    case CSSCharacterWhiteSpace:
+        while (isCSSWhiteSpace(*end))
+            ++end;
+        if (!*end)
+            reachedEnd = true;
+        m_token = WHITESPACE;
+        break;
+
+    case CSSCharacterNameStart:
+    case CSSCharacterDash:
+    case CSSCharacterBackSlash: {
+        if (p[0] == '-' && p[1] == '-') {
+            if (p[2] == '>') {
+                m_token = SGML_CD;
+                end = p + 3;
+                break;
+            }
+            if (!p[2])
+                reachedEnd = true;
+        }
+        UChar* nameEnd = identifierEnd(p, reachedEnd);
+        if (nameEnd) {
+            int nameLength = nameEnd - p;
+            end = nameEnd;
+            m_token = IDENT;
+            if (*nameEnd == '(') {
+                end = nameEnd + 1;
+                m_token = cssFunctionToken(p, nameLength);
+                if (nameLength == 3 && equalToCSSKeyword(p, nameLength, "url")) {
+                    if (UChar* uriEnd = urlEnd(end, reachedEnd)) {
+                        m_token = URI;
+                        end = uriEnd;
+                    }
+                }
+            } else if (m_inMediaQuery && (nameLength == 3 || nameLength == 4)) {
+                if (equalToCSSKeyword(p, nameLength, "not"))
+                    m_token = MEDIA_NOT;
+                else if (equalToCSSKeyword(p, nameLength, "only"))
+                    m_token = MEDIA_ONLY;
+                else if (equalToCSSKeyword(p, nameLength, "and"))
+                    m_token = MEDIA_AND;
+            } else if (nameLength == 1 && (*p | 0x20) == 'u' && p[1] == '+') {
+                if (UChar* rangeEnd = unicodeRangeEnd(p + 2, reachedEnd)) {
+                    m_token = UNICODERANGE;
+                    end = rangeEnd;
+                }
+            }
+        }
+        if (UChar* expressionEnd = nthEnd(p, reachedEnd)) {
+            // Identifiers win over an+b expressions of the same length.
+            if (!nameEnd || expressionEnd > end) {
+                m_token = NTH;
+                end = expressionEnd;
+            }
+        }
+        break;
+    }
+
+    case CSSCharacterDigit:
+    case CSSCharacterDot: {
+        UChar* digitsEnd = numberEnd(p, reachedEnd);
+        if (!digitsEnd)
+            break;
+        end = digitsEnd;
+        if (UChar* unitEnd = identifierEnd(digitsEnd, reachedEnd)) {
+            end = unitEnd;
+            m_token = cssUnitToken(digitsEnd, unitEnd - digitsEnd);
+            if (*unitEnd == '+') {
+                m_token = INVALIDDIMEN;
+                ++end;
+            }
+        } else if (*digitsEnd == '%') {
+            do
+                ++end;
+            while (*end == '%');
+            if (!*end)
+                reachedEnd = true;
+            m_token = PERCENTAGE;
+        } else {
+            m_token = INTEGER;
+            for (UChar* digit = p; digit < digitsEnd; ++digit) {
+                if (*digit == '.') {
+                    m_token = FLOATTOKEN;
+                    break;
+                }
+            }
+        }
+        if (*p != '.') {
+            // An an+b expression wins over the other tokens of the same length.
+            UChar* expressionEnd = nthEnd(p, reachedEnd);
+            if (expressionEnd && expressionEnd >= end) {
+                m_token = NTH;
+                end = expressionEnd;
+            }
+        }
+        break;
+    }
+
+    case CSSCharacterPlus:
+        if (UChar* expressionEnd = nthEnd(p, reachedEnd)) {
+            m_token = NTH;
+            end = expressionEnd;
+        }
+        break;
+
+    case CSSCharacterQuote:
+        if (UChar* quoteEnd = stringEnd(p, reachedEnd)) {
+            m_token = STRING;
+            end = quoteEnd;
+        }
+        break;
+
+    case CSSCharacterHash: {
+        UChar* hexEnd = p + 1;
+        while (isASCIIHexDigit(*hexEnd))
+            ++hexEnd;
+        if (!*hexEnd)
+            reachedEnd = true;
+        UChar* nameEnd = identifierEnd(p + 1, reachedEnd);
+        if (nameEnd && nameEnd > hexEnd) {
+            m_token = IDSEL;
+            end = nameEnd;
+        } else if (hexEnd > p + 1) {
+            m_token = HEX;
+            end = hexEnd;
+        }
+        break;
+    }
+
+    case CSSCharacterAt: {
+        UChar* nameEnd = identifierEnd(p + 1, reachedEnd);
+        if (!nameEnd)
+            break;
+        end = nameEnd;
+        m_token = ATKEYWORD;
+        int nameLength = nameEnd - p - 1;
+        for (size_t i = 0; i < WTF_ARRAY_LENGTH(cssAtRules); ++i) {
+            if (equalToCSSKeyword(p + 1, nameLength, cssAtRules[i].name)) {
+                m_token = cssAtRules[i].token;
+                if (cssAtRules[i].startsMediaQuery)
+                    m_inMediaQuery = true;
+                break;
+            }
+        }
+        break;
+    }
+
+    case CSSCharacterExclamationMark: {
+        UChar* important = skipCSSWhiteSpace(p + 1);
+        static const char importantKeyword[] = "important";
+        int matched = 0;
+        while (importantKeyword[matched] && toASCIILower(important[matched]) == importantKeyword[matched])
+            ++matched;
+        if (!importantKeyword[matched]) {
+            m_token = IMPORTANT_SYM;
+            end = important + matched;
+        } else if (!important[matched])
+            reachedEnd = true;
+        break;
+    }
+
+    case CSSCharacterSlash:
+        if (p[1] == '*') {
+            UChar* commentEnd = p + 2;
+            while (*commentEnd && !(commentEnd[0] == '*' && commentEnd[1] == '/'))
+                ++commentEnd;
+            if (!*commentEnd) {
+                reachedEnd = true;
+                break;
+            }
+            m_tokenStart = p;
+            m_tokenLength = commentEnd + 2 - p;
+            m_currentCharacter = commentEnd + 2;
+            countLines();
+            goto restartAfterComment;
+        }
+        if (!p[1])
+            reachedEnd = true;
+        break;
+
+    case CSSCharacterLess:
+        if (p[1] == '!' && p[2] == '-' && p[3] == '-') {
+            m_token = SGML_CD;
+            end = p + 4;
+        } else if (!p[1] || (p[1] == '!' && (!p[2] || (p[2] == '-' && !p[3]))))
+            reachedEnd = true;
+        break;
+
+    case CSSCharacterBeforeEquals:
+        if (p[1] == '=') {
+            switch (*p) {
+            case '~':
+                m_token = INCLUDES;
+                break;
+            case '|':
+                m_token = DASHMATCH;
+                break;
+            case '^':
+                m_token = BEGINSWITH;
+                break;
+            case '$':
+                m_token = ENDSWITH;
+                break;
+            case '*':
+                m_token = CONTAINS;
+                break;
+            }
+            end = p + 2;
+        } else if (!p[1])
+            reachedEnd = true;
+        break;
+
+    case CSSCharacterEndMediaQuery:
+        m_inMediaQuery = false;
+        break;
+    }
+
+    if (reachedEnd) {
+        // The input ends where the token could still go on. As the flex generated tokenizer
+        // did, drop the unfinished token and stay at the end, so that every further call
+        // returns the end as well.
+        end = p;
+        while (*end)
+            ++end;
+        m_token = END_TOKEN;
+        m_tokenStart = p;
+        m_tokenLength = end + 1 - p;
+        m_currentCharacter = end;
+        return m_token;
+    }
+
+    m_tokenStart = p;
+    m_tokenLength = end - p;
+    m_currentCharacter = end;
+    if (m_token == WHITESPACE)
+        countLines();
+    return m_token;
+}
 
 }
@@ -270,7 +270,7 @@ namespace WebCore {
         void resetRuleBodyMarks() { m_ruleBodyRange.start = m_ruleBodyRange.end = 0; }
         void resetPropertyMarks() { m_propertyRange.start = m_propertyRange.end = UINT_MAX; }
         int lex(void* yylval);
-        int token() { return yyTok; }
+        int token() { return m_token; }
         UChar* text(int* length);
         void countLines();
         int lex();
@@ -306,14 +306,11 @@ namespace WebCore {
         SizeParameterType parseSizeParameter(CSSValueList* parsedValues, CSSParserValue* value, SizeParameterType prevParamType);
 
         UChar* m_data;
-        UChar* yytext;
-        UChar* yy_c_buf_p;
-        UChar yy_hold_char;
-        int yy_last_accepting_state;
-        UChar* yy_last_accepting_cpos;
-        int yyleng;
-        int yyTok;
-        int yy_start;
+        UChar* m_currentCharacter;
+        UChar* m_tokenStart;
+        int m_tokenLength;
+        int m_token;
+        bool m_inMediaQuery;
         int m_lineNumber;
         int m_lastSelectorLineNumber;
 
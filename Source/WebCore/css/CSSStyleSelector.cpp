@@ -64,6 +64,7 @@
 #include "HTMLTextAreaElement.h"
 #include "KeyframeList.h"
 #include "LinkHash.h"
+#include "Logging.h"
 #include "Matrix3DTransformOperation.h"
 #include "MatrixTransformOperation.h"
 #include "MediaList.h"
@@ -535,6 +536,7 @@ CSSStyleSelector::Features::Features()
     : usesFirstLineRules(false)
     , usesBeforeAfterRules(false)
     , usesLinkRules(false)
+    , usesIdOrClassAttributeSelectors(false)
 {
 }
 
@@ -939,6 +941,7 @@ bool CSSStyleSelector::SelectorChecker::checkSelector(CSSSelector* sel, Element*
 
 static const unsigned cStyleSearchThreshold = 10;
 static const unsigned cStyleSearchLevelThreshold = 10;
+static const unsigned cStyleSharingCacheSize = 128;
 
 Node* CSSStyleSelector::locateCousinList(Element* parent, unsigned& visitedNodeCount) const
 {
@@ -1120,6 +1123,76 @@ inline Node* CSSStyleSelector::findSiblingForStyleSharing(Node* node, unsigned&
     return node;
 }
 
+void CSSStyleSelector::startStyleSharingCache()
+{
+    ASSERT(m_styleSharingCache.isEmpty());
+    m_styleSharingCache.grow(cStyleSharingCacheSize);
+#if !LOG_DISABLED
+    m_styleSharingLookups = 0;
+    m_styleSharingCacheHits = 0;
+    m_styleSharingSiblingHits = 0;
+#endif
+}
+
+void CSSStyleSelector::finishStyleSharingCache()
+{
+    m_styleSharingCache.clear();
+#if !LOG_DISABLED
+    if (!m_styleSharingLookups)
+        return;
+    unsigned misses = m_styleSharingLookups - m_styleSharingCacheHits - m_styleSharingSiblingHits;
+    LOG(StyleSharing, "%u elements looked for a style to share: %u (%.1f%%) shared with a cousin from the cache, %u (%.1f%%) with a nearby sibling or cousin, %u (%.1f%%) not shared",
+        m_styleSharingLookups,
+        m_styleSharingCacheHits, 100.0 * m_styleSharingCacheHits / m_styleSharingLookups,
+        m_styleSharingSiblingHits, 100.0 * m_styleSharingSiblingHits / m_styleSharingLookups,
+        misses, 100.0 * misses / m_styleSharingLookups);
+#endif
+}
+
+// Elements with the same tag, class and parent style land in the same slot, so the most
+// recent one is the best candidate to share with.
+static inline unsigned styleSharingCacheIndex(StyledElement* element, RenderStyle* parentStyle)
+{
+    uint64_t key = PtrHash<AtomicStringImpl*>::hash(element->localName().impl());
+    if (element->hasClass())
+        key ^= PtrHash<AtomicStringImpl*>::hash(element->fastGetAttribute(classAttr).impl());
+    key = (key << 32) | PtrHash<RenderStyle*>::hash(parentStyle);
+    return WTF::intHash(key) % cStyleSharingCacheSize;
+}
+
+// Cousins from the cache may be far apart in the tree. Like those locateCousinList finds, they
+// can only share a style if each pair of their ancestors, up to the closest common one, does.
+static bool ancestorsShareStyle(Node* candidate, Node* node, RenderStyle* parentStyle)
+{
+    ContainerNode* candidateAncestor = candidate->parentNodeForRenderingAndStyle();
+    ContainerNode* ancestor = node->parentNodeForRenderingAndStyle();
+    if (!candidateAncestor || candidateAncestor->renderStyle() != parentStyle)
+        return false;
+    for (unsigned level = 0; level < cStyleSearchLevelThreshold; ++level) {
+        if (candidateAncestor == ancestor)
+            return true;
+        candidateAncestor = candidateAncestor->parentNodeForRenderingAndStyle();
+        ancestor = ancestor->parentNodeForRenderingAndStyle();
+        if (!candidateAncestor || !ancestor || candidateAncestor->renderStyle() != ancestor->renderStyle())
+            return false;
+    }
+    return false;
+}
+
+Node* CSSStyleSelector::findCousinInStyleSharingCache()
+{
+    RefPtr<StyledElement>& entry = m_styleSharingCache[styleSharingCacheIndex(m_styledElement, m_parentStyle)];
+    // The candidate may have been removed from the tree, leaving the cache as its only owner.
+    RefPtr<StyledElement> candidate = entry.release();
+    // Remember this element for the ones that follow; it will be given a style shortly.
+    entry = m_styledElement;
+    if (!candidate || candidate == m_styledElement)
+        return 0;
+    if (!canShareStyleWithElement(candidate.get()) || !ancestorsShareStyle(candidate.get(), m_styledElement, m_parentStyle))
+        return 0;
+    return candidate.get();
+}
+
 static inline bool parentStylePreventsSharing(const RenderStyle* parentStyle)
 {
     return parentStyle->childrenAffectedByPositionalRules() 
@@ -1141,11 +1214,22 @@ ALWAYS_INLINE RenderStyle* CSSStyleSelector::locateSharedStyle()
     if (parentStylePreventsSharing(m_parentStyle))
         return 0;
 
+    // During a style recalc, look for an earlier element with the same tag, class and parent style.
+    Node* shareNode = 0;
+    if (!m_styleSharingCache.isEmpty()) {
+#if !LOG_DISABLED
+        ++m_styleSharingLookups;
+#endif
+        shareNode = findCousinInStyleSharingCache();
+    }
+#if !LOG_DISABLED
+    bool foundInCache = shareNode;
+#endif
+
     // Check previous siblings and their cousins.
     unsigned count = 0;
     unsigned visitedNodeCount = 0;
-    Node* shareNode = 0;
-    Node* cousinList = m_styledElement->previousSibling();
+    Node* cousinList = shareNode ? 0 : m_styledElement->previousSibling();
     while (cousinList) {
         shareNode = findSiblingForStyleSharing(cousinList, count);
         if (shareNode)
@@ -1163,6 +1247,14 @@ ALWAYS_INLINE RenderStyle* CSSStyleSelector::locateSharedStyle()
     // Tracking child index requires unique style for each node. This may get set by the sibling rule match above.
     if (parentStylePreventsSharing(m_parentStyle))
         return 0;
+#if !LOG_DISABLED
+    if (!m_styleSharingCache.isEmpty()) {
+        if (foundInCache)
+            ++m_styleSharingCacheHits;
+        else
+            ++m_styleSharingSiblingHits;
+    }
+#endif
     return shareNode->renderStyle();
 }
 
@@ -1240,6 +1332,125 @@ PassRefPtr<RenderStyle> CSSStyleSelector::styleForDocument(Document* document)
 // If resolveForRootDefault is true, style based on user agent style sheet only. This is used in media queries, where
 // relative units are interpreted according to document root element style, styled only with UA stylesheet
 
+static const unsigned cMatchedDeclarationCacheSize = 128;
+
+void CSSStyleSelector::clearMatchedDeclarationCache()
+{
+    m_matchedDeclarationCache.clear();
+}
+
+bool CSSStyleSelector::isCacheableInMatchedDeclarationCache(Element* element, bool hasParentStyle) const
+{
+    if (!hasParentStyle || !m_parentNode || m_checker.m_matchVisitedPseudoClass)
+        return false;
+    // Link colors depend on the visited state, and rem units on the root element.
+    if (element->isLink() || m_style->insideLink() != NotInsideLink)
+        return false;
+    if (element == element->document()->documentElement())
+        return false;
+    // The inline style declaration is edited in place, so its pointer says nothing about its contents.
+    if (m_styledElement && m_styledElement->inlineStyleDecl())
+        return false;
+    // Applying the SVG zoom rules and the -wap- input properties looks at the element itself.
+    if (element->isSVGElement() || element->isFormControlElement())
+        return false;
+    return true;
+}
+
+unsigned CSSStyleSelector::matchedDeclarationCacheIndex() const
+{
+    unsigned hash = PtrHash<RenderStyle*>::hash(m_parentStyle);
+    for (unsigned i = 0; i < m_matchedDecls.size(); ++i)
+        hash = WTF::intHash((static_cast<uint64_t>(hash) << 32) | PtrHash<CSSMutableStyleDeclaration*>::hash(m_matchedDecls[i]));
+    return hash % cMatchedDeclarationCacheSize;
+}
+
+const CSSStyleSelector::MatchedDeclarationCacheItem* CSSStyleSelector::findFromMatchedDeclarationCache(unsigned index, int firstUARule, int lastUARule, int firstUserRule, int lastUserRule, int firstAuthorRule, int lastAuthorRule) const
+{
+    if (m_matchedDeclarationCache.isEmpty())
+        return 0;
+    const MatchedDeclarationCacheItem& item = m_matchedDeclarationCache[index];
+    // An empty slot has no parent style, so it never matches.
+    if (item.parentStyle != m_parentStyle || item.rootElementStyle != m_rootElementStyle)
+        return 0;
+    if (item.firstUARule != firstUARule || item.lastUARule != lastUARule
+        || item.firstUserRule != firstUserRule || item.lastUserRule != lastUserRule
+        || item.firstAuthorRule != firstAuthorRule || item.lastAuthorRule != lastAuthorRule)
+        return 0;
+    unsigned size = m_matchedDecls.size();
+    if (item.matchedDecls.size() != size)
+        return 0;
+    for (unsigned i = 0; i < size; ++i) {
+        if (item.matchedDecls[i] != m_matchedDecls[i])
+            return 0;
+    }
+    return &item;
+}
+
+void CSSStyleSelector::addToMatchedDeclarationCache(unsigned index, PassRefPtr<RenderStyle> style, int firstUARule, int lastUARule, int firstUserRule, int lastUserRule, int firstAuthorRule, int lastAuthorRule)
+{
+    if (m_matchedDeclarationCache.isEmpty())
+        m_matchedDeclarationCache.grow(cMatchedDeclarationCacheSize);
+    MatchedDeclarationCacheItem& item = m_matchedDeclarationCache[index];
+    item.matchedDecls.clear();
+    item.matchedDecls.reserveCapacity(m_matchedDecls.size());
+    for (unsigned i = 0; i < m_matchedDecls.size(); ++i)
+        item.matchedDecls.append(m_matchedDecls[i]);
+    item.firstUARule = firstUARule;
+    item.lastUARule = lastUARule;
+    item.firstUserRule = firstUserRule;
+    item.lastUserRule = lastUserRule;
+    item.firstAuthorRule = firstAuthorRule;
+    item.lastAuthorRule = lastAuthorRule;
+    item.renderStyle = style;
+    item.parentStyle = m_parentStyle;
+    item.rootElementStyle = m_rootElementStyle;
+    item.pendingImageProperties = m_pendingImageProperties;
+}
+
+void CSSStyleSelector::applyMatchedDeclarations(int firstUARule, int lastUARule, int firstUserRule, int lastUserRule, int firstAuthorRule, int lastAuthorRule, bool resolveForRootDefault)
+{
+    // Now we have all of the matched rules in the appropriate order.  Walk the rules and apply
+    // high-priority properties first, i.e., those properties that other properties depend on.
+    // The order is (1) high-priority not important, (2) high-priority important, (3) normal not important
+    // and (4) normal important.
+    m_lineHeightValue = 0;
+    applyDeclarations<true>(false, 0, m_matchedDecls.size() - 1);
+    if (!resolveForRootDefault) {
+        applyDeclarations<true>(true, firstAuthorRule, lastAuthorRule);
+        applyDeclarations<true>(true, firstUserRule, lastUserRule);
+    }
+    applyDeclarations<true>(true, firstUARule, lastUARule);
+    
+    // If our font got dirtied, go ahead and update it now.
+    if (m_fontDirty)
+        updateFont();
+
+    // Line-height is set when we are sure we decided on the font-size
+    if (m_lineHeightValue)
+        applyProperty(CSSPropertyLineHeight, m_lineHeightValue);
+
+    // Now do the normal priority UA properties.
+    applyDeclarations<false>(false, firstUARule, lastUARule);
+    
+    // Cache our border and background so that we can examine them later.
+    cacheBorderAndBackground();
+    
+    // Now do the author and user normal priority properties and all the !important properties.
+    if (!resolveForRootDefault) {
+        applyDeclarations<false>(false, lastUARule + 1, m_matchedDecls.size() - 1);
+        applyDeclarations<false>(true, firstAuthorRule, lastAuthorRule);
+        applyDeclarations<false>(true, firstUserRule, lastUserRule);
+    }
+    applyDeclarations<false>(true, firstUARule, lastUARule);
+
+    ASSERT(!m_fontDirty);
+    // If our font got dirtied by one of the non-essential font props, 
+    // go ahead and update it a second time.
+    if (m_fontDirty)
+        updateFont();
+}
+
 PassRefPtr<RenderStyle> CSSStyleSelector::styleForElement(Element* e, RenderStyle* defaultParent, bool allowSharing, bool resolveForRootDefault, bool matchVisitedPseudoClass)
 {
     // Once an element has a renderer, we don't try to destroy it, since otherwise the renderer
@@ -1283,6 +1494,7 @@ PassRefPtr<RenderStyle> CSSStyleSelector::styleForElement(Element* e, RenderStyl
 
     m_style = RenderStyle::create();
 
+    bool hasParentStyle = m_parentStyle;
     if (m_parentStyle)
         m_style->inheritFrom(m_parentStyle);
     else {
@@ -1444,47 +1656,25 @@ PassRefPtr<RenderStyle> CSSStyleSelector::styleForElement(Element* e, RenderStyl
 
     // Reset the value back before applying properties, so that -webkit-link knows what color to use.
     m_checker.m_matchVisitedPseudoClass = matchVisitedPseudoClass;
-    
-    // Now we have all of the matched rules in the appropriate order.  Walk the rules and apply
-    // high-priority properties first, i.e., those properties that other properties depend on.
-    // The order is (1) high-priority not important, (2) high-priority important, (3) normal not important
-    // and (4) normal important.
-    m_lineHeightValue = 0;
-    applyDeclarations<true>(false, 0, m_matchedDecls.size() - 1);
-    if (!resolveForRootDefault) {
-        applyDeclarations<true>(true, firstAuthorRule, lastAuthorRule);
-        applyDeclarations<true>(true, firstUserRule, lastUserRule);
-    }
-    applyDeclarations<true>(true, firstUARule, lastUARule);
-    
-    // If our font got dirtied, go ahead and update it now.
-    if (m_fontDirty)
-        updateFont();
 
-    // Line-height is set when we are sure we decided on the font-size
-    if (m_lineHeightValue)
-        applyProperty(CSSPropertyLineHeight, m_lineHeightValue);
-
-    // Now do the normal priority UA properties.
-    applyDeclarations<false>(false, firstUARule, lastUARule);
-    
-    // Cache our border and background so that we can examine them later.
-    cacheBorderAndBackground();
-    
-    // Now do the author and user normal priority properties and all the !important properties.
-    if (!resolveForRootDefault) {
-        applyDeclarations<false>(false, lastUARule + 1, m_matchedDecls.size() - 1);
-        applyDeclarations<false>(true, firstAuthorRule, lastAuthorRule);
-        applyDeclarations<false>(true, firstUserRule, lastUserRule);
+    if (resolveForRootDefault || !isCacheableInMatchedDeclarationCache(e, hasParentStyle))
+        applyMatchedDeclarations(firstUARule, lastUARule, firstUserRule, lastUserRule, firstAuthorRule, lastAuthorRule, resolveForRootDefault);
+    else {
+        unsigned cacheIndex = matchedDeclarationCacheIndex();
+        if (const MatchedDeclarationCacheItem* cacheItem = findFromMatchedDeclarationCache(cacheIndex, firstUARule, lastUARule, firstUserRule, lastUserRule, firstAuthorRule, lastAuthorRule)) {
+            // The flags set while matching describe this element, so only the property values are copied.
+            m_style->copyPropertiesFrom(cacheItem->renderStyle.get());
+            m_pendingImageProperties = cacheItem->pendingImageProperties;
+        } else {
+            applyMatchedDeclarations(firstUARule, lastUARule, firstUserRule, lastUserRule, firstAuthorRule, lastAuthorRule, resolveForRootDefault);
+            // Some declarations, like attr() in content, make the style unique because they depend on the
+            // element itself. Styles with an appearance are adjusted using state kept on the side by
+            // cacheBorderAndBackground().
+            if (!m_style->unique() && !m_style->hasAppearance())
+                addToMatchedDeclarationCache(cacheIndex, RenderStyle::clone(style()), firstUARule, lastUARule, firstUserRule, lastUserRule, firstAuthorRule, lastAuthorRule);
+        }
     }
-    applyDeclarations<false>(true, firstUARule, lastUARule);
 
-    ASSERT(!m_fontDirty);
-    // If our font got dirtied by one of the non-essential font props, 
-    // go ahead and update it a second time.
-    if (m_fontDirty)
-        updateFont();
-    
     // Clean up our style object's display and text decorations (among other fixups).
     adjustRenderStyle(style(), m_parentStyle, e);
 
@@ -3221,10 +3411,21 @@ void RuleSet::addStyleRule(CSSStyleRule* rule)
     }
 }
     
-static inline void collectFeaturesFromSelector(CSSStyleSelector::Features& features, const CSSSelector* selector)
+static inline void collectFeaturesFromSelector(CSSStyleSelector::Features& features, const CSSSelector* selector, bool isLeftOfCombinator)
 {
-    if (selector->m_match == CSSSelector::Id && !selector->value().isEmpty())
-        features.idsInRules.add(selector->value().impl());
+    if ((selector->m_match == CSSSelector::Id || selector->m_match == CSSSelector::Class) && !selector->value().isEmpty()) {
+        if (selector->m_match == CSSSelector::Id)
+            features.idsInRules.add(selector->value().impl());
+        else
+            features.classesInRules.add(selector->value().impl());
+        if (isLeftOfCombinator)
+            features.idsAndClassesLeftOfCombinators.add(selector->value().impl());
+    } else if (selector->hasAttribute()) {
+        // Attribute selectors on id and class compare whole values, which the sets above can't describe.
+        const AtomicString& attributeName = selector->attribute().localName();
+        if (attributeName == idAttr.localName() || attributeName == classAttr.localName())
+            features.usesIdOrClassAttributeSelectors = true;
+    }
     switch (selector->pseudoType()) {
     case CSSSelector::PseudoFirstLine:
         features.usesFirstLineRules = true;
@@ -3248,17 +3449,22 @@ static void collectFeaturesFromList(CSSStyleSelector::Features& features, const
     for (unsigned i = 0; i < size; ++i) {
         const RuleData& ruleData = rules[i];
         bool foundSiblingSelector = false;
+        bool isLeftOfCombinator = false;
         for (CSSSelector* selector = ruleData.selector(); selector; selector = selector->tagHistory()) {
-            collectFeaturesFromSelector(features, selector);
+            collectFeaturesFromSelector(features, selector, isLeftOfCombinator);
 
             if (CSSSelectorList* selectorList = selector->selectorList()) {
                 for (CSSSelector* subSelector = selectorList->first(); subSelector; subSelector = CSSSelectorList::next(subSelector)) {
                     if (selector->isSiblingSelector())
                         foundSiblingSelector = true;
-                    collectFeaturesFromSelector(features, subSelector);
+                    collectFeaturesFromSelector(features, subSelector, isLeftOfCombinator);
                 }
             } else if (selector->isSiblingSelector())
                 foundSiblingSelector = true;
+
+            // Everything after the rightmost compound selector matches ancestors or siblings.
+            if (selector->relation() != CSSSelector::SubSelector)
+                isLeftOfCombinator = true;
         }
         if (foundSiblingSelector) {
             if (!features.siblingRules)
@@ -7018,6 +7224,28 @@ bool CSSStyleSelector::hasSelectorForAttribute(const AtomicString &attrname) con
     return m_selectorAttrs.contains(attrname.impl());
 }
 
+// The features of the default style sheets are not collected. Of those, only the view source
+// style sheet has class selectors, and none have id selectors.
+inline bool CSSStyleSelector::idAndClassFeaturesAreIncomplete() const
+{
+    return m_features.usesIdOrClassAttributeSelectors || m_checker.m_document->usesViewSourceStyles();
+}
+
+bool CSSStyleSelector::hasSelectorForId(const AtomicString& id) const
+{
+    return idAndClassFeaturesAreIncomplete() || m_features.idsInRules.contains(id.impl());
+}
+
+bool CSSStyleSelector::hasSelectorForClass(const AtomicString& className) const
+{
+    return idAndClassFeaturesAreIncomplete() || m_features.classesInRules.contains(className.impl());
+}
+
+bool CSSStyleSelector::idOrClassMayAffectOtherElements(const AtomicString& idOrClass) const
+{
+    return idAndClassFeaturesAreIncomplete() || m_features.idsAndClassesLeftOfCombinators.contains(idOrClass.impl());
+}
+
 void CSSStyleSelector::addViewportDependentMediaQueryResult(const MediaQueryExp* expr, bool result)
 {
     m_viewportDependentMediaQueryResults.append(new MediaQueryResult(*expr, result));
@@ -97,6 +97,15 @@ public:
         void pushParent(Element* parent);
         void popParent(Element* parent);
 
+        // While the cache is in use, elements that might share their style are remembered by tag,
+        // class and parent style, so that identical cousins anywhere in the tree can find each other.
+        void startStyleSharingCache();
+        void finishStyleSharingCache();
+
+        // Computed styles are remembered by the declarations that matched and the parent style they
+        // were applied to. Anything else they depend on, like the zoom or the loaded fonts, only changes
+        // ahead of a forced style recalc, which clears the cache.
+        void clearMatchedDeclarationCache();
 
         PassRefPtr<RenderStyle> styleForElement(Element* e, RenderStyle* parentStyle = 0, bool allowSharing = true, bool resolveForRootDefault = false, bool matchVisitedPseudoClass = false);
         
@@ -121,11 +130,32 @@ public:
     private:
         void initForStyleResolve(Element*, RenderStyle* parentStyle = 0, PseudoId = NOPSEUDO);
         void initElement(Element*);
+        bool idAndClassFeaturesAreIncomplete() const;
         RenderStyle* locateSharedStyle();
         bool matchesSiblingRules();
         Node* locateCousinList(Element* parent, unsigned& visitedNodeCount) const;
         Node* findSiblingForStyleSharing(Node*, unsigned& count) const;
         bool canShareStyleWithElement(Node*) const;
+        Node* findCousinInStyleSharingCache();
+
+        struct MatchedDeclarationCacheItem {
+            Vector<RefPtr<CSSMutableStyleDeclaration> > matchedDecls;
+            int firstUARule;
+            int lastUARule;
+            int firstUserRule;
+            int lastUserRule;
+            int firstAuthorRule;
+            int lastAuthorRule;
+            RefPtr<RenderStyle> renderStyle;
+            RefPtr<RenderStyle> parentStyle;
+            RefPtr<RenderStyle> rootElementStyle;
+            HashSet<int> pendingImageProperties;
+        };
+        bool isCacheableInMatchedDeclarationCache(Element*, bool hasParentStyle) const;
+        unsigned matchedDeclarationCacheIndex() const;
+        const MatchedDeclarationCacheItem* findFromMatchedDeclarationCache(unsigned index, int firstUARule, int lastUARule, int firstUserRule, int lastUserRule, int firstAuthorRule, int lastAuthorRule) const;
+        void addToMatchedDeclarationCache(unsigned index, PassRefPtr<RenderStyle>, int firstUARule, int lastUARule, int firstUserRule, int lastUserRule, int firstAuthorRule, int lastAuthorRule);
+        void applyMatchedDeclarations(int firstUARule, int lastUARule, int firstUserRule, int lastUserRule, int firstAuthorRule, int lastAuthorRule, bool resolveForRootDefault);
         
         void pushParentStackFrame(Element* parent);
         void popParentStackFrame();
@@ -165,6 +195,9 @@ public:
         Color getColorFromPrimitiveValue(CSSPrimitiveValue*) const;
 
         bool hasSelectorForAttribute(const AtomicString&) const;
+        bool hasSelectorForId(const AtomicString&) const;
+        bool hasSelectorForClass(const AtomicString&) const;
+        bool idOrClassMayAffectOtherElements(const AtomicString&) const;
  
         CSSFontSelector* fontSelector() const { return m_fontSelector.get(); }
 
@@ -189,10 +222,15 @@ public:
             Features();
             ~Features();
             HashSet<AtomicStringImpl*> idsInRules;
+            HashSet<AtomicStringImpl*> classesInRules;
+            // Ids and classes that appear to the left of a combinator. A change to one of these on an
+            // element can change the style of its descendants or siblings, not just its own.
+            HashSet<AtomicStringImpl*> idsAndClassesLeftOfCombinators;
             OwnPtr<RuleSet> siblingRules;
             bool usesFirstLineRules;
             bool usesBeforeAfterRules;
             bool usesLinkRules;
+            bool usesIdOrClassAttributeSelectors;
         };
 
     private:
@@ -360,6 +398,15 @@ public:
         Vector<CSSMutableStyleDeclaration*> m_additionalAttributeStyleDecls;
         Vector<MediaQueryResult*> m_viewportDependentMediaQueryResults;
 
+        Vector<RefPtr<StyledElement> > m_styleSharingCache; // Empty unless a style recalc is in progress.
+#if !LOG_DISABLED
+        // Reported on the StyleSharing log channel at the end of each style recalc.
+        unsigned m_styleSharingLookups;
+        unsigned m_styleSharingCacheHits;
+        unsigned m_styleSharingSiblingHits;
+#endif
+        Vector<MatchedDeclarationCacheItem> m_matchedDeclarationCache; // Empty until the first element is cached.
+
         const CSSStyleApplyProperty& m_applyProperty;
     };
 
@@ -1490,6 +1490,10 @@ void Document::recalcStyle(StyleChange change)
     if (change == Force) {
         // style selector may set this again during recalc
         m_hasNodesWithPlaceholderStyle = false;
+
+        // Whatever forced the recalc, like a zoom change or a web font load, may change how the
+        // same declarations compute.
+        styleSelector()->clearMatchedDeclarationCache();
         
         RefPtr<RenderStyle> documentStyle = CSSStyleSelector::styleForDocument(this);
         StyleChange ch = diff(documentStyle.get(), renderer()->style());
@@ -1497,10 +1501,16 @@ void Document::recalcStyle(StyleChange change)
             renderer()->setStyle(documentStyle.release());
     }
 
+    styleSelector()->startStyleSharingCache();
+
     for (Node* n = firstChild(); n; n = n->nextSibling())
         if (change >= Inherit || n->childNeedsStyleRecalc() || n->needsStyleRecalc())
             n->recalcStyle(change);
 
+    // The style selector may have been replaced during the recalc.
+    if (m_styleSelector)
+        m_styleSelector->finishStyleSharingCache();
+
     // FIXME: Disabling the deletion of retired custom font data until
     // we fix all the stale style bugs (68804, 68624, etc). These bugs
     // indicate problems where some styles were not updated in recalcStyle,
@@ -771,8 +771,21 @@ void Element::recalcStyleIfNeededAfterAttributeChanged(Attribute* attr)
         setNeedsStyleRecalc();
 }
 
+// Only the element itself needs a new style if the selectors using an id never match it on an
+// ancestor or sibling, and no element does if no selector uses the id at all.
+static inline void addStyleChangeForId(CSSStyleSelector* styleSelector, const AtomicString& id, StyleChangeType& changeType)
+{
+    if (id.isNull() || !styleSelector->hasSelectorForId(id))
+        return;
+    if (styleSelector->idOrClassMayAffectOtherElements(id))
+        changeType = FullStyleChange;
+    else if (changeType == NoStyleChange)
+        changeType = InlineStyleChange;
+}
+
 void Element::idAttributeChanged(Attribute* attr)
 {
+    AtomicString oldId = hasID() && attributeMap() ? attributeMap()->idForStyleResolution() : nullAtom;
     setHasID(!attr->isNull());
     if (attributeMap()) {
         if (attr->isNull())
@@ -782,7 +795,19 @@ void Element::idAttributeChanged(Attribute* attr)
         else
             attributeMap()->setIdForStyleResolution(attr->value());
     }
-    setNeedsStyleRecalc();
+
+    if (!attached() || !document()->attached()) {
+        setNeedsStyleRecalc();
+        return;
+    }
+    AtomicString newId = hasID() && attributeMap() ? attributeMap()->idForStyleResolution() : nullAtom;
+    if (oldId == newId)
+        return;
+    StyleChangeType changeType = NoStyleChange;
+    addStyleChangeForId(document()->styleSelector(), oldId, changeType);
+    addStyleChangeForId(document()->styleSelector(), newId, changeType);
+    if (changeType != NoStyleChange)
+        setNeedsStyleRecalc(changeType);
 }
     
 // Returns true is the given attribute is an event handler.
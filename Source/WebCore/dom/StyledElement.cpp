@@ -210,6 +210,19 @@ bool StyledElement::mapToEntry(const QualifiedName& attrName, MappedAttributeEnt
     return true;
 }
 
+// Only the element itself needs a new style if the selectors using a class never match it on an
+// ancestor or sibling, and no element does if no selector uses the class at all.
+static void addStyleChangeForClassesNotIn(CSSStyleSelector* styleSelector, const SpaceSplitString& classes, const SpaceSplitString& otherClasses, StyleChangeType& changeType)
+{
+    size_t size = classes.size();
+    for (size_t i = 0; i < size && changeType != FullStyleChange; ++i) {
+        const AtomicString& className = classes[i];
+        if (otherClasses.contains(className) || !styleSelector->hasSelectorForClass(className))
+            continue;
+        changeType = styleSelector->idOrClassMayAffectOtherElements(className) ? FullStyleChange : InlineStyleChange;
+    }
+}
+
 void StyledElement::classAttributeChanged(const AtomicString& newClassString)
 {
     const UChar* characters = newClassString.characters();
@@ -220,6 +233,20 @@ void StyledElement::classAttributeChanged(const AtomicString& newClassString)
             break;
     }
     bool hasClass = i < length;
+
+    StyleChangeType changeType = FullStyleChange;
+    if (attached() && document()->attached()) {
+        SpaceSplitString noClasses;
+        SpaceSplitString newClasses;
+        if (hasClass)
+            newClasses.set(newClassString, document()->inQuirksMode());
+        const SpaceSplitString& oldClasses = attributeMap() ? attributeMap()->classNames() : noClasses;
+        CSSStyleSelector* styleSelector = document()->styleSelector();
+        changeType = NoStyleChange;
+        addStyleChangeForClassesNotIn(styleSelector, oldClasses, newClasses, changeType);
+        addStyleChangeForClassesNotIn(styleSelector, newClasses, oldClasses, changeType);
+    }
+
     setHasClass(hasClass);
     if (hasClass) {
         attributes()->setClass(newClassString);
@@ -227,7 +254,8 @@ void StyledElement::classAttributeChanged(const AtomicString& newClassString)
             static_cast<ClassList*>(classList)->reset(newClassString);
     } else if (attributeMap())
         attributeMap()->clearClass();
-    setNeedsStyleRecalc();
+    if (changeType != NoStyleChange)
+        setNeedsStyleRecalc(changeType);
     dispatchSubtreeModifiedEvent();
 }
 
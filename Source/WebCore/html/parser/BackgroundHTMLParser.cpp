@@ -0,0 +1,313 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE COMPUTER, INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "BackgroundHTMLParser.h"
+
+#include "HTMLDocumentParser.h"
+#include "HTMLNames.h"
+#include "HTMLParserThread.h"
+#include "HTMLTokenizer.h"
+#include "MathMLNames.h"
+#include "SVGNames.h"
+#include <wtf/MainThread.h>
+
+namespace WebCore {
+
+using namespace HTMLNames;
+
+// The main thread starts building the tree once this many tokens are ready,
+// even if the tokenizer has not reached the end of the input it has.
+static const size_t pendingTokenLimit = 1000;
+
+class BackgroundHTMLParser::InputTask : public HTMLParserThread::Task {
+public:
+    static PassOwnPtr<InputTask> create(BackgroundHTMLParser* parser, const String& input, bool isEndOfFile)
+    {
+        return adoptPtr(new InputTask(parser, input, isEndOfFile));
+    }
+
+    virtual void performTask() { m_parser->processInput(m_input, m_isEndOfFile); }
+
+private:
+    InputTask(BackgroundHTMLParser* parser, const String& input, bool isEndOfFile)
+        : HTMLParserThread::Task(parser)
+        , m_parser(parser)
+        , m_input(input)
+        , m_isEndOfFile(isEndOfFile)
+    {
+    }
+
+    RefPtr<BackgroundHTMLParser> m_parser;
+    String m_input;
+    bool m_isEndOfFile;
+};
+
+class BackgroundHTMLParser::TokenBatch {
+    WTF_MAKE_NONCOPYABLE(TokenBatch); WTF_MAKE_FAST_ALLOCATED;
+public:
+    explicit TokenBatch(BackgroundHTMLParser* parser)
+        : m_parser(parser)
+    {
+    }
+
+    RefPtr<BackgroundHTMLParser> m_parser;
+    Vector<CompactHTMLToken> m_tokens;
+};
+
+BackgroundHTMLParser::BackgroundHTMLParser(HTMLDocumentParser* parser, HTMLParserThread* thread, bool usePreHTML5ParserQuirks, bool scriptEnabled, bool pluginsEnabled)
+    : m_thread(thread)
+    , m_parser(parser)
+    , m_tokenizer(HTMLTokenizer::create(usePreHTML5ParserQuirks))
+    , m_inTextMode(false)
+    , m_scriptEnabled(scriptEnabled)
+    , m_pluginsEnabled(pluginsEnabled)
+{
+    ASSERT(isMainThread());
+}
+
+BackgroundHTMLParser::~BackgroundHTMLParser()
+{
+}
+
+void BackgroundHTMLParser::append(const String& input)
+{
+    ASSERT(isMainThread());
+    m_thread->postTask(InputTask::create(this, input.crossThreadString(), false));
+}
+
+void BackgroundHTMLParser::finish()
+{
+    ASSERT(isMainThread());
+    m_thread->postTask(InputTask::create(this, String(), true));
+}
+
+void BackgroundHTMLParser::stop()
+{
+    ASSERT(isMainThread());
+    m_parser = 0;
+    m_thread->unscheduleTasks(this);
+}
+
+void BackgroundHTMLParser::processInput(const String& input, bool isEndOfFile)
+{
+    ASSERT(!isMainThread());
+    if (isEndOfFile) {
+        // Matches HTMLInputStream::markEndOfFile().
+        static const UChar endOfFileMarker = 0;
+        m_input.append(SegmentedString(String(&endOfFileMarker, 1)));
+        m_input.close();
+    } else
+        m_input.append(SegmentedString(input));
+    pumpTokenizer();
+}
+
+void BackgroundHTMLParser::pumpTokenizer()
+{
+    while (m_tokenizer->nextToken(m_input, m_token)) {
+        CompactHTMLToken::Checkpoint checkpoint;
+        checkpoint.m_inputOffset = m_input.numberOfCharactersConsumed();
+        checkpoint.m_lineNumber = m_tokenizer->lineNumber();
+        checkpoint.m_columnNumber = m_input.currentColumn().zeroBasedInt();
+        checkpoint.m_state = m_tokenizer->state();
+        checkpoint.m_skipNextNewLine = m_tokenizer->skipNextNewLine();
+        checkpoint.m_canResume = !m_tokenizer->hasBufferedEndTag();
+        m_pendingTokens.append(CompactHTMLToken(m_token, checkpoint));
+        m_token.clear();
+
+        CompactHTMLToken& token = m_pendingTokens.last();
+        simulateTreeBuilder(token);
+
+        CompactHTMLToken::Prediction prediction;
+        prediction.m_state = m_tokenizer->state();
+        prediction.m_forceNullCharacterReplacement = m_tokenizer->forceNullCharacterReplacement();
+        prediction.m_shouldAllowCDATA = m_tokenizer->shouldAllowCDATA();
+        prediction.m_skipLeadingNewLineForListing = m_tokenizer->skipLeadingNewLineForListing();
+        token.setPrediction(prediction);
+
+        if (m_pendingTokens.size() >= pendingTokenLimit)
+            sendTokensToMainThread();
+    }
+    sendTokensToMainThread();
+}
+
+// The names are compared through the AtomicString's const reference, so
+// that its reference count, which is not thread safe, is left alone.
+static inline bool tagMatches(const String& tagName, const QualifiedName& tag)
+{
+    return tagName == tag.localName();
+}
+
+static bool tokenExitsForeignContent(const CompactHTMLToken& token)
+{
+    const String& tagName = token.data();
+    if (tagMatches(tagName, fontTag)) {
+        const Vector<CompactHTMLToken::Attribute>& attributes = token.attributes();
+        for (Vector<CompactHTMLToken::Attribute>::const_iterator iter = attributes.begin(); iter != attributes.end(); ++iter) {
+            if (tagMatches(iter->m_name, colorAttr) || tagMatches(iter->m_name, faceAttr) || tagMatches(iter->m_name, sizeAttr))
+                return true;
+        }
+        return false;
+    }
+    return tagMatches(tagName, bTag)
+        || tagMatches(tagName, bigTag)
+        || tagMatches(tagName, blockquoteTag)
+        || tagMatches(tagName, bodyTag)
+        || tagMatches(tagName, brTag)
+        || tagMatches(tagName, centerTag)
+        || tagMatches(tagName, codeTag)
+        || tagMatches(tagName, ddTag)
+        || tagMatches(tagName, divTag)
+        || tagMatches(tagName, dlTag)
+        || tagMatches(tagName, dtTag)
+        || tagMatches(tagName, emTag)
+        || tagMatches(tagName, embedTag)
+        || tagMatches(tagName, h1Tag)
+        || tagMatches(tagName, h2Tag)
+        || tagMatches(tagName, h3Tag)
+        || tagMatches(tagName, h4Tag)
+        || tagMatches(tagName, h5Tag)
+        || tagMatches(tagName, h6Tag)
+        || tagMatches(tagName, headTag)
+        || tagMatches(tagName, hrTag)
+        || tagMatches(tagName, iTag)
+        || tagMatches(tagName, imgTag)
+        || tagMatches(tagName, liTag)
+        || tagMatches(tagName, listingTag)
+        || tagMatches(tagName, menuTag)
+        || tagMatches(tagName, metaTag)
+        || tagMatches(tagName, nobrTag)
+        || tagMatches(tagName, olTag)
+        || tagMatches(tagName, pTag)
+        || tagMatches(tagName, preTag)
+        || tagMatches(tagName, rubyTag)
+        || tagMatches(tagName, sTag)
+        || tagMatches(tagName, smallTag)
+        || tagMatches(tagName, spanTag)
+        || tagMatches(tagName, strongTag)
+        || tagMatches(tagName, strikeTag)
+        || tagMatches(tagName, subTag)
+        || tagMatches(tagName, supTag)
+        || tagMatches(tagName, tableTag)
+        || tagMatches(tagName, ttTag)
+        || tagMatches(tagName, uTag)
+        || tagMatches(tagName, ulTag)
+        || tagMatches(tagName, varTag);
+}
+
+static bool isHTMLIntegrationPoint(const String& tagName, bool inSVG)
+{
+    if (inSVG) {
+        // The tokenizer lowercases tag names; SVGNames::foreignObjectTag is camel case.
+        return equalIgnoringCase(tagName, "foreignobject")
+            || tagMatches(tagName, SVGNames::descTag)
+            || tagMatches(tagName, SVGNames::titleTag);
+    }
+    return tagMatches(tagName, MathMLNames::miTag)
+        || tagMatches(tagName, MathMLNames::moTag)
+        || tagMatches(tagName, MathMLNames::mnTag)
+        || tagMatches(tagName, MathMLNames::msTag)
+        || tagMatches(tagName, MathMLNames::mtextTag);
+}
+
+// Approximates what HTMLTreeBuilder would ask of the tokenizer after the
+// token. It does not need to be exact: a wrong guess only costs falling back
+// to tokenizing on the main thread.
+void BackgroundHTMLParser::simulateTreeBuilder(const CompactHTMLToken& token)
+{
+    if (token.type() == HTMLToken::StartTag) {
+        const String& tagName = token.data();
+        if (currentNodeIsForeign() && tokenExitsForeignContent(token)) {
+            while (currentNodeIsForeign())
+                m_namespaceStack.removeLast();
+        }
+
+        if (currentNodeIsForeign()) {
+            if (!token.selfClosing() && isHTMLIntegrationPoint(tagName, m_namespaceStack.last() == SVGNamespace))
+                m_namespaceStack.append(HTMLNamespace);
+        } else if (tagMatches(tagName, SVGNames::svgTag)) {
+            if (!token.selfClosing())
+                m_namespaceStack.append(SVGNamespace);
+        } else if (tagMatches(tagName, MathMLNames::mathTag)) {
+            if (!token.selfClosing())
+                m_namespaceStack.append(MathMLNamespace);
+        } else if (tagMatches(tagName, textareaTag)) {
+            m_tokenizer->setSkipLeadingNewLineForListing(true);
+            m_tokenizer->setState(HTMLTokenizer::RCDATAState);
+            m_inTextMode = true;
+        } else if (tagMatches(tagName, titleTag)) {
+            m_tokenizer->setState(HTMLTokenizer::RCDATAState);
+            m_inTextMode = true;
+        } else if (tagMatches(tagName, plaintextTag))
+            m_tokenizer->setState(HTMLTokenizer::PLAINTEXTState);
+        else if (tagMatches(tagName, scriptTag)) {
+            m_tokenizer->setState(HTMLTokenizer::ScriptDataState);
+            m_inTextMode = true;
+        } else if (tagMatches(tagName, styleTag)
+            || tagMatches(tagName, iframeTag)
+            || tagMatches(tagName, xmpTag)
+            || (tagMatches(tagName, noembedTag) && m_pluginsEnabled)
+            || tagMatches(tagName, noframesTag)
+            || (tagMatches(tagName, noscriptTag) && m_scriptEnabled)) {
+            m_tokenizer->setState(HTMLTokenizer::RAWTEXTState);
+            m_inTextMode = true;
+        } else if (tagMatches(tagName, preTag) || tagMatches(tagName, listingTag))
+            m_tokenizer->setSkipLeadingNewLineForListing(true);
+    } else if (token.type() == HTMLToken::EndTag) {
+        // The tokenizer only leaves the RCDATA, RAWTEXT and script data
+        // states on the end tag for the element that put it there.
+        m_inTextMode = false;
+        if (inForeignContent()) {
+            const String& tagName = token.data();
+            Namespace currentNamespace = m_namespaceStack.last();
+            if ((currentNamespace == SVGNamespace && tagMatches(tagName, SVGNames::svgTag))
+                || (currentNamespace == MathMLNamespace && tagMatches(tagName, MathMLNames::mathTag))
+                || (currentNamespace == HTMLNamespace && m_namespaceStack.size() > 1 && isHTMLIntegrationPoint(tagName, m_namespaceStack[m_namespaceStack.size() - 2] == SVGNamespace)))
+                m_namespaceStack.removeLast();
+        }
+    }
+
+    m_tokenizer->setForceNullCharacterReplacement(m_inTextMode || inForeignContent());
+    m_tokenizer->setShouldAllowCDATA(currentNodeIsForeign());
+}
+
+void BackgroundHTMLParser::sendTokensToMainThread()
+{
+    if (m_pendingTokens.isEmpty())
+        return;
+    TokenBatch* batch = new TokenBatch(this);
+    batch->m_tokens.swap(m_pendingTokens);
+    callOnMainThread(didProduceTokens, batch);
+}
+
+void BackgroundHTMLParser::didProduceTokens(void* context)
+{
+    ASSERT(isMainThread());
+    OwnPtr<TokenBatch> batch = adoptPtr(static_cast<TokenBatch*>(context));
+    if (HTMLDocumentParser* parser = batch->m_parser->m_parser)
+        parser->didReceiveTokensFromBackgroundParser(batch->m_tokens);
+}
+
+} // namespace WebCore
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE COMPUTER, INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BackgroundHTMLParser_h
+#define BackgroundHTMLParser_h
+
+#include "CompactHTMLToken.h"
+#include "HTMLToken.h"
+#include "SegmentedString.h"
+#include <wtf/OwnPtr.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+class HTMLDocumentParser;
+class HTMLParserThread;
+class HTMLTokenizer;
+
+// Tokenizes the network input of an HTMLDocumentParser on the
+// HTMLParserThread, ahead of the tree builder. The tokens go back to the
+// main thread in batches of CompactHTMLTokens. Each carries the tokenizer's
+// position after it, and the background parser's guess at what the tree
+// builder will ask of the tokenizer once it has seen the token. The
+// HTMLDocumentParser checks every guess; when one is wrong, or when a script
+// calls document.write, it stops the background parser and tokenizes the
+// rest of the input itself from the last token it processed.
+class BackgroundHTMLParser : public ThreadSafeRefCounted<BackgroundHTMLParser> {
+public:
+    static PassRefPtr<BackgroundHTMLParser> create(HTMLDocumentParser* parser, HTMLParserThread* thread, bool usePreHTML5ParserQuirks, bool scriptEnabled, bool pluginsEnabled)
+    {
+        return adoptRef(new BackgroundHTMLParser(parser, thread, usePreHTML5ParserQuirks, scriptEnabled, pluginsEnabled));
+    }
+
+    ~BackgroundHTMLParser();
+
+    // These are called on the main thread.
+    void append(const String&);
+    void finish();
+    void stop();
+
+private:
+    class InputTask;
+    class TokenBatch;
+
+    enum Namespace {
+        HTMLNamespace,
+        SVGNamespace,
+        MathMLNamespace,
+    };
+
+    BackgroundHTMLParser(HTMLDocumentParser*, HTMLParserThread*, bool usePreHTML5ParserQuirks, bool scriptEnabled, bool pluginsEnabled);
+
+    // These run on the HTMLParserThread.
+    void processInput(const String&, bool isEndOfFile);
+    void pumpTokenizer();
+    void simulateTreeBuilder(const CompactHTMLToken&);
+    void sendTokensToMainThread();
+
+    bool inForeignContent() const { return !m_namespaceStack.isEmpty(); }
+    bool currentNodeIsForeign() const { return inForeignContent() && m_namespaceStack.last() != HTMLNamespace; }
+
+    static void didProduceTokens(void* context);
+
+    HTMLParserThread* m_thread;
+
+    // Only used on the main thread; cleared by stop().
+    HTMLDocumentParser* m_parser;
+
+    // The rest is only used on the HTMLParserThread.
+    SegmentedString m_input;
+    OwnPtr<HTMLTokenizer> m_tokenizer;
+    HTMLToken m_token;
+    Vector<CompactHTMLToken> m_pendingTokens;
+
+    // A rough model of the tree builder: the namespaces of the foreign
+    // elements and HTML integration points that are open, and whether a
+    // <script>, <style>, <title> or the like is open.
+    Vector<Namespace, 1> m_namespaceStack;
+    bool m_inTextMode;
+    bool m_scriptEnabled;
+    bool m_pluginsEnabled;
+};
+
+} // namespace WebCore
+
+#endif // BackgroundHTMLParser_h
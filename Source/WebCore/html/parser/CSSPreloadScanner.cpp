@@ -50,11 +50,21 @@ void CSSPreloadScanner::reset()
 }
 
 void CSSPreloadScanner::scan(const HTMLToken& token, bool scanningBody)
+{
+    const HTMLToken::DataVector& characters = token.characters();
+    scan(characters.data(), characters.data() + characters.size(), scanningBody);
+}
+
+void CSSPreloadScanner::scan(const String& characters, bool scanningBody)
+{
+    scan(characters.characters(), characters.characters() + characters.length(), scanningBody);
+}
+
+void CSSPreloadScanner::scan(const UChar* begin, const UChar* end, bool scanningBody)
 {
     m_scanningBody = scanningBody;
 
-    const HTMLToken::DataVector& characters = token.characters();
-    for (HTMLToken::DataVector::const_iterator iter = characters.begin(); iter != characters.end() && m_state != DoneParsingImportRules; ++iter)
+    for (const UChar* iter = begin; iter != end && m_state != DoneParsingImportRules; ++iter)
         tokenize(*iter);
 }
 
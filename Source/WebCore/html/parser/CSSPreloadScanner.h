@@ -42,6 +42,7 @@ public:
 
     void reset();
     void scan(const HTMLToken&, bool scanningBody);
+    void scan(const String&, bool scanningBody);
 
 private:
     enum State {
@@ -57,6 +58,7 @@ private:
         DoneParsingImportRules,
     };
 
+    void scan(const UChar* begin, const UChar* end, bool scanningBody);
     inline void tokenize(UChar c);
     void emitRule();
 
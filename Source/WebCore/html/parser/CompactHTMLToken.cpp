@@ -0,0 +1,129 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE COMPUTER, INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "CompactHTMLToken.h"
+
+#include <wtf/text/AtomicString.h>
+
+namespace WebCore {
+
+template<size_t inlineCapacity>
+static inline String toStringPreservingNull(const Vector<UChar, inlineCapacity>& vector)
+{
+    if (vector.isEmpty())
+        return String();
+    return String(vector.data(), vector.size());
+}
+
+CompactHTMLToken::CompactHTMLToken(const HTMLToken& token, const Checkpoint& checkpoint)
+    : m_type(token.type())
+    , m_selfClosing(false)
+    , m_forceQuirks(false)
+    , m_checkpoint(checkpoint)
+{
+    switch (m_type) {
+    case HTMLToken::Uninitialized:
+        ASSERT_NOT_REACHED();
+        break;
+    case HTMLToken::DOCTYPE:
+        m_data = toStringPreservingNull(token.name());
+        m_publicIdentifier = toStringPreservingNull(token.publicIdentifier());
+        m_systemIdentifier = toStringPreservingNull(token.systemIdentifier());
+        m_forceQuirks = token.forceQuirks();
+        break;
+    case HTMLToken::EndOfFile:
+        break;
+    case HTMLToken::StartTag:
+    case HTMLToken::EndTag: {
+        m_selfClosing = token.selfClosing();
+        m_data = toStringPreservingNull(token.name());
+        const HTMLToken::AttributeList& attributes = token.attributes();
+        m_attributes.reserveInitialCapacity(attributes.size());
+        for (HTMLToken::AttributeList::const_iterator iter = attributes.begin(); iter != attributes.end(); ++iter) {
+            // AtomicHTMLToken drops attributes with empty names.
+            if (iter->m_name.isEmpty())
+                continue;
+            m_attributes.append(Attribute(toStringPreservingNull(iter->m_name), toStringPreservingNull(iter->m_value)));
+        }
+        break;
+    }
+    case HTMLToken::Comment:
+        m_data = toStringPreservingNull(token.comment());
+        break;
+    case HTMLToken::Character:
+        m_data = toStringPreservingNull(token.characters());
+        break;
+    }
+}
+
+// Lives here rather than in HTMLToken.h so that HTMLToken.h need not
+// include CompactHTMLToken.h. The background parser leaves empty strings
+// null, so they are made empty again here, as the tree builder expects.
+AtomicHTMLToken::AtomicHTMLToken(const CompactHTMLToken& token)
+    : m_type(token.type())
+{
+    switch (m_type) {
+    case HTMLToken::Uninitialized:
+        ASSERT_NOT_REACHED();
+        break;
+    case HTMLToken::DOCTYPE: {
+        m_name = token.data().isNull() ? emptyAtom : AtomicString(token.data());
+        m_doctypeData = adoptPtr(new HTMLToken::DoctypeData);
+        const String& publicIdentifier = token.publicIdentifier();
+        m_doctypeData->m_publicIdentifier.append(publicIdentifier.characters(), publicIdentifier.length());
+        const String& systemIdentifier = token.systemIdentifier();
+        m_doctypeData->m_systemIdentifier.append(systemIdentifier.characters(), systemIdentifier.length());
+        m_doctypeData->m_forceQuirks = token.forceQuirks();
+        break;
+    }
+    case HTMLToken::EndOfFile:
+        break;
+    case HTMLToken::StartTag:
+    case HTMLToken::EndTag: {
+        m_selfClosing = token.selfClosing();
+        m_name = AtomicString(token.data());
+        const Vector<CompactHTMLToken::Attribute>& attributes = token.attributes();
+        if (attributes.isEmpty())
+            break;
+        m_attributes = NamedNodeMap::create();
+        m_attributes->reserveInitialCapacity(attributes.size());
+        for (Vector<CompactHTMLToken::Attribute>::const_iterator iter = attributes.begin(); iter != attributes.end(); ++iter) {
+            AtomicString value = iter->m_value.isNull() ? emptyAtom : AtomicString(iter->m_value);
+            m_attributes->insertAttribute(Attribute::createMapped(AtomicString(iter->m_name), value), false);
+        }
+        break;
+    }
+    case HTMLToken::Comment:
+        m_data = token.data().isNull() ? emptyAtom.string() : token.data();
+        break;
+    case HTMLToken::Character:
+        m_externalCharacters = token.data().characters();
+        m_externalCharactersLength = token.data().length();
+        break;
+    }
+}
+
+} // namespace WebCore
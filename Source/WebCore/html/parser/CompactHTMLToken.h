@@ -0,0 +1,138 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE COMPUTER, INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CompactHTMLToken_h
+#define CompactHTMLToken_h
+
+#include "HTMLToken.h"
+#include "HTMLTokenizer.h"
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+
+// An HTMLToken that BackgroundHTMLParser has copied into Strings so that it
+// can be handed to the main thread. Empty strings are left null, because
+// the shared empty StringImpl must not be referenced off the main thread.
+class CompactHTMLToken {
+public:
+    class Attribute {
+    public:
+        Attribute(const String& name, const String& value)
+            : m_name(name)
+            , m_value(value)
+        {
+        }
+
+        String m_name;
+        String m_value;
+    };
+
+    // Where the background tokenizer stood just after emitting the token.
+    class Checkpoint {
+    public:
+        unsigned m_inputOffset; // Characters consumed since the parser started.
+        int m_lineNumber;
+        int m_columnNumber;
+        HTMLTokenizer::State m_state;
+        bool m_skipNextNewLine;
+        // The main thread's tokenizer cannot take over from a tokenizer that
+        // has buffered an end tag.
+        bool m_canResume;
+    };
+
+    // What the background parser assumed the tree builder would ask of the
+    // tokenizer after processing the token.
+    class Prediction {
+    public:
+        HTMLTokenizer::State m_state;
+        bool m_forceNullCharacterReplacement;
+        bool m_shouldAllowCDATA;
+        bool m_skipLeadingNewLineForListing;
+    };
+
+    CompactHTMLToken(const HTMLToken&, const Checkpoint&);
+
+    HTMLToken::Type type() const { return m_type; }
+
+    // "name" for DOCTYPE, StartTag, and EndTag
+    // "data" for Comment
+    // "characters" for Character
+    const String& data() const { return m_data; }
+
+    bool selfClosing() const
+    {
+        ASSERT(m_type == HTMLToken::StartTag || m_type == HTMLToken::EndTag);
+        return m_selfClosing;
+    }
+
+    const Vector<Attribute>& attributes() const
+    {
+        ASSERT(m_type == HTMLToken::StartTag || m_type == HTMLToken::EndTag);
+        return m_attributes;
+    }
+
+    const String& publicIdentifier() const
+    {
+        ASSERT(m_type == HTMLToken::DOCTYPE);
+        return m_publicIdentifier;
+    }
+
+    const String& systemIdentifier() const
+    {
+        ASSERT(m_type == HTMLToken::DOCTYPE);
+        return m_systemIdentifier;
+    }
+
+    bool forceQuirks() const
+    {
+        ASSERT(m_type == HTMLToken::DOCTYPE);
+        return m_forceQuirks;
+    }
+
+    const Checkpoint& checkpoint() const { return m_checkpoint; }
+
+    const Prediction& prediction() const { return m_prediction; }
+    void setPrediction(const Prediction& prediction) { m_prediction = prediction; }
+
+private:
+    HTMLToken::Type m_type;
+    bool m_selfClosing;
+    bool m_forceQuirks;
+
+    String m_data;
+    Vector<Attribute> m_attributes;
+
+    // For DOCTYPE
+    String m_publicIdentifier;
+    String m_systemIdentifier;
+
+    Checkpoint m_checkpoint;
+    Prediction m_prediction;
+};
+
+} // namespace WebCore
+
+#endif // CompactHTMLToken_h
@@ -26,12 +26,14 @@
 #include "config.h"
 #include "HTMLDocumentParser.h"
 
+#include "BackgroundHTMLParser.h"
 #include "ContentSecurityPolicy.h"
 #include "DocumentFragment.h"
 #include "Element.h"
 #include "Frame.h"
 #include "HTMLNames.h"
 #include "HTMLParserScheduler.h"
+#include "HTMLParserThread.h"
 #include "HTMLTokenizer.h"
 #include "HTMLPreloadScanner.h"
 #include "HTMLScriptRunner.h"
@@ -72,6 +74,19 @@ HTMLTokenizer::State tokenizerStateForContextElement(Element* contextElement, bo
     return HTMLTokenizer::DataState;
 }
 
+// Where the main thread's input stream stands when the background parser starts.
+CompactHTMLToken::Checkpoint initialSpeculativeCheckpoint()
+{
+    CompactHTMLToken::Checkpoint checkpoint;
+    checkpoint.m_inputOffset = 0;
+    checkpoint.m_lineNumber = 0;
+    checkpoint.m_columnNumber = 0;
+    checkpoint.m_state = HTMLTokenizer::DataState;
+    checkpoint.m_skipNextNewLine = false;
+    checkpoint.m_canResume = true;
+    return checkpoint;
+}
+
 } // namespace
 
 HTMLDocumentParser::HTMLDocumentParser(HTMLDocument* document, bool reportErrors)
@@ -81,6 +96,11 @@ HTMLDocumentParser::HTMLDocumentParser(HTMLDocument* document, bool reportErrors
     , m_treeBuilder(HTMLTreeBuilder::create(this, document, reportErrors, usePreHTML5ParserQuirks(document)))
     , m_parserScheduler(HTMLParserScheduler::create(this))
     , m_xssFilter(this)
+    , m_nextSpeculativeToken(0)
+    , m_preloadScannedSpeculativeTokens(0)
+    , m_lastSpeculativeCheckpoint(initialSpeculativeCheckpoint())
+    , m_speculationFailed(false)
+    , m_mayStartBackgroundParser(true)
     , m_endWasDelayed(false)
     , m_pumpSessionNestingLevel(0)
 {
@@ -93,6 +113,11 @@ HTMLDocumentParser::HTMLDocumentParser(DocumentFragment* fragment, Element* cont
     , m_tokenizer(HTMLTokenizer::create(usePreHTML5ParserQuirks(fragment->document())))
     , m_treeBuilder(HTMLTreeBuilder::create(this, fragment, contextElement, scriptingPermission, usePreHTML5ParserQuirks(fragment->document())))
     , m_xssFilter(this)
+    , m_nextSpeculativeToken(0)
+    , m_preloadScannedSpeculativeTokens(0)
+    , m_lastSpeculativeCheckpoint(initialSpeculativeCheckpoint())
+    , m_speculationFailed(false)
+    , m_mayStartBackgroundParser(false)
     , m_endWasDelayed(false)
     , m_pumpSessionNestingLevel(0)
 {
@@ -105,6 +130,7 @@ HTMLDocumentParser::~HTMLDocumentParser()
     ASSERT(!m_parserScheduler);
     ASSERT(!m_pumpSessionNestingLevel);
     ASSERT(!m_preloadScanner);
+    ASSERT(!m_backgroundParser);
 }
 
 void HTMLDocumentParser::detach()
@@ -113,6 +139,7 @@ void HTMLDocumentParser::detach()
     if (m_scriptRunner)
         m_scriptRunner->detach();
     m_treeBuilder->detach();
+    stopBackgroundParser();
     // FIXME: It seems wrong that we would have a preload scanner here.
     // Yet during fast/dom/HTMLScriptElement/script-load-events.html we do.
     m_preloadScanner.clear();
@@ -123,6 +150,7 @@ void HTMLDocumentParser::stopParsing()
 {
     DocumentParser::stopParsing();
     m_parserScheduler.clear(); // Deleting the scheduler will clear any timers.
+    stopBackgroundParser();
 }
 
 // This kicks off "Once the user agent stops parsing" as described by:
@@ -158,7 +186,7 @@ bool HTMLDocumentParser::isParsingFragment() const
 
 bool HTMLDocumentParser::processingData() const
 {
-    return isScheduledForResume() || inPumpSession();
+    return isScheduledForResume() || inPumpSession() || m_backgroundParser;
 }
 
 void HTMLDocumentParser::pumpTokenizerIfPossible(SynchronousMode mode)
@@ -259,6 +287,12 @@ void HTMLDocumentParser::pumpTokenizer(SynchronousMode mode)
     InspectorInstrumentationCookie cookie = InspectorInstrumentation::willWriteHTML(document(), m_input.current().length(), m_tokenizer->lineNumber());
 
     while (canTakeNextToken(mode, session) && !session.needsYield) {
+        if (m_backgroundParser) {
+            if (!processTokenFromBackgroundParser())
+                break;
+            continue;
+        }
+
         if (!isParsingFragment())
             m_sourceTracker.start(m_input, m_token);
 
@@ -287,7 +321,9 @@ void HTMLDocumentParser::pumpTokenizer(SynchronousMode mode)
     if (session.needsYield)
         m_parserScheduler->scheduleForResume();
 
-    if (isWaitingForScripts()) {
+    if (isWaitingForScripts() && m_backgroundParser)
+        scanSpeculativeTokensForPreloads();
+    else if (isWaitingForScripts()) {
         ASSERT(m_tokenizer->state() == HTMLTokenizer::DataState);
         if (!m_preloadScanner) {
             m_preloadScanner.set(new HTMLPreloadScanner(document()));
@@ -299,6 +335,162 @@ void HTMLDocumentParser::pumpTokenizer(SynchronousMode mode)
     InspectorInstrumentation::didWriteHTML(cookie, m_tokenizer->lineNumber());
 }
 
+void HTMLDocumentParser::startBackgroundParserIfPossible()
+{
+    if (!m_mayStartBackgroundParser)
+        return;
+    m_mayStartBackgroundParser = false;
+
+    // We will not have a scriptRunner when parsing a DocumentFragment.
+    if (!m_scriptRunner || wasCreatedByScript() || inPumpSession())
+        return;
+
+    Settings* settings = document()->settings();
+    if (!settings || !settings->threadedHTMLParserEnabled())
+        return;
+
+    // The background parser tokenizes the network input from its very
+    // beginning, in the data state.
+    if (m_tokenizer->state() != HTMLTokenizer::DataState
+        || !m_token.isUninitialized()
+        || !m_input.current().isEmpty()
+        || m_input.haveSeenEndOfFile()
+        || m_input.hasInsertionPoint())
+        return;
+
+    // The XSSFilter needs the source of each token, which only the main
+    // thread's tokenizer can give it.
+    if (m_xssFilter.isEnabled())
+        return;
+
+    HTMLParserThread* thread = HTMLParserThread::shared();
+    if (!thread)
+        return;
+
+    Frame* frame = document()->frame();
+    m_backgroundParser = BackgroundHTMLParser::create(this, thread, usePreHTML5ParserQuirks(document()), HTMLTreeBuilder::scriptEnabled(frame), HTMLTreeBuilder::pluginsEnabled(frame));
+}
+
+void HTMLDocumentParser::stopBackgroundParser()
+{
+    if (!m_backgroundParser)
+        return;
+
+    m_backgroundParser->stop();
+    m_backgroundParser = 0;
+    m_speculativeTokens.clear();
+    m_nextSpeculativeToken = 0;
+    m_preloadScannedSpeculativeTokens = 0;
+    m_speculationFailed = false;
+}
+
+// Returns false if there are no tokens from the background parser to process.
+bool HTMLDocumentParser::processTokenFromBackgroundParser()
+{
+    ASSERT(m_backgroundParser);
+
+    if (m_nextSpeculativeToken == m_speculativeTokens.size()) {
+        // We have caught up with the background parser. Clear the preload
+        // scanner so that it starts from the next token if we block again.
+        m_speculativeTokens.clear();
+        m_nextSpeculativeToken = 0;
+        m_preloadScannedSpeculativeTokens = 0;
+        m_preloadScanner.clear();
+        return false;
+    }
+
+    // Building the tree can re-enter the parser and discard the tokens, so
+    // we work on a copy.
+    CompactHTMLToken token = m_speculativeTokens[m_nextSpeculativeToken++];
+    const CompactHTMLToken::Checkpoint& checkpoint = token.checkpoint();
+
+    // Move the input stream and the tokenizer to where they would be had
+    // they produced the token themselves, so that line numbers are right
+    // and discardSpeculation() can pick up from here.
+    SegmentedString& input = m_input.current();
+    input.advanceWithoutUpdatingLineNumber(checkpoint.m_inputOffset - m_lastSpeculativeCheckpoint.m_inputOffset);
+    input.setCurrentPosition(WTF::ZeroBasedNumber::fromZeroBasedInt(checkpoint.m_lineNumber), WTF::ZeroBasedNumber::fromZeroBasedInt(checkpoint.m_columnNumber), 0);
+    m_tokenizer->setState(checkpoint.m_state);
+    m_tokenizer->setLineNumber(checkpoint.m_lineNumber);
+    m_tokenizer->setSkipLeadingNewLineForListing(false);
+    m_lastSpeculativeCheckpoint = checkpoint;
+    if (token.type() == HTMLToken::StartTag)
+        m_lastSpeculativeStartTagName = token.data();
+
+    AtomicHTMLToken atomicToken(token);
+    m_treeBuilder->constructTreeFromAtomicToken(atomicToken);
+
+    if (!m_backgroundParser || isStopped())
+        return true;
+
+    // The background parser tokenized what followed this token assuming the
+    // tree builder would leave the tokenizer as predicted. If it did not,
+    // the main thread takes over as soon as it is able to.
+    const CompactHTMLToken::Prediction& prediction = token.prediction();
+    if (m_tokenizer->state() != prediction.m_state
+        || m_tokenizer->forceNullCharacterReplacement() != prediction.m_forceNullCharacterReplacement
+        || m_tokenizer->shouldAllowCDATA() != prediction.m_shouldAllowCDATA
+        || m_tokenizer->skipLeadingNewLineForListing() != prediction.m_skipLeadingNewLineForListing)
+        m_speculationFailed = true;
+
+    if (token.type() == HTMLToken::EndOfFile || (m_speculationFailed && checkpoint.m_canResume))
+        discardSpeculation();
+    return true;
+}
+
+// Stops the background parser and continues tokenizing on the main thread
+// from just after the last token the tree builder processed.
+void HTMLDocumentParser::discardSpeculation()
+{
+    ASSERT(m_backgroundParser);
+    // Scripts only run after a </script>, and failed predictions wait for a
+    // token the main thread's tokenizer can resume after.
+    ASSERT(m_lastSpeculativeCheckpoint.m_canResume);
+
+    stopBackgroundParser();
+    m_tokenizer->resumeAfterToken(m_lastSpeculativeCheckpoint.m_lineNumber, m_lastSpeculativeCheckpoint.m_skipNextNewLine, m_lastSpeculativeStartTagName);
+
+    // The preload scanner has seen tokens the main thread's tokenizer has
+    // yet to produce.
+    m_preloadScanner.clear();
+}
+
+void HTMLDocumentParser::scanSpeculativeTokensForPreloads()
+{
+    ASSERT(m_backgroundParser);
+    if (!m_preloadScanner)
+        m_preloadScanner.set(new HTMLPreloadScanner(document()));
+    if (m_preloadScannedSpeculativeTokens < m_nextSpeculativeToken)
+        m_preloadScannedSpeculativeTokens = m_nextSpeculativeToken;
+    for (; m_preloadScannedSpeculativeTokens < m_speculativeTokens.size(); ++m_preloadScannedSpeculativeTokens)
+        m_preloadScanner->scan(m_speculativeTokens[m_preloadScannedSpeculativeTokens]);
+}
+
+void HTMLDocumentParser::didReceiveTokensFromBackgroundParser(Vector<CompactHTMLToken>& tokens)
+{
+    ASSERT(m_backgroundParser);
+    if (m_speculativeTokens.isEmpty())
+        m_speculativeTokens.swap(tokens);
+    else
+        m_speculativeTokens.append(tokens);
+
+    // pumpTokenizer can cause this parser to be detached from the Document,
+    // but we need to ensure it isn't deleted yet.
+    RefPtr<HTMLDocumentParser> protect(this);
+
+    if (isWaitingForScripts()) {
+        scanSpeculativeTokensForPreloads();
+        return;
+    }
+
+    // As in append(), a less-nested pump will process the tokens.
+    if (inPumpSession())
+        return;
+
+    pumpTokenizerIfPossible(AllowYield);
+    endIfDelayed();
+}
+
 bool HTMLDocumentParser::hasInsertionPoint()
 {
     // FIXME: The wasCreatedByScript() branch here might not be fully correct.
@@ -318,6 +510,10 @@ void HTMLDocumentParser::insert(const SegmentedString& source)
     // but we need to ensure it isn't deleted yet.
     RefPtr<HTMLDocumentParser> protect(this);
 
+    // The background parser's tokens do not account for what scripts write.
+    if (m_backgroundParser)
+        discardSpeculation();
+
     SegmentedString excludedLineNumberSource(source);
     excludedLineNumberSource.setExcludeLineNumbers();
     m_input.insertAtCurrentInsertionPoint(excludedLineNumberSource);
@@ -343,6 +539,16 @@ void HTMLDocumentParser::append(const SegmentedString& source)
     // but we need to ensure it isn't deleted yet.
     RefPtr<HTMLDocumentParser> protect(this);
 
+    startBackgroundParserIfPossible();
+    if (m_backgroundParser) {
+        // The main thread keeps its own copy of the input so that it can
+        // take over tokenizing if it has to discard the background parser's
+        // tokens. The tokens arrive in didReceiveTokensFromBackgroundParser().
+        m_input.appendToEnd(source);
+        m_backgroundParser->append(source.toString());
+        return;
+    }
+
     if (m_preloadScanner) {
         if (m_input.current().isEmpty() && !isWaitingForScripts()) {
             // We have parsed until the end of the current input and so are now moving ahead of the preload scanner.
@@ -422,8 +628,11 @@ void HTMLDocumentParser::finish()
     // We're not going to get any more data off the network, so we tell the
     // input stream we've reached the end of file.  finish() can be called more
     // than once, if the first time does not call end().
-    if (!m_input.haveSeenEndOfFile())
+    if (!m_input.haveSeenEndOfFile()) {
         m_input.markEndOfFile();
+        if (m_backgroundParser)
+            m_backgroundParser->finish();
+    }
     attemptToEnd();
 }
 
@@ -497,6 +706,10 @@ void HTMLDocumentParser::stopWatchingForLoad(CachedResource* cachedScript)
 void HTMLDocumentParser::appendCurrentInputStreamToPreloadScannerAndScan()
 {
     ASSERT(m_preloadScanner);
+    if (m_backgroundParser) {
+        scanSpeculativeTokensForPreloads();
+        return;
+    }
     m_preloadScanner->appendToEnd(m_input.current());
     m_preloadScanner->scan();
 }
@@ -27,6 +27,7 @@
 #define HTMLDocumentParser_h
 
 #include "CachedResourceClient.h"
+#include "CompactHTMLToken.h"
 #include "FragmentScriptingPermission.h"
 #include "HTMLInputStream.h"
 #include "HTMLScriptRunnerHost.h"
@@ -37,9 +38,12 @@
 #include "Timer.h"
 #include "XSSFilter.h"
 #include <wtf/OwnPtr.h>
+#include <wtf/RefPtr.h>
+#include <wtf/Vector.h>
 
 namespace WebCore {
 
+class BackgroundHTMLParser;
 class Document;
 class DocumentFragment;
 class HTMLDocument;
@@ -83,6 +87,9 @@ public:
     virtual void suspendScheduledTasks();
     virtual void resumeScheduledTasks();
 
+    // Called by BackgroundHTMLParser. Takes the contents of the Vector.
+    void didReceiveTokensFromBackgroundParser(Vector<CompactHTMLToken>&);
+
 protected:
     virtual void insert(const SegmentedString&);
     virtual void append(const SegmentedString&);
@@ -123,6 +130,12 @@ private:
     void pumpTokenizer(SynchronousMode);
     void pumpTokenizerIfPossible(SynchronousMode);
 
+    void startBackgroundParserIfPossible();
+    void stopBackgroundParser();
+    bool processTokenFromBackgroundParser();
+    void discardSpeculation();
+    void scanSpeculativeTokensForPreloads();
+
     bool runScriptsForPausedTreeBuilder();
     void resumeParsingAfterScriptExecution();
 
@@ -136,7 +149,7 @@ private:
     bool isScheduledForResume() const;
     bool inScriptExecution() const;
     bool inPumpSession() const { return m_pumpSessionNestingLevel > 0; }
-    bool shouldDelayEnd() const { return inPumpSession() || isWaitingForScripts() || inScriptExecution() || isScheduledForResume(); }
+    bool shouldDelayEnd() const { return inPumpSession() || isWaitingForScripts() || inScriptExecution() || isScheduledForResume() || m_backgroundParser; }
 
     ScriptController* script() const;
 
@@ -153,6 +166,18 @@ private:
     HTMLSourceTracker m_sourceTracker;
     XSSFilter m_xssFilter;
 
+    // Set while BackgroundHTMLParser tokenizes the network input. The main
+    // thread's tokenizer then only takes over the position after each of the
+    // background parser's tokens, until the tokens have to be discarded.
+    RefPtr<BackgroundHTMLParser> m_backgroundParser;
+    Vector<CompactHTMLToken> m_speculativeTokens;
+    size_t m_nextSpeculativeToken;
+    size_t m_preloadScannedSpeculativeTokens;
+    CompactHTMLToken::Checkpoint m_lastSpeculativeCheckpoint;
+    AtomicString m_lastSpeculativeStartTagName;
+    bool m_speculationFailed;
+    bool m_mayStartBackgroundParser;
+
     bool m_endWasDelayed;
     unsigned m_pumpSessionNestingLevel;
 };
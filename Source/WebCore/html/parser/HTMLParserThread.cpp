@@ -0,0 +1,110 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE COMPUTER, INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "HTMLParserThread.h"
+
+#include "AutodrainedPool.h"
+#include <wtf/MainThread.h>
+#include <wtf/OwnPtr.h>
+
+namespace WebCore {
+
+HTMLParserThread::HTMLParserThread()
+    : m_threadID(0)
+{
+}
+
+HTMLParserThread* HTMLParserThread::shared()
+{
+    ASSERT(isMainThread());
+    static HTMLParserThread* thread;
+    static bool triedToStart;
+    if (!triedToStart) {
+        triedToStart = true;
+        OwnPtr<HTMLParserThread> newThread = adoptPtr(new HTMLParserThread);
+        if (newThread->start())
+            thread = newThread.leakPtr();
+    }
+    return thread;
+}
+
+bool HTMLParserThread::start()
+{
+    MutexLocker lock(m_threadCreationMutex);
+    if (m_threadID)
+        return true;
+    m_threadID = createThread(HTMLParserThread::threadStart, this, "WebCore: HTMLParser");
+    return m_threadID;
+}
+
+void HTMLParserThread::postTask(PassOwnPtr<Task> task)
+{
+    m_queue.append(task);
+}
+
+namespace {
+
+class SameInstancePredicate {
+public:
+    SameInstancePredicate(const void* instance) : m_instance(instance) { }
+    bool operator()(HTMLParserThread::Task* task) const { return task->instance() == m_instance; }
+private:
+    const void* m_instance;
+};
+
+} // namespace
+
+void HTMLParserThread::unscheduleTasks(const void* instance)
+{
+    SameInstancePredicate predicate(instance);
+    m_queue.removeIf(predicate);
+}
+
+void* HTMLParserThread::threadStart(void* arg)
+{
+    HTMLParserThread* parserThread = static_cast<HTMLParserThread*>(arg);
+    return parserThread->runLoop();
+}
+
+void* HTMLParserThread::runLoop()
+{
+    {
+        // Wait for start() to complete to have m_threadID established
+        // before starting the main loop.
+        MutexLocker lock(m_threadCreationMutex);
+    }
+
+    AutodrainedPool pool;
+    while (OwnPtr<Task> task = m_queue.waitForMessage()) {
+        task->performTask();
+        pool.cycle();
+    }
+
+    detachThread(m_threadID);
+    return 0;
+}
+
+} // namespace WebCore
@@ -29,6 +29,7 @@
 #include "HTMLPreloadScanner.h"
 
 #include "CachedResourceLoader.h"
+#include "CompactHTMLToken.h"
 #include "Document.h"
 #include "InputType.h"
 #include "HTMLDocumentParser.h"
@@ -56,38 +57,60 @@ public:
         processAttributes(token.attributes());
     }
 
+    PreloadTask(const CompactHTMLToken& token)
+        : m_tagName(token.data())
+        , m_linkIsStyleSheet(false)
+        , m_linkMediaAttributeIsScreen(true)
+        , m_inputIsImage(false)
+    {
+        if (!tagNeedsAttributes())
+            return;
+        const Vector<CompactHTMLToken::Attribute>& attributes = token.attributes();
+        for (Vector<CompactHTMLToken::Attribute>::const_iterator iter = attributes.begin(); iter != attributes.end(); ++iter)
+            processAttribute(iter->m_name, iter->m_value);
+    }
+
+    bool tagNeedsAttributes() const
+    {
+        return m_tagName == imgTag
+            || m_tagName == inputTag
+            || m_tagName == linkTag
+            || m_tagName == scriptTag;
+    }
+
     void processAttributes(const HTMLToken::AttributeList& attributes)
     {
-        if (m_tagName != imgTag
-            && m_tagName != inputTag
-            && m_tagName != linkTag
-            && m_tagName != scriptTag)
+        if (!tagNeedsAttributes())
             return;
 
         for (HTMLToken::AttributeList::const_iterator iter = attributes.begin();
              iter != attributes.end(); ++iter) {
             AtomicString attributeName(iter->m_name.data(), iter->m_name.size());
             String attributeValue(iter->m_value.data(), iter->m_value.size());
+            processAttribute(attributeName, attributeValue);
+        }
+    }
 
-            if (attributeName == charsetAttr)
-                m_charset = attributeValue;
-
-            if (m_tagName == scriptTag || m_tagName == imgTag) {
-                if (attributeName == srcAttr)
-                    setUrlToLoad(attributeValue);
-            } else if (m_tagName == linkTag) {
-                if (attributeName == hrefAttr)
-                    setUrlToLoad(attributeValue);
-                else if (attributeName == relAttr)
-                    m_linkIsStyleSheet = relAttributeIsStyleSheet(attributeValue);
-                else if (attributeName == mediaAttr)
-                    m_linkMediaAttributeIsScreen = linkMediaAttributeIsScreen(attributeValue);
-            } else if (m_tagName == inputTag) {
-                if (attributeName == srcAttr)
-                    setUrlToLoad(attributeValue);
-                else if (attributeName == typeAttr)
-                    m_inputIsImage = equalIgnoringCase(attributeValue, InputTypeNames::image());
-            }
+    void processAttribute(const AtomicString& attributeName, const String& attributeValue)
+    {
+        if (attributeName == charsetAttr)
+            m_charset = attributeValue;
+
+        if (m_tagName == scriptTag || m_tagName == imgTag) {
+            if (attributeName == srcAttr)
+                setUrlToLoad(attributeValue);
+        } else if (m_tagName == linkTag) {
+            if (attributeName == hrefAttr)
+                setUrlToLoad(attributeValue);
+            else if (attributeName == relAttr)
+                m_linkIsStyleSheet = relAttributeIsStyleSheet(attributeValue);
+            else if (attributeName == mediaAttr)
+                m_linkMediaAttributeIsScreen = linkMediaAttributeIsScreen(attributeValue);
+        } else if (m_tagName == inputTag) {
+            if (attributeName == srcAttr)
+                setUrlToLoad(attributeValue);
+            else if (attributeName == typeAttr)
+                m_inputIsImage = equalIgnoringCase(attributeValue, InputTypeNames::image());
         }
     }
 
@@ -172,6 +195,32 @@ void HTMLPreloadScanner::scan()
     }
 }
 
+void HTMLPreloadScanner::scan(const CompactHTMLToken& token)
+{
+    if (m_inStyle) {
+        if (token.type() == HTMLToken::Character)
+            m_cssScanner.scan(token.data(), scanningBody());
+        else if (token.type() == HTMLToken::EndTag) {
+            m_inStyle = false;
+            m_cssScanner.reset();
+        }
+    }
+
+    if (token.type() != HTMLToken::StartTag)
+        return;
+
+    // The background parser has already put its tokenizer in the right state.
+    PreloadTask task(token);
+
+    if (task.tagName() == bodyTag)
+        m_bodySeen = true;
+
+    if (task.tagName() == styleTag)
+        m_inStyle = true;
+
+    task.preload(m_document, scanningBody());
+}
+
 void HTMLPreloadScanner::processToken()
 {
     if (m_inStyle) {
@@ -33,6 +33,7 @@
 
 namespace WebCore {
 
+class CompactHTMLToken;
 class Document;
 class HTMLToken;
 class HTMLTokenizer;
@@ -46,6 +47,10 @@ public:
     void appendToEnd(const SegmentedString&);
     void scan();
 
+    // Looks for resources in a token that BackgroundHTMLParser has already
+    // tokenized, without going through this scanner's own tokenizer.
+    void scan(const CompactHTMLToken&);
+
 private:
     void processToken();
     bool scanningBody() const;
@@ -35,11 +35,18 @@
 #include "NotImplemented.h"
 #include <wtf/ASCIICType.h>
 #include <wtf/CurrentTime.h>
+#include <wtf/Threading.h>
 #include <wtf/UnusedParam.h>
 #include <wtf/text/AtomicString.h>
 #include <wtf/text/CString.h>
 #include <wtf/unicode/Unicode.h>
 
+#if CPU(X86_64) || (CPU(X86) && defined(__SSE2__))
+#include <emmintrin.h>
+#elif CPU(ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 using namespace WTF;
 
 namespace WebCore {
@@ -84,6 +91,93 @@ inline bool vectorEqualsString(const Vector<UChar, 32>& vector, const String& st
     return !memcmp(stringData, vectorData, vector.size() * sizeof(UChar));
 }
 
+inline bool isPlainCharacter(UChar cc, UChar delimiter)
+{
+    // All the characters we stop at are at or below '<'.
+    return cc > '<' || (cc != delimiter && cc != '&' && cc != '\n' && cc != '\r' && cc);
+}
+
+// Finds the first character that the text and quoted attribute value states
+// cannot simply copy into the token: the |delimiter| that ends the run,
+// '&', and the characters InputStreamPreprocessor rewrites or counts lines at.
+// Checks eight characters at a time where SSE2 or NEON is available.
+inline const UChar* findNonPlainCharacter(const UChar* characters, const UChar* end, UChar delimiter)
+{
+#if CPU(X86_64) || (CPU(X86) && defined(__SSE2__))
+    const __m128i delimiters = _mm_set1_epi16(delimiter);
+    const __m128i ampersands = _mm_set1_epi16('&');
+    const __m128i newlines = _mm_set1_epi16('\n');
+    const __m128i carriageReturns = _mm_set1_epi16('\r');
+    const __m128i nulls = _mm_setzero_si128();
+    for (; end - characters >= 8; characters += 8) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters));
+        __m128i matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi16(block, delimiters), _mm_cmpeq_epi16(block, ampersands)),
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi16(block, newlines), _mm_cmpeq_epi16(block, carriageReturns)), _mm_cmpeq_epi16(block, nulls)));
+        if (_mm_movemask_epi8(matches))
+            break;
+    }
+#elif CPU(ARM_NEON)
+    const uint16x8_t delimiters = vdupq_n_u16(delimiter);
+    const uint16x8_t ampersands = vdupq_n_u16('&');
+    const uint16x8_t newlines = vdupq_n_u16('\n');
+    const uint16x8_t carriageReturns = vdupq_n_u16('\r');
+    const uint16x8_t nulls = vdupq_n_u16(0);
+    for (; end - characters >= 8; characters += 8) {
+        uint16x8_t block = vld1q_u16(reinterpret_cast<const uint16_t*>(characters));
+        uint16x8_t matches = vorrq_u16(vorrq_u16(vceqq_u16(block, delimiters), vceqq_u16(block, ampersands)),
+            vorrq_u16(vorrq_u16(vceqq_u16(block, newlines), vceqq_u16(block, carriageReturns)), vceqq_u16(block, nulls)));
+        if (vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(matches)), 0))
+            break;
+    }
+#endif
+    // The block with the match, if any, and whatever is left is done one
+    // character at a time.
+    for (; characters < end; ++characters) {
+        if (!isPlainCharacter(*characters, delimiter))
+            return characters;
+    }
+    return end;
+}
+
+// The same search over 8-bit characters, sixteen at a time where SSE2 or NEON
+// is available.
+inline const LChar* findNonPlainCharacter(const LChar* characters, const LChar* end, UChar delimiter)
+{
+    ASSERT(delimiter <= 0xFF);
+#if CPU(X86_64) || (CPU(X86) && defined(__SSE2__))
+    const __m128i delimiters = _mm_set1_epi8(static_cast<char>(delimiter));
+    const __m128i ampersands = _mm_set1_epi8('&');
+    const __m128i newlines = _mm_set1_epi8('\n');
+    const __m128i carriageReturns = _mm_set1_epi8('\r');
+    const __m128i nulls = _mm_setzero_si128();
+    for (; end - characters >= 16; characters += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters));
+        __m128i matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, delimiters), _mm_cmpeq_epi8(block, ampersands)),
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, newlines), _mm_cmpeq_epi8(block, carriageReturns)), _mm_cmpeq_epi8(block, nulls)));
+        if (_mm_movemask_epi8(matches))
+            break;
+    }
+#elif CPU(ARM_NEON)
+    const uint8x16_t delimiters = vdupq_n_u8(delimiter);
+    const uint8x16_t ampersands = vdupq_n_u8('&');
+    const uint8x16_t newlines = vdupq_n_u8('\n');
+    const uint8x16_t carriageReturns = vdupq_n_u8('\r');
+    const uint8x16_t nulls = vdupq_n_u8(0);
+    for (; end - characters >= 16; characters += 16) {
+        uint8x16_t block = vld1q_u8(characters);
+        uint8x16_t matches = vorrq_u8(vorrq_u8(vceqq_u8(block, delimiters), vceqq_u8(block, ampersands)),
+            vorrq_u8(vorrq_u8(vceqq_u8(block, newlines), vceqq_u8(block, carriageReturns)), vceqq_u8(block, nulls)));
+        if (vget_lane_u64(vreinterpret_u64_u8(vorr_u8(vget_low_u8(matches), vget_high_u8(matches))), 0))
+            break;
+    }
+#endif
+    for (; characters < end; ++characters) {
+        if (!isPlainCharacter(*characters, delimiter))
+            return characters;
+    }
+    return end;
+}
+
 inline bool isEndTagBufferingState(HTMLTokenizer::State state)
 {
     switch (state) {
@@ -125,6 +219,15 @@ void HTMLTokenizer::reset()
     m_additionalAllowedCharacter = '\0';
 }
 
+void HTMLTokenizer::resumeAfterToken(int lineNumber, bool skipNextNewLine, const String& lastStartTagName)
+{
+    ASSERT(!hasBufferedEndTag());
+    m_lineNumber = lineNumber;
+    m_inputStreamPreprocessor.setSkipNextNewLine(skipNextNewLine);
+    m_appropriateEndTagName.clear();
+    m_appropriateEndTagName.append(lastStartTagName.characters(), lastStartTagName.length());
+}
+
 inline bool HTMLTokenizer::processEntity(SegmentedString& source)
 {
     bool notEnoughCharacters = false;
@@ -175,6 +278,20 @@ inline bool HTMLTokenizer::processEntity(SegmentedString& source)
 // we consume the next input character and when we switch to a particular
 // state. We handle those cases by advancing the source directly and using
 // this macro to switch to the indicated state.
+// Like ADVANCE_TO, but first has |appendPlainCharacters| copy the run of
+// characters after the current one that need no handling of their own.
+#define ADVANCE_PAST_PLAIN_CHARACTERS_TO(stateName, appendPlainCharacters, delimiter) \
+    do {                                                                   \
+        m_state = stateName;                                               \
+        if (!m_inputStreamPreprocessor.advance(source, m_lineNumber))      \
+            return haveBufferedCharacterToken();                           \
+        if (appendPlainCharacters(source, delimiter)                       \
+            && !m_inputStreamPreprocessor.peek(source, m_lineNumber))      \
+            return haveBufferedCharacterToken();                           \
+        cc = m_inputStreamPreprocessor.nextInputCharacter();               \
+        goto stateName;                                                    \
+    } while (false)
+
 #define SWITCH_TO(stateName)                                               \
     do {                                                                   \
         m_state = stateName;                                               \
@@ -317,7 +434,7 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
             return emitEndOfFile(source);
         else {
             bufferCharacter(cc);
-            ADVANCE_TO(DataState);
+            ADVANCE_PAST_PLAIN_CHARACTERS_TO(DataState, bufferPlainCharacters, '<');
         }
     }
     END_STATE()
@@ -338,7 +455,7 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
             return emitEndOfFile(source);
         else {
             bufferCharacter(cc);
-            ADVANCE_TO(RCDATAState);
+            ADVANCE_PAST_PLAIN_CHARACTERS_TO(RCDATAState, bufferPlainCharacters, '<');
         }
     }
     END_STATE()
@@ -357,7 +474,7 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
             return emitEndOfFile(source);
         else {
             bufferCharacter(cc);
-            ADVANCE_TO(RAWTEXTState);
+            ADVANCE_PAST_PLAIN_CHARACTERS_TO(RAWTEXTState, bufferPlainCharacters, '<');
         }
     }
     END_STATE()
@@ -369,7 +486,7 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
             return emitEndOfFile(source);
         else {
             bufferCharacter(cc);
-            ADVANCE_TO(ScriptDataState);
+            ADVANCE_PAST_PLAIN_CHARACTERS_TO(ScriptDataState, bufferPlainCharacters, '<');
         }
     }
     END_STATE()
@@ -379,7 +496,7 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
             return emitEndOfFile(source);
         else
             bufferCharacter(cc);
-        ADVANCE_TO(PLAINTEXTState);
+        ADVANCE_PAST_PLAIN_CHARACTERS_TO(PLAINTEXTState, bufferPlainCharacters, InputStreamPreprocessor::endOfFileMarker);
     }
     END_STATE()
 
@@ -1004,7 +1121,7 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
             RECONSUME_IN(DataState);
         } else {
             m_token->appendToAttributeValue(cc);
-            ADVANCE_TO(AttributeValueDoubleQuotedState);
+            ADVANCE_PAST_PLAIN_CHARACTERS_TO(AttributeValueDoubleQuotedState, appendPlainCharactersToAttributeValue, '"');
         }
     }
     END_STATE()
@@ -1022,7 +1139,7 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
             RECONSUME_IN(DataState);
         } else {
             m_token->appendToAttributeValue(cc);
-            ADVANCE_TO(AttributeValueSingleQuotedState);
+            ADVANCE_PAST_PLAIN_CHARACTERS_TO(AttributeValueSingleQuotedState, appendPlainCharactersToAttributeValue, '\'');
         }
     }
     END_STATE()
@@ -1131,9 +1248,10 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
     END_STATE()
 
     BEGIN_STATE(MarkupDeclarationOpenState) {
-        DEFINE_STATIC_LOCAL(String, dashDashString, ("--"));
-        DEFINE_STATIC_LOCAL(String, doctypeString, ("doctype"));
-        DEFINE_STATIC_LOCAL(String, cdataString, ("[CDATA["));
+        // BackgroundHTMLParser runs tokenizers on another thread.
+        AtomicallyInitializedStatic(String&, dashDashString = *new String("--"));
+        AtomicallyInitializedStatic(String&, doctypeString = *new String("doctype"));
+        AtomicallyInitializedStatic(String&, cdataString = *new String("[CDATA["));
         if (cc == '-') {
             SegmentedString::LookAheadResult result = source.lookAhead(dashDashString);
             if (result == SegmentedString::DidMatch) {
@@ -1334,8 +1452,8 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
             m_token->setForceQuirks();
             return emitAndReconsumeIn(source, DataState);
         } else {
-            DEFINE_STATIC_LOCAL(String, publicString, ("public"));
-            DEFINE_STATIC_LOCAL(String, systemString, ("system"));
+            AtomicallyInitializedStatic(String&, publicString = *new String("public"));
+            AtomicallyInitializedStatic(String&, systemString = *new String("system"));
             if (cc == 'P' || cc == 'p') {
                 SegmentedString::LookAheadResult result = source.lookAheadIgnoringCase(publicString);
                 if (result == SegmentedString::DidMatch) {
@@ -1685,6 +1803,43 @@ inline void HTMLTokenizer::bufferCharacter(UChar character)
     m_token->appendToCharacter(character);
 }
 
+inline bool HTMLTokenizer::bufferPlainCharacters(SegmentedString& source, UChar delimiter)
+{
+    if (source.contiguousCharactersAre8Bit())
+        return bufferPlainCharacters(source, source.contiguousCharacters8(), delimiter);
+    return bufferPlainCharacters(source, source.contiguousCharacters16(), delimiter);
+}
+
+template<typename CharacterType>
+inline bool HTMLTokenizer::bufferPlainCharacters(SegmentedString& source, const CharacterType* characters, UChar delimiter)
+{
+    unsigned length = findNonPlainCharacter(characters, characters + source.lengthOfContiguousCharacters(), delimiter) - characters;
+    if (!length)
+        return false;
+    m_token->ensureIsCharacterToken();
+    m_token->appendToCharacter(characters, length);
+    source.advancePastNonNewlines(length);
+    return true;
+}
+
+inline bool HTMLTokenizer::appendPlainCharactersToAttributeValue(SegmentedString& source, UChar delimiter)
+{
+    if (source.contiguousCharactersAre8Bit())
+        return appendPlainCharactersToAttributeValue(source, source.contiguousCharacters8(), delimiter);
+    return appendPlainCharactersToAttributeValue(source, source.contiguousCharacters16(), delimiter);
+}
+
+template<typename CharacterType>
+inline bool HTMLTokenizer::appendPlainCharactersToAttributeValue(SegmentedString& source, const CharacterType* characters, UChar delimiter)
+{
+    unsigned length = findNonPlainCharacter(characters, characters + source.lengthOfContiguousCharacters(), delimiter) - characters;
+    if (!length)
+        return false;
+    m_token->appendToAttributeValue(characters, length);
+    source.advancePastNonNewlines(length);
+    return true;
+}
+
 inline void HTMLTokenizer::parseError()
 {
     notImplemented();
@@ -131,6 +131,7 @@ public:
     bool nextToken(SegmentedString&, HTMLToken&);
 
     int lineNumber() const { return m_lineNumber; }
+    void setLineNumber(int lineNumber) { m_lineNumber = lineNumber; }
     int columnNumber() const { return 1; } // Matches LegacyHTMLDocumentParser.h behavior.
 
     State state() const { return m_state; }
@@ -154,6 +155,7 @@ public:
 
     // Hack to skip leading newline in <pre>/<listing> for authoring ease.
     // http://www.whatwg.org/specs/web-apps/current-work/multipage/tokenization.html#parsing-main-inbody
+    bool skipLeadingNewLineForListing() const { return m_skipLeadingNewLineForListing; }
     void setSkipLeadingNewLineForListing(bool value) { m_skipLeadingNewLineForListing = value; }
 
     bool forceNullCharacterReplacement() const { return m_forceNullCharacterReplacement; }
@@ -162,6 +164,14 @@ public:
     bool shouldAllowCDATA() const { return m_shouldAllowCDATA; }
     void setShouldAllowCDATA(bool value) { m_shouldAllowCDATA = value; }
 
+    // Between tokens, the state the tree builder does not control is the
+    // state, the line number, the name of the last start tag and whether a
+    // '\r' has just been read. BackgroundHTMLParser uses these to hand its
+    // position in the input over to the main thread's tokenizer.
+    bool hasBufferedEndTag() const { return !m_bufferedEndTagName.isEmpty(); }
+    bool skipNextNewLine() const { return m_inputStreamPreprocessor.skipNextNewLine(); }
+    void resumeAfterToken(int lineNumber, bool skipNextNewLine, const String& lastStartTagName);
+
     bool shouldSkipNullCharacters() const
     {
         return !m_forceNullCharacterReplacement
@@ -185,6 +195,9 @@ private:
 
         UChar nextInputCharacter() const { return m_nextInputCharacter; }
 
+        bool skipNextNewLine() const { return m_skipNextNewLine; }
+        void setSkipNextNewLine(bool value) { m_skipNextNewLine = value; }
+
         // Returns whether we succeeded in peeking at the next character.
         // The only way we can fail to peek is if there are no more
         // characters in |source| (after collapsing \r\n, etc).
@@ -264,6 +277,14 @@ private:
     inline void bufferCharacter(UChar);
     inline void bufferCodePoint(unsigned);
 
+    // Copy the characters at the front of |source|, up to |delimiter| or a
+    // character that needs handling of its own, in one go. Return whether
+    // there were any.
+    inline bool bufferPlainCharacters(SegmentedString&, UChar delimiter);
+    inline bool appendPlainCharactersToAttributeValue(SegmentedString&, UChar delimiter);
+    template<typename CharacterType> inline bool bufferPlainCharacters(SegmentedString&, const CharacterType*, UChar delimiter);
+    template<typename CharacterType> inline bool appendPlainCharactersToAttributeValue(SegmentedString&, const CharacterType*, UChar delimiter);
+
     inline bool emitAndResumeIn(SegmentedString&, State);
     inline bool emitAndReconsumeIn(SegmentedString&, State);
     inline bool emitEndOfFile(SegmentedString&);
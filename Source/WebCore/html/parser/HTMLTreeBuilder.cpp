@@ -249,8 +249,8 @@ class HTMLTreeBuilder::ExternalCharacterTokenBuffer {
     WTF_MAKE_NONCOPYABLE(ExternalCharacterTokenBuffer);
 public:
     explicit ExternalCharacterTokenBuffer(AtomicHTMLToken& token)
-        : m_current(token.characters().data())
-        , m_end(m_current + token.characters().size())
+        : m_current(token.characters())
+        , m_end(m_current + token.charactersLength())
     {
         ASSERT(!isEmpty());
     }
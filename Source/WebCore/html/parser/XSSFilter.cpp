@@ -189,14 +189,19 @@ void XSSFilter::init()
         m_isEnabled = false;
 }
 
-void XSSFilter::filterToken(HTMLToken& token)
+bool XSSFilter::isEnabled()
 {
     if (m_state == Uninitialized) {
         init();
         ASSERT(m_state == Initial);
     }
 
-    if (!m_isEnabled || m_xssProtection == XSSProtectionDisabled)
+    return m_isEnabled && m_xssProtection != XSSProtectionDisabled;
+}
+
+void XSSFilter::filterToken(HTMLToken& token)
+{
+    if (!isEnabled())
         return;
 
     bool didBlockScript = false;
@@ -41,6 +41,9 @@ public:
 
     void filterToken(HTMLToken&);
 
+    // Whether filterToken() might change tokens in this document.
+    bool isEnabled();
+
 private:
     enum State {
         Uninitialized,
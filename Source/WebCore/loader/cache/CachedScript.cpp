@@ -86,6 +86,10 @@ const String& CachedScript::script()
     if (!m_script && m_data) {
         m_script = m_decoder->decode(m_data->data(), encodedSize());
         m_script += m_decoder->flush();
+        // The source provider reads UTF-16, so widen an 8-bit script once here
+        // rather than have characters() keep a second copy on the string.
+        if (m_script.impl() && m_script.impl()->is8Bit())
+            m_script = String(reinterpret_cast<const char*>(m_script.impl()->characters8()), m_script.length());
         setDecodedSize(m_script.length() * sizeof(UChar));
     }
     m_decodedDataDeletionTimer.startOneShot(0);
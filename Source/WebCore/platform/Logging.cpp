@@ -60,6 +60,7 @@ WTFLogChannel LogArchives =          { 0x04000000, "WebCoreLogLevel", WTFLogChan
 WTFLogChannel LogProgress =          { 0x08000000, "WebCoreLogLevel", WTFLogChannelOff };
 
 WTFLogChannel LogFileAPI =           { 0x10000000, "WebCoreLogLevel", WTFLogChannelOff };
+WTFLogChannel LogStyleSharing =      { 0x20000000, "WebCoreLogLevel", WTFLogChannelOff };
 
 WTFLogChannel* getChannelFromName(const String& channelName)
 {
@@ -135,6 +136,9 @@ WTFLogChannel* getChannelFromName(const String& channelName)
     if (equalIgnoringCase(channelName, String("FileAPI")))
         return &LogFileAPI;
 
+    if (equalIgnoringCase(channelName, String("StyleSharing")))
+        return &LogStyleSharing;
+
     return 0;
 }
 
@@ -32,20 +32,52 @@ class SegmentedSubstring {
 public:
     SegmentedSubstring()
         : m_length(0)
-        , m_current(0)
+        , m_current16(0)
         , m_doNotExcludeLineNumbers(true)
+        , m_is8Bit(false)
     {
     }
 
+    // 8-bit strings, such as decoded Latin-1 text, are read as they are
+    // rather than through characters(), which would cache a UTF-16 copy.
     SegmentedSubstring(const String& str)
         : m_length(str.length())
-        , m_current(str.isEmpty() ? 0 : str.characters())
+        , m_current16(0)
         , m_string(str)
         , m_doNotExcludeLineNumbers(true)
+        , m_is8Bit(str.impl() && str.impl()->is8Bit())
     {
+        if (m_is8Bit)
+            m_current8 = str.impl()->characters8();
+        else if (m_length)
+            m_current16 = str.characters();
     }
 
-    void clear() { m_length = 0; m_current = 0; }
+    void clear() { m_length = 0; m_current16 = 0; m_is8Bit = false; }
+
+    bool is8Bit() const { return m_is8Bit; }
+
+    UChar currentChar() const
+    {
+        if (!m_length)
+            return 0;
+        return m_is8Bit ? *m_current8 : *m_current16;
+    }
+
+    UChar incrementAndGetCurrentChar()
+    {
+        ASSERT(m_length);
+        return m_is8Bit ? *++m_current8 : *++m_current16;
+    }
+
+    // Moves past |count| characters without changing m_length.
+    void skip(unsigned count)
+    {
+        if (m_is8Bit)
+            m_current8 += count;
+        else
+            m_current16 += count;
+    }
     
     bool excludeLineNumbers() const { return !m_doNotExcludeLineNumbers; }
     bool doNotExcludeLineNumbers() const { return m_doNotExcludeLineNumbers; }
@@ -56,22 +88,26 @@ public:
 
     void appendTo(String& str) const
     {
-        if (m_string.characters() == m_current) {
+        if (!numberOfCharactersConsumed()) {
             if (str.isEmpty())
                 str = m_string;
             else
                 str.append(m_string);
         } else
-            str.append(String(m_current, m_length));
+            str.append(m_string.substring(numberOfCharactersConsumed(), m_length));
     }
 
 public:
     int m_length;
-    const UChar* m_current;
+    union {
+        const LChar* m_current8;
+        const UChar* m_current16;
+    };
 
 private:
     String m_string;
     bool m_doNotExcludeLineNumbers;
+    bool m_is8Bit;
 };
 
 class SegmentedString {
@@ -91,7 +127,7 @@ public:
         : m_pushedChar1(0)
         , m_pushedChar2(0)
         , m_currentString(str)
-        , m_currentChar(m_currentString.m_current)
+        , m_currentChar(m_currentString.currentChar())
         , m_numberOfCharactersConsumedPriorToCurrentString(0)
         , m_numberOfCharactersConsumedPriorToCurrentLine(0)
         , m_currentLine(0)
@@ -116,14 +152,14 @@ public:
     {
         if (!m_pushedChar1) {
             m_pushedChar1 = c;
-            m_currentChar = m_pushedChar1 ? &m_pushedChar1 : m_currentString.m_current;
+            updateCurrentChar();
         } else {
             ASSERT(!m_pushedChar2);
             m_pushedChar2 = c;
         }
     }
 
-    bool isEmpty() const { return !current(); }
+    bool isEmpty() const { return !m_pushedChar1 && !m_currentString.m_length; }
     unsigned length() const;
 
     bool isClosed() const { return m_closed; }
@@ -141,7 +177,7 @@ public:
     {
         if (!m_pushedChar1 && m_currentString.m_length > 1) {
             --m_currentString.m_length;
-            m_currentChar = ++m_currentString.m_current;
+            m_currentChar = m_currentString.incrementAndGetCurrentChar();
             return;
         }
         advanceSlowCase();
@@ -149,19 +185,19 @@ public:
 
     void advanceAndASSERT(UChar expectedCharacter)
     {
-        ASSERT_UNUSED(expectedCharacter, *current() == expectedCharacter);
+        ASSERT_UNUSED(expectedCharacter, m_currentChar == expectedCharacter);
         advance();
     }
 
     void advanceAndASSERTIgnoringCase(UChar expectedCharacter)
     {
-        ASSERT_UNUSED(expectedCharacter, WTF::Unicode::foldCase(*current()) == WTF::Unicode::foldCase(expectedCharacter));
+        ASSERT_UNUSED(expectedCharacter, WTF::Unicode::foldCase(m_currentChar) == WTF::Unicode::foldCase(expectedCharacter));
         advance();
     }
 
     void advancePastNewline(int& lineNumber)
     {
-        ASSERT(*current() == '\n');
+        ASSERT(m_currentChar == '\n');
         if (!m_pushedChar1 && m_currentString.m_length > 1) {
             int newLineFlag = m_currentString.doNotExcludeLineNumbers();
             lineNumber += newLineFlag;
@@ -169,7 +205,7 @@ public:
             if (newLineFlag)
                 m_numberOfCharactersConsumedPriorToCurrentLine = numberOfCharactersConsumed() + 1;
             --m_currentString.m_length;
-            m_currentChar = ++m_currentString.m_current;
+            m_currentChar = m_currentString.incrementAndGetCurrentChar();
             return;
         }
         advanceSlowCase(lineNumber);
@@ -177,25 +213,42 @@ public:
     
     void advancePastNonNewline()
     {
-        ASSERT(*current() != '\n');
+        ASSERT(m_currentChar != '\n');
         if (!m_pushedChar1 && m_currentString.m_length > 1) {
             --m_currentString.m_length;
-            m_currentChar = ++m_currentString.m_current;
+            m_currentChar = m_currentString.incrementAndGetCurrentChar();
             return;
         }
         advanceSlowCase();
     }
+
+    // The characters that can be read ahead without leaving the current
+    // substring, for callers that scan them in bulk. The last character of
+    // the substring is left for advance() to step past. The characters are
+    // 8-bit or UTF-16, as the current substring is.
+    bool contiguousCharactersAre8Bit() const { return m_currentString.is8Bit(); }
+    const LChar* contiguousCharacters8() const { ASSERT(m_currentString.is8Bit()); return m_currentString.m_current8; }
+    const UChar* contiguousCharacters16() const { ASSERT(!m_currentString.is8Bit()); return m_currentString.m_current16; }
+    unsigned lengthOfContiguousCharacters() const { return m_pushedChar1 || m_currentString.m_length < 1 ? 0 : m_currentString.m_length - 1; }
+
+    void advancePastNonNewlines(unsigned count)
+    {
+        ASSERT(count <= lengthOfContiguousCharacters());
+        m_currentString.m_length -= count;
+        m_currentString.skip(count);
+        m_currentChar = m_currentString.currentChar();
+    }
     
     void advance(int& lineNumber)
     {
         if (!m_pushedChar1 && m_currentString.m_length > 1) {
-            int newLineFlag = (*m_currentString.m_current == '\n') & m_currentString.doNotExcludeLineNumbers();
+            int newLineFlag = (m_currentChar == '\n') & m_currentString.doNotExcludeLineNumbers();
             lineNumber += newLineFlag;
             m_currentLine += newLineFlag;
             if (newLineFlag)
                 m_numberOfCharactersConsumedPriorToCurrentLine = numberOfCharactersConsumed() + 1;
             --m_currentString.m_length;
-            m_currentChar = ++m_currentString.m_current;
+            m_currentChar = m_currentString.incrementAndGetCurrentChar();
             return;
         }
         advanceSlowCase(lineNumber);
@@ -205,6 +258,11 @@ public:
     // have space for at least |count| characters.
     void advance(unsigned count, UChar* consumedCharacters);
 
+    // Skips |count| characters a substring at a time. The line number is not
+    // updated; callers that know the position after those characters should
+    // set it with setCurrentPosition().
+    void advanceWithoutUpdatingLineNumber(unsigned count);
+
     bool escaped() const { return m_pushedChar1; }
 
     int numberOfCharactersConsumed() const
@@ -220,9 +278,8 @@ public:
 
     String toString() const;
 
-    const UChar& operator*() const { return *current(); }
-    const UChar* operator->() const { return current(); }
-    
+    UChar operator*() const { return m_currentChar; }
+
 
     // The method is moderately slow, comparing to currentLine method.
     WTF::ZeroBasedNumber currentColumn() const;
@@ -238,7 +295,7 @@ private:
     void advanceSlowCase();
     void advanceSlowCase(int& lineNumber);
     void advanceSubstring();
-    const UChar* current() const { return m_currentChar; }
+    void updateCurrentChar() { m_currentChar = m_pushedChar1 ? m_pushedChar1 : m_currentString.currentChar(); }
 
     static bool equalsLiterally(const UChar* str1, const UChar* str2, size_t count) { return !memcmp(str1, str2, count * sizeof(UChar)); }
     static bool equalsIgnoringCase(const UChar* str1, const UChar* str2, size_t count) { return !WTF::Unicode::umemcasecmp(str1, str2, count); }
@@ -247,7 +304,13 @@ private:
     inline LookAheadResult lookAheadInline(const String& string)
     {
         if (!m_pushedChar1 && string.length() <= static_cast<unsigned>(m_currentString.m_length)) {
-            if (equals(string.characters(), m_currentString.m_current, string.length()))
+            const UChar* characters = m_currentString.is8Bit() ? 0 : m_currentString.m_current16;
+            Vector<UChar, 32> widenedCharacters;
+            if (!characters) {
+                widenedCharacters.append(m_currentString.m_current8, string.length());
+                characters = widenedCharacters.data();
+            }
+            if (equals(string.characters(), characters, string.length()))
                 return DidMatch;
             return DidNotMatch;
         }
@@ -275,7 +338,7 @@ private:
     UChar m_pushedChar1;
     UChar m_pushedChar2;
     SegmentedSubstring m_currentString;
-    const UChar* m_currentChar;
+    UChar m_currentChar;
     int m_numberOfCharactersConsumedPriorToCurrentString;
     int m_numberOfCharactersConsumedPriorToCurrentLine;
     int m_currentLine;
@@ -29,6 +29,12 @@
 
 #include <stdint.h>
 
+#if CPU(X86_64) || (CPU(X86) && defined(__SSE2__))
+#include <emmintrin.h>
+#elif CPU(ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace WebCore {
 
 // Assuming that a pointer is the size of a "machine word", then
@@ -91,6 +97,75 @@ template<typename T> inline T* alignToMachineWord(T* pointer)
     return reinterpret_cast<T*>(reinterpret_cast<uintptr_t>(pointer) & ~machineWordAlignmentMask);
 }
 
+// Returns the length of the run of ASCII bytes at the start of [source, end),
+// checking a machine word at a time once source is aligned.
+inline size_t lengthOfASCIIPrefix(const uint8_t* source, const uint8_t* end)
+{
+    const uint8_t* start = source;
+
+    while (source < end && !isAlignedToMachineWord(source) && !(*source & 0x80))
+        ++source;
+    if (isAlignedToMachineWord(source)) {
+        const uint8_t* alignedEnd = alignToMachineWord(end);
+        while (source < alignedEnd && isAllASCII(*reinterpret_cast_ptr<const MachineWord*>(source)))
+            source += sizeof(MachineWord);
+    }
+    while (source < end && !(*source & 0x80))
+        ++source;
+
+    return source - start;
+}
+
+// Widens the run of ASCII bytes at the start of [source, end) into destination,
+// which must have room for end - source characters, and returns its length.
+// Where SSE2 or NEON is available, sixteen bytes are checked and widened at a
+// time from any alignment; otherwise a machine word at a time once aligned.
+inline size_t copyASCIIPrefix(UChar* destination, const uint8_t* source, const uint8_t* end)
+{
+    const uint8_t* start = source;
+
+#if CPU(X86_64) || (CPU(X86) && defined(__SSE2__))
+    const __m128i zero = _mm_setzero_si128();
+    while (end - source >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+        if (_mm_movemask_epi8(chunk))
+            break;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), _mm_unpacklo_epi8(chunk, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + 8), _mm_unpackhi_epi8(chunk, zero));
+        source += 16;
+        destination += 16;
+    }
+#elif CPU(ARM_NEON)
+    while (end - source >= 16) {
+        uint8x16_t chunk = vld1q_u8(source);
+        uint8x8_t ored = vorr_u8(vget_low_u8(chunk), vget_high_u8(chunk));
+        if (vget_lane_u64(vreinterpret_u64_u8(ored), 0) & NonASCIIMask<8>::value())
+            break;
+        vst1q_u16(reinterpret_cast<uint16_t*>(destination), vmovl_u8(vget_low_u8(chunk)));
+        vst1q_u16(reinterpret_cast<uint16_t*>(destination + 8), vmovl_u8(vget_high_u8(chunk)));
+        source += 16;
+        destination += 16;
+    }
+#else
+    if (isAlignedToMachineWord(source)) {
+        const uint8_t* alignedEnd = alignToMachineWord(end);
+        while (source < alignedEnd) {
+            MachineWord chunk = *reinterpret_cast_ptr<const MachineWord*>(source);
+            if (!isAllASCII(chunk))
+                break;
+            copyASCIIMachineWord(destination, source);
+            source += sizeof(MachineWord);
+            destination += sizeof(MachineWord);
+        }
+    }
+#endif
+
+    while (source < end && !(*source & 0x80))
+        *destination++ = *source++;
+
+    return source - start;
+}
+
 } // namespace WebCore
 
 #endif // TextCodecASCIIFastPath_h
@@ -116,42 +116,47 @@ void TextCodecLatin1::registerCodecs(TextCodecRegistrar registrar)
     registrar("US-ASCII", newStreamingTextDecoderWindowsLatin1, 0);
 }
 
-String TextCodecLatin1::decode(const char* bytes, size_t length, bool, bool, bool&)
+// Windows Latin-1 maps every byte to the code point of the same value, except
+// for most of 0x80-0x9F. Text without any of those decodes to its own bytes.
+static inline bool decodesToSameValues(const uint8_t* source, const uint8_t* end)
 {
-    UChar* characters;
-    String result = String::createUninitialized(length, characters);
+    while (source < end) {
+        source += lengthOfASCIIPrefix(source, end);
+        if (source == end)
+            break;
+        if (table[*source] != *source)
+            return false;
+        ++source;
+    }
+    return true;
+}
 
+String TextCodecLatin1::decode(const char* bytes, size_t length, bool, bool, bool&)
+{
     const uint8_t* source = reinterpret_cast<const uint8_t*>(bytes);
     const uint8_t* end = reinterpret_cast<const uint8_t*>(bytes + length);
-    const uint8_t* alignedEnd = alignToMachineWord(end);
+
+    // Keep such text in an 8-bit string, at half the size of its UTF-16 form.
+    if (decodesToSameValues(source, end)) {
+        LChar* characters;
+        String result = String::createUninitialized(length, characters);
+        memcpy(characters, bytes, length);
+        return result;
+    }
+
+    UChar* characters;
+    String result = String::createUninitialized(length, characters);
     UChar* destination = characters;
 
     while (source < end) {
         if (isASCII(*source)) {
             // Fast path for ASCII. Most Latin-1 text will be ASCII.
-            if (isAlignedToMachineWord(source)) {
-                while (source < alignedEnd) {
-                    MachineWord chunk = *reinterpret_cast_ptr<const MachineWord*>(source);
-
-                    if (!isAllASCII(chunk))
-                        goto useLookupTable;
-
-                    copyASCIIMachineWord(destination, source);
-                    source += sizeof(MachineWord);
-                    destination += sizeof(MachineWord);
-                }
-
-                if (source == end)
-                    break;
-            }
-            *destination = *source;
-        } else {
-useLookupTable:
-            *destination = table[*source];
+            size_t asciiLength = copyASCIIPrefix(destination, source, end);
+            source += asciiLength;
+            destination += asciiLength;
+            continue;
         }
-
-        ++source;
-        ++destination;
+        *destination++ = table[*source++];
     }
 
     return result;
@@ -150,6 +150,49 @@ static inline UChar* appendCharacter(UChar* destination, int character)
     return destination;
 }
 
+static inline bool isLatin1LeadByte(uint8_t byte)
+{
+    return byte == 0xC2 || byte == 0xC3;
+}
+
+static inline bool isContinuationByte(uint8_t byte)
+{
+    return (byte & 0xC0) == 0x80;
+}
+
+// Returns true, and the number of characters in latin1Length, if [source, end) is
+// only ASCII and complete two-byte sequences for U+0080-U+00FF.
+static inline bool decodesToLatin1(const uint8_t* source, const uint8_t* end, size_t& latin1Length)
+{
+    size_t sequenceCount = 0;
+    const uint8_t* start = source;
+    while (source < end) {
+        source += lengthOfASCIIPrefix(source, end);
+        if (source == end)
+            break;
+        if (!isLatin1LeadByte(source[0]) || end - source < 2 || !isContinuationByte(source[1]))
+            return false;
+        source += 2;
+        ++sequenceCount;
+    }
+    latin1Length = (source - start) - sequenceCount;
+    return true;
+}
+
+static inline void decodeLatin1(LChar* destination, const uint8_t* source, const uint8_t* end)
+{
+    while (source < end) {
+        size_t asciiLength = lengthOfASCIIPrefix(source, end);
+        memcpy(destination, source, asciiLength);
+        source += asciiLength;
+        destination += asciiLength;
+        if (source == end)
+            break;
+        *destination++ = ((source[0] & 0x1F) << 6) | (source[1] & 0x3F);
+        source += 2;
+    }
+}
+
 void TextCodecUTF8::consumePartialSequenceByte()
 {
     --m_partialSequenceSize;
@@ -215,6 +258,20 @@ void TextCodecUTF8::handlePartialSequence(UChar*& destination, const uint8_t*& s
 
 String TextCodecUTF8::decode(const char* bytes, size_t length, bool flush, bool stopOnError, bool& sawError)
 {
+    // Text that is all ASCII and Latin-1 is kept in an 8-bit string. A chunk that
+    // starts or ends inside a sequence takes the general path below.
+    if (!m_partialSequenceSize) {
+        const uint8_t* source = reinterpret_cast<const uint8_t*>(bytes);
+        const uint8_t* end = source + length;
+        size_t latin1Length;
+        if (decodesToLatin1(source, end, latin1Length)) {
+            LChar* characters;
+            String result = String::createUninitialized(latin1Length, characters);
+            decodeLatin1(characters, source, end);
+            return result;
+        }
+    }
+
     // Each input byte might turn into a character.
     // That includes all bytes in the partial-sequence buffer because
     // each byte in an invalid sequence will turn into a replacement character.
@@ -222,7 +279,6 @@ String TextCodecUTF8::decode(const char* bytes, size_t length, bool flush, bool
 
     const uint8_t* source = reinterpret_cast<const uint8_t*>(bytes);
     const uint8_t* end = source + length;
-    const uint8_t* alignedEnd = alignToMachineWord(end);
     UChar* destination = buffer.characters();
 
     do {
@@ -242,21 +298,9 @@ String TextCodecUTF8::decode(const char* bytes, size_t length, bool flush, bool
         while (source < end) {
             if (isASCII(*source)) {
                 // Fast path for ASCII. Most UTF-8 text will be ASCII.
-                if (isAlignedToMachineWord(source)) {
-                    while (source < alignedEnd) {
-                        MachineWord chunk = *reinterpret_cast_ptr<const MachineWord*>(source);
-                        if (!isAllASCII(chunk))
-                            break;
-                        copyASCIIMachineWord(destination, source);
-                        source += sizeof(MachineWord);
-                        destination += sizeof(MachineWord);
-                    }
-                    if (source == end)
-                        break;
-                    if (!isASCII(*source))
-                        continue;
-                }
-                *destination++ = *source++;
+                size_t asciiLength = copyASCIIPrefix(destination, source, end);
+                source += asciiLength;
+                destination += asciiLength;
                 continue;
             }
             int count = nonASCIISequenceLength(*source);
@@ -98,6 +98,7 @@ void InitializeLoggingChannelsIfNecessary()
     initializeWithUserDefault(LogArchives);
     initializeWithUserDefault(LogProgress);
     initializeWithUserDefault(LogFileAPI);
+    initializeWithUserDefault(LogStyleSharing);
 }
 
 } // namespace WebCore
@@ -320,6 +320,9 @@ public:
     ~RenderStyle();
 
     void inheritFrom(const RenderStyle* inheritParent);
+    // Copies the values of all properties, but none of the state recorded while matching rules:
+    // the affected-by and child state bits, the pseudo style bits and whether this is a link.
+    void copyPropertiesFrom(const RenderStyle*);
 
     PseudoId styleType() const { return static_cast<PseudoId>(noninherited_flags._styleType); }
     void setStyleType(PseudoId styleType) { noninherited_flags._styleType = styleType; }
@@ -209,6 +209,8 @@ using namespace WebCore;
                 [NSNumber numberWithInt:heapFree], @"JavaScriptFreeSize",
                 [NSNumber numberWithUnsignedInt:(unsigned int)globalMemoryStats.stackBytes], @"JavaScriptStackSize",
                 [NSNumber numberWithUnsignedInt:(unsigned int)globalMemoryStats.JITBytes], @"JavaScriptJITSize",
+                [NSNumber numberWithUnsignedInt:(unsigned int)globalMemoryStats.JITFreeBytes], @"JavaScriptJITFreeSize",
+                [NSNumber numberWithUnsignedInt:(unsigned int)globalMemoryStats.JITLargestFreeBlockBytes], @"JavaScriptJITLargestFreeBlockSize",
             nil];
 }
 
@@ -392,6 +392,7 @@ static bool useQuickLookQuirks(void)
         [NSNumber numberWithBool:YES],  WebKitHyperlinkAuditingEnabledPreferenceKey,
         [NSNumber numberWithBool:NO],   WebKitUsePreHTML5ParserQuirksKey,
         [NSNumber numberWithBool:useQuickLookQuirks()], WebKitUseQuickLookResourceCachingQuirksPreferenceKey,
+        [NSNumber numberWithBool:NO],   WebKitThreadedHTMLParserEnabledPreferenceKey,
         [NSNumber numberWithLongLong:WebCore::ApplicationCacheStorage::noQuota()], WebKitApplicationCacheTotalQuota,
         [NSNumber numberWithLongLong:WebCore::ApplicationCacheStorage::noQuota()], WebKitApplicationCacheDefaultOriginQuota,
         nil];
@@ -1469,6 +1470,16 @@ static NSString *classIBCreatorID = nil;
     return [self _boolValueForKey:WebKitAsynchronousSpellCheckingEnabledPreferenceKey];
 }
 
+- (void)setThreadedHTMLParserEnabled:(BOOL)flag
+{
+    [self _setBoolValue:flag forKey:WebKitThreadedHTMLParserEnabledPreferenceKey];
+}
+
+- (BOOL)threadedHTMLParserEnabled
+{
+    return [self _boolValueForKey:WebKitThreadedHTMLParserEnabledPreferenceKey];
+}
+
 + (void)setWebKitLinkTimeVersion:(int)version
 {
     setWebKitLinkTimeVersion(version);
@@ -235,6 +235,9 @@ extern NSString *WebPreferencesChangedInternalNotification;
 - (void)setAsynchronousSpellCheckingEnabled:(BOOL)flag;
 - (BOOL)asynchronousSpellCheckingEnabled;
 
+- (void)setThreadedHTMLParserEnabled:(BOOL)flag;
+- (BOOL)threadedHTMLParserEnabled;
+
 - (void)setUsePreHTML5ParserQuirks:(BOOL)flag;
 - (BOOL)usePreHTML5ParserQuirks;
 